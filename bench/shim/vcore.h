@@ -0,0 +1,127 @@
+/* ========== <vcore.h>							==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Minimal Linux stand-in for the vcore functions used by	*/
+/* the physics engine. Only built with the bench.			*/
+
+#ifndef _VSHIM_CORE_INCLUDE_
+#define _VSHIM_CORE_INCLUDE_
+
+/* ========== INCLUDES							==========	*/
+#include "vtypes.h"
+
+
+/* ========== STRUCTURES						==========	*/
+typedef struct vComponent
+{
+	vUI16 componentHandle;
+	struct vObject* parent;
+	vPTR  objectAttribute;
+} vComponent, *vPComponent;
+
+#define SHIM_OBJECT_COMPONENTS	0x8
+typedef struct vObject
+{
+	vPComponent components[SHIM_OBJECT_COMPONENTS];
+	vPTR userData;
+} vObject, *vPObject;
+
+typedef struct vWorker
+{
+	volatile vUI64 cycleCount;
+	vTIME  cycleInterval;
+	void (*initFunc)(struct vWorker*, vPTR, vPTR);
+	void (*exitFunc)(struct vWorker*, vPTR);
+	void (*cycleFunc)(struct vWorker*, vPTR);
+	vPTR   persistentData;
+	vPTR   input;
+	volatile vBOOL exitRequested;
+	pthread_t thread;
+} vWorker, *vPWorker;
+
+typedef void (*vPFDBUFFERINITIALIZER)(vHNDL, vPTR, vPTR);
+typedef void (*vPFDBUFFERDESTRUCTOR)(vHNDL, vPTR);
+typedef void (*vPFDBUFFERITERATEFUNC)(vHNDL, vPTR, vPTR);
+typedef void (*vPFCOMPONENTINITIALIZE)(vPObject, vPComponent, vPTR);
+typedef void (*vPFCOMPONENTDESTROY)(vPObject, vPComponent);
+typedef void (*vPFWORKERINIT)(vPWorker, vPTR, vPTR);
+typedef void (*vPFWORKEREXIT)(vPWorker, vPTR);
+typedef void (*vPFWORKERCYCLE)(vPWorker, vPTR);
+
+
+/* ========== WIN32 STAND-INS					==========	*/
+void InitializeCriticalSection(PCRITICAL_SECTION section);
+void DeleteCriticalSection(PCRITICAL_SECTION section);
+void EnterCriticalSection(PCRITICAL_SECTION section);
+void LeaveCriticalSection(PCRITICAL_SECTION section);
+void InitializeConditionVariable(PCONDITION_VARIABLE variable);
+BOOL SleepConditionVariableCS(PCONDITION_VARIABLE variable,
+	PCRITICAL_SECTION section, DWORD milliseconds);
+void WakeConditionVariable(PCONDITION_VARIABLE variable);
+void WakeAllConditionVariable(PCONDITION_VARIABLE variable);
+ULONGLONG GetTickCount64(void);
+BOOL QueryPerformanceCounter(LARGE_INTEGER* counter);
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* frequency);
+LONG InterlockedIncrement(volatile LONG* value);
+LONG InterlockedDecrement(volatile LONG* value);
+LONG64 InterlockedIncrement64(volatile LONG64* value);
+LONG InterlockedExchange(volatile LONG* target, LONG value);
+LONG InterlockedExchangeAdd(volatile LONG* value, LONG add);
+LONG InterlockedCompareExchange(volatile LONG* dest, LONG exchange,
+	LONG comparand);
+DWORD GetCurrentThreadId(void);
+BOOL  FlushFileBuffers(HANDLE file);
+HANDLE CreateFileA(const char* fileName, DWORD access, DWORD shareMode,
+	vPTR security, DWORD disposition, DWORD flags, HANDLE templateFile);
+BOOL   GetFileSizeEx(HANDLE file, LARGE_INTEGER* size);
+HANDLE CreateFileMappingA(HANDLE file, vPTR security, DWORD protect,
+	DWORD sizeHigh, DWORD sizeLow, const char* name);
+vPTR   MapViewOfFile(HANDLE mapping, DWORD access, DWORD offsetHigh,
+	DWORD offsetLow, SIZE_T size);
+BOOL   UnmapViewOfFile(const void* view);
+BOOL   CloseHandle(HANDLE object);
+void  Sleep(DWORD milliseconds);
+
+
+/* ========== MEMORY							==========	*/
+vPTR vAlloc(SIZE_T size);
+vPTR vAllocZeroed(SIZE_T size);
+void vFree(vPTR block);
+void vZeroMemory(vPTR block, SIZE_T size);
+void vMemCopy(vPTR dest, const void* source, SIZE_T size);
+
+
+/* ========== LOGGING AND FILES					==========	*/
+void  vLogInfo(const char* function, const char* message);
+void  vLogWarning(const char* function, const char* message);
+void  vLogError(const char* function, const char* message);
+vBOOL vFileWrite(HANDLE file, vUI64 offset, vUI64 size, vPTR data);
+vUI64 vFileSize(HANDLE file);
+
+
+/* ========== DYNAMIC BUFFERS					==========	*/
+vHNDL vCreateDBuffer(vPCHAR name, vUI64 elementSize, vUI64 nodeSize,
+	vPTR initFunc, vPTR destroyFunc);
+void  vDestroyDBuffer(vHNDL buffer);
+vPTR  vDBufferAdd(vHNDL buffer, vPTR input);
+void  vDBufferRemove(vHNDL buffer, vPTR element);
+void  vDBufferIterate(vHNDL buffer, vPTR iterateFunc, vPTR input);
+vUI64 vDBufferGetElementCount(vHNDL buffer);
+
+
+/* ========== OBJECTS AND COMPONENTS			==========	*/
+vUI16 vCreateComponent(vPCHAR name, vPTR settings, vUI64 attributeSize,
+	vPTR globalInput, vPTR initFunc, vPTR destroyFunc, vPTR cycleFunc,
+	vPTR worker);
+vPObject	vCreateObject(vPObject parent);
+void		vDestroyObject(vPObject object);
+vPComponent vObjectAddComponent(vPObject object, vUI16 component, vPTR input);
+vPComponent vObjectGetComponent(vPObject object, vUI16 component);
+void		vObjectRemoveComponent(vPObject object, vUI16 component);
+
+
+/* ========== WORKERS							==========	*/
+vPWorker vCreateWorker(vPCHAR name, vTIME cycleInterval, vPTR initFunc,
+	vPTR exitFunc, vPTR cycleFunc, vPTR persistentData, vPTR input);
+void	 vDestroyWorker(vPWorker worker);
+
+#endif
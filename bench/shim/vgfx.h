@@ -0,0 +1,51 @@
+/* ========== <vgfx.h>							==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Minimal Linux stand-in for the vgfx functions used by	*/
+/* the physics engine. Draw calls are only counted.			*/
+
+#ifndef _VSHIM_GFX_INCLUDE_
+#define _VSHIM_GFX_INCLUDE_
+
+/* ========== INCLUDES							==========	*/
+#include "vcore.h"
+
+
+/* ========== STRUCTURES						==========	*/
+typedef struct vGRect
+{
+	float left;
+	float right;
+	float bottom;
+	float top;
+} vGRect, *vPGRect;
+
+typedef struct vGColor
+{
+	float R, G, B, A;
+} vGColor, *vPGColor;
+
+typedef struct vGRenderable
+{
+	vTransform transform;
+} vGRenderable, *vPGRenderable;
+
+
+/* ========== FUNCTIONS							==========	*/
+vPosition vCreatePosition(float x, float y);
+vGRect  vGCreateRect(float left, float right, float bottom, float top);
+vGColor vGCreateColorB(vUI8 r, vUI8 g, vUI8 b, vUI8 a);
+vUI16   vGGetComponentHandle(void);
+void    vGLock(void);
+void    vGUnlock(void);
+
+void vGDrawLineF(float x1, float y1, float x2, float y2, vGColor color,
+	float width);
+void vGDrawLineV(vPosition p1, vPosition p2, vGColor color, float width);
+void vGDrawLinesConnected(vPPosition positions, vUI16 count, vGColor color,
+	float width);
+void vGDrawCross(vPosition position, float size, vGColor color, float width);
+
+/* number of draw calls issued since startup (bench only) */
+vUI64 vShimGetDrawCallCount(void);
+
+#endif
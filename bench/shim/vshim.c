@@ -0,0 +1,599 @@
+/* ========== <vshim.c>							==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Minimal Linux stand-in for vcore and vgfx. Implements	*/
+/* only what the physics engine calls, as simply as	*/
+/* possible, so that the engine can be benchmarked			*/
+/* headlessly.												*/
+
+/* ========== INCLUDES							==========	*/
+#define _GNU_SOURCE
+#include "vcore.h"
+#include "vgfx.h"
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+
+/* ========== WIN32 STAND-INS					==========	*/
+void InitializeCriticalSection(PCRITICAL_SECTION section)
+{
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&section->mutex, &attr);
+	pthread_mutexattr_destroy(&attr);
+}
+
+void DeleteCriticalSection(PCRITICAL_SECTION section)
+{
+	pthread_mutex_destroy(&section->mutex);
+}
+
+void EnterCriticalSection(PCRITICAL_SECTION section)
+{
+	pthread_mutex_lock(&section->mutex);
+}
+
+void LeaveCriticalSection(PCRITICAL_SECTION section)
+{
+	pthread_mutex_unlock(&section->mutex);
+}
+
+void InitializeConditionVariable(PCONDITION_VARIABLE variable)
+{
+	pthread_cond_init(&variable->cond, NULL);
+}
+
+BOOL SleepConditionVariableCS(PCONDITION_VARIABLE variable,
+	PCRITICAL_SECTION section, DWORD milliseconds)
+{
+	if (milliseconds == INFINITE)
+		return pthread_cond_wait(&variable->cond, &section->mutex) == 0;
+
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_sec  += milliseconds / 1000;
+	ts.tv_nsec += (long)(milliseconds % 1000) * 1000000;
+	if (ts.tv_nsec >= 1000000000) { ts.tv_sec++; ts.tv_nsec -= 1000000000; }
+	return pthread_cond_timedwait(&variable->cond, &section->mutex, &ts) == 0;
+}
+
+void WakeConditionVariable(PCONDITION_VARIABLE variable)
+{
+	pthread_cond_signal(&variable->cond);
+}
+
+void WakeAllConditionVariable(PCONDITION_VARIABLE variable)
+{
+	pthread_cond_broadcast(&variable->cond);
+}
+
+ULONGLONG GetTickCount64(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ULONGLONG)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+BOOL QueryPerformanceCounter(LARGE_INTEGER* counter)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	counter->QuadPart = (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+	return TRUE;
+}
+
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* frequency)
+{
+	frequency->QuadPart = 1000000000;
+	return TRUE;
+}
+
+LONG InterlockedIncrement(volatile LONG* value)
+{
+	return __atomic_add_fetch(value, 1, __ATOMIC_SEQ_CST);
+}
+
+LONG InterlockedDecrement(volatile LONG* value)
+{
+	return __atomic_sub_fetch(value, 1, __ATOMIC_SEQ_CST);
+}
+
+LONG64 InterlockedIncrement64(volatile LONG64* value)
+{
+	return __atomic_add_fetch(value, 1, __ATOMIC_SEQ_CST);
+}
+
+LONG InterlockedExchange(volatile LONG* target, LONG value)
+{
+	return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+LONG InterlockedExchangeAdd(volatile LONG* value, LONG add)
+{
+	return __atomic_fetch_add(value, add, __ATOMIC_SEQ_CST);
+}
+
+LONG InterlockedCompareExchange(volatile LONG* dest, LONG exchange,
+	LONG comparand)
+{
+	__atomic_compare_exchange_n(dest, &comparand, exchange, FALSE,
+		__ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return comparand;
+}
+
+DWORD GetCurrentThreadId(void)
+{
+	return (DWORD)syscall(SYS_gettid);
+}
+
+BOOL FlushFileBuffers(HANDLE file)
+{
+	return fflush((FILE*)file) == 0;
+}
+
+void Sleep(DWORD milliseconds)
+{
+	usleep(milliseconds * 1000);
+}
+
+/* file and mapping handles are both an open descriptor, views	*/
+/* remember their length so they can be unmapped by address	*/
+typedef struct ShimFile
+{
+	int    fd;
+	size_t size;
+} ShimFile;
+
+#define SHIM_VIEWS_MAX	0x40
+static struct { const void* view; size_t size; } __shimViews[SHIM_VIEWS_MAX];
+static pthread_mutex_t __shimViewLock = PTHREAD_MUTEX_INITIALIZER;
+
+HANDLE CreateFileA(const char* fileName, DWORD access, DWORD shareMode,
+	vPTR security, DWORD disposition, DWORD flags, HANDLE templateFile)
+{
+	int fd = open(fileName, O_RDONLY);
+	if (fd < 0) return INVALID_HANDLE_VALUE;
+
+	struct stat info;
+	fstat(fd, &info);
+	ShimFile* file = calloc(1, sizeof(ShimFile));
+	file->fd   = fd;
+	file->size = (size_t)info.st_size;
+	return file;
+}
+
+BOOL GetFileSizeEx(HANDLE file, LARGE_INTEGER* size)
+{
+	size->QuadPart = (int64_t)((ShimFile*)file)->size;
+	return TRUE;
+}
+
+HANDLE CreateFileMappingA(HANDLE file, vPTR security, DWORD protect,
+	DWORD sizeHigh, DWORD sizeLow, const char* name)
+{
+	ShimFile* mapping = calloc(1, sizeof(ShimFile));
+	mapping->fd   = dup(((ShimFile*)file)->fd);
+	mapping->size = ((ShimFile*)file)->size;
+	return mapping;
+}
+
+vPTR MapViewOfFile(HANDLE mapping, DWORD access, DWORD offsetHigh,
+	DWORD offsetLow, SIZE_T size)
+{
+	ShimFile* map = mapping;
+	if (size == 0) size = map->size;
+	vPTR view = mmap(NULL, size, PROT_READ, MAP_PRIVATE, map->fd, 0);
+	if (view == MAP_FAILED) return NULL;
+
+	pthread_mutex_lock(&__shimViewLock);
+	for (int i = 0; i < SHIM_VIEWS_MAX; i++)
+	{
+		if (__shimViews[i].view != NULL) continue;
+		__shimViews[i].view = view;
+		__shimViews[i].size = size;
+		break;
+	}
+	pthread_mutex_unlock(&__shimViewLock);
+	return view;
+}
+
+BOOL UnmapViewOfFile(const void* view)
+{
+	pthread_mutex_lock(&__shimViewLock);
+	for (int i = 0; i < SHIM_VIEWS_MAX; i++)
+	{
+		if (__shimViews[i].view != view) continue;
+		munmap((void*)view, __shimViews[i].size);
+		__shimViews[i].view = NULL;
+		break;
+	}
+	pthread_mutex_unlock(&__shimViewLock);
+	return TRUE;
+}
+
+BOOL CloseHandle(HANDLE object)
+{
+	close(((ShimFile*)object)->fd);
+	free(object);
+	return TRUE;
+}
+
+
+/* ========== MEMORY							==========	*/
+vPTR vAlloc(SIZE_T size)
+{
+	return malloc(size);
+}
+
+vPTR vAllocZeroed(SIZE_T size)
+{
+	return calloc(1, size);
+}
+
+void vFree(vPTR block)
+{
+	free(block);
+}
+
+void vZeroMemory(vPTR block, SIZE_T size)
+{
+	memset(block, 0, size);
+}
+
+void vMemCopy(vPTR dest, const void* source, SIZE_T size)
+{
+	memcpy(dest, source, size);
+}
+
+
+/* ========== LOGGING AND FILES					==========	*/
+void vLogInfo(const char* function, const char* message)
+{
+	/* info logs are silenced to keep bench output clean */
+}
+
+void vLogWarning(const char* function, const char* message)
+{
+	fprintf(stderr, "[WARN] %s: %s\n", function, message);
+}
+
+void vLogError(const char* function, const char* message)
+{
+	fprintf(stderr, "[ERROR] %s: %s\n", function, message);
+}
+
+vBOOL vFileWrite(HANDLE file, vUI64 offset, vUI64 size, vPTR data)
+{
+	fseek((FILE*)file, (long)offset, SEEK_SET);
+	return fwrite(data, 1, size, (FILE*)file) == size;
+}
+
+vUI64 vFileSize(HANDLE file)
+{
+	fseek((FILE*)file, 0, SEEK_END);
+	return (vUI64)ftell((FILE*)file);
+}
+
+
+/* ========== DYNAMIC BUFFERS					==========	*/
+typedef struct ShimDBufferNode
+{
+	struct ShimDBufferNode* next;
+	vUI64  used;
+	vPUI64 useMask;
+	vUI8*  elements;
+} ShimDBufferNode;
+
+typedef struct ShimDBuffer
+{
+	vUI64 elementSize;
+	vUI64 nodeSize;
+	vUI64 elementCount;
+	vPFDBUFFERINITIALIZER initFunc;
+	vPFDBUFFERDESTRUCTOR  destroyFunc;
+	ShimDBufferNode* head;
+	ShimDBufferNode* tail;
+} ShimDBuffer;
+
+vHNDL vCreateDBuffer(vPCHAR name, vUI64 elementSize, vUI64 nodeSize,
+	vPTR initFunc, vPTR destroyFunc)
+{
+	ShimDBuffer* buffer = vAllocZeroed(sizeof(ShimDBuffer));
+	buffer->elementSize = elementSize;
+	buffer->nodeSize    = nodeSize;
+	buffer->initFunc    = (vPFDBUFFERINITIALIZER)initFunc;
+	buffer->destroyFunc = (vPFDBUFFERDESTRUCTOR)destroyFunc;
+	return buffer;
+}
+
+void vDestroyDBuffer(vHNDL hndl)
+{
+	ShimDBuffer* buffer = hndl;
+	ShimDBufferNode* node = buffer->head;
+	while (node != NULL)
+	{
+		ShimDBufferNode* next = node->next;
+		vFree(node->useMask);
+		vFree(node->elements);
+		vFree(node);
+		node = next;
+	}
+	vFree(buffer);
+}
+
+vPTR vDBufferAdd(vHNDL hndl, vPTR input)
+{
+	ShimDBuffer* buffer = hndl;
+
+	/* find node with space */
+	ShimDBufferNode* node = buffer->head;
+	while (node != NULL && node->used == buffer->nodeSize) node = node->next;
+
+	if (node == NULL)
+	{
+		node = vAllocZeroed(sizeof(ShimDBufferNode));
+		node->useMask  = vAllocZeroed(((buffer->nodeSize + 63) / 64) * 8);
+		node->elements = vAllocZeroed(buffer->elementSize * buffer->nodeSize);
+		if (buffer->tail == NULL) buffer->head = node;
+		else buffer->tail->next = node;
+		buffer->tail = node;
+	}
+
+	/* find free slot */
+	vUI64 slot = 0;
+	while (node->useMask[slot >> 6] & (1ull << (slot & 63))) slot++;
+	node->useMask[slot >> 6] |= (1ull << (slot & 63));
+	node->used++;
+	buffer->elementCount++;
+
+	vPTR element = node->elements + slot * buffer->elementSize;
+	vZeroMemory(element, buffer->elementSize);
+	if (buffer->initFunc != NULL) buffer->initFunc(hndl, element, input);
+	return element;
+}
+
+void vDBufferRemove(vHNDL hndl, vPTR element)
+{
+	ShimDBuffer* buffer = hndl;
+	for (ShimDBufferNode* node = buffer->head; node != NULL; node = node->next)
+	{
+		vUI8* e = element;
+		if (e < node->elements ||
+			e >= node->elements + buffer->elementSize * buffer->nodeSize) continue;
+
+		vUI64 slot = (vUI64)(e - node->elements) / buffer->elementSize;
+		if (buffer->destroyFunc != NULL) buffer->destroyFunc(hndl, element);
+		node->useMask[slot >> 6] &= ~(1ull << (slot & 63));
+		node->used--;
+		buffer->elementCount--;
+		return;
+	}
+}
+
+void vDBufferIterate(vHNDL hndl, vPTR iterateFunc, vPTR input)
+{
+	ShimDBuffer* buffer = hndl;
+	vPFDBUFFERITERATEFUNC func = (vPFDBUFFERITERATEFUNC)iterateFunc;
+	for (ShimDBufferNode* node = buffer->head; node != NULL; node = node->next)
+	{
+		if (node->used == 0) continue;
+		for (vUI64 slot = 0; slot < buffer->nodeSize; slot++)
+		{
+			if ((node->useMask[slot >> 6] & (1ull << (slot & 63))) == 0) continue;
+			func(hndl, node->elements + slot * buffer->elementSize, input);
+		}
+	}
+}
+
+vUI64 vDBufferGetElementCount(vHNDL hndl)
+{
+	return ((ShimDBuffer*)hndl)->elementCount;
+}
+
+
+/* ========== OBJECTS AND COMPONENTS			==========	*/
+#define SHIM_MAX_COMPONENT_TYPES	0x20
+
+typedef struct ShimComponentType
+{
+	vUI64 attributeSize;
+	vPFCOMPONENTINITIALIZE initFunc;
+	vPFCOMPONENTDESTROY    destroyFunc;
+} ShimComponentType;
+
+static ShimComponentType __shimComponents[SHIM_MAX_COMPONENT_TYPES];
+static vUI16 __shimComponentCount = 0;
+static vUI16 __shimRenderableHandle = 0xFFFF;
+
+vUI16 vCreateComponent(vPCHAR name, vPTR settings, vUI64 attributeSize,
+	vPTR globalInput, vPTR initFunc, vPTR destroyFunc, vPTR cycleFunc,
+	vPTR worker)
+{
+	ShimComponentType* type = __shimComponents + __shimComponentCount;
+	type->attributeSize = attributeSize;
+	type->initFunc      = (vPFCOMPONENTINITIALIZE)initFunc;
+	type->destroyFunc   = (vPFCOMPONENTDESTROY)destroyFunc;
+	return __shimComponentCount++;
+}
+
+vPObject vCreateObject(vPObject parent)
+{
+	return vAllocZeroed(sizeof(vObject));
+}
+
+void vDestroyObject(vPObject object)
+{
+	for (int i = 0; i < SHIM_OBJECT_COMPONENTS; i++)
+	{
+		if (object->components[i] == NULL) continue;
+		vObjectRemoveComponent(object, object->components[i]->componentHandle);
+	}
+	vFree(object);
+}
+
+vPComponent vObjectAddComponent(vPObject object, vUI16 component, vPTR input)
+{
+	ShimComponentType* type = __shimComponents + component;
+
+	for (int i = 0; i < SHIM_OBJECT_COMPONENTS; i++)
+	{
+		if (object->components[i] != NULL) continue;
+
+		vPComponent comp = vAllocZeroed(sizeof(vComponent));
+		comp->componentHandle = component;
+		comp->parent          = object;
+		comp->objectAttribute = vAllocZeroed(type->attributeSize);
+		object->components[i] = comp;
+
+		if (type->initFunc != NULL) type->initFunc(object, comp, input);
+		return comp;
+	}
+
+	vLogError(__func__, "Object component slots exhausted.");
+	return NULL;
+}
+
+vPComponent vObjectGetComponent(vPObject object, vUI16 component)
+{
+	for (int i = 0; i < SHIM_OBJECT_COMPONENTS; i++)
+	{
+		vPComponent comp = object->components[i];
+		if (comp != NULL && comp->componentHandle == component) return comp;
+	}
+	return NULL;
+}
+
+void vObjectRemoveComponent(vPObject object, vUI16 component)
+{
+	for (int i = 0; i < SHIM_OBJECT_COMPONENTS; i++)
+	{
+		vPComponent comp = object->components[i];
+		if (comp == NULL || comp->componentHandle != component) continue;
+
+		ShimComponentType* type = __shimComponents + component;
+		if (type->destroyFunc != NULL) type->destroyFunc(object, comp);
+		vFree(comp->objectAttribute);
+		vFree(comp);
+		object->components[i] = NULL;
+		return;
+	}
+}
+
+
+/* ========== WORKERS							==========	*/
+static void* ShimWorkerThread(void* input)
+{
+	vPWorker worker = input;
+	vPFWORKERINIT  initFunc  = (vPFWORKERINIT)worker->initFunc;
+	vPFWORKEREXIT  exitFunc  = (vPFWORKEREXIT)worker->exitFunc;
+	vPFWORKERCYCLE cycleFunc = (vPFWORKERCYCLE)worker->cycleFunc;
+
+	if (initFunc != NULL) initFunc(worker, worker->persistentData, worker->input);
+	while (worker->exitRequested == FALSE)
+	{
+		if (cycleFunc != NULL) cycleFunc(worker, worker->persistentData);
+		worker->cycleCount++;
+		if (worker->cycleInterval > 0) Sleep((DWORD)worker->cycleInterval);
+	}
+	if (exitFunc != NULL) exitFunc(worker, worker->persistentData);
+	return NULL;
+}
+
+vPWorker vCreateWorker(vPCHAR name, vTIME cycleInterval, vPTR initFunc,
+	vPTR exitFunc, vPTR cycleFunc, vPTR persistentData, vPTR input)
+{
+	vPWorker worker = vAllocZeroed(sizeof(vWorker));
+	worker->cycleInterval  = cycleInterval;
+	worker->initFunc       = initFunc;
+	worker->exitFunc       = exitFunc;
+	worker->cycleFunc      = cycleFunc;
+	worker->persistentData = persistentData;
+	worker->input          = input;
+	pthread_create(&worker->thread, NULL, ShimWorkerThread, worker);
+	return worker;
+}
+
+void vDestroyWorker(vPWorker worker)
+{
+	worker->exitRequested = TRUE;
+	pthread_join(worker->thread, NULL);
+	vFree(worker);
+}
+
+
+/* ========== GRAPHICS							==========	*/
+static vUI64 __shimDrawCalls = 0;
+
+vPosition vCreatePosition(float x, float y)
+{
+	vPosition p;
+	p.x = x;
+	p.y = y;
+	return p;
+}
+
+vGRect vGCreateRect(float left, float right, float bottom, float top)
+{
+	vGRect r;
+	r.left   = left;
+	r.right  = right;
+	r.bottom = bottom;
+	r.top    = top;
+	return r;
+}
+
+vGColor vGCreateColorB(vUI8 r, vUI8 g, vUI8 b, vUI8 a)
+{
+	vGColor c;
+	c.R = r / 255.0f;
+	c.G = g / 255.0f;
+	c.B = b / 255.0f;
+	c.A = a / 255.0f;
+	return c;
+}
+
+vUI16 vGGetComponentHandle(void)
+{
+	/* renderables are never attached in the bench */
+	if (__shimRenderableHandle == 0xFFFF)
+	{
+		__shimRenderableHandle = vCreateComponent("vGRenderable", NULL,
+			sizeof(vGRenderable), NULL, NULL, NULL, NULL, NULL);
+	}
+	return __shimRenderableHandle;
+}
+
+void vGLock(void)	{ }
+void vGUnlock(void)	{ }
+
+void vGDrawLineF(float x1, float y1, float x2, float y2, vGColor color,
+	float width)
+{
+	__shimDrawCalls++;
+}
+
+void vGDrawLineV(vPosition p1, vPosition p2, vGColor color, float width)
+{
+	__shimDrawCalls++;
+}
+
+void vGDrawLinesConnected(vPPosition positions, vUI16 count, vGColor color,
+	float width)
+{
+	__shimDrawCalls++;
+}
+
+void vGDrawCross(vPosition position, float size, vGColor color, float width)
+{
+	__shimDrawCalls++;
+}
+
+vUI64 vShimGetDrawCallCount(void)
+{
+	return __shimDrawCalls;
+}
@@ -0,0 +1,108 @@
+/* ========== <vtypes.h>						==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Minimal Linux stand-in for the vcore type definitions	*/
+/* used by the physics engine. Only built with the bench.	*/
+
+#ifndef _VSHIM_TYPES_INCLUDE_
+#define _VSHIM_TYPES_INCLUDE_
+
+/* ========== INCLUDES							==========	*/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <pthread.h>
+
+
+/* ========== WIN32 STAND-INS					==========	*/
+#define __declspec(x)
+#define __stdcall
+
+#ifndef TRUE
+#define TRUE	1
+#define FALSE	0
+#endif
+#define ZERO	0
+
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+typedef void*				HANDLE;
+typedef int					BOOL;
+typedef uint32_t			DWORD;
+typedef DWORD*				PDWORD;
+typedef int32_t				LONG;
+typedef int64_t				LONG64;
+typedef uint64_t			ULONGLONG;
+typedef size_t				SIZE_T;
+typedef union _LARGE_INTEGER
+{
+	int64_t QuadPart;
+} LARGE_INTEGER;
+
+typedef struct _CRITICAL_SECTION
+{
+	pthread_mutex_t mutex;
+} CRITICAL_SECTION, *PCRITICAL_SECTION;
+
+typedef struct _CONDITION_VARIABLE
+{
+	pthread_cond_t cond;
+} CONDITION_VARIABLE, *PCONDITION_VARIABLE;
+
+#define INVALID_HANDLE_VALUE		((HANDLE)(intptr_t)-1)
+#define INFINITE					0xFFFFFFFF
+#define GENERIC_READ				0x80000000
+#define FILE_SHARE_READ				0x00000001
+#define OPEN_EXISTING				3
+#define FILE_ATTRIBUTE_NORMAL		0x00000080
+#define FILE_FLAG_SEQUENTIAL_SCAN	0x08000000
+#define PAGE_READONLY				0x02
+#define FILE_MAP_READ				0x0004
+
+#define sprintf_s	snprintf
+#define vsprintf_s	vsnprintf
+#define _fseeki64	fseeko
+
+
+/* ========== VCORE TYPES						==========	*/
+#define BUFF_TINY		0x20
+#define BUFF_SMALL		0x40
+#define BUFF_MEDIUM		0x100
+#define BUFF_LARGE		0x400
+
+typedef uint8_t		vUI8;
+typedef uint16_t	vUI16;
+typedef uint32_t	vUI32;
+typedef uint64_t	vUI64;
+typedef int8_t		vI8;
+typedef int16_t		vI16;
+typedef int32_t		vI32;
+typedef int64_t		vI64;
+typedef vI32*		vPI32;
+typedef vUI32*		vPUI32;
+typedef vUI64*		vPUI64;
+typedef int			vBOOL;
+typedef void*		vPTR;
+typedef char		vCHAR;
+typedef char*		vPCHAR;
+typedef vPTR		vHNDL;
+typedef vUI64		vTIME;
+
+typedef struct vPosition
+{
+	float x;
+	float y;
+} vPosition, *vPPosition;
+
+typedef struct vTransform
+{
+	vPosition position;
+	float rotation;
+	float scale;
+} vTransform, *vPTransform;
+
+#endif
@@ -0,0 +1,584 @@
+/* ========== <vpxbench.c>						==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Headless scene benchmark. Steps the engine synchronously	*/
+/* through a set of canonical scenes at increasing body		*/
+/* counts and reports ticks/sec and per-phase timings as	*/
+/* JSON lines (stdout) and a readable table (stderr).		*/
+
+
+/* ========== INCLUDES							==========	*/
+#include "vphys.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+
+/* ========== DEFINITIONS						==========	*/
+#define BENCH_N_MIN_DEFAULT			1000
+#define BENCH_N_MAX_DEFAULT			1000000
+#define BENCH_N_FACTOR_DEFAULT		10
+#define BENCH_TICKS_MIN				3
+#define BENCH_TICKS_MAX				240
+#define BENCH_WARMUP_TICKS			2
+#define BENCH_RUN_BUDGET_DEFAULT	10.0
+#define BENCH_GRAVITY				-0.01f
+
+#define BENCH_SCENE_GAS				0
+#define BENCH_SCENE_STACKS			1
+#define BENCH_SCENE_PILE			2
+#define BENCH_SCENE_STATIC_LEVEL	3
+#define BENCH_SCENE_MIXED			4
+#define BENCH_SCENE_DEBRIS			5
+#define BENCH_SCENE_SHAPES			6
+#define BENCH_SCENE_TILE_LEVEL		7
+#define BENCH_SCENE_COUNT			8
+
+
+/* ========== STRUCTURES						==========	*/
+typedef struct BenchOptions
+{
+	vUI32  nMin;
+	vUI32  nMax;
+	vUI32  nFactor;
+	vUI32  ticks;		/* fixed tick count (0 = fit to budget)	*/
+	double runBudget;	/* seconds per (scene, N) run			*/
+	vBOOL  sceneEnabled[BENCH_SCENE_COUNT];
+	vUI32  seed;
+	vBOOL  debugDraw;	/* run with the debug overlay enabled	*/
+	vBOOL  spatialSort;	/* let the engine re-sort body storage	*/
+	vBOOL  deterministic;	/* step the world in deterministic mode	*/
+	vBOOL  fieldGravity;	/* world gravity instead of callbacks	*/
+} BenchOptions, *PBenchOptions;
+
+typedef struct BenchScene
+{
+	vPObject* objects;
+	vUI32 count;
+	vUI32 rngState;
+	vBOOL fieldGravity;
+} BenchScene, *PBenchScene;
+
+typedef struct BenchResult
+{
+	vUI32  ticks;
+	double seconds;
+	double phaseMs[PX_PHASE_COUNT];
+	double pairTests;
+	double pairHits;
+	double partitionsUsed;
+	double drawCalls;
+	double cacheMisses;	/* per tick, < 0 if counters unavailable	*/
+	double cacheRefs;
+	vUI32  bodySorts;
+	vUI64  stateHash;
+	vBOOL  overBudget;
+} BenchResult, *PBenchResult;
+
+static const char* __sceneNames[BENCH_SCENE_COUNT] =
+{
+	"gas", "stacks", "pile", "static_level", "mixed_sizes", "debris",
+	"shapes", "tile_level"
+};
+
+static const char* __phaseNames[PX_PHASE_COUNT] =
+{
+	"reset", "setup", "collision", "dynamics", "particles", "debugdraw"
+};
+
+
+/* ========== HELPERS							==========	*/
+static double BenchNow(void)
+{
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+static float BenchRandom(PBenchScene scene, float low, float high)
+{
+	/* xorshift32, so scenes are reproducible across runs */
+	vUI32 x = scene->rngState;
+	x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+	scene->rngState = x;
+	return low + (high - low) * ((x >> 8) * (1.0f / 16777216.0f));
+}
+
+static int BenchPerfOpen(vUI64 config, int group)
+{
+	/* hardware cache counters for this thread, may be unavailable */
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.type           = PERF_TYPE_HARDWARE;
+	attr.size           = sizeof(attr);
+	attr.config         = config;
+	attr.disabled       = (group < 0);
+	attr.exclude_kernel = 1;
+	attr.exclude_hv     = 1;
+	return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+static vUI64 BenchPerfRead(int fd)
+{
+	vUI64 value = 0;
+	if (read(fd, &value, sizeof(value)) != sizeof(value)) return 0;
+	return value;
+}
+
+static void BenchGravityUpdate(vPPhysical phys)
+{
+	phys->acceleration.y += BENCH_GRAVITY;
+}
+
+static void BenchMakeFalling(PBenchScene scene, vPPhysical phys)
+{
+	/* only falling bodies are reached by world gravity */
+	if (scene->fieldGravity)
+		vPXSetPhysicsObjectFieldLayer(phys, PX_LAYER_1);
+	else
+		vPXSetPhysicsObjectCallbacks(phys, BenchGravityUpdate, NULL);
+}
+
+static vPPhysical BenchAddBox(PBenchScene scene, float x, float y, float w,
+	float h, float mass, vBOOL isStatic)
+{
+	vPObject object = vCreateObject(NULL);
+	scene->objects[scene->count++] = object;
+
+	vTransform transform;
+	transform.position = vCreatePosition(x, y);
+	transform.rotation = 0.0f;
+	transform.scale    = 1.0f;
+
+	vGRect bound = vGCreateRect(-w * 0.5f, w * 0.5f, -h * 0.5f, h * 0.5f);
+	vPPhysical phys = vPXCreatePhysicsObject(object, transform, bound,
+		0.01f, 0.1f, isStatic ? 100000.0f : mass, PX_LAYER_0);
+	phys->properties.staticPosition = isStatic;
+	phys->properties.staticRotation = isStatic;
+	return phys;
+}
+
+
+/* ========== SCENES							==========	*/
+static void BenchBuildGas(PBenchScene scene, vUI32 n)
+{
+	/* uniform density of unit boxes, random velocities */
+	float side = sqrtf((float)n) * 2.5f;
+	for (vUI32 i = 0; i < n; i++)
+	{
+		vPPhysical p = BenchAddBox(scene, BenchRandom(scene, 0, side),
+			BenchRandom(scene, 0, side), 1.0f, 1.0f, 1.0f, FALSE);
+		p->velocity = vCreatePosition(BenchRandom(scene, -0.1f, 0.1f),
+			BenchRandom(scene, -0.1f, 0.1f));
+	}
+}
+
+static void BenchBuildStacks(PBenchScene scene, vUI32 n)
+{
+	/* columns of 32 boxes resting on a static floor */
+	const vUI32 height = 32;
+	vUI32 columns = max(1, (n - 1) / height);
+	float width = columns * 2.0f;
+
+	BenchAddBox(scene, width * 0.5f, -1.0f, width + 2.0f, 1.0f, 1.0f, TRUE);
+	for (vUI32 i = 1; i < n; i++)
+	{
+		vUI32 col = (i - 1) % columns;
+		vUI32 row = (i - 1) / columns;
+		vPPhysical p = BenchAddBox(scene, col * 2.0f + 0.5f, row * 1.0f,
+			1.0f, 1.0f, 1.0f, FALSE);
+		BenchMakeFalling(scene, p);
+	}
+}
+
+static void BenchBuildPile(PBenchScene scene, vUI32 n)
+{
+	/* every box starts overlapping inside one small area */
+	float side = sqrtf((float)n) * 0.5f;
+	for (vUI32 i = 0; i < n; i++)
+	{
+		vPPhysical p = BenchAddBox(scene, BenchRandom(scene, 0, side),
+			BenchRandom(scene, 0, side), 1.0f, 1.0f, 1.0f, FALSE);
+		BenchMakeFalling(scene, p);
+	}
+}
+
+static void BenchBuildStaticLevel(PBenchScene scene, vUI32 n)
+{
+	/* 90% static tiles on a grid, 10% movers above them */
+	vUI32 statics = n - n / 10;
+	vUI32 columns = (vUI32)sqrtf((float)statics) + 1;
+	for (vUI32 i = 0; i < statics; i++)
+	{
+		BenchAddBox(scene, (i % columns) * 1.0f, (i / columns) * 4.0f,
+			1.0f, 1.0f, 1.0f, TRUE);
+	}
+
+	float side = columns * 1.0f;
+	for (vUI32 i = statics; i < n; i++)
+	{
+		vPPhysical p = BenchAddBox(scene, BenchRandom(scene, 0, side),
+			BenchRandom(scene, 0, side * 4.0f), 0.5f, 0.5f, 1.0f, FALSE);
+		p->velocity = vCreatePosition(BenchRandom(scene, -0.1f, 0.1f), 0.0f);
+		BenchMakeFalling(scene, p);
+	}
+}
+
+static void BenchBuildTileLevel(PBenchScene scene, vUI32 n)
+{
+	/* static_level with its tiles in a tilemap instead */
+	vUI32 statics = n - n / 10;
+	vUI32 columns = (vUI32)sqrtf((float)statics) + 1;
+	vUI32 rows    = (statics + columns - 1) / columns * 4;
+	vUI8* tiles   = vAllocZeroed(columns * rows);
+	for (vUI32 i = 0; i < statics; i++)
+		tiles[(i / columns) * 4 * columns + (i % columns)] = 1;
+
+	/* tile centers line up with the static boxes */
+	vPXSetTilemap(vCreatePosition(-0.5f, -0.5f), 1.0f, columns, rows, tiles,
+		PX_LAYER_0);
+	vFree(tiles);
+
+	float side = columns * 1.0f;
+	for (vUI32 i = statics; i < n; i++)
+	{
+		vPPhysical p = BenchAddBox(scene, BenchRandom(scene, 0, side),
+			BenchRandom(scene, 0, side * 4.0f), 0.5f, 0.5f, 1.0f, FALSE);
+		p->velocity = vCreatePosition(BenchRandom(scene, -0.1f, 0.1f), 0.0f);
+		BenchMakeFalling(scene, p);
+	}
+}
+
+static void BenchBuildMixed(PBenchScene scene, vUI32 n)
+{
+	/* log-uniform sizes from 0.25 to 8 at gas density */
+	float side = sqrtf((float)n) * 3.0f;
+	for (vUI32 i = 0; i < n; i++)
+	{
+		float size = powf(2.0f, BenchRandom(scene, -2.0f, 3.0f));
+		vPPhysical p = BenchAddBox(scene, BenchRandom(scene, 0, side),
+			BenchRandom(scene, 0, side), size,
+			size * BenchRandom(scene, 0.5f, 1.5f), size * size, FALSE);
+		p->velocity = vCreatePosition(BenchRandom(scene, -0.1f, 0.1f),
+			BenchRandom(scene, -0.1f, 0.1f));
+	}
+}
+
+static void BenchBuildDebris(PBenchScene scene, vUI32 n)
+{
+	/* n particles raining through one static ledge per 1000 */
+	float side = sqrtf((float)n);
+	vUI32 ledges = max(8, n / 1000);
+	for (vUI32 i = 0; i < ledges; i++)
+	{
+		BenchAddBox(scene, BenchRandom(scene, 0, side),
+			BenchRandom(scene, 0, side), 4.0f, 0.5f, 1.0f, TRUE);
+	}
+
+	vPXParticleEmitter emitter;
+	vZeroMemory(&emitter, sizeof(emitter));
+	emitter.position       = vCreatePosition(side * 0.5f, side * 0.5f);
+	emitter.positionSpread = vCreatePosition(side * 0.5f, side * 0.5f);
+	emitter.velocitySpread = vCreatePosition(0.05f, 0.05f);
+	emitter.radius         = 0.1f;
+	emitter.life           = PX_PARTICLE_LIFE_FOREVER;
+	emitter.collideLayer   = PX_LAYER_0;
+	vPXSetParticleMotion(vCreatePosition(0.0f, BENCH_GRAVITY), 0.01f);
+	vPXEmitParticles(&emitter, n);
+}
+
+static void BenchBuildShapes(PBenchScene scene, vUI32 n)
+{
+	/* gas of circles, capsules and hexagons */
+	vVect hexagon[6];
+	for (int i = 0; i < 6; i++)
+	{
+		hexagon[i] = vCreatePosition(0.5f * cosf(i * VPHYS_PI / 3.0f),
+			0.5f * sinf(i * VPHYS_PI / 3.0f));
+	}
+	vPXShapeID shapes[3] =
+	{
+		vPXCreateCircleShape(0.5f),
+		vPXCreateCapsuleShape(0.25f, 0.25f),
+		vPXCreatePolygonShape(hexagon, 6)
+	};
+
+	float side = sqrtf((float)n) * 2.5f;
+	for (vUI32 i = 0; i < n; i++)
+	{
+		vPPhysical p = BenchAddBox(scene, BenchRandom(scene, 0, side),
+			BenchRandom(scene, 0, side), 1.0f, 1.0f, 1.0f, FALSE);
+		p->transform.rotation = BenchRandom(scene, 0.0f, 360.0f);
+		p->velocity = vCreatePosition(BenchRandom(scene, -0.1f, 0.1f),
+			BenchRandom(scene, -0.1f, 0.1f));
+		vPXSetPhysicsObjectShape(p, shapes[i % 3]);
+	}
+}
+
+static void BenchBuildScene(PBenchScene scene, vUI32 sceneID, vUI32 n,
+	vUI32 seed)
+{
+	scene->objects  = vAlloc(sizeof(vPObject) * n);
+	scene->count    = 0;
+	scene->rngState = seed ^ (sceneID * 0x9E3779B9u) ^ n;
+	if (scene->rngState == 0) scene->rngState = 1;
+
+	switch (sceneID)
+	{
+	case BENCH_SCENE_GAS:			BenchBuildGas(scene, n);			break;
+	case BENCH_SCENE_STACKS:		BenchBuildStacks(scene, n);			break;
+	case BENCH_SCENE_PILE:			BenchBuildPile(scene, n);			break;
+	case BENCH_SCENE_STATIC_LEVEL:	BenchBuildStaticLevel(scene, n);	break;
+	case BENCH_SCENE_MIXED:			BenchBuildMixed(scene, n);			break;
+	case BENCH_SCENE_DEBRIS:		BenchBuildDebris(scene, n);			break;
+	case BENCH_SCENE_SHAPES:		BenchBuildShapes(scene, n);			break;
+	case BENCH_SCENE_TILE_LEVEL:	BenchBuildTileLevel(scene, n);		break;
+	}
+}
+
+static void BenchDestroyScene(PBenchScene scene)
+{
+	for (vUI32 i = 0; i < scene->count; i++)
+	{
+		vPXDestroyPhysicsObject(scene->objects[i]);
+		vDestroyObject(scene->objects[i]);
+	}
+	vFree(scene->objects);
+	vPXClearParticles();
+	vPXClearTilemap();
+}
+
+
+/* ========== RUNNING							==========	*/
+static void BenchAccumulate(PBenchResult result)
+{
+	vPXStats stats;
+	vPXGetStats(&stats);
+	for (int i = 0; i < PX_PHASE_COUNT; i++)
+		result->phaseMs[i] += stats.phaseTimeNs[i] / 1000000.0;
+	result->pairTests      += stats.pairTests;
+	result->pairHits       += stats.pairHits;
+	result->partitionsUsed += stats.partitionsUsed;
+}
+
+static BenchResult BenchRun(PBenchOptions options)
+{
+	BenchResult result;
+	vZeroMemory(&result, sizeof(result));
+
+	/* warmup, also used to size the measured run */
+	double warmStart = BenchNow();
+	for (int i = 0; i < BENCH_WARMUP_TICKS; i++) vPXStep();
+	double tickEstimate = (BenchNow() - warmStart) / BENCH_WARMUP_TICKS;
+
+	vUI32 ticks = options->ticks;
+	if (ticks == 0)
+	{
+		ticks = (vUI32)(options->runBudget / max(tickEstimate, 1e-6));
+		ticks = max(BENCH_TICKS_MIN, min(BENCH_TICKS_MAX, ticks));
+	}
+	result.overBudget = tickEstimate * BENCH_TICKS_MIN > options->runBudget;
+
+	int missFD = BenchPerfOpen(PERF_COUNT_HW_CACHE_MISSES, -1);
+	int refFD  = (missFD < 0) ? -1 :
+		BenchPerfOpen(PERF_COUNT_HW_CACHE_REFERENCES, missFD);
+	if (missFD >= 0)
+	{
+		ioctl(missFD, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(missFD, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	}
+
+	vPXStats statsStart;
+	vPXGetStats(&statsStart);
+	vUI64 drawCallsStart = vShimGetDrawCallCount();
+	double start = BenchNow();
+	for (vUI32 i = 0; i < ticks; i++)
+	{
+		vPXStep();
+		BenchAccumulate(&result);
+	}
+	result.seconds   = BenchNow() - start;
+	result.drawCalls = (double)(vShimGetDrawCallCount() - drawCallsStart);
+	result.ticks   = ticks;
+
+	vPXStats statsEnd;
+	vPXGetStats(&statsEnd);
+	result.bodySorts = statsEnd.bodySorts - statsStart.bodySorts;
+	result.stateHash = statsEnd.stateHash;
+
+	result.cacheMisses = -1.0;
+	result.cacheRefs   = -1.0;
+	if (missFD >= 0)
+	{
+		ioctl(missFD, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+		result.cacheMisses = (double)BenchPerfRead(missFD) / ticks;
+		if (refFD >= 0) result.cacheRefs = (double)BenchPerfRead(refFD) / ticks;
+		close(missFD);
+		if (refFD >= 0) close(refFD);
+	}
+
+	for (int i = 0; i < PX_PHASE_COUNT; i++) result.phaseMs[i] /= ticks;
+	result.pairTests      /= ticks;
+	result.pairHits       /= ticks;
+	result.partitionsUsed /= ticks;
+	result.drawCalls      /= ticks;
+	return result;
+}
+
+static void BenchReport(vUI32 sceneID, vUI32 n, PBenchResult result)
+{
+	double tps = result->ticks / result->seconds;
+
+	printf("{\"scene\":\"%s\",\"n\":%u,\"ticks\":%u,\"seconds\":%.6f,"
+		"\"ticks_per_sec\":%.3f,\"ms_per_tick\":%.4f",
+		__sceneNames[sceneID], n, result->ticks, result->seconds, tps,
+		1000.0 / tps);
+	for (int i = 0; i < PX_PHASE_COUNT; i++)
+		printf(",\"%s_ms\":%.4f", __phaseNames[i], result->phaseMs[i]);
+	printf(",\"pair_tests\":%.1f,\"pair_hits\":%.1f,\"partitions\":%.1f,"
+		"\"draw_calls\":%.1f,\"cache_misses\":%.0f,\"cache_refs\":%.0f,"
+		"\"body_sorts\":%u,\"state_hash\":\"%016llx\",\"over_budget\":%s}\n",
+		result->pairTests, result->pairHits, result->partitionsUsed,
+		result->drawCalls, result->cacheMisses, result->cacheRefs,
+		result->bodySorts, (unsigned long long)result->stateHash,
+		result->overBudget ? "true" : "false");
+	fflush(stdout);
+
+	fprintf(stderr, "%-12s %8u %9.2f t/s %9.3f ms | setup %8.3f coll %8.3f "
+		"dyn %8.3f part %8.3f | pairs %10.0f | misses %10.0f%s\n", __sceneNames[sceneID],
+		n, tps, 1000.0 / tps, result->phaseMs[PX_PHASE_SETUP],
+		result->phaseMs[PX_PHASE_COLLISION], result->phaseMs[PX_PHASE_DYNAMICS],
+		result->phaseMs[PX_PHASE_PARTICLES], result->pairTests, result->cacheMisses,
+		result->overBudget ? " (over budget)" : "");
+}
+
+
+/* ========== ENTRY								==========	*/
+static void BenchUsage(void)
+{
+	fprintf(stderr,
+		"usage: vpxbench [options]\n"
+		"  --scene NAME     run only NAME (repeatable): gas stacks pile\n"
+		"                   static_level mixed_sizes debris shapes tile_level\n"
+		"  --min N          smallest body count (default %d)\n"
+		"  --max N          largest body count (default %d)\n"
+		"  --factor F       body count multiplier per step (default %d)\n"
+		"  --ticks T        measured ticks per run (default: fit budget)\n"
+		"  --budget S       seconds per run; larger N are skipped once a\n"
+		"                   run cannot fit (default %.0f)\n"
+		"  --seed S         scene generation seed\n"
+		"  --debugdraw 0|1  enable the debug overlay while measuring\n"
+		"  --sort 0|1       spatial re-sorting of body storage (default 1)\n"
+		"  --deterministic 0|1\n"
+		"                   deterministic stepping, reports a state hash\n"
+		"  --gravity callback|field\n"
+		"                   how falling bodies get gravity (default callback)\n",
+		BENCH_N_MIN_DEFAULT, BENCH_N_MAX_DEFAULT, BENCH_N_FACTOR_DEFAULT,
+		BENCH_RUN_BUDGET_DEFAULT);
+}
+
+static vBOOL BenchParseArgs(int argc, char** argv, PBenchOptions options)
+{
+	vBOOL sceneFilter = FALSE;
+
+	options->nMin      = BENCH_N_MIN_DEFAULT;
+	options->nMax      = BENCH_N_MAX_DEFAULT;
+	options->nFactor   = BENCH_N_FACTOR_DEFAULT;
+	options->ticks     = 0;
+	options->runBudget = BENCH_RUN_BUDGET_DEFAULT;
+	options->seed      = 0x2022;
+	options->debugDraw = FALSE;
+	options->spatialSort = TRUE;
+	options->deterministic = FALSE;
+	options->fieldGravity  = FALSE;
+	for (int i = 0; i < BENCH_SCENE_COUNT; i++) options->sceneEnabled[i] = TRUE;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		const char* val = (i + 1 < argc) ? argv[i + 1] : NULL;
+		if (val == NULL) return FALSE;
+		i++;
+
+		if (strcmp(arg, "--scene") == 0)
+		{
+			if (sceneFilter == FALSE)
+			{
+				for (int s = 0; s < BENCH_SCENE_COUNT; s++)
+					options->sceneEnabled[s] = FALSE;
+				sceneFilter = TRUE;
+			}
+
+			vBOOL found = FALSE;
+			for (int s = 0; s < BENCH_SCENE_COUNT; s++)
+			{
+				if (strcmp(val, __sceneNames[s]) != 0) continue;
+				options->sceneEnabled[s] = TRUE;
+				found = TRUE;
+			}
+			if (found == FALSE) return FALSE;
+		}
+		else if (strcmp(arg, "--min") == 0)    options->nMin = atoi(val);
+		else if (strcmp(arg, "--max") == 0)    options->nMax = atoi(val);
+		else if (strcmp(arg, "--factor") == 0) options->nFactor = atoi(val);
+		else if (strcmp(arg, "--ticks") == 0)  options->ticks = atoi(val);
+		else if (strcmp(arg, "--budget") == 0) options->runBudget = atof(val);
+		else if (strcmp(arg, "--seed") == 0)   options->seed = atoi(val);
+		else if (strcmp(arg, "--debugdraw") == 0) options->debugDraw = atoi(val);
+		else if (strcmp(arg, "--sort") == 0) options->spatialSort = atoi(val);
+		else if (strcmp(arg, "--deterministic") == 0)
+			options->deterministic = atoi(val);
+		else if (strcmp(arg, "--gravity") == 0)
+		{
+			if (strcmp(val, "field") == 0)         options->fieldGravity = TRUE;
+			else if (strcmp(val, "callback") == 0) options->fieldGravity = FALSE;
+			else return FALSE;
+		}
+		else return FALSE;
+	}
+
+	return options->nMin > 0 && options->nFactor > 1;
+}
+
+int main(int argc, char** argv)
+{
+	BenchOptions options;
+	if (BenchParseArgs(argc, argv, &options) == FALSE)
+	{
+		BenchUsage();
+		return 1;
+	}
+
+	vPXInitializeHeadless(NULL, 1);
+	vPXDebugMode(options.debugDraw);
+	vPXSpatialSortEnable(options.spatialSort);
+	vPXWorldSetDeterministic(vPXGetDefaultWorld(), options.deterministic);
+	if (options.fieldGravity)
+		vPXSetGravity(vCreatePosition(0.0f, BENCH_GRAVITY), PX_LAYER_1);
+
+	for (vUI32 sceneID = 0; sceneID < BENCH_SCENE_COUNT; sceneID++)
+	{
+		if (options.sceneEnabled[sceneID] == FALSE) continue;
+
+		for (vUI64 n = options.nMin; n <= options.nMax; n *= options.nFactor)
+		{
+			BenchScene scene;
+			scene.fieldGravity = options.fieldGravity;
+			BenchBuildScene(&scene, sceneID, (vUI32)n, options.seed);
+
+			BenchResult result = BenchRun(&options);
+			BenchReport(sceneID, (vUI32)n, &result);
+
+			BenchDestroyScene(&scene);
+
+			/* larger counts will not fit either */
+			if (result.overBudget) break;
+		}
+	}
+
+	return 0;
+}
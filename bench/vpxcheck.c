@@ -0,0 +1,1325 @@
+/* ========== <vpxcheck.c>						==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Regression checks for the headless build.				*/
+/* Each check builds a small world, drives it through the	*/
+/* case it covers and reports what it expected against		*/
+/* what it got. The exit code is the number of failures.	*/
+
+
+/* ========== INCLUDES							==========	*/
+#include "vphys.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+/* ========== DEFINITIONS						==========	*/
+#define CHECK_FIELD_BODIES		3000
+#define CHECK_FIELD_SPACING		1.5f
+#define CHECK_LOD_TICKS			64
+#define CHECK_LOD_SPEED			0.5f
+#define CHECK_STREAM_BODIES		64
+#define CHECK_STREAM_FAR		1000.0f
+#define CHECK_PAGE_FILE			"vpxcheck.page"
+#define CHECK_SNAPSHOT_FILE		"vpxcheck.snap"
+#define CHECK_STREAM_CROWD		255
+#define CHECK_QUERY_SIDE		24
+#define CHECK_QUERY_COUNT		64
+#define CHECK_QUERY_RESULTS		64
+#define CHECK_QUERY_K			5
+#define CHECK_HANDLE_REUSES		1100
+#define CHECK_TRACE_FILE		"vpxcheck.trace"
+#define CHECK_TRACE_CAPACITY	5
+#define CHECK_TRACE_KEPT		8		/* capacity, rounded up	*/
+#define CHECK_PRIMITIVE_SAMPLES	256
+#define CHECK_PRECISE_ERROR		1e-5	/* relative				*/
+#define CHECK_FAST_ERROR		0.05	/* relative, see vpxmicro	*/
+#define CHECK_DRAW_BODIES		512
+#define CHECK_RAY_ERROR			1e-3f
+#define CHECK_SORT_SIDE			32
+#define CHECK_SORT_TICKS		0x21	/* two disorder checks	*/
+#define CHECK_LOCKSTEP_BODIES	200
+#define CHECK_LOCKSTEP_TICKS	30
+#define CHECK_RECORD_FILE		"vpxcheck.rec"
+#define CHECK_RECORD_KEYFRAME	8
+#define CHECK_RECORD_RING		64		/* every tick, no drops	*/
+#define CHECK_RECORD_SEEK		19		/* between keyframes	*/
+#define CHECK_RECORD_ERROR		(1.0f / 2048.0f)	/* a quantum	*/
+#define CHECK_PARTICLE_TICKS	40
+#define CHECK_PARTICLE_RADIUS	0.1f
+#define CHECK_TILE_WIDTH		16
+#define CHECK_TILE_HEIGHT		4
+#define CHECK_TILE_TICKS		60
+#define CHECK_POOL_BODIES		256
+#define CHECK_POOL_THREADS		3
+#define CHECK_POOL_TICKS		8
+#define CHECK_BOUND_STILL		10
+#define CHECK_BUDGET_US			1		/* always over budget	*/
+#define CHECK_BUDGET_SPARSE		200
+#define CHECK_BUDGET_CROWD		48		/* one cell, overlapping	*/
+#define CHECK_BUDGET_TICKS		40
+
+static vUI32 __checkFailures = 0;
+static vUI32 __checkSeed = 12345;
+static vPXHandle __checkVictim = PX_HANDLE_NULL;
+static volatile LONG __checkUpdates[CHECK_POOL_BODIES + 1];
+
+#define CHECK(cond, ...)									\
+	do {													\
+		if (!(cond)) {										\
+			fprintf(stderr, "FAIL %s: ", __func__);			\
+			fprintf(stderr, __VA_ARGS__);					\
+			fputc('\n', stderr);							\
+			__checkFailures++;								\
+		}													\
+	} while (0)
+
+
+/* ========== HELPERS							==========	*/
+static vTransform CheckTransform(vFloat x, vFloat y)
+{
+	vTransform transform;
+	transform.position = vCreatePosition(x, y);
+	transform.rotation = 0.0f;
+	transform.scale    = 1.0f;
+	return transform;
+}
+
+static vGRect CheckUnitBox(void)
+{
+	return vGCreateRect(-0.5f, 0.5f, -0.5f, 0.5f);
+}
+
+static vFloat CheckRandom(vFloat low, vFloat high)
+{
+	/* fixed sequence, so a failure repeats */
+	__checkSeed = __checkSeed * 1664525 + 1013904223;
+	return low + (high - low) * ((__checkSeed >> 8) / (vFloat)(1 << 24));
+}
+
+static int CheckHandleCompare(const void* h1, const void* h2)
+{
+	vPXHandle a = *(const vPXHandle*)h1;
+	vPXHandle b = *(const vPXHandle*)h2;
+	return (a > b) - (a < b);
+}
+
+static void CheckDestroyVictim(vPPhysical phys)
+{
+	vPXWorldDestroyBody(phys->world, __checkVictim);
+}
+
+static void CheckCountUpdate(vPPhysical phys)
+{
+	/* each body only writes its own counter */
+	__checkUpdates[vPXGetPhysicsObjectHandle(phys) & PX_HANDLE_INDEX_MASK]++;
+}
+
+static vPPXWorld CheckWorld(void)
+{
+	vPPXWorld world = vPXWorldCreate(NULL, 1, FALSE);
+	vPXWorldSetGravity(world, vCreatePosition(0.0f, 0.0f), 0xFF);
+	return world;
+}
+
+
+/* ========== CHECKS							==========	*/
+static void CheckFieldGatherGrowth(void)
+{
+	/* more bodies than the scratch starts with, all inside one	*/
+	/* bounded field, so the gather must grow past its minimum	*/
+	vPPXWorld world = CheckWorld();
+	vUI32 side = (vUI32)ceilf(sqrtf((vFloat)CHECK_FIELD_BODIES));
+	vFloat half = side * CHECK_FIELD_SPACING * 0.5f;
+
+	vPXHandle handles[CHECK_FIELD_BODIES];
+	for (vUI32 i = 0; i < CHECK_FIELD_BODIES; i++)
+	{
+		vFloat x = (i % side) * CHECK_FIELD_SPACING - half;
+		vFloat y = (i / side) * CHECK_FIELD_SPACING - half;
+		handles[i] = vPXWorldCreateBody(world, CheckTransform(x, y),
+			CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	}
+
+	vPXForceField field;
+	vZeroMemory(&field, sizeof(field));
+	field.type      = PX_FIELD_RADIAL;
+	field.falloff   = PX_FIELD_FALLOFF_NONE;
+	field.layerMask = PX_LAYER_0;
+	field.center    = vCreatePosition(0.0f, 0.0f);
+	field.radius    = half * 2.0f;
+	field.strength  = 1.0f;
+	field.life      = PX_FIELD_LIFE_FOREVER;
+	vPXWorldAddForceField(world, &field);
+
+	vPXWorldStep(world);
+
+	vPXStats stats;
+	vPXWorldGetStats(world, &stats);
+	CHECK(stats.fieldBodies == CHECK_FIELD_BODIES,
+		"field pushed %u bodies, expected %u",
+		stats.fieldBodies, CHECK_FIELD_BODIES);
+
+	vUI32 still = 0;
+	for (vUI32 i = 0; i < CHECK_FIELD_BODIES; i++)
+	{
+		vPPhysical body = vPXWorldResolveHandle(world, handles[i]);
+		if (body->velocity.x == 0.0f && body->velocity.y == 0.0f) still++;
+	}
+	CHECK(still == 0, "%u bodies inside the field were not pushed", still);
+
+	vPXWorldDestroy(world);
+}
+
+static void CheckLODConservesTime(void)
+{
+	/* a free body whose tier changes every few ticks must end	*/
+	/* up where it would have at full rate						*/
+	vPPXWorld world = CheckWorld();
+	vPXHandle handle = vPXWorldCreateBody(world, CheckTransform(0.0f, 0.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	vPXWorldResolveHandle(world, handle)->velocity =
+		vCreatePosition(CHECK_LOD_SPEED, 0.0f);
+
+	vPXWorldEnableLOD(world, 16.0f, 1000.0f);
+	vPXInterestID interest = vPXWorldAddInterest(world,
+		vCreatePosition(0.0f, 0.0f), 1.0f);
+
+	/* near, a partition or two off, then well out, in turn */
+	static const vFloat offsets[] = { 0.0f, 40.0f, 200.0f, 40.0f, 200.0f };
+	for (vUI32 tick = 0; tick < CHECK_LOD_TICKS; tick++)
+	{
+		vPPhysical body = vPXWorldResolveHandle(world, handle);
+		vVect at = body->transform.position;
+		at.y += offsets[(tick / 3) % (sizeof(offsets) / sizeof(vFloat))];
+		vPXWorldMoveInterest(world, interest, at, 1.0f);
+		vPXWorldStep(world);
+	}
+
+	/* back to full rate, anything owed is paid on this tick */
+	vPXWorldDisableLOD(world);
+	vPXWorldStep(world);
+
+	vFloat expected = CHECK_LOD_SPEED * (CHECK_LOD_TICKS + 1);
+	vFloat got = vPXWorldResolveHandle(world, handle)->transform.position.x;
+	CHECK(fabsf(got - expected) < 1e-3f,
+		"body reached x = %f, expected %f", got, expected);
+
+	vPXWorldDestroy(world);
+}
+
+static void CheckSnapshotWhilePaged(void)
+{
+	/* half the bodies sit far from the only interest, so they	*/
+	/* are paged out when the snapshot is saved					*/
+	vPPXWorld world = CheckWorld();
+	vPXHandle handles[CHECK_STREAM_BODIES];
+	for (vUI32 i = 0; i < CHECK_STREAM_BODIES; i++)
+	{
+		vFloat x = (i & 1) ? CHECK_STREAM_FAR : 0.0f;
+		handles[i] = vPXWorldCreateBody(world,
+			CheckTransform(x + (i >> 1) * 2.0f, 0.0f), CheckUnitBox(),
+			0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	}
+
+	CHECK(vPXWorldEnableStreaming(world, CHECK_PAGE_FILE, 0.0f) == TRUE,
+		"could not enable streaming");
+	vPXWorldAddInterest(world, vCreatePosition(0.0f, 0.0f), 1.0f);
+	vPXWorldStreamFlush(world);
+
+	vPXStats stats;
+	vPXWorldStep(world);
+	vPXWorldGetStats(world, &stats);
+	CHECK(stats.bodiesPaged == CHECK_STREAM_BODIES / 2,
+		"%u bodies paged before saving, expected %u",
+		stats.bodiesPaged, CHECK_STREAM_BODIES / 2);
+
+	CHECK(vPXWorldSaveSnapshot(world, CHECK_SNAPSHOT_FILE) == TRUE,
+		"could not save with bodies paged out");
+
+	/* every body, paged or not, must come back in the copy */
+	vPPXWorld copy = vPXWorldCreate(NULL, 1, FALSE);
+	CHECK(vPXWorldLoadSnapshot(copy, CHECK_SNAPSHOT_FILE) == TRUE,
+		"could not load a snapshot saved with bodies paged out");
+
+	vUI32 missing = 0;
+	for (vUI32 i = 0; i < CHECK_STREAM_BODIES; i++)
+		if (vPXWorldResolveHandle(copy, handles[i]) == NULL) missing++;
+	CHECK(missing == 0, "%u bodies did not survive the snapshot", missing);
+
+	/* a world still holding paged bodies is not empty */
+	vPXWorldStep(world);
+	vPXWorldGetStats(world, &stats);
+	CHECK(stats.bodiesPaged == CHECK_STREAM_BODIES / 2,
+		"%u bodies paged after saving, expected %u",
+		stats.bodiesPaged, CHECK_STREAM_BODIES / 2);
+	vPXWorldStreamFlush(world);
+	vUI32 resident = 0;
+	for (vUI32 i = 0; i < CHECK_STREAM_BODIES; i++)
+	{
+		vPXHandle handle = handles[i];
+		if (vPXWorldResolveHandle(world, handle) == NULL) continue;
+		vPXWorldDestroyBody(world, handle);
+		resident++;
+	}
+	CHECK(resident == CHECK_STREAM_BODIES / 2,
+		"%u bodies resident after saving, expected %u",
+		resident, CHECK_STREAM_BODIES / 2);
+	CHECK(vPXWorldLoadSnapshot(world, CHECK_SNAPSHOT_FILE) == FALSE,
+		"loaded a snapshot over paged bodies");
+
+	vPXWorldDestroy(copy);
+	vPXWorldDestroy(world);
+	remove(CHECK_SNAPSHOT_FILE);
+	remove(CHECK_PAGE_FILE);
+}
+
+static void CheckStreamLoadDuringCheck(void)
+{
+	/* a region paged out empty gets a body handed to it, then	*/
+	/* comes back in the same check that sees one more body		*/
+	/* than the scratch was sized for							*/
+	vPPXWorld world = CheckWorld();
+	for (vUI32 i = 0; i < CHECK_STREAM_CROWD; i++)
+	{
+		vPXWorldCreateBody(world, CheckTransform(0.0f, 0.0f),
+			CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	}
+	vPXHandle far = vPXWorldCreateBody(world,
+		CheckTransform(CHECK_STREAM_FAR, 0.0f), CheckUnitBox(),
+		0.0f, 0.0f, 1.0f, PX_LAYER_0);
+
+	CHECK(vPXWorldEnableStreaming(world, CHECK_PAGE_FILE, 0.0f) == TRUE,
+		"could not enable streaming");
+	vPXWorldAddInterest(world, vCreatePosition(0.0f, 0.0f), 1.0f);
+	vPXInterestID farInterest = vPXWorldAddInterest(world,
+		vCreatePosition(CHECK_STREAM_FAR, 0.0f), 1.0f);
+	vPXWorldStreamFlush(world);
+
+	/* bring the far body home, then page its region out empty */
+	vPXSetPhysicsObjectTransform(vPXWorldResolveHandle(world, far),
+		CheckTransform(0.0f, 0.0f));
+	vPXWorldStreamFlush(world);
+	vPXWorldRemoveInterest(world, farInterest);
+	vPXWorldStreamFlush(world);
+
+	/* send it back out, it is handed to the paged region */
+	vPXSetPhysicsObjectTransform(vPXWorldResolveHandle(world, far),
+		CheckTransform(CHECK_STREAM_FAR, 0.0f));
+	vPXWorldStreamFlush(world);
+	CHECK(vPXWorldResolveHandle(world, far) == NULL,
+		"body in a paged region is still resident");
+
+	vPXHandle last = vPXWorldCreateBody(world, CheckTransform(0.0f, 0.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	vPXWorldAddInterest(world, vCreatePosition(CHECK_STREAM_FAR, 0.0f), 1.0f);
+	vPXWorldStreamFlush(world);
+
+	CHECK(vPXWorldResolveHandle(world, far) != NULL,
+		"handed off body did not come back");
+	CHECK(vPXWorldResolveHandle(world, last) != NULL,
+		"body created before the load went missing");
+
+	vPXWorldStep(world);
+	vPXStats stats;
+	vPXWorldGetStats(world, &stats);
+	CHECK(stats.bodiesPaged == 0, "%u bodies still paged, expected 0",
+		stats.bodiesPaged);
+
+	vPXWorldDestroy(world);
+	remove(CHECK_PAGE_FILE);
+}
+
+static void CheckQueryBatchesMatchSingle(void)
+{
+	/* a batch must answer each query as the single form does */
+	vPPXWorld world = CheckWorld();
+	for (vUI32 i = 0; i < CHECK_QUERY_SIDE * CHECK_QUERY_SIDE; i++)
+	{
+		vFloat x = (i % CHECK_QUERY_SIDE) * 3.1f + CheckRandom(-0.5f, 0.5f);
+		vFloat y = (i / CHECK_QUERY_SIDE) * 3.1f + CheckRandom(-0.5f, 0.5f);
+		vPXWorldCreateBody(world, CheckTransform(x, y), CheckUnitBox(),
+			0.0f, 0.0f, 1.0f, (i & 1) ? PX_LAYER_1 : PX_LAYER_0);
+	}
+	vPXWorldQueryEnable(world, TRUE);
+	vPXWorldStep(world);
+
+	vFloat extent = CHECK_QUERY_SIDE * 3.1f;
+	vPXRay rays[CHECK_QUERY_COUNT];
+	vPXRegionQuery regions[CHECK_QUERY_COUNT];
+	vPXNearestQuery nearest[CHECK_QUERY_COUNT];
+	for (vUI32 i = 0; i < CHECK_QUERY_COUNT; i++)
+	{
+		vPXRay* ray = rays + i;
+		ray->origin      = vCreatePosition(CheckRandom(-10.0f, extent + 10.0f),
+			CheckRandom(-10.0f, extent + 10.0f));
+		ray->direction   = vCreatePosition(CheckRandom(-1.0f, 1.0f),
+			CheckRandom(-1.0f, 1.0f));
+		ray->maxDistance = (i % 3 == 0) ? 0.0f : CheckRandom(5.0f, 40.0f);
+		ray->radius      = (i % 4 == 0) ? CheckRandom(0.1f, 2.0f) : 0.0f;
+		ray->layerMask   = (i % 5 == 0) ? PX_LAYER_1 : 0xFF;
+		ray->flags       = (i % 7 == 0) ? PX_RAY_ANY_HIT : 0;
+
+		vPXRegionQuery* region = regions + i;
+		region->center      = vCreatePosition(CheckRandom(0.0f, extent),
+			CheckRandom(0.0f, extent));
+		region->halfExtents = vCreatePosition(CheckRandom(0.5f, 6.0f),
+			CheckRandom(0.5f, 6.0f));
+		region->rotation    = (i & 1) ? CheckRandom(0.0f, 3.0f) : 0.0f;
+		region->layerMask   = (i % 5 == 0) ? PX_LAYER_0 : 0xFF;
+
+		vPXNearestQuery* near = nearest + i;
+		near->point       = vCreatePosition(CheckRandom(-20.0f, extent + 20.0f),
+			CheckRandom(-20.0f, extent + 20.0f));
+		near->maxDistance = (i % 3 == 0) ? CheckRandom(1.0f, 8.0f) : 0.0f;
+		near->k           = 1 + i % CHECK_QUERY_K;
+		near->layerMask   = (i % 5 == 0) ? PX_LAYER_1 : 0xFF;
+	}
+
+	vPXRayHit hits[CHECK_QUERY_COUNT];
+	vUI32 hitCount = vPXWorldRaycastBatch(world, rays, hits, CHECK_QUERY_COUNT);
+	vUI32 singleHits = 0, rayMismatch = 0;
+	for (vUI32 i = 0; i < CHECK_QUERY_COUNT; i++)
+	{
+		vPXRayHit single;
+		singleHits += vPXWorldRaycast(world, rays + i, &single);
+		if (single.hit != hits[i].hit) rayMismatch++;
+		else if (single.hit && (rays[i].flags & PX_RAY_ANY_HIT) == 0 &&
+			fabsf(single.distance - hits[i].distance) > 1e-5f) rayMismatch++;
+	}
+	CHECK(hitCount == singleHits && rayMismatch == 0,
+		"ray batch hit %u, single %u, %u answers differ",
+		hitCount, singleHits, rayMismatch);
+
+	static vPXHandle found[CHECK_QUERY_COUNT * CHECK_QUERY_RESULTS];
+	vUI32 counts[CHECK_QUERY_COUNT];
+	vUI32 total = vPXWorldQueryRegionBatch(world, regions, CHECK_QUERY_COUNT,
+		found, CHECK_QUERY_COUNT * CHECK_QUERY_RESULTS, counts);
+	vUI32 offset = 0, regionMismatch = 0;
+	for (vUI32 i = 0; i < CHECK_QUERY_COUNT; i++)
+	{
+		vPXHandle single[CHECK_QUERY_COUNT * CHECK_QUERY_RESULTS];
+		vUI32 singleCount = vPXWorldQueryRegion(world, regions + i, single,
+			CHECK_QUERY_COUNT * CHECK_QUERY_RESULTS);
+		qsort(single, singleCount, sizeof(vPXHandle), CheckHandleCompare);
+		qsort(found + offset, counts[i], sizeof(vPXHandle), CheckHandleCompare);
+		if (singleCount != counts[i] || memcmp(single, found + offset,
+			singleCount * sizeof(vPXHandle)) != 0) regionMismatch++;
+		offset += counts[i];
+	}
+	CHECK(total == offset && regionMismatch == 0,
+		"%u region answers differ from the single form", regionMismatch);
+
+	/* a short buffer fills in query order */
+	vUI32 tight = total / 2;
+	vUI32 tightTotal = vPXWorldQueryRegionBatch(world, regions,
+		CHECK_QUERY_COUNT, found, tight, counts);
+	vUI32 owed = tight;
+	vUI32 shareMismatch = 0;
+	for (vUI32 i = 0; i < CHECK_QUERY_COUNT; i++)
+	{
+		vPXHandle single[CHECK_QUERY_COUNT * CHECK_QUERY_RESULTS];
+		vUI32 want = min(owed, vPXWorldQueryRegion(world, regions + i, single,
+			CHECK_QUERY_COUNT * CHECK_QUERY_RESULTS));
+		if (counts[i] != want) shareMismatch++;
+		owed -= want;
+	}
+	CHECK(tightTotal == tight && shareMismatch == 0,
+		"short buffer took %u of %u, %u shares differ",
+		tightTotal, tight, shareMismatch);
+
+	static vPXNearestHit nearHits[CHECK_QUERY_COUNT * CHECK_QUERY_K];
+	vUI32 nearTotal = vPXWorldQueryNearestBatch(world, nearest,
+		CHECK_QUERY_COUNT, nearHits, counts);
+	vUI32 nearMismatch = 0, singleTotal = 0;
+	vPXNearestHit* slot = nearHits;
+	for (vUI32 i = 0; i < CHECK_QUERY_COUNT; i++)
+	{
+		vPXNearestHit single[CHECK_QUERY_K];
+		vUI32 singleCount = vPXWorldQueryNearest(world, nearest[i].point,
+			nearest[i].k, nearest[i].layerMask, single);
+		if (nearest[i].maxDistance == 0.0f)
+		{
+			if (singleCount != counts[i]) nearMismatch++;
+			else for (vUI32 j = 0; j < singleCount; j++)
+				if (single[j].distance != slot[j].distance) nearMismatch++;
+		}
+		singleTotal += counts[i];
+		slot += nearest[i].k;
+	}
+	CHECK(nearTotal == singleTotal && nearMismatch == 0,
+		"%u nearest answers differ from the single form", nearMismatch);
+
+	vPXWorldDestroy(world);
+}
+
+static void CheckViewSyncNeedsTouch(void)
+{
+	/* a view edit reaches the store only once it is touched,	*/
+	/* and the tick's motion always reaches the view			*/
+	vPPXWorld world = CheckWorld();
+	vPXHandle handle = vPXWorldCreateBody(world, CheckTransform(0.0f, 0.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	vPPhysical body = vPXWorldResolveHandle(world, handle);
+	vPXSetPhysicsObjectVelocity(body, vCreatePosition(1.0f, 0.0f), 0.0f);
+	vPXWorldStep(world);
+	CHECK(body->transform.position.x == 1.0f,
+		"tick moved the view to x = %f, expected 1", body->transform.position.x);
+
+	body->velocity = vCreatePosition(0.0f, 0.0f);
+	vPXWorldStep(world);
+	CHECK(body->transform.position.x == 2.0f,
+		"untouched edit was read, x = %f, expected 2", body->transform.position.x);
+
+	body->velocity = vCreatePosition(0.0f, 0.0f);
+	vPXTouchPhysicsObject(body);
+	vPXWorldStep(world);
+	CHECK(body->transform.position.x == 2.0f,
+		"touched edit was not read, x = %f, expected 2", body->transform.position.x);
+
+	vPXWorldDestroy(world);
+}
+
+static void CheckHolesAreSkipped(void)
+{
+	/* a body destroyed mid-tick in a deterministic world is a	*/
+	/* hole until the next tick, and must not be published		*/
+	vPPXWorld world = CheckWorld();
+	vPXWorldSetDeterministic(world, TRUE);
+	vPXWorldQueryEnable(world, TRUE);
+	vPXHandle killer = vPXWorldCreateBody(world, CheckTransform(0.0f, 0.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	__checkVictim = vPXWorldCreateBody(world, CheckTransform(50.0f, 0.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	vPXSetPhysicsObjectCallbacks(vPXWorldResolveHandle(world, killer),
+		CheckDestroyVictim, NULL);
+	vPXWorldStep(world);
+
+	vPXHandle found[4];
+	vUI32 count = vPXWorldQueryAABB(world,
+		vGCreateRect(49.0f, 51.0f, -1.0f, 1.0f), 0xFF, found, 4);
+	CHECK(count == 0, "destroyed body was published %u times", count);
+
+	vPXWorldDestroy(world);
+}
+
+static void CheckGenerationsRetire(void)
+{
+	/* reusing one slot past every generation must never make	*/
+	/* an old handle resolve again								*/
+	vPPXWorld world = CheckWorld();
+	vPXHandle first = vPXWorldCreateBody(world, CheckTransform(0.0f, 0.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	vPXWorldDestroyBody(world, first);
+
+	vUI32 revived = 0;
+	for (vUI32 i = 0; i < CHECK_HANDLE_REUSES; i++)
+	{
+		vPXHandle handle = vPXWorldCreateBody(world,
+			CheckTransform(0.0f, 0.0f), CheckUnitBox(), 0.0f, 0.0f, 1.0f,
+			PX_LAYER_0);
+		if (vPXWorldIsHandleValid(world, first) == TRUE) revived++;
+		vPXWorldDestroyBody(world, handle);
+	}
+	CHECK(revived == 0, "stale handle resolved again %u times", revived);
+
+	vPXWorldDestroy(world);
+}
+
+static void CheckGravityUsesFieldLayer(void)
+{
+	/* gravity follows the field layer, not the collide layer */
+	vPPXWorld world = CheckWorld();
+	vPXWorldSetGravity(world, vCreatePosition(0.0f, -1.0f), PX_LAYER_1);
+	vPXHandle falling = vPXWorldCreateBody(world, CheckTransform(0.0f, 0.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	vPXHandle resting = vPXWorldCreateBody(world, CheckTransform(50.0f, 0.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_1);
+	vPXSetPhysicsObjectFieldLayer(vPXWorldResolveHandle(world, falling),
+		PX_LAYER_1);
+	vPXSetPhysicsObjectFieldLayer(vPXWorldResolveHandle(world, resting),
+		PX_LAYER_0);
+	vPXWorldStep(world);
+
+	vPPhysical body = vPXWorldResolveHandle(world, falling);
+	CHECK(body->velocity.y < 0.0f && body->properties.collideLayer == PX_LAYER_0,
+		"field layer body did not fall, vy = %f", body->velocity.y);
+	body = vPXWorldResolveHandle(world, resting);
+	CHECK(body->velocity.y == 0.0f,
+		"collide layer alone let gravity in, vy = %f", body->velocity.y);
+
+	vPXWorldDestroy(world);
+}
+
+static void CheckHullsFollowBodies(void)
+{
+	/* world hulls are built once per setup, a polygon moved	*/
+	/* onto another must still collide where it now is			*/
+	vPPXWorld world = CheckWorld();
+	vVect diamond[4] = { { 0.0f, -0.7f }, { 0.7f, 0.0f }, { 0.0f, 0.7f },
+		{ -0.7f, 0.0f } };
+	vPXShapeID shape = vPXWorldCreatePolygonShape(world, diamond, 4);
+	vPXHandle still = vPXWorldCreateBody(world, CheckTransform(0.0f, 0.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	vPXHandle moved = vPXWorldCreateBody(world, CheckTransform(20.0f, 0.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	vPPhysical a = vPXWorldResolveHandle(world, still);
+	vPPhysical b = vPXWorldResolveHandle(world, moved);
+	vPXSetPhysicsObjectShape(a, shape);
+	vPXSetPhysicsObjectShape(b, shape);
+	vPXWorldStep(world);
+
+	vPXSetPhysicsObjectTransform(b, CheckTransform(1.0f, 0.2f));
+	vPXWorldStep(world);
+	CHECK(b->transform.position.x > 1.0f,
+		"moved polygon was not pushed, x = %f", b->transform.position.x);
+
+	vPXWorldDestroy(world);
+}
+
+static void CheckRandInitRestartsDefault(void)
+{
+	/* the default world's stream starts over on every init */
+	vPXInitializeHeadless(NULL, 1);
+	vPPXWorld world = vPXGetDefaultWorld();
+	vPXRandInit();
+	vFloat first = vPXWorldRandNormalized(world);
+	vPXWorldRandNormalized(world);
+	vPXRandInit();
+	vFloat again = vPXWorldRandNormalized(world);
+	CHECK(first == again, "default stream did not restart, %f then %f",
+		first, again);
+}
+
+static void CheckTraceRingWraps(void)
+{
+	/* a wrapped ring keeps its newest events, a power of two	*/
+	/* of them, and counts the rest as dropped					*/
+	vPPXWorld world = CheckWorld();
+	vPXWorldCreateBody(world, CheckTransform(0.0f, 0.0f), CheckUnitBox(),
+		0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	CHECK(vPXWorldTraceBegin(world, CHECK_TRACE_FILE, CHECK_TRACE_CAPACITY)
+		== TRUE, "could not begin trace");
+	for (int i = 0; i < 4; i++) vPXWorldStep(world);
+	CHECK(vPXWorldTraceEnd(world) == TRUE, "could not end trace");
+	CHECK(vPXWorldTraceIsEnabled(world) == FALSE, "trace still enabled");
+
+	FILE* file = fopen(CHECK_TRACE_FILE, "r");
+	CHECK(file != NULL, "trace file missing");
+	if (file != NULL)
+	{
+		char line[512];
+		vUI32 events = 0;
+		unsigned long long dropped = 0;
+		while (fgets(line, sizeof(line), file) != NULL)
+		{
+			if (strstr(line, "\"cat\":\"vphysics\"") != NULL) events++;
+			char* tail = strstr(line, "\"droppedEvents\":");
+			if (tail != NULL) sscanf(tail, "\"droppedEvents\":%llu", &dropped);
+		}
+		fclose(file);
+		CHECK(events == CHECK_TRACE_KEPT && dropped > 0,
+			"trace kept %u events and dropped %llu", events, dropped);
+	}
+	remove(CHECK_TRACE_FILE);
+
+	vPXWorldDestroy(world);
+}
+
+
+static void CheckStepCountsTick(void)
+{
+	/* a synchronous step simulates one tick and reports what	*/
+	/* it did in the stats										*/
+	vPPXWorld world = CheckWorld();
+	vPXHandle moving = vPXWorldCreateBody(world, CheckTransform(0.0f, 0.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	vPXWorldCreateBody(world, CheckTransform(0.5f, 0.0f), CheckUnitBox(),
+		0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	vPXSetPhysicsObjectVelocity(vPXWorldResolveHandle(world, moving),
+		vCreatePosition(0.1f, 0.0f), 0.0f);
+	vPXWorldStep(world);
+
+	vPXStats stats;
+	vPXWorldGetStats(world, &stats);
+	CHECK(stats.activeBodies == 2 && stats.partitionsUsed > 0,
+		"stats saw %u bodies in %u partitions", stats.activeBodies,
+		stats.partitionsUsed);
+	CHECK(stats.pairHits > 0, "overlapping bodies made no pair hits");
+
+	vPXWorldStep(world);
+	vPXWorldGetStats(world, &stats);
+	CHECK(stats.tickCount == 2, "stepped twice, stats say %llu ticks",
+		(unsigned long long)stats.tickCount);
+
+	vUI64 phases = 0;
+	for (int i = 0; i < PX_PHASE_COUNT; i++) phases += stats.phaseTimeNs[i];
+	CHECK(phases <= stats.tickTimeNs, "phases took %llu ns of a %llu ns tick",
+		(unsigned long long)phases, (unsigned long long)stats.tickTimeNs);
+
+	vPXWorldDestroy(world);
+}
+
+static void CheckPrimitivesNearReference(void)
+{
+	/* the precise primitives agree with double math, the fast	*/
+	/* ones stay within the error vpxmicro reports for them		*/
+	double rotatePrecise = 0.0, rotateFast = 0.0;
+	double magPrecise = 0.0, magFast = 0.0, normalized = 0.0;
+	for (vUI32 i = 0; i < CHECK_PRIMITIVE_SAMPLES; i++)
+	{
+		vVect v = vCreatePosition(CheckRandom(-100.0f, 100.0f),
+			CheckRandom(-100.0f, 100.0f));
+		vFloat theta = CheckRandom(-360.0f, 360.0f);
+		double a   = theta * (double)VPHYS_DEGTORAD;
+		double rx  = v.x * cos(a) - v.y * sin(a);
+		double ry  = v.x * sin(a) + v.y * cos(a);
+		double mag = hypot(v.x, v.y);
+
+		vVect r = v;
+		vPXVectorRotatePrecise(&r, theta);
+		rotatePrecise = fmax(rotatePrecise, hypot(r.x - rx, r.y - ry) / mag);
+		r = v;
+		vPXVectorRotate(&r, theta);
+		rotateFast = fmax(rotateFast, hypot(r.x - rx, r.y - ry) / mag);
+
+		magPrecise = fmax(magPrecise,
+			fabs(vPXVectorMagnitudePrecise(v) - mag) / mag);
+		magFast = fmax(magFast, fabs(vPXVectorMagnitudeV(v) - mag) / mag);
+
+		vVect n = v;
+		vPXVectorNormalize(&n);
+		normalized = fmax(normalized, fabs(hypot(n.x, n.y) - 1.0));
+	}
+
+	CHECK(rotatePrecise < CHECK_PRECISE_ERROR && magPrecise < CHECK_PRECISE_ERROR,
+		"precise rotate off by %g, magnitude by %g", rotatePrecise, magPrecise);
+	CHECK(rotateFast < CHECK_FAST_ERROR && magFast < CHECK_FAST_ERROR,
+		"fast rotate off by %g, magnitude by %g", rotateFast, magFast);
+	CHECK(normalized < CHECK_PRECISE_ERROR, "normalized length off by %g",
+		normalized);
+}
+
+static void CheckDebugDrawOneCall(void)
+{
+	/* the whole overlay is one draw call, and a view that sees	*/
+	/* nothing draws nothing									*/
+	vPPXWorld world = CheckWorld();
+	for (vUI32 i = 0; i < CHECK_DRAW_BODIES; i++)
+	{
+		vPXWorldCreateBody(world, CheckTransform(CheckRandom(-200.0f, 200.0f),
+			CheckRandom(-200.0f, 200.0f)), CheckUnitBox(), 0.0f, 0.0f, 1.0f,
+			PX_LAYER_0);
+	}
+	vPXWorldDebugMode(world, TRUE);
+
+	vUI64 drawCalls = vShimGetDrawCallCount();
+	vPXWorldStep(world);
+	CHECK(vShimGetDrawCallCount() - drawCalls == 1,
+		"overlay took %llu draw calls",
+		(unsigned long long)(vShimGetDrawCallCount() - drawCalls));
+
+	vPXWorldDebugSetView(world, vGCreateRect(1000.0f, 1010.0f, 1000.0f, 1010.0f));
+	drawCalls = vShimGetDrawCallCount();
+	vPXWorldStep(world);
+	CHECK(vShimGetDrawCallCount() == drawCalls,
+		"empty view still drew %llu times",
+		(unsigned long long)(vShimGetDrawCallCount() - drawCalls));
+
+	vPXWorldDestroy(world);
+}
+
+static void CheckRaycastFindsNearest(void)
+{
+	/* a ray stops at the nearest body on its layers, and a	*/
+	/* swept circle stops its radius sooner						*/
+	vPPXWorld world = CheckWorld();
+	vPXHandle nearBody = vPXWorldCreateBody(world, CheckTransform(10.0f, 0.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	vPXHandle farBody  = vPXWorldCreateBody(world, CheckTransform(20.0f, 0.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_1);
+	vPXWorldQueryEnable(world, TRUE);
+	vPXWorldStep(world);
+
+	vPXRay ray;
+	vZeroMemory(&ray, sizeof(ray));
+	ray.origin    = vCreatePosition(0.0f, 0.0f);
+	ray.direction = vCreatePosition(2.0f, 0.0f);
+	ray.layerMask = 0xFF;
+
+	vPXRayHit hit;
+	vPXWorldRaycast(world, &ray, &hit);
+	CHECK(hit.hit && hit.body == nearBody &&
+		fabsf(hit.distance - 9.5f) < CHECK_RAY_ERROR && hit.normal.x < 0.0f,
+		"ray hit %d at %f, expected the near body at 9.5", hit.hit,
+		hit.distance);
+
+	ray.layerMask = PX_LAYER_1;
+	vPXWorldRaycast(world, &ray, &hit);
+	CHECK(hit.hit && hit.body == farBody &&
+		fabsf(hit.distance - 19.5f) < CHECK_RAY_ERROR,
+		"masked ray hit %d at %f, expected the far body at 19.5", hit.hit,
+		hit.distance);
+
+	ray.layerMask = 0xFF;
+	ray.radius    = 0.5f;
+	vPXWorldRaycast(world, &ray, &hit);
+	CHECK(hit.hit && hit.body == nearBody &&
+		fabsf(hit.distance - 9.0f) < CHECK_RAY_ERROR,
+		"swept circle hit %d at %f, expected 9", hit.hit, hit.distance);
+
+	ray.radius      = 0.0f;
+	ray.maxDistance = 5.0f;
+	CHECK(vPXWorldRaycast(world, &ray, &hit) == FALSE && hit.hit == FALSE,
+		"ray hit past its max distance");
+
+	vPXWorldDestroy(world);
+}
+
+static void CheckSortKeepsHandles(void)
+{
+	/* bodies created out of spatial order get re-sorted, and	*/
+	/* every handle still finds its own body afterwards			*/
+	vPPXWorld world = CheckWorld();
+	vPXWorldSpatialSortEnable(world, TRUE);
+
+	/* shuffled grid cells */
+	vUI32     cells[CHECK_SORT_SIDE * CHECK_SORT_SIDE];
+	vPXHandle handles[CHECK_SORT_SIDE * CHECK_SORT_SIDE];
+	vVect     places[CHECK_SORT_SIDE * CHECK_SORT_SIDE];
+	for (vUI32 i = 0; i < CHECK_SORT_SIDE * CHECK_SORT_SIDE; i++) cells[i] = i;
+	for (vUI32 i = CHECK_SORT_SIDE * CHECK_SORT_SIDE - 1; i > 0; i--)
+	{
+		vUI32 j = (vUI32)CheckRandom(0.0f, (vFloat)i + 0.999f);
+		vUI32 swap = cells[i]; cells[i] = cells[j]; cells[j] = swap;
+	}
+
+	for (vUI32 i = 0; i < CHECK_SORT_SIDE * CHECK_SORT_SIDE; i++)
+	{
+		vUI32 cell = cells[i];
+		places[i]  = vCreatePosition((cell % CHECK_SORT_SIDE) * 3.0f,
+			(cell / CHECK_SORT_SIDE) * 3.0f);
+		handles[i] = vPXWorldCreateBody(world,
+			CheckTransform(places[i].x, places[i].y), CheckUnitBox(),
+			0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	}
+	for (vUI32 t = 0; t < CHECK_SORT_TICKS; t++) vPXWorldStep(world);
+
+	vPXStats stats;
+	vPXWorldGetStats(world, &stats);
+	CHECK(stats.bodySorts > 0, "scattered bodies were never re-sorted");
+
+	vUI32 lost = 0;
+	for (vUI32 i = 0; i < CHECK_SORT_SIDE * CHECK_SORT_SIDE; i++)
+	{
+		vPPhysical body = vPXWorldResolveHandle(world, handles[i]);
+		if (body == NULL || vPXGetPhysicsObjectHandle(body) != handles[i] ||
+			body->transform.position.x != places[i].x ||
+			body->transform.position.y != places[i].y) lost++;
+	}
+	CHECK(lost == 0, "%u handles lost their body in the sort", lost);
+
+	vPXWorldDestroy(world);
+}
+
+static void CheckWorldsAreIndependent(void)
+{
+	/* stepping, pulling on or destroying one world leaves		*/
+	/* another untouched										*/
+	vPPXWorld pulled = CheckWorld();
+	vPPXWorld still  = CheckWorld();
+	vPXWorldSetGravity(pulled, vCreatePosition(0.0f, -1.0f), 0xFF);
+	vPXHandle falling = vPXWorldCreateBody(pulled, CheckTransform(0.0f, 0.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	vPXHandle resting = vPXWorldCreateBody(still, CheckTransform(0.0f, 0.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	for (int i = 0; i < 3; i++) vPXWorldStep(pulled);
+
+	vPPhysical body = vPXWorldResolveHandle(pulled, falling);
+	CHECK(body->world == pulled && body->transform.position.y < 0.0f,
+		"body in the stepped world did not fall, y = %f",
+		body->transform.position.y);
+
+	vPXStats stats;
+	vPXWorldGetStats(still, &stats);
+	body = vPXWorldResolveHandle(still, resting);
+	CHECK(stats.tickCount == 0 && body->world == still &&
+		body->transform.position.y == 0.0f,
+		"other world moved, %llu ticks and y = %f",
+		(unsigned long long)stats.tickCount, body->transform.position.y);
+
+	vPXWorldDestroy(pulled);
+	vPXWorldStep(still);
+	body = vPXWorldResolveHandle(still, resting);
+	CHECK(body != NULL && body->transform.position.y == 0.0f,
+		"other world broke when one was destroyed");
+
+	vPXWorldDestroy(still);
+}
+
+static vPPXWorld CheckLockstepSettings(void)
+{
+	/* settings live outside snapshots, so a copy needs them too */
+	vPPXWorld world = CheckWorld();
+	vPXWorldSetDeterministic(world, TRUE);
+	vPXWorldSetGravity(world, vCreatePosition(0.0f, -0.1f), 0xFF);
+	return world;
+}
+
+static vPPXWorld CheckLockstepWorld(vPXHandle* handles)
+{
+	/* same seed, same pile, every time */
+	vPPXWorld world = CheckLockstepSettings();
+	__checkSeed = 777;
+	for (vUI32 i = 0; i < CHECK_LOCKSTEP_BODIES; i++)
+	{
+		handles[i] = vPXWorldCreateBody(world,
+			CheckTransform(CheckRandom(-8.0f, 8.0f), CheckRandom(-8.0f, 8.0f)),
+			CheckUnitBox(), 0.0f, 0.1f, CheckRandom(0.5f, 2.0f), PX_LAYER_0);
+		vPXSetPhysicsObjectVelocity(vPXWorldResolveHandle(world, handles[i]),
+			vCreatePosition(CheckRandom(-0.2f, 0.2f), CheckRandom(-0.2f, 0.2f)),
+			0.0f);
+	}
+	return world;
+}
+
+static void CheckLockstepHashesMatch(void)
+{
+	/* two worlds fed the same input hash the same every tick,	*/
+	/* and one changed body makes them differ					*/
+	vPXHandle handlesA[CHECK_LOCKSTEP_BODIES];
+	vPXHandle handlesB[CHECK_LOCKSTEP_BODIES];
+	vPPXWorld a = CheckLockstepWorld(handlesA);
+	vPPXWorld b = CheckLockstepWorld(handlesB);
+
+	vUI32 diverged = 0;
+	for (vUI32 t = 0; t < CHECK_LOCKSTEP_TICKS; t++)
+	{
+		vPXWorldStep(a);
+		vPXWorldStep(b);
+		if (vPXWorldGetStateHash(a) != vPXWorldGetStateHash(b)) diverged++;
+	}
+	CHECK(diverged == 0, "lockstep worlds diverged on %u ticks", diverged);
+	CHECK(vPXWorldGetStateHash(a) == vPXWorldComputeStateHash(a),
+		"recorded hash does not match the state");
+
+	vPPhysical body = vPXWorldResolveHandle(b, handlesB[0]);
+	vTransform nudged = body->transform;
+	nudged.position.x += 0.001f;
+	vPXSetPhysicsObjectTransform(body, nudged);
+	vPXWorldStep(a);
+	vPXWorldStep(b);
+	CHECK(vPXWorldGetStateHash(a) != vPXWorldGetStateHash(b),
+		"nudged world still hashes the same");
+
+	vPXWorldDestroy(a);
+	vPXWorldDestroy(b);
+}
+
+static void CheckSnapshotRoundTrip(void)
+{
+	/* a loaded snapshot hashes as the world did when saved,	*/
+	/* and carries on exactly as the original did				*/
+	vPXHandle handles[CHECK_LOCKSTEP_BODIES];
+	vPPXWorld world = CheckLockstepWorld(handles);
+	for (vUI32 t = 0; t < CHECK_LOCKSTEP_TICKS; t++) vPXWorldStep(world);
+	CHECK(vPXWorldSaveSnapshot(world, CHECK_SNAPSHOT_FILE) == TRUE,
+		"could not save snapshot");
+	vUI64 saved = vPXWorldComputeStateHash(world);
+	for (vUI32 t = 0; t < CHECK_LOCKSTEP_TICKS; t++) vPXWorldStep(world);
+	vUI64 later = vPXWorldGetStateHash(world);
+
+	vPPXWorld copy = CheckLockstepSettings();
+	CHECK(vPXWorldLoadSnapshot(copy, CHECK_SNAPSHOT_FILE) == TRUE,
+		"could not load snapshot");
+	CHECK(vPXWorldComputeStateHash(copy) == saved,
+		"loaded world hashes %016llx, saved %016llx",
+		(unsigned long long)vPXWorldComputeStateHash(copy),
+		(unsigned long long)saved);
+
+	vUI32 missing = 0;
+	for (vUI32 i = 0; i < CHECK_LOCKSTEP_BODIES; i++)
+		if (vPXWorldResolveHandle(copy, handles[i]) == NULL) missing++;
+	CHECK(missing == 0, "%u handles did not survive the snapshot", missing);
+
+	for (vUI32 t = 0; t < CHECK_LOCKSTEP_TICKS; t++) vPXWorldStep(copy);
+	CHECK(vPXWorldGetStateHash(copy) == later,
+		"loaded world went its own way after %u ticks", CHECK_LOCKSTEP_TICKS);
+
+	vPXWorldDestroy(copy);
+	vPXWorldDestroy(world);
+	remove(CHECK_SNAPSHOT_FILE);
+}
+
+static void CheckReplayMatchesRun(void)
+{
+	/* seeking a delta frame decodes the bodies as they were	*/
+	/* on that tick, to within the recorder's quantization		*/
+	vPXHandle handles[CHECK_LOCKSTEP_BODIES];
+	vPPXWorld world = CheckLockstepWorld(handles);
+	CHECK(vPXWorldRecordBegin(world, CHECK_RECORD_FILE, CHECK_RECORD_KEYFRAME,
+		CHECK_RECORD_RING) == TRUE, "could not begin recording");
+
+	vVect seen[CHECK_LOCKSTEP_BODIES];
+	vUI64 seenTick = 0;
+	for (vUI32 t = 0; t < CHECK_LOCKSTEP_TICKS; t++)
+	{
+		vPXWorldStep(world);
+		if (t != CHECK_RECORD_SEEK) continue;
+
+		vPXStats stats;
+		vPXWorldGetStats(world, &stats);
+		seenTick = stats.tickCount;
+		for (vUI32 i = 0; i < CHECK_LOCKSTEP_BODIES; i++)
+			seen[i] = vPXWorldResolveHandle(world, handles[i])->transform.position;
+	}
+	CHECK(vPXWorldRecordEnd(world) == TRUE, "could not end recording");
+
+	vPXStats stats;
+	vPXWorldGetStats(world, &stats);
+	CHECK(stats.recordDrops == 0, "recorder dropped %u ticks", stats.recordDrops);
+
+	vPPXReplay replay = vPXReplayOpen(CHECK_RECORD_FILE);
+	CHECK(replay != NULL, "could not open recording");
+	if (replay != NULL)
+	{
+		CHECK(vPXReplayGetFrameCount(replay) == CHECK_LOCKSTEP_TICKS,
+			"recording holds %u frames, expected %u",
+			vPXReplayGetFrameCount(replay), CHECK_LOCKSTEP_TICKS);
+		CHECK(vPXReplaySeek(replay, seenTick) == TRUE &&
+			vPXReplayGetTick(replay) == seenTick, "could not seek to tick %llu",
+			(unsigned long long)seenTick);
+
+		vPXReplayBody bodies[CHECK_LOCKSTEP_BODIES];
+		vUI32 count = vPXReplayGetBodies(replay, bodies, CHECK_LOCKSTEP_BODIES);
+		CHECK(count == CHECK_LOCKSTEP_BODIES, "replay holds %u bodies", count);
+
+		vUI32 wrong = 0;
+		for (vUI32 i = 0; i < count; i++)
+		{
+			if (bodies[i].handle != handles[i] ||
+				fabsf(bodies[i].position.x - seen[i].x) > CHECK_RECORD_ERROR ||
+				fabsf(bodies[i].position.y - seen[i].y) > CHECK_RECORD_ERROR)
+				wrong++;
+		}
+		CHECK(wrong == 0, "%u replayed bodies differ from the run", wrong);
+		vPXReplayClose(replay);
+	}
+
+	vPXWorldDestroy(world);
+	remove(CHECK_RECORD_FILE);
+}
+
+static void CheckParticlesLandAndExpire(void)
+{
+	/* a falling particle comes to rest on a body instead of	*/
+	/* passing through it, and short lived ones expire			*/
+	vPPXWorld world = CheckWorld();
+	vPXWorldCreateBody(world, CheckTransform(0.0f, 0.0f),
+		vGCreateRect(-5.0f, 5.0f, -5.0f, 5.0f), 0.0f, 0.0f, 1000.0f,
+		PX_LAYER_0);
+	vPXWorldSetParticleMotion(world, vCreatePosition(0.0f, -0.05f), 0.0f);
+
+	vVect fallFrom = vCreatePosition(0.0f, 8.0f);
+	vVect fleeting = vCreatePosition(50.0f, 0.0f);
+	vPXWorldAddParticles(world, &fallFrom, NULL, 1, CHECK_PARTICLE_RADIUS,
+		PX_PARTICLE_LIFE_FOREVER, PX_LAYER_0);
+	vPXWorldAddParticles(world, &fleeting, NULL, 1, CHECK_PARTICLE_RADIUS,
+		3, PX_LAYER_0);
+	for (vUI32 t = 0; t < CHECK_PARTICLE_TICKS; t++) vPXWorldStep(world);
+
+	vVect landed;
+	vUI32 alive = vPXWorldGetParticles(world, &landed, NULL, 1);
+	CHECK(alive == 1, "%u particles alive, expected the long lived one", alive);
+	CHECK(landed.y > 5.0f && landed.y < 6.0f,
+		"particle came to rest at y = %f, expected on top of the body",
+		landed.y);
+
+	CHECK(vPXWorldKillParticlesInRect(world,
+		vGCreateRect(-1.0f, 1.0f, 4.0f, 7.0f), PX_LAYER_0) == 1 &&
+		vPXWorldGetParticleCount(world) == 0, "kill rect missed the particle");
+
+	vPXWorldDestroy(world);
+}
+
+static void CheckTilemapHoldsBodies(void)
+{
+	/* a body falls onto a solid row of tiles and stays above	*/
+	/* it; a body on another layer falls straight through		*/
+	vPPXWorld world = CheckWorld();
+	vPXWorldSetGravity(world, vCreatePosition(0.0f, -0.05f), 0xFF);
+	vUI8 tiles[CHECK_TILE_WIDTH * CHECK_TILE_HEIGHT];
+	vZeroMemory(tiles, sizeof(tiles));
+	for (vUI32 x = 0; x < CHECK_TILE_WIDTH; x++) tiles[x] = 1;
+	CHECK(vPXWorldSetTilemap(world, vCreatePosition(-8.0f, -4.0f), 1.0f,
+		CHECK_TILE_WIDTH, CHECK_TILE_HEIGHT, tiles, PX_LAYER_0) == TRUE,
+		"could not set tilemap");
+
+	vUI32 tileX, tileY;
+	CHECK(vPXWorldGetTileCoord(world, vCreatePosition(-7.5f, -3.5f),
+		&tileX, &tileY) == TRUE && tileX == 0 && tileY == 0 &&
+		vPXWorldGetTile(world, tileX, tileY) == 1,
+		"tile under (-7.5, -3.5) is not the solid corner tile");
+
+	vPXHandle held = vPXWorldCreateBody(world, CheckTransform(-4.0f, 2.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	vPXHandle passes = vPXWorldCreateBody(world, CheckTransform(4.0f, 2.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_1);
+	for (vUI32 t = 0; t < CHECK_TILE_TICKS; t++) vPXWorldStep(world);
+
+	vFloat heldY   = vPXWorldResolveHandle(world, held)->transform.position.y;
+	vFloat passesY = vPXWorldResolveHandle(world, passes)->transform.position.y;
+	CHECK(heldY > -2.6f && heldY < -2.0f,
+		"body came to rest at y = %f, expected on the tiles at -2.5", heldY);
+	CHECK(passesY < -4.0f, "other layer body stopped at y = %f", passesY);
+
+	vPXStats stats;
+	vPXWorldGetStats(world, &stats);
+	CHECK(stats.tileContacts == 1, "%u tile contacts last tick, expected 1",
+		stats.tileContacts);
+
+	vPXWorldDestroy(world);
+}
+
+static void CheckSensorEnterExit(void)
+{
+	/* a body passing through a sensor is not slowed by it and	*/
+	/* raises one enter and one later exit						*/
+	vPPXWorld world = CheckWorld();
+	vPXHandle sensor = vPXWorldCreateBody(world, CheckTransform(0.0f, 0.0f),
+		vGCreateRect(-1.0f, 1.0f, -1.0f, 1.0f), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	vPXHandle passing = vPXWorldCreateBody(world, CheckTransform(-5.0f, 0.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	vPPhysical sensorBody = vPXWorldResolveHandle(world, sensor);
+	sensorBody->properties.isSensor = TRUE;
+	vPXTouchPhysicsObject(sensorBody);
+	vPPhysical body = vPXWorldResolveHandle(world, passing);
+	vPXSetPhysicsObjectVelocity(body, vCreatePosition(1.0f, 0.0f), 0.0f);
+
+	vUI32 overlapped = 0;
+	for (int t = 0; t < 10; t++)
+	{
+		vPXWorldStep(world);
+		vPXHandle inside;
+		overlapped += vPXWorldGetSensorOverlaps(world, sensor, &inside, 1);
+	}
+	CHECK(overlapped > 0, "body was never inside the sensor");
+	CHECK(body->velocity.x == 1.0f && body->transform.position.x == 5.0f &&
+		sensorBody->transform.position.x == 0.0f,
+		"sensor touched the body, x = %f and vx = %f",
+		body->transform.position.x, body->velocity.x);
+
+	vPXSensorEvent events[4];
+	vUI32 count = vPXWorldReadSensorEvents(world, events, 4);
+	CHECK(count == 2 && events[0].type == PX_SENSOR_ENTER &&
+		events[1].type == PX_SENSOR_EXIT && events[0].tick < events[1].tick &&
+		events[0].sensor == sensor && events[0].body == passing &&
+		events[1].sensor == sensor && events[1].body == passing,
+		"expected one enter then one exit, got %u events", count);
+	CHECK(vPXWorldGetSensorEventCount(world) == 0, "reading left events queued");
+
+	vPXWorldDestroy(world);
+}
+
+static void CheckLayerMatrixGatesPairs(void)
+{
+	/* overlapping bodies on layers that do not collide are		*/
+	/* skipped by cell, and collide once the matrix allows it	*/
+	vPPXWorld world = CheckWorld();
+	vPXHandle moving = vPXWorldCreateBody(world, CheckTransform(0.0f, 0.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	vPXWorldCreateBody(world, CheckTransform(0.5f, 0.0f), CheckUnitBox(),
+		0.0f, 0.0f, 1.0f, PX_LAYER_1);
+	vPXSetPhysicsObjectVelocity(vPXWorldResolveHandle(world, moving),
+		vCreatePosition(0.1f, 0.0f), 0.0f);
+
+	vPXStats stats;
+	vPXWorldStep(world);
+	vPXWorldGetStats(world, &stats);
+	CHECK(stats.pairTests == 0 && stats.layerCellSkips > 0,
+		"split layers made %u pair tests and %u cell skips",
+		stats.pairTests, stats.layerCellSkips);
+
+	vPXWorldSetLayersCollide(world, PX_LAYER_0, PX_LAYER_1, TRUE);
+	CHECK(vPXWorldGetLayersCollide(world, PX_LAYER_1, PX_LAYER_0) == TRUE,
+		"layer matrix is not symmetric");
+	vPXWorldStep(world);
+	vPXWorldGetStats(world, &stats);
+	CHECK(stats.pairHits > 0, "joined layers did not collide");
+
+	vPXWorldResetLayerMatrix(world);
+	CHECK(vPXWorldGetLayersCollide(world, PX_LAYER_0, PX_LAYER_1) == FALSE &&
+		vPXWorldGetLayersCollide(world, PX_LAYER_1, PX_LAYER_1) == TRUE,
+		"reset matrix is not each layer with itself");
+
+	vPXWorldDestroy(world);
+}
+
+static void CheckPoolRunsEachUpdateOnce(void)
+{
+	/* marked updates run on the pool and unmarked ones on the	*/
+	/* tick, each exactly once per tick							*/
+	vPPXWorld world = CheckWorld();
+	vPXWorldSetThreadCount(world, CHECK_POOL_THREADS);
+	vZeroMemory((vPTR)__checkUpdates, sizeof(__checkUpdates));
+	for (vUI32 i = 0; i <= CHECK_POOL_BODIES; i++)
+	{
+		vPXHandle handle = vPXWorldCreateBody(world,
+			CheckTransform((vFloat)(i * 2), 0.0f), CheckUnitBox(), 0.0f, 0.0f,
+			1.0f, PX_LAYER_0);
+		vPPhysical body = vPXWorldResolveHandle(world, handle);
+		vPXSetPhysicsObjectCallbacks(body, CheckCountUpdate, NULL);
+
+		/* the last body stays on the tick thread */
+		body->properties.threadSafeUpdate = (i < CHECK_POOL_BODIES);
+		vPXTouchPhysicsObject(body);
+	}
+	for (vUI32 t = 0; t < CHECK_POOL_TICKS; t++) vPXWorldStep(world);
+
+	vUI32 wrong = 0;
+	for (vUI32 i = 0; i <= CHECK_POOL_BODIES; i++)
+		if (__checkUpdates[i] != CHECK_POOL_TICKS) wrong++;
+	CHECK(wrong == 0, "%u bodies were not updated once per tick", wrong);
+
+	vPXStats stats;
+	vPXWorldGetStats(world, &stats);
+	CHECK(stats.parallelUpdates == CHECK_POOL_BODIES,
+		"%u updates ran on the pool, expected %u", stats.parallelUpdates,
+		CHECK_POOL_BODIES);
+
+	vPXWorldDestroy(world);
+}
+
+static void CheckStillBoundsReused(void)
+{
+	/* bodies that did not move keep their world bounds, and a	*/
+	/* moved one is rebuilt where it now is						*/
+	vPPXWorld world = CheckWorld();
+	vPXWorldQueryEnable(world, TRUE);
+	vPXHandle still[CHECK_BOUND_STILL];
+	for (vUI32 i = 0; i < CHECK_BOUND_STILL; i++)
+	{
+		still[i] = vPXWorldCreateBody(world, CheckTransform(i * 3.0f, 0.0f),
+			CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	}
+	vPXHandle moving = vPXWorldCreateBody(world, CheckTransform(0.0f, 50.0f),
+		CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	vPXSetPhysicsObjectVelocity(vPXWorldResolveHandle(world, moving),
+		vCreatePosition(1.0f, 0.0f), 0.0f);
+
+	vPXStats stats;
+	vPXWorldStep(world);
+	vPXWorldStep(world);
+	vPXWorldGetStats(world, &stats);
+	CHECK(stats.boundsReused == CHECK_BOUND_STILL,
+		"%u bounds reused, expected the %u still bodies", stats.boundsReused,
+		CHECK_BOUND_STILL);
+
+	vPXSetPhysicsObjectTransform(vPXWorldResolveHandle(world, still[0]),
+		CheckTransform(100.0f, 0.0f));
+	vPXWorldStep(world);
+	vPXWorldGetStats(world, &stats);
+	CHECK(stats.boundsReused == CHECK_BOUND_STILL - 1,
+		"%u bounds reused after a move, expected %u", stats.boundsReused,
+		CHECK_BOUND_STILL - 1);
+
+	vPXHandle found;
+	vUI32 count = vPXWorldQueryAABB(world,
+		vGCreateRect(99.0f, 101.0f, -1.0f, 1.0f), 0xFF, &found, 1);
+	CHECK(count == 1 && found == still[0], "moved body's bound was not rebuilt");
+
+	vPXWorldDestroy(world);
+}
+
+static void CheckPairCapRotates(void)
+{
+	/* a world far over budget degrades down to capping pair	*/
+	/* tests, and the cap still lets every body of a crowded	*/
+	/* cell be tested in turn									*/
+	vPPXWorld world = CheckWorld();
+	vPXWorldSetTickBudget(world, CHECK_BUDGET_US);
+	for (vUI32 i = 0; i < CHECK_BUDGET_SPARSE; i++)
+	{
+		vPXWorldCreateBody(world, CheckTransform(i * 3.0f + 1.5f, -100.0f),
+			CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+	}
+	for (vUI32 t = 0; t < 4; t++) vPXWorldStep(world);
+
+	vPXStats stats;
+	vPXWorldGetStats(world, &stats);
+	CHECK(stats.degradeLevel == PX_DEGRADE_PAIR_CAP &&
+		stats.degradeEscalations > 0, "over budget world is at level %u",
+		stats.degradeLevel);
+
+	/* bodies are only pushed when they are the source of a	*/
+	/* test, so one that never moves off its row was starved	*/
+	vPXHandle crowd[CHECK_BUDGET_CROWD];
+	vFloat    rows[CHECK_BUDGET_CROWD];
+	for (vUI32 i = 0; i < CHECK_BUDGET_CROWD; i++)
+	{
+		rows[i]  = 1.5f + CheckRandom(-0.3f, 0.3f);
+		crowd[i] = vPXWorldCreateBody(world,
+			CheckTransform(1.5f + CheckRandom(-0.3f, 0.3f), rows[i]),
+			CheckUnitBox(), 0.0f, 0.0f, 1.0f, PX_LAYER_0);
+		vPXSetPhysicsObjectVelocity(vPXWorldResolveHandle(world, crowd[i]),
+			vCreatePosition(0.01f, 0.0f), 0.0f);
+	}
+
+	vUI32 cappedCells = 0;
+	for (vUI32 t = 0; t < CHECK_BUDGET_TICKS; t++)
+	{
+		vPXWorldStep(world);
+		vPXWorldGetStats(world, &stats);
+		cappedCells += stats.pairCapCells;
+	}
+	CHECK(cappedCells > 0, "crowded cell never ran out of pair tests");
+
+	vUI32 starved = 0;
+	for (vUI32 i = 0; i < CHECK_BUDGET_CROWD; i++)
+	{
+		vPPhysical body = vPXWorldResolveHandle(world, crowd[i]);
+		if (body->transform.position.y == rows[i]) starved++;
+	}
+	CHECK(starved == 0, "%u of %u crowded bodies were never tested",
+		starved, CHECK_BUDGET_CROWD);
+
+	vPXWorldDestroy(world);
+}
+
+/* ========== ENTRY POINT						==========	*/
+int main(void)
+{
+	CheckFieldGatherGrowth();
+	CheckLODConservesTime();
+	CheckSnapshotWhilePaged();
+	CheckStreamLoadDuringCheck();
+	CheckQueryBatchesMatchSingle();
+	CheckViewSyncNeedsTouch();
+	CheckHolesAreSkipped();
+	CheckGenerationsRetire();
+	CheckGravityUsesFieldLayer();
+	CheckHullsFollowBodies();
+	CheckRandInitRestartsDefault();
+	CheckTraceRingWraps();
+	CheckStepCountsTick();
+	CheckPrimitivesNearReference();
+	CheckDebugDrawOneCall();
+	CheckRaycastFindsNearest();
+	CheckSortKeepsHandles();
+	CheckWorldsAreIndependent();
+	CheckLockstepHashesMatch();
+	CheckSnapshotRoundTrip();
+	CheckReplayMatchesRun();
+	CheckParticlesLandAndExpire();
+	CheckTilemapHoldsBodies();
+	CheckSensorEnterExit();
+	CheckLayerMatrixGatesPairs();
+	CheckPoolRunsEachUpdateOnce();
+	CheckStillBoundsReused();
+	CheckPairCapRotates();
+
+	if (__checkFailures == 0) printf("all checks passed\n");
+	else printf("%u checks failed\n", __checkFailures);
+	return (int)__checkFailures;
+}
@@ -0,0 +1,646 @@
+/* ========== <vpxmicro.c>						==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Microbenchmarks for the vector, collision and random		*/
+/* number primitives.										*/
+/* Each primitive runs over a large randomized input set;	*/
+/* ns/op and error against a double-precision reference of	*/
+/* the same algorithm are reported as JSON lines (stdout)	*/
+/* and a readable table (stderr).							*/
+
+
+/* ========== INCLUDES							==========	*/
+#include "vphys.h"
+#include "vcollision.h"
+#include "vbodystore.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+/* ========== DEFINITIONS						==========	*/
+#define MICRO_N_DEFAULT			0x100000
+#define MICRO_PAIRS_DEFAULT		0x40000
+#define MICRO_REPS_DEFAULT		5
+#define MICRO_DEGTORAD			0.017453292519943295
+
+
+/* ========== STRUCTURES						==========	*/
+typedef struct MicroOptions
+{
+	vUI32 n;		/* vector inputs	*/
+	vUI32 pairs;	/* body pair inputs	*/
+	vUI32 reps;
+	vUI32 seed;
+} MicroOptions, *PMicroOptions;
+
+typedef struct MicroError
+{
+	double maxErr;
+	double sumErr;
+	vUI64  samples;
+	vUI64  mismatches;	/* boolean disagreements with the reference */
+} MicroError, *PMicroError;
+
+typedef struct MicroDBox
+{
+	double mesh[4][2];
+	double center[2];
+	double radius;		/* circles only	*/
+} MicroDBox, *PMicroDBox;
+
+static vUI32 __microRng = 1;
+static volatile vFloat __microSink;
+
+
+/* ========== HELPERS							==========	*/
+static double MicroNow(void)
+{
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+static float MicroRandom(float low, float high)
+{
+	vUI32 x = __microRng;
+	x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+	__microRng = x;
+	return low + (high - low) * ((x >> 8) * (1.0f / 16777216.0f));
+}
+
+static void MicroErrorAdd(PMicroError err, double value)
+{
+	err->maxErr = max(err->maxErr, value);
+	err->sumErr += value;
+	err->samples++;
+}
+
+static void MicroReport(const char* name, vUI64 ops, double seconds,
+	const char* metric, PMicroError err)
+{
+	double nsPerOp = (seconds * 1e9) / (double)ops;
+	double meanErr = err->samples ? err->sumErr / (double)err->samples : 0.0;
+	double mismatchRate = err->samples ?
+		(double)err->mismatches / (double)err->samples : 0.0;
+
+	printf("{\"primitive\":\"%s\",\"ops\":%llu,\"ns_per_op\":%.3f,"
+		"\"error_metric\":\"%s\",\"max_error\":%.9g,\"mean_error\":%.9g,"
+		"\"mismatch_rate\":%.9g}\n", name, (unsigned long long)ops, nsPerOp,
+		metric, err->maxErr, meanErr, mismatchRate);
+	fflush(stdout);
+
+	fprintf(stderr, "%-34s %8.2f ns/op  %-10s max %-12.4g mean %-12.4g "
+		"mismatch %.4g\n", name, nsPerOp, metric, err->maxErr, meanErr,
+		mismatchRate);
+}
+
+
+/* ========== INPUT GENERATION					==========	*/
+static void MicroBuildBox(vPPhysical phys, PMicroDBox dbox)
+{
+	/* random oriented box, world bounds generated in double precision */
+	vZeroMemory(phys, sizeof(vPhysical));
+	double cx = MicroRandom(-2.0f, 2.0f);
+	double cy = MicroRandom(-2.0f, 2.0f);
+	double hw = MicroRandom(0.25f, 1.0f);
+	double hh = MicroRandom(0.25f, 1.0f);
+	double r  = MicroRandom(0.0f, 360.0f) * MICRO_DEGTORAD;
+	double c  = cos(r), s = sin(r);
+	const double corners[4][2] = 
+		{ { -hw, -hh }, { -hw, hh }, { hw, hh }, { hw, -hh } };
+
+	double minX = 1e30, maxX = -1e30, minY = 1e30, maxY = -1e30;
+	for (int i = 0; i < 4; i++)
+	{
+		double x = cx + corners[i][0] * c - corners[i][1] * s;
+		double y = cy + corners[i][0] * s + corners[i][1] * c;
+		dbox->mesh[i][0] = x;
+		dbox->mesh[i][1] = y;
+		phys->worldBound.mesh[i] = vCreatePosition((float)x, (float)y);
+		minX = min(minX, x); maxX = max(maxX, x);
+		minY = min(minY, y); maxY = max(maxY, y);
+	}
+	dbox->center[0] = cx;
+	dbox->center[1] = cy;
+	phys->worldBound.center = vCreatePosition((float)cx, (float)cy);
+	phys->worldBound.axis   = vCreatePosition((float)c, (float)s);
+	phys->anticipatedPos    = phys->worldBound.center;
+	phys->transform.scale   = 1.0f;
+	phys->worldBound.boundingBox = 
+		vGCreateRect((float)minX, (float)maxX, (float)minY, (float)maxY);
+	phys->worldBound.boundingBoxDims = 
+		vCreatePosition((float)(maxX - minX), (float)(maxY - minY));
+
+	phys->mass     = MicroRandom(0.5f, 5.0f);
+	phys->friction = MicroRandom(0.0f, 0.5f);
+	phys->velocity = vCreatePosition(MicroRandom(-1.0f, 1.0f),
+		MicroRandom(-1.0f, 1.0f));
+	phys->angularVelocity = MicroRandom(-1.0f, 1.0f);
+}
+
+
+static void MicroBuildCircle(vPPhysical phys, PMicroDBox dbox, vPXShapeID shape)
+{
+	/* unit circle shape, sized by scale */
+	vZeroMemory(phys, sizeof(vPhysical));
+	double cx = MicroRandom(-2.0f, 2.0f);
+	double cy = MicroRandom(-2.0f, 2.0f);
+	float  r  = MicroRandom(0.25f, 1.0f);
+
+	dbox->center[0] = cx;
+	dbox->center[1] = cy;
+	dbox->radius    = r;
+
+	phys->world           = vPXGetDefaultWorld();
+	phys->shape           = shape;
+	phys->transform.scale = r;
+	phys->anticipatedPos  = vCreatePosition((float)cx, (float)cy);
+	phys->worldBound.center = phys->anticipatedPos;
+	phys->worldBound.axis   = vCreatePosition(1.0f, 0.0f);
+}
+
+
+/* ========== DOUBLE PRECISION REFERENCES		==========	*/
+static vBOOL MicroRefSAT(PMicroDBox s, PMicroDBox t, double* pushMag)
+{
+	/* same algorithm as vPXDetectCollisionSAT, in double */
+	double disp[2] = { s->center[0] - t->center[0], s->center[1] - t->center[1] };
+	double dispMag = sqrt(disp[0] * disp[0] + disp[1] * disp[1]);
+	disp[0] /= dispMag; disp[1] /= dispMag;
+
+	double best = 65536.0;
+	for (int i = 0; i < 8; i++)
+	{
+		PMicroDBox m = (i < 4) ? s : t;
+		int v = i & 3;
+		double ax = m->mesh[(v + 1) & 3][0] - m->mesh[v][0];
+		double ay = m->mesh[(v + 1) & 3][1] - m->mesh[v][1];
+		double mag = sqrt(ax * ax + ay * ay);
+		ax /= mag; ay /= mag;
+
+		double sMin = 1e30, sMax = -1e30, tMin = 1e30, tMax = -1e30;
+		for (int j = 0; j < 4; j++)
+		{
+			double sd = s->mesh[j][0] * ax + s->mesh[j][1] * ay;
+			double td = t->mesh[j][0] * ax + t->mesh[j][1] * ay;
+			sMin = min(sMin, sd); sMax = max(sMax, sd);
+			tMin = min(tMin, td); tMax = max(tMax, td);
+		}
+
+		if (max(sMax, tMax) - min(sMin, tMin) > (sMax - sMin) + (tMax - tMin))
+			return FALSE;
+
+		double overlap = min(sMax, tMax) - max(sMin, tMin);
+		if (ax * disp[0] + ay * disp[1] > 0.0 && overlap < best) best = overlap;
+	}
+
+	*pushMag = best;
+	return TRUE;
+}
+
+static vBOOL MicroRefCircles(PMicroDBox s, PMicroDBox t, double* pushMag)
+{
+	double dx = s->center[0] - t->center[0];
+	double dy = s->center[1] - t->center[1];
+	double dist = sqrt(dx * dx + dy * dy);
+	*pushMag = s->radius + t->radius - dist;
+	return *pushMag >= 0.0;
+}
+
+static void MicroRefMomentum(vPPhysical s, vPPhysical t, double out[2])
+{
+	double v1x = s->velocity.x - t->velocity.x;
+	double v1y = s->velocity.y - t->velocity.y;
+	v1x *= 1.0 - t->friction;
+	v1y *= 1.0 - t->friction;
+	double k = ((double)s->mass - t->mass) / ((double)s->mass + t->mass);
+	out[0] = v1x * k + t->velocity.x;
+	out[1] = v1y * k + t->velocity.y;
+}
+
+static double MicroRefAngularForce(vPPhysical target, vPPhysical source)
+{
+	/* same algorithm as PXCalculateAngularForce, in double, with the */
+	/* exact magnitude in place of the fast approximation			  */
+	double sv[2], tv[2];
+	MicroRefMomentum(source, target, sv);
+	MicroRefMomentum(target, source, tv);
+	double dx = tv[0] - sv[0], dy = tv[1] - sv[1];
+
+	double px = dy, py = -dx;
+	double pm = sqrt(px * px + py * py);
+	px /= pm; py /= pm;
+
+	double sc = px * source->worldBound.center.x + py * source->worldBound.center.y;
+	double tc = px * target->worldBound.center.x + py * target->worldBound.center.y;
+
+	double minPos = 1e30, maxPos = -1e30;
+	for (int i = 0; i < 4; i++)
+	{
+		double a = px * source->worldBound.mesh[i].x + py * source->worldBound.mesh[i].y;
+		double b = px * target->worldBound.mesh[i].x + py * target->worldBound.mesh[i].y;
+		minPos = min(minPos, min(a, b));
+		maxPos = max(maxPos, max(a, b));
+	}
+
+	double shadowCenter = (minPos + maxPos) * 0.5;
+	double sRadius = sc - shadowCenter;
+	if (fabs(sRadius) < VPHYS_EPSILON) return 0.0;
+
+	double centerDist = fabs(sc - tc);
+	double shadowSize = maxPos - minPos;
+	if (centerDist < VPHYS_EPSILON) return 0.0;
+	if (fabs(shadowSize) < VPHYS_EPSILON) return 0.0;
+
+	double scale = min(1.0, centerDist / shadowSize);
+	double deltaV = sqrt(dx * dx + dy * dy);
+	if (deltaV < VPHYS_EPSILON) return 0.0;
+
+	double deltaR = (180.0 * deltaV) / (sRadius * 3.14159265358979);
+	deltaR *= (double)target->mass / ((double)source->mass + target->mass);
+	deltaR *= scale;
+	deltaR *= 1.0 - source->friction;
+
+	if (deltaR < 0.0 && source->angularVelocity < deltaR) return 0.0;
+	if (deltaR > 0.0 && source->angularVelocity > deltaR) return 0.0;
+	return deltaR;
+}
+
+
+/* ========== VECTOR BENCHMARKS					==========	*/
+static void MicroBenchRotate(PMicroOptions opt, vPVect input, vPFloat angles,
+	vPVect work, vBOOL precise)
+{
+	double seconds = 0.0;
+	for (vUI32 r = 0; r < opt->reps; r++)
+	{
+		vMemCopy(work, input, sizeof(vVect) * opt->n);
+		double start = MicroNow();
+		if (precise)
+			for (vUI32 i = 0; i < opt->n; i++) vPXVectorRotatePrecise(work + i, angles[i]);
+		else
+			for (vUI32 i = 0; i < opt->n; i++) vPXVectorRotate(work + i, angles[i]);
+		seconds += MicroNow() - start;
+	}
+
+	MicroError err;
+	vZeroMemory(&err, sizeof(err));
+	for (vUI32 i = 0; i < opt->n; i++)
+	{
+		double x = input[i].x, y = input[i].y;
+		double a = angles[i] * MICRO_DEGTORAD;
+		double rx = x * cos(a) - y * sin(a);
+		double ry = x * sin(a) + y * cos(a);
+		double mag = sqrt(x * x + y * y);
+		if (mag == 0.0) continue;
+		MicroErrorAdd(&err, hypot(work[i].x - rx, work[i].y - ry) / mag);
+	}
+
+	MicroReport(precise ? "vPXVectorRotatePrecise" : "vPXVectorRotate",
+		(vUI64)opt->n * opt->reps, seconds, "rel", &err);
+}
+
+static void MicroBenchMagnitude(PMicroOptions opt, vPVect input, vBOOL precise)
+{
+	double seconds = 0.0;
+	vFloat accum = 0.0f;
+	for (vUI32 r = 0; r < opt->reps; r++)
+	{
+		double start = MicroNow();
+		if (precise)
+			for (vUI32 i = 0; i < opt->n; i++) accum += vPXVectorMagnitudePrecise(input[i]);
+		else
+			for (vUI32 i = 0; i < opt->n; i++) accum += vPXVectorMagnitudeV(input[i]);
+		seconds += MicroNow() - start;
+	}
+	__microSink = accum;
+
+	MicroError err;
+	vZeroMemory(&err, sizeof(err));
+	for (vUI32 i = 0; i < opt->n; i++)
+	{
+		double ref = hypot(input[i].x, input[i].y);
+		if (ref == 0.0) continue;
+		vFloat got = precise ? vPXVectorMagnitudePrecise(input[i]) :
+			vPXVectorMagnitudeV(input[i]);
+		MicroErrorAdd(&err, fabs(got - ref) / ref);
+	}
+
+	MicroReport(precise ? "vPXVectorMagnitudePrecise" : "vPXVectorMagnitudeV",
+		(vUI64)opt->n * opt->reps, seconds, "rel", &err);
+}
+
+static void MicroBenchNormalize(PMicroOptions opt, vPVect input, vPVect work)
+{
+	double seconds = 0.0;
+	for (vUI32 r = 0; r < opt->reps; r++)
+	{
+		vMemCopy(work, input, sizeof(vVect) * opt->n);
+		double start = MicroNow();
+		for (vUI32 i = 0; i < opt->n; i++) vPXVectorNormalize(work + i);
+		seconds += MicroNow() - start;
+	}
+
+	MicroError err;
+	vZeroMemory(&err, sizeof(err));
+	for (vUI32 i = 0; i < opt->n; i++)
+	{
+		double mag = hypot(input[i].x, input[i].y);
+		if (mag == 0.0) continue;
+		MicroErrorAdd(&err, hypot(work[i].x - input[i].x / mag,
+			work[i].y - input[i].y / mag));
+	}
+
+	MicroReport("vPXVectorNormalize", (vUI64)opt->n * opt->reps, seconds,
+		"abs", &err);
+}
+
+
+/* ========== COLLISION BENCHMARKS				==========	*/
+static void MicroBenchPreEstimate(PMicroOptions opt, vPPhysical bodies,
+	PMicroDBox dboxes)
+{
+	double seconds = 0.0;
+	vUI32 passed = 0;
+	for (vUI32 r = 0; r < opt->reps; r++)
+	{
+		double start = MicroNow();
+		for (vUI32 i = 0; i < opt->pairs; i++)
+			passed += vPXDetectCollisionPreEstimate(bodies + 2 * i, bodies + 2 * i + 1);
+		seconds += MicroNow() - start;
+	}
+	__microSink = (vFloat)passed;
+
+	/* error is the rate of disjoint pairs the estimate accepts, */
+	/* mismatches are overlapping pairs it wrongly rejects		*/
+	MicroError err;
+	vZeroMemory(&err, sizeof(err));
+	for (vUI32 i = 0; i < opt->pairs; i++)
+	{
+		double mag;
+		vBOOL truth = MicroRefSAT(dboxes + 2 * i, dboxes + 2 * i + 1, &mag);
+		vBOOL est = vPXDetectCollisionPreEstimate(bodies + 2 * i, bodies + 2 * i + 1);
+		MicroErrorAdd(&err, (est == TRUE && truth == FALSE) ? 1.0 : 0.0);
+		if (truth == TRUE && est == FALSE) err.mismatches++;
+	}
+
+	MicroReport("vPXDetectCollisionPreEstimate", (vUI64)opt->pairs * opt->reps,
+		seconds, "false_pos", &err);
+}
+
+static void MicroBenchSAT(PMicroOptions opt, vPPhysical bodies, PMicroDBox dboxes)
+{
+	double seconds = 0.0;
+	vFloat accum = 0.0f;
+	for (vUI32 r = 0; r < opt->reps; r++)
+	{
+		double start = MicroNow();
+		for (vUI32 i = 0; i < opt->pairs; i++)
+		{
+			vVect push; vFloat mag;
+			if (vPXDetectCollisionSAT(bodies + 2 * i, bodies + 2 * i + 1, &push, &mag))
+				accum += mag;
+		}
+		seconds += MicroNow() - start;
+	}
+	__microSink = accum;
+
+	MicroError err;
+	vZeroMemory(&err, sizeof(err));
+	for (vUI32 i = 0; i < opt->pairs; i++)
+	{
+		vVect push; vFloat mag; double refMag;
+		vBOOL got = vPXDetectCollisionSAT(bodies + 2 * i, bodies + 2 * i + 1,
+			&push, &mag);
+		vBOOL ref = MicroRefSAT(dboxes + 2 * i, dboxes + 2 * i + 1, &refMag);
+		if (got != ref)
+		{
+			err.mismatches++;
+			err.samples++;
+			continue;
+		}
+		if (ref == TRUE) MicroErrorAdd(&err, fabs(mag - refMag));
+		else err.samples++;
+	}
+
+	MicroReport("vPXDetectCollisionSAT", (vUI64)opt->pairs * opt->reps,
+		seconds, "abs_push", &err);
+}
+
+static void MicroBenchShapes(PMicroOptions opt, vPPhysical bodies,
+	PMicroDBox dboxes, vBOOL circles)
+{
+	/* through the shape pair table, boxes take the general SAT */
+	double seconds = 0.0;
+	vFloat accum = 0.0f;
+	for (vUI32 r = 0; r < opt->reps; r++)
+	{
+		double start = MicroNow();
+		for (vUI32 i = 0; i < opt->pairs; i++)
+		{
+			vVect push; vFloat mag;
+			if (vPXDetectCollision(bodies + 2 * i, bodies + 2 * i + 1, &push, &mag))
+				accum += mag;
+		}
+		seconds += MicroNow() - start;
+	}
+	__microSink = accum;
+
+	MicroError err;
+	vZeroMemory(&err, sizeof(err));
+	for (vUI32 i = 0; i < opt->pairs; i++)
+	{
+		vVect push; vFloat mag; double refMag;
+		vBOOL got = vPXDetectCollision(bodies + 2 * i, bodies + 2 * i + 1,
+			&push, &mag);
+		vBOOL ref = circles ?
+			MicroRefCircles(dboxes + 2 * i, dboxes + 2 * i + 1, &refMag) :
+			MicroRefSAT(dboxes + 2 * i, dboxes + 2 * i + 1, &refMag);
+		if (got != ref)
+		{
+			err.mismatches++;
+			err.samples++;
+			continue;
+		}
+		if (ref == TRUE) MicroErrorAdd(&err, fabs(mag - refMag));
+		else err.samples++;
+	}
+
+	MicroReport(circles ? "vPXDetectCollision circle" : "vPXDetectCollision box",
+		(vUI64)opt->pairs * opt->reps, seconds, "abs_push", &err);
+}
+
+static void MicroBenchAngularForce(PMicroOptions opt, vPPhysical bodies)
+{
+	vPPXWorld world = vPXGetDefaultWorld();
+	PXPushbackInfo pushInfo;
+	vZeroMemory(&pushInfo, sizeof(pushInfo));
+
+	double seconds = 0.0;
+	vFloat accum = 0.0f;
+	for (vUI32 r = 0; r < opt->reps; r++)
+	{
+		double start = MicroNow();
+		for (vUI32 i = 0; i < opt->pairs; i++)
+		{
+			PXAngularForceInfo info = PXCalculateAngularForce(world,
+				&pushInfo, 2 * i + 1, 2 * i);
+			accum += info.angularForce;
+		}
+		seconds += MicroNow() - start;
+	}
+	__microSink = accum;
+
+	/* relative error where the reference applies a force */
+	MicroError err;
+	vZeroMemory(&err, sizeof(err));
+	for (vUI32 i = 0; i < opt->pairs; i++)
+	{
+		vPPhysical source = bodies + 2 * i;
+		vPPhysical target = bodies + 2 * i + 1;
+		double ref = MicroRefAngularForce(target, source);
+		PXAngularForceInfo info = PXCalculateAngularForce(world, &pushInfo,
+			PXBodyStoreResolve(world, target->handle),
+			PXBodyStoreResolve(world, source->handle));
+
+		if ((ref == 0.0) != (info.angularForce == 0.0f))
+		{
+			err.mismatches++;
+			err.samples++;
+			continue;
+		}
+		if (ref != 0.0) MicroErrorAdd(&err, fabs(info.angularForce - ref) / fabs(ref));
+		else err.samples++;
+	}
+
+	MicroReport("PXCalculateAngularForce", (vUI64)opt->pairs * opt->reps,
+		seconds, "rel", &err);
+}
+
+
+/* ========== RANDOM BENCHMARKS					==========	*/
+static void MicroBenchRand(PMicroOptions opt, vPFloat out, vBOOL bulk)
+{
+	vPXRandStream stream;
+	vPXRandStreamSeed(&stream, opt->seed);
+
+	double seconds = 0.0;
+	for (vUI32 r = 0; r < opt->reps; r++)
+	{
+		double start = MicroNow();
+		if (bulk) vPXRandStreamFill(&stream, out, opt->n, 0.0f, 1.0f);
+		else for (vUI32 i = 0; i < opt->n; i++)
+			out[i] = vPXRandStreamRange(&stream, 0.0f, 1.0f);
+		seconds += MicroNow() - start;
+	}
+	__microSink = out[opt->n - 1];
+
+	/* bulk output must equal single draws from the same state, */
+	/* starting off a lane boundary								*/
+	MicroError err;
+	vZeroMemory(&err, sizeof(err));
+	if (bulk)
+	{
+		vPXRandStream fillStream, singleStream;
+		vPXRandStreamSeed(&fillStream, opt->seed + 1);
+		vPXRandStreamNext(&fillStream);
+		singleStream = fillStream;
+
+		vPXRandStreamFill(&fillStream, out, opt->n, -1.0f, 1.0f);
+		for (vUI32 i = 0; i < opt->n; i++)
+		{
+			vFloat ref = vPXRandStreamRange(&singleStream, -1.0f, 1.0f);
+			MicroErrorAdd(&err, fabs(out[i] - ref));
+			if (out[i] != ref) err.mismatches++;
+		}
+	}
+
+	MicroReport(bulk ? "vPXRandStreamFill" : "vPXRandStreamRange",
+		(vUI64)opt->n * opt->reps, seconds, "abs", &err);
+}
+
+
+/* ========== ENTRY								==========	*/
+static vBOOL MicroParseArgs(int argc, char** argv, PMicroOptions opt)
+{
+	opt->n     = MICRO_N_DEFAULT;
+	opt->pairs = MICRO_PAIRS_DEFAULT;
+	opt->reps  = MICRO_REPS_DEFAULT;
+	opt->seed  = 0x2022;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--n") == 0)          opt->n = atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--pairs") == 0) opt->pairs = atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--reps") == 0)  opt->reps = atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--seed") == 0)  opt->seed = atoi(argv[i + 1]);
+		else return FALSE;
+	}
+	if ((argc & 1) == 0) return FALSE;
+
+	return opt->n > 0 && opt->pairs > 0 && opt->reps > 0;
+}
+
+int main(int argc, char** argv)
+{
+	MicroOptions opt;
+	if (MicroParseArgs(argc, argv, &opt) == FALSE)
+	{
+		fprintf(stderr, "usage: vpxmicro [--n N] [--pairs P] [--reps R] "
+			"[--seed S]\n");
+		return 1;
+	}
+	__microRng = opt.seed ? opt.seed : 1;
+
+	/* vector inputs span several magnitudes */
+	vPVect  input  = vAlloc(sizeof(vVect) * opt.n);
+	vPVect  work   = vAlloc(sizeof(vVect) * opt.n);
+	vPFloat angles = vAlloc(sizeof(vFloat) * opt.n);
+	for (vUI32 i = 0; i < opt.n; i++)
+	{
+		float scale = powf(10.0f, MicroRandom(-2.0f, 3.0f));
+		input[i]  = vCreatePosition(MicroRandom(-1.0f, 1.0f) * scale,
+			MicroRandom(-1.0f, 1.0f) * scale);
+		angles[i] = MicroRandom(-180.0f, 180.0f);
+	}
+
+	/* body pairs, roughly half of them overlapping */
+	vPPhysical bodies = vAlloc(sizeof(vPhysical) * opt.pairs * 2);
+	PMicroDBox dboxes = vAlloc(sizeof(MicroDBox) * opt.pairs * 2);
+	for (vUI32 i = 0; i < opt.pairs * 2; i++) MicroBuildBox(bodies + i, dboxes + i);
+
+	/* collision response works on the default world's body store */
+	vPXInitializeHeadless(NULL, 1);
+	for (vUI32 i = 0; i < opt.pairs * 2; i++)
+		PXBodyStoreAdd(vPXGetDefaultWorld(), bodies + i);
+
+	/* circle pairs, never added to the store */
+	vPXShapeID circle = vPXCreateCircleShape(1.0f);
+	vPPhysical circles = vAlloc(sizeof(vPhysical) * opt.pairs * 2);
+	PMicroDBox dcircles = vAlloc(sizeof(MicroDBox) * opt.pairs * 2);
+	for (vUI32 i = 0; i < opt.pairs * 2; i++)
+		MicroBuildCircle(circles + i, dcircles + i, circle);
+
+	MicroBenchRotate(&opt, input, angles, work, FALSE);
+	MicroBenchRotate(&opt, input, angles, work, TRUE);
+	MicroBenchMagnitude(&opt, input, FALSE);
+	MicroBenchMagnitude(&opt, input, TRUE);
+	MicroBenchNormalize(&opt, input, work);
+	MicroBenchPreEstimate(&opt, bodies, dboxes);
+	MicroBenchSAT(&opt, bodies, dboxes);
+	MicroBenchShapes(&opt, bodies, dboxes, FALSE);
+	MicroBenchShapes(&opt, circles, dcircles, TRUE);
+	MicroBenchAngularForce(&opt, bodies);
+	MicroBenchRand(&opt, (vPFloat)work, FALSE);
+	MicroBenchRand(&opt, (vPFloat)work, TRUE);
+
+	vFree(input);
+	vFree(work);
+	vFree(angles);
+	vFree(bodies);
+	vFree(dboxes);
+	vFree(circles);
+	vFree(dcircles);
+	return 0;
+}
@@ -0,0 +1,692 @@
+/* ========== <vbodystore.c>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Internal structure-of-arrays body storage				*/
+/* The simulation passes work on the packed arrays here;	*/
+/* each vPhysical is a view that is gathered from at the	*/
+/* start of a tick once touched, and has the fields the	*/
+/* tick moved scattered back to it at the end.				*/
+
+
+/* ========== INCLUDES							==========	*/
+#include "vbodystore.h"
+#include "vspacepart.h"
+#include <stddef.h>
+#include <math.h>
+#include <string.h>
+
+
+/* ========== FIELD TABLE						==========	*/
+/* every per-body array in the store, so growing, moving	*/
+/* and reordering bodies cannot miss one					*/
+typedef struct PXBodyField
+{
+	SIZE_T offset;	/* offset of array pointer in PXBodyStore	*/
+	SIZE_T size;	/* element size								*/
+} PXBodyField;
+
+#define PXBODYFIELD(name, type) { offsetof(PXBodyStore, name), sizeof(type) }
+
+static const PXBodyField __bodyFields[] =
+{
+	PXBODYFIELD(physical,			 vPPhysical),
+	PXBODYFIELD(handle,				 vPXHandle),
+	PXBODYFIELD(position,			 vVect),
+	PXBODYFIELD(rotation,			 vFloat),
+	PXBODYFIELD(scale,				 vFloat),
+	PXBODYFIELD(velocity,			 vVect),
+	PXBODYFIELD(acceleration,		 vVect),
+	PXBODYFIELD(angularVelocity,	 vFloat),
+	PXBODYFIELD(angularAcceleration, vFloat),
+	PXBODYFIELD(mass,				 vFloat),
+	PXBODYFIELD(drag,				 vFloat),
+	PXBODYFIELD(friction,			 vFloat),
+	PXBODYFIELD(bound,				 vGRect),
+	PXBODYFIELD(shape,				 vPXShapeID),
+	PXBODYFIELD(collideLayer,		 vUI8),
+	PXBODYFIELD(fieldLayer,			 vUI8),
+	PXBODYFIELD(flags,				 vUI8),
+	PXBODYFIELD(age,				 vUI64),
+	PXBODYFIELD(lastStepTick,		 vUI64),
+	PXBODYFIELD(updateFunc,			 vPXPFPHYSICALUPDATEFUNC),
+	PXBODYFIELD(anticipatedPos,		 vVect),
+	PXBODYFIELD(worldBound,			 vPXWorldBoundMesh),
+	PXBODYFIELD(drawTick,			 vUI64),
+	PXBODYFIELD(queryTick,			 vUI64),
+	PXBODYFIELD(querySlot,			 vUI32),
+	PXBODYFIELD(lodTier,			 vUI8),
+	PXBODYFIELD(viewSync,			 vUI8),
+	PXBODYFIELD(hull,				 vUI32),
+	PXBODYFIELD(boundOrigin,		 vVect),
+	PXBODYFIELD(boundRotation,		 vFloat),
+	PXBODYFIELD(boundScale,			 vFloat),
+	PXBODYFIELD(boundDirty,			 vUI8),
+};
+
+#define BODYFIELD_COUNT (sizeof(__bodyFields) / sizeof(PXBodyField))
+
+static vUI8** PXBodyFieldArray(PPXBodyStore store, vUI32 field)
+{
+	return (vUI8**)((vUI8*)store + __bodyFields[field].offset);
+}
+
+
+/* ========== HELPERS							==========	*/
+static void PXBodyStoreGrowArray(vPTR* array, SIZE_T elementSize,
+	vUI32 oldCapacity, vUI32 newCapacity)
+{
+	vPTR newArray = vAllocZeroed(elementSize * newCapacity);
+	if (*array != NULL) vMemCopy(newArray, *array, elementSize * oldCapacity);
+	vFree(*array);
+	*array = newArray;
+}
+
+static void PXBodyStoreEnsureCapacity(vPPXWorld world, vUI32 required)
+{
+	PPXBodyStore store = &world->bodies;
+	if (store->capacity >= required) return;
+
+	vUI32 oldCap = store->capacity;
+	vUI32 newCap = max(BODYSTORE_CAPACITY_MIN, oldCap);
+	while (newCap < required) newCap <<= 1;
+
+	for (vUI32 f = 0; f < BODYFIELD_COUNT; f++)
+	{
+		PXBodyStoreGrowArray(PXBodyFieldArray(store, f), __bodyFields[f].size,
+			oldCap, newCap);
+	}
+
+	/* sort scratch holds the largest field or the sort keys */
+	PXBodyStoreGrowArray(&store->sortKey, sizeof(vUI32), oldCap, newCap);
+	PXBodyStoreGrowArray(&store->sortOrder, sizeof(vUI32), oldCap, newCap);
+	PXBodyStoreGrowArray(&store->sortScratch, sizeof(vPXWorldBoundMesh),
+		oldCap, newCap);
+
+	store->capacity = newCap;
+}
+
+static void PXBodyStoreMove(vPPXWorld world, vUI32 dst, vUI32 src)
+{
+	PPXBodyStore store = &world->bodies;
+
+	for (vUI32 f = 0; f < BODYFIELD_COUNT; f++)
+	{
+		vUI8*  array = *PXBodyFieldArray(store, f);
+		SIZE_T size  = __bodyFields[f].size;
+		vMemCopy(array + dst * size, array + src * size, size);
+	}
+
+	/* repoint the moved body's handle */
+	store->slots[store->handle[dst] & PX_HANDLE_INDEX_MASK].body = dst;
+}
+
+static vPXHandle PXBodyStoreAllocateHandle(vPPXWorld world, vUI32 body)
+{
+	PPXBodyStore store = &world->bodies;
+
+	/* reuse a released slot, keeping its bumped generation */
+	vUI32 slot = store->freeSlot;
+	if (slot != PX_BODY_NONE)
+	{
+		store->freeSlot = store->slots[slot].body;
+	}
+	else
+	{
+		if (store->slotCount == store->slotCapacity)
+		{
+			vUI32 newCapacity = max(BODYSTORE_CAPACITY_MIN, store->slotCapacity << 1);
+			PXBodyStoreGrowArray(&store->slots, sizeof(PXHandleSlot),
+				store->slotCapacity, newCapacity);
+			store->slotCapacity = newCapacity;
+		}
+		slot = store->slotCount++;
+		store->slots[slot].generation = 1;
+	}
+
+	store->slots[slot].body  = body;
+	store->slots[slot].inUse = TRUE;
+	return ((vPXHandle)store->slots[slot].generation << PX_HANDLE_INDEX_BITS) | slot;
+}
+
+static void PXBodyStoreReleaseHandle(vPPXWorld world, vPXHandle handle)
+{
+	PPXBodyStore store = &world->bodies;
+	vUI32 slot = handle & PX_HANDLE_INDEX_MASK;
+
+	/* bump generation so old handles no longer resolve. a slot	*/
+	/* that runs out of generations is retired, never reused,	*/
+	/* as wrapping would bring back handles long since stale	*/
+	store->slots[slot].inUse = FALSE;
+	if (store->slots[slot].generation == PX_HANDLE_GENERATION_MASK)
+	{
+		store->slots[slot].body = PX_BODY_NONE;
+		return;
+	}
+	store->slots[slot].generation++;
+
+	store->slots[slot].body = store->freeSlot;
+	store->freeSlot = slot;
+}
+
+static vUI32 PXBodyStoreInsert(vPPXWorld world, vPPhysical phys,
+	vPXHandle handle)
+{
+	PPXBodyStore store = &world->bodies;
+	PXBodyStoreEnsureCapacity(world, store->count + 1);
+
+	vUI32 body = store->count++;
+	store->slots[handle & PX_HANDLE_INDEX_MASK].body  = body;
+	store->slots[handle & PX_HANDLE_INDEX_MASK].inUse = TRUE;
+
+	store->physical[body]   = phys;
+	store->handle[body]     = handle;
+	store->drawTick[body]   = 0;
+	store->queryTick[body]  = 0;
+	store->lodTier[body]    = PX_LOD_FULL;
+	store->hull[body]       = PX_BODY_NONE;
+	store->lastStepTick[body] = world->stats.tickCount;
+	store->boundDirty[body] = TRUE;
+	store->worldBound[body] = phys->worldBound;
+	phys->handle = handle;
+
+	/* edits made between creation and the first tick count */
+	PXBodyStoreGather(world, body);
+	store->viewSync[body] = PX_VIEW_DIRTY;
+	return body;
+}
+
+static void PXBodyStoreDetach(vPPXWorld world, vUI32 body)
+{
+	PPXBodyStore store = &world->bodies;
+
+	/* deterministic worlds leave a hole that is closed in order	*/
+	/* by the next compaction, so body order only ever depends	*/
+	/* on creation order (holes left from an earlier deterministic	*/
+	/* period must also be compacted first)						*/
+	if (world->deterministic == TRUE || store->removed > 0)
+	{
+		store->physical[body] = NULL;
+		store->removed++;
+		return;
+	}
+
+	/* swap last body into the hole to stay packed */
+	vUI32 last = --store->count;
+	if (body != last) PXBodyStoreMove(world, body, last);
+}
+
+
+/* ========== BODY STORE FUNCTIONS				==========	*/
+void PXBodyStoreInit(vPPXWorld world)
+{
+	vZeroMemory(&world->bodies, sizeof(PXBodyStore));
+	world->bodies.freeSlot    = PX_BODY_NONE;
+	world->bodies.sortEnabled = TRUE;
+}
+
+void PXBodyStoreFree(vPPXWorld world)
+{
+	PPXBodyStore store = &world->bodies;
+
+	/* detach remaining views, their component destroy becomes a no-op */
+	for (vUI32 body = 0; body < store->count; body++)
+	{
+		if (store->physical[body] != NULL)
+			store->physical[body]->world = NULL;
+	}
+
+	for (vUI32 f = 0; f < BODYFIELD_COUNT; f++)
+		vFree(*PXBodyFieldArray(store, f));
+	vFree(store->slots);
+	vFree(store->freeViews);
+	vFree(store->hulls);
+
+	while (store->viewBlocks != NULL)
+	{
+		PPXBodyBlock next = store->viewBlocks->next;
+		vFree(store->viewBlocks->views);
+		vFree(store->viewBlocks);
+		store->viewBlocks = next;
+	}
+
+	vFree(store->sortKey);
+	vFree(store->sortOrder);
+	vFree(store->sortScratch);
+	vZeroMemory(store, sizeof(PXBodyStore));
+}
+
+vUI32 PXBodyStoreAdd(vPPXWorld world, vPPhysical phys)
+{
+	vPXHandle handle = PXBodyStoreAllocateHandle(world, world->bodies.count);
+	return PXBodyStoreInsert(world, phys, handle);
+}
+
+void PXBodyStoreRemove(vPPXWorld world, vUI32 body)
+{
+	PXBodyStoreReleaseHandle(world, world->bodies.handle[body]);
+	PXBodyStoreDetach(world, body);
+}
+
+void PXBodyStorePage(vPPXWorld world, vUI32 body)
+{
+	/* the slot stays reserved, resolving to nothing until the	*/
+	/* body is brought back under the same handle				*/
+	PPXBodyStore store = &world->bodies;
+	PPXHandleSlot slot = store->slots +
+		(store->handle[body] & PX_HANDLE_INDEX_MASK);
+	slot->body  = PX_BODY_NONE;
+	slot->inUse = PX_SLOT_PAGED;
+	PXBodyStoreDetach(world, body);
+}
+
+vUI32 PXBodyStoreUnpage(vPPXWorld world, vPPhysical phys, vPXHandle handle)
+{
+	PPXBodyStore store = &world->bodies;
+	PPXHandleSlot slot = store->slots + (handle & PX_HANDLE_INDEX_MASK);
+	if ((handle & PX_HANDLE_INDEX_MASK) >= store->slotCount ||
+		slot->inUse != PX_SLOT_PAGED ||
+		slot->generation != (handle >> PX_HANDLE_INDEX_BITS))
+		return PX_BODY_NONE;
+
+	return PXBodyStoreInsert(world, phys, handle);
+}
+
+void PXBodyStoreCompact(vPPXWorld world)
+{
+	PPXBodyStore store = &world->bodies;
+	if (store->removed == 0) return;
+
+	/* slide live bodies down over the holes, keeping their order */
+	vUI32 write = 0;
+	for (vUI32 read = 0; read < store->count; read++)
+	{
+		if (store->physical[read] == NULL) continue;
+		if (write != read) PXBodyStoreMove(world, write, read);
+		write++;
+	}
+
+	store->count   = write;
+	store->removed = 0;
+}
+
+void PXBodyStoreReserve(vPPXWorld world, vUI32 bodies, vUI32 slots)
+{
+	PPXBodyStore store = &world->bodies;
+	PXBodyStoreEnsureCapacity(world, bodies);
+
+	if (store->slotCapacity >= slots) return;
+	PXBodyStoreGrowArray(&store->slots, sizeof(PXHandleSlot),
+		store->slotCapacity, slots);
+	store->slotCapacity = slots;
+}
+
+vPPhysical PXBodyStoreAllocateViews(vPPXWorld world, vUI32 count)
+{
+	/* one block for many views, freed with the store. views	*/
+	/* given back go through PXBodyStoreReleaseView instead		*/
+	PPXBodyBlock block = vAllocZeroed(sizeof(PXBodyBlock));
+	block->views = vAllocZeroed(sizeof(vPhysical) * max(1, count));
+	block->count = count;
+	block->next  = world->bodies.viewBlocks;
+	world->bodies.viewBlocks = block;
+	world->bodies.viewBlockUsed = count;
+	return block->views;
+}
+
+vPPhysical PXBodyStoreAcquireView(vPPXWorld world)
+{
+	PPXBodyStore store = &world->bodies;
+
+	/* reuse a view given back by paging or destroy first */
+	vPPhysical phys;
+	if (store->freeViewCount > 0)
+	{
+		phys = store->freeViews[--store->freeViewCount];
+	}
+	else
+	{
+		if (store->viewBlocks == NULL ||
+			store->viewBlockUsed == store->viewBlocks->count)
+		{
+			PXBodyStoreAllocateViews(world, BODYSTORE_VIEW_BLOCK);
+			store->viewBlockUsed = 0;
+		}
+		phys = store->viewBlocks->views + store->viewBlockUsed++;
+	}
+
+	vZeroMemory(phys, sizeof(vPhysical));
+	phys->world = world;
+	return phys;
+}
+
+void PXBodyStoreReleaseView(vPPXWorld world, vPPhysical phys)
+{
+	PPXBodyStore store = &world->bodies;
+	if (store->freeViewCount == store->freeViewCapacity)
+	{
+		vUI32 newCapacity = max(BODYSTORE_CAPACITY_MIN,
+			store->freeViewCapacity << 1);
+		PXBodyStoreGrowArray(&store->freeViews, sizeof(vPPhysical),
+			store->freeViewCapacity, newCapacity);
+		store->freeViewCapacity = newCapacity;
+	}
+
+	phys->world = NULL;
+	store->freeViews[store->freeViewCount++] = phys;
+}
+
+vUI32 PXBodyStoreResolve(vPPXWorld world, vPXHandle handle)
+{
+	PPXBodyStore store = &world->bodies;
+	vUI32 slot = handle & PX_HANDLE_INDEX_MASK;
+	vUI32 generation = handle >> PX_HANDLE_INDEX_BITS;
+
+	/* stale or foreign handles resolve to nothing */
+	if (slot >= store->slotCount) return PX_BODY_NONE;
+	if (store->slots[slot].inUse == FALSE) return PX_BODY_NONE;
+	if (store->slots[slot].generation != generation) return PX_BODY_NONE;
+	return store->slots[slot].body;
+}
+
+
+/* ========== SPATIAL ORDERING					==========	*/
+static vUI32 PXMortonKey(vPPXWorld world, vVect position)
+{
+	return PXCellMortonKey((vI32)floorf(position.x / world->partitionSize),
+		(vI32)floorf(position.y / world->partitionSize));
+}
+
+static vFloat PXBodyStoreMeasureDisorder(vPPXWorld world)
+{
+	/* fraction of neighbouring bodies whose keys step backwards, */
+	/* ~0 just after a sort and ~0.5 for a random order			  */
+	PPXBodyStore store = &world->bodies;
+	if (store->count < 2) return 0.0f;
+
+	vUI32 descents = 0;
+	vUI32 prevKey = store->sortKey[0] = PXMortonKey(world, store->position[0]);
+	for (vUI32 body = 1; body < store->count; body++)
+	{
+		vUI32 key = store->sortKey[body] = PXMortonKey(world, store->position[body]);
+		if (key < prevKey) descents++;
+		prevKey = key;
+	}
+	return (vFloat)descents / (vFloat)(store->count - 1);
+}
+
+static void PXBodyStoreSortByKey(vPPXWorld world)
+{
+	PPXBodyStore store = &world->bodies;
+	/* order bodies by key, then move every field into that order */
+	vPUI32 order = store->sortOrder;
+	PXCellSortByKey(store->sortKey, store->count, order,
+		(vPUI32)store->sortScratch);
+	for (vUI32 f = 0; f < BODYFIELD_COUNT; f++)
+	{
+		vUI8*  array = *PXBodyFieldArray(store, f);
+		vUI8*  scratch = store->sortScratch;
+		SIZE_T size = __bodyFields[f].size;
+
+		for (vUI32 i = 0; i < store->count; i++)
+			vMemCopy(scratch + i * size, array + order[i] * size, size);
+		vMemCopy(array, scratch, size * store->count);
+	}
+
+	/* repoint every handle */
+	for (vUI32 body = 0; body < store->count; body++)
+		store->slots[store->handle[body] & PX_HANDLE_INDEX_MASK].body = body;
+}
+
+vBOOL PXBodyStoreSpatialSort(vPPXWorld world)
+{
+	PPXBodyStore store = &world->bodies;
+	if (store->sortEnabled == FALSE) return FALSE;
+
+	/* deterministic worlds keep bodies in creation order */
+	if (world->deterministic == TRUE) return FALSE;
+
+	/* measuring is a pass over all positions, so only do it periodically */
+	vUI64 tick = world->stats.tickCount;
+	if (tick % BODYSORT_CHECK_INTERVAL != 0) return FALSE;
+
+	store->disorder = PXBodyStoreMeasureDisorder(world);
+	world->stats.bodyDisorder = store->disorder;
+
+	/* resort once bodies have drifted far enough out of order */
+	if (store->disorder < BODYSORT_DISORDER_THRESHOLD) return FALSE;
+	if (tick - store->lastSortTick < BODYSORT_INTERVAL_MIN &&
+		store->lastSortTick != 0) return FALSE;
+
+	PXBodyStoreSortByKey(world);
+	store->lastSortTick = max(1, tick);
+	world->stats.bodySorts++;
+	return TRUE;
+}
+
+
+/* ========== VIEW SYNCHRONIZATION				==========	*/
+void PXBodyStoreGather(vPPXWorld world, vUI32 body)
+{
+	/* pull everything the user may write through the view */
+	PPXBodyStore store = &world->bodies;
+	vPPhysical phys = store->physical[body];
+
+	store->position[body]            = phys->transform.position;
+	store->rotation[body]            = phys->transform.rotation;
+	store->scale[body]               = phys->transform.scale;
+	store->velocity[body]            = phys->velocity;
+	store->acceleration[body]        = phys->acceleration;
+	store->angularVelocity[body]     = phys->angularVelocity;
+	store->angularAcceleration[body] = phys->angularAcceleration;
+	store->mass[body]                = phys->mass;
+	store->drag[body]                = phys->drag;
+	store->friction[body]            = phys->friction;
+
+	/* a new bound or shape invalidates the cached world bound,	*/
+	/* position, rotation and scale are compared during setup	*/
+	vPXShapeID shape = (phys->shape < store->shapeCount) ?
+		phys->shape : PX_SHAPE_BOUND;
+	if (shape != store->shape[body] ||
+		memcmp(&phys->bound, store->bound + body, sizeof(vGRect)) != 0)
+		store->boundDirty[body] = TRUE;
+	store->bound[body]               = phys->bound;
+	store->shape[body]               = shape;
+	store->collideLayer[body]        = phys->properties.collideLayer;
+	store->fieldLayer[body]          = phys->properties.fieldLayer;
+	store->age[body]                 = phys->age;
+	store->updateFunc[body]          = phys->updateFunc;
+
+	vUI8 flags = 0;
+	if (phys->properties.isActive)            flags |= PX_BODY_ACTIVE;
+	if (phys->properties.noPartitionOptimize) flags |= PX_BODY_NO_PARTITION_OPTIMIZE;
+	if (phys->properties.isSensor)            flags |= PX_BODY_SENSOR;
+	if (phys->properties.staticPosition)      flags |= PX_BODY_STATIC;
+	if (phys->properties.threadSafeUpdate)    flags |= PX_BODY_THREADSAFE_UPDATE;
+	store->flags[body] = flags;
+}
+
+void PXBodyStoreScatter(vPPXWorld world, vUI32 body)
+{
+	/* push simulation results back out to the view */
+	PPXBodyStore store = &world->bodies;
+	vPPhysical phys = store->physical[body];
+
+	phys->transform.position  = store->position[body];
+	phys->transform.rotation  = store->rotation[body];
+	phys->velocity            = store->velocity[body];
+	phys->acceleration        = store->acceleration[body];
+	phys->angularVelocity     = store->angularVelocity[body];
+	phys->angularAcceleration = store->angularAcceleration[body];
+	phys->age                 = store->age[body];
+	phys->anticipatedPos      = store->anticipatedPos[body];
+	phys->worldBound          = store->worldBound[body];
+	store->viewSync[body]    &= ~PX_VIEW_BOUND;
+}
+
+void PXBodyStoreFillView(vPPXWorld world, vUI32 body)
+{
+	/* write every stored field out, for views created */
+	/* after the store was filled directly				*/
+	PPXBodyStore store = &world->bodies;
+	vPPhysical phys = store->physical[body];
+
+	PXBodyStoreScatter(world, body);
+	phys->handle          = store->handle[body];
+	phys->transform.scale = store->scale[body];
+	phys->mass            = store->mass[body];
+	phys->drag            = store->drag[body];
+	phys->friction        = store->friction[body];
+	phys->bound           = store->bound[body];
+	phys->shape           = store->shape[body];
+	phys->updateFunc      = store->updateFunc[body];
+	phys->properties.collideLayer        = store->collideLayer[body];
+	phys->properties.fieldLayer          = store->fieldLayer[body];
+	phys->properties.isActive            =
+		(store->flags[body] & PX_BODY_ACTIVE) != 0;
+	phys->properties.noPartitionOptimize =
+		(store->flags[body] & PX_BODY_NO_PARTITION_OPTIMIZE) != 0;
+	phys->properties.isSensor =
+		(store->flags[body] & PX_BODY_SENSOR) != 0;
+	phys->properties.threadSafeUpdate =
+		(store->flags[body] & PX_BODY_THREADSAFE_UPDATE) != 0;
+}
+
+PPXShapeHull PXBodyStoreAddHull(vPPXWorld world, vUI32 body)
+{
+	PPXBodyStore store = &world->bodies;
+	if (store->hullCount == store->hullCapacity)
+	{
+		vUI32 newCapacity = max(BODYSTORE_CAPACITY_MIN, store->hullCapacity << 1);
+		PXBodyStoreGrowArray(&store->hulls, sizeof(PXShapeHull),
+			store->hullCapacity, newCapacity);
+		store->hullCapacity = newCapacity;
+	}
+
+	store->hull[body] = store->hullCount;
+	return store->hulls + store->hullCount++;
+}
+
+void PXBodyStoreTouch(vPPXWorld world, vUI32 body)
+{
+	world->bodies.viewSync[body] |= PX_VIEW_DIRTY;
+}
+
+void PXBodyStoreGatherTouched(vPPXWorld world)
+{
+	PPXBodyStore store = &world->bodies;
+	for (vUI32 body = 0; body < store->count; body++)
+	{
+		if ((store->viewSync[body] & PX_VIEW_DIRTY) == 0) continue;
+		if (store->physical[body] == NULL) continue;
+		PXBodyStoreGather(world, body);
+		store->viewSync[body] &= ~PX_VIEW_DIRTY;
+	}
+}
+
+void PXBodyStoreScatterTick(vPPXWorld world)
+{
+	/* only what a tick moves goes back out. the world bound is	*/
+	/* the bulk of a view, so it is only written once rebuilt	*/
+	PPXBodyStore store = &world->bodies;
+	vBOOL renderLocked = FALSE;
+	for (vUI32 body = 0; body < store->count; body++)
+	{
+		vPPhysical phys = store->physical[body];
+		if (phys == NULL) continue;
+
+		phys->transform.position  = store->position[body];
+		phys->transform.rotation  = store->rotation[body];
+		phys->velocity            = store->velocity[body];
+		phys->acceleration        = store->acceleration[body];
+		phys->angularVelocity     = store->angularVelocity[body];
+		phys->angularAcceleration = store->angularAcceleration[body];
+		phys->age                 = store->age[body];
+		phys->anticipatedPos      = store->anticipatedPos[body];
+		if (store->viewSync[body] & PX_VIEW_BOUND)
+		{
+			phys->worldBound = store->worldBound[body];
+			store->viewSync[body] &= ~PX_VIEW_BOUND;
+		}
+
+		/* update renderable transform (if applicable), holding	*/
+		/* the graphics lock once for every body				*/
+		if ((store->flags[body] & PX_BODY_ACTIVE) &&
+			phys->renderableTransformOverride == TRUE &&
+			phys->renderableCache != NULL)
+		{
+			if (renderLocked == FALSE) vGLock();
+			renderLocked = TRUE;
+			phys->renderableCache->transform = phys->transform;
+		}
+	}
+	if (renderLocked == TRUE) vGUnlock();
+}
+
+
+/* ========== STATE HASHING						==========	*/
+vUI64 PXHashBytes(vUI64 hash, vPTR data, SIZE_T size)
+{
+	/* FNV-1a, folded a 32 bit word at a time */
+	vUI8* bytes = data;
+	SIZE_T i = 0;
+	for (; i + sizeof(vUI32) <= size; i += sizeof(vUI32))
+	{
+		vUI32 word;
+		memcpy(&word, bytes + i, sizeof(vUI32));
+		hash ^= word;
+		hash *= PX_HASH_PRIME;
+	}
+	for (; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= PX_HASH_PRIME;
+	}
+	return hash;
+}
+
+/* one body's entry of a store array, for PXBodyStoreHash */
+#define PXHASHFIELD(name) \
+	hash = PXHashBytes(hash, store->name + body, sizeof(*store->name))
+
+vUI64 PXBodyStoreHash(vPPXWorld world, vUI64 hash)
+{
+	/* every field that carries state into the next tick, body	*/
+	/* by body in handle order, so storage order and holes do	*/
+	/* not count; tick intermediates are derived from these		*/
+	PPXBodyStore store = &world->bodies;
+	vUI32 live = 0;
+	for (vUI32 slot = 0; slot < store->slotCount; slot++)
+	{
+		PPXHandleSlot entry = store->slots + slot;
+		if (entry->inUse == FALSE) continue;
+
+		hash = PXHashBytes(hash, &slot, sizeof(slot));
+		hash = PXHashBytes(hash, &entry->generation, sizeof(vUI16));
+		hash = PXHashBytes(hash, &entry->inUse, sizeof(vUI16));
+
+		/* a paged body's state is in the page file */
+		if (entry->inUse != TRUE) continue;
+
+		vUI32 body = entry->body;
+		PXHASHFIELD(position);
+		PXHASHFIELD(rotation);
+		PXHASHFIELD(scale);
+		PXHASHFIELD(velocity);
+		PXHASHFIELD(angularVelocity);
+		PXHASHFIELD(mass);
+		PXHASHFIELD(drag);
+		PXHASHFIELD(friction);
+		PXHASHFIELD(bound);
+		PXHASHFIELD(shape);
+		PXHASHFIELD(collideLayer);
+		PXHASHFIELD(fieldLayer);
+		PXHASHFIELD(flags);
+		PXHASHFIELD(age);
+		PXHASHFIELD(lastStepTick);
+		live++;
+	}
+
+	hash = PXHashBytes(hash, &live, sizeof(live));
+	hash = PXHashBytes(hash, &store->shapeCount, sizeof(vUI32));
+	hash = PXHashBytes(hash, store->shapes, sizeof(PXShape) * store->shapeCount);
+	return hash;
+}
@@ -0,0 +1,55 @@
+/* ========== <vbodystore.h>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Internal structure-of-arrays body storage				*/
+
+#ifndef _VPHYS_INTERNAL_BODYSTORE_INCLUDE_
+#define _VPHYS_INTERNAL_BODYSTORE_INCLUDE_
+
+
+/* ========== INCLUDES							==========	*/
+#include "vphys.h"
+
+
+/* ========== BODY STORE FUNCTIONS				==========	*/
+void  PXBodyStoreInit(vPPXWorld world);
+void  PXBodyStoreFree(vPPXWorld world);
+vUI32 PXBodyStoreAdd(vPPXWorld world, vPPhysical phys);
+void  PXBodyStoreRemove(vPPXWorld world, vUI32 body);
+vUI32 PXBodyStoreResolve(vPPXWorld world, vPXHandle handle);
+void  PXBodyStoreCompact(vPPXWorld world);
+void  PXBodyStoreReserve(vPPXWorld world, vUI32 bodies, vUI32 slots);
+vPPhysical PXBodyStoreAllocateViews(vPPXWorld world, vUI32 count);
+
+
+/* ========== PAGING							==========	*/
+/* paged bodies leave the store but keep their handle slot	*/
+void  PXBodyStorePage(vPPXWorld world, vUI32 body);
+vUI32 PXBodyStoreUnpage(vPPXWorld world, vPPhysical phys, vPXHandle handle);
+/* headless views, taken from a free list or a shared block	*/
+/* and given back when their body is paged or destroyed		*/
+vPPhysical PXBodyStoreAcquireView(vPPXWorld world);
+void       PXBodyStoreReleaseView(vPPXWorld world, vPPhysical phys);
+
+
+/* ========== SPATIAL ORDERING					==========	*/
+vBOOL PXBodyStoreSpatialSort(vPPXWorld world);
+
+
+/* ========== VIEW SYNCHRONIZATION				==========	*/
+void PXBodyStoreGather(vPPXWorld world, vUI32 body);
+void PXBodyStoreScatter(vPPXWorld world, vUI32 body);
+void PXBodyStoreTouch(vPPXWorld world, vUI32 body);
+/* a hull for body, valid until the next setup clears them	*/
+PPXShapeHull PXBodyStoreAddHull(vPPXWorld world, vUI32 body);
+/* views are gathered only once touched, and get back only	*/
+/* the fields a tick writes									*/
+void PXBodyStoreGatherTouched(vPPXWorld world);
+void PXBodyStoreScatterTick(vPPXWorld world);
+void PXBodyStoreFillView(vPPXWorld world, vUI32 body);
+
+
+/* ========== STATE HASHING						==========	*/
+vUI64 PXHashBytes(vUI64 hash, vPTR data, SIZE_T size);
+vUI64 PXBodyStoreHash(vPPXWorld world, vUI64 hash);
+
+#endif
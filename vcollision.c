@@ -5,53 +5,518 @@
 
 /* ========== INCLUDES							==========	*/
 #include "vcollision.h"
+#include "vphysshape.h"
+#include "vbodystore.h"
 #include <stdio.h>
+#include <math.h>
+#include <float.h>
 
 
 
 /* ========== INTERNAL STRUCTS					==========	*/
-typedef struct PXProjectionPlane
+typedef vBOOL (*PXPFSHAPEPAIRFUNC)(PPXShapeInstance source,
+	PPXShapeInstance target, vPVect pushVector, vPFloat pushVectorMagnitude);
+
+
+/* ========== HELPER							==========	*/
+static vVect PXShapeRotate(vVect axis, vVect v)
 {
-	vVect  vert1;
-	vVect  vert2;
-	vVect  planeVector;
-	vFloat planeVectorMag;
-} PXProjectionPlane, *PPXProjectionPlane;
+	return vPXCreateVect(v.x * axis.x - v.y * axis.y,
+		v.x * axis.y + v.y * axis.x);
+}
 
+static vVect PXShapePoint(PPXShapeInstance inst, vVect local)
+{
+	vVect v = PXShapeRotate(inst->worldBound->axis, local);
+	return vPXCreateVect(inst->origin.x + v.x * inst->scale,
+		inst->origin.y + v.y * inst->scale);
+}
 
+static vFloat PXClamp(vFloat v, vFloat low, vFloat high)
+{
+	return max(low, min(high, v));
+}
 
-/* ========== HELPER							==========	*/
-PXProjectionPlane PXGenerateProjectionPlane(vVect v1, vVect v2)
+static vBOOL PXPointsCoincide(vVect a, vVect b)
+{
+	vFloat dx = a.x - b.x, dy = a.y - b.y;
+	return dx * dx + dy * dy < VPHYS_EPSILON * VPHYS_EPSILON;
+}
+
+static vVect PXClosestOnSegment(vVect p, vVect a, vVect b)
+{
+	vVect  ab = vPXCreateVect(b.x - a.x, b.y - a.y);
+	vFloat abLength = vPXVectorDotProduct(ab, ab);
+	if (abLength < VPHYS_EPSILON * VPHYS_EPSILON) return a;
+
+	vFloat t = PXClamp(((p.x - a.x) * ab.x + (p.y - a.y) * ab.y) / abLength,
+		0.0f, 1.0f);
+	return vPXCreateVect(a.x + ab.x * t, a.y + ab.y * t);
+}
+
+static void PXClosestBetweenSegments(vVect a1, vVect b1, vVect a2, vVect b2,
+	vPVect c1, vPVect c2)
+{
+	/* refer to Ericson, Real-Time Collision Detection 5.1.9 */
+	vVect  d1 = vPXCreateVect(b1.x - a1.x, b1.y - a1.y);
+	vVect  d2 = vPXCreateVect(b2.x - a2.x, b2.y - a2.y);
+	vVect  r  = vPXCreateVect(a1.x - a2.x, a1.y - a2.y);
+	vFloat a  = vPXVectorDotProduct(d1, d1);
+	vFloat e  = vPXVectorDotProduct(d2, d2);
+	vFloat f  = vPXVectorDotProduct(d2, r);
+	vFloat s, t;
+
+	if (a < VPHYS_EPSILON * VPHYS_EPSILON)
+	{
+		s = 0.0f;
+		t = (e < VPHYS_EPSILON * VPHYS_EPSILON) ? 0.0f :
+			PXClamp(f / e, 0.0f, 1.0f);
+	}
+	else
+	{
+		vFloat c = vPXVectorDotProduct(d1, r);
+		if (e < VPHYS_EPSILON * VPHYS_EPSILON)
+		{
+			t = 0.0f;
+			s = PXClamp(-c / a, 0.0f, 1.0f);
+		}
+		else
+		{
+			vFloat b = vPXVectorDotProduct(d1, d2);
+			vFloat denom = a * e - b * b;
+			s = (denom != 0.0f) ? PXClamp((b * f - c * e) / denom, 0.0f, 1.0f) :
+				0.0f;
+			t = (b * s + f) / e;
+			if (t < 0.0f)
+			{
+				t = 0.0f;
+				s = PXClamp(-c / a, 0.0f, 1.0f);
+			}
+			else if (t > 1.0f)
+			{
+				t = 1.0f;
+				s = PXClamp((b - c) / a, 0.0f, 1.0f);
+			}
+		}
+	}
+
+	*c1 = vPXCreateVect(a1.x + d1.x * s, a1.y + d1.y * s);
+	*c2 = vPXCreateVect(a2.x + d2.x * t, a2.y + d2.y * t);
+}
+
+
+/* ========== SEPARATING AXIS TEST				==========	*/
+static void PXShapeHullProject(PPXShapeHull hull, vVect axis, vPFloat minOut,
+	vPFloat maxOut)
+{
+	vFloat low, high;
+	low = high = vPXVectorDotProduct(hull->points[0], axis);
+	for (vUI32 i = 1; i < hull->pointCount; i++)
+	{
+		vFloat d = vPXVectorDotProduct(hull->points[i], axis);
+		low  = min(low, d);
+		high = max(high, d);
+	}
+	*minOut = low - hull->radius;
+	*maxOut = high + hull->radius;
+}
+
+static vBOOL PXShapeHullTestAxes(PPXShapeHull source, PPXShapeHull target,
+	vPVect axes, vUI32 axisCount, vVect displacement, vPVect bestDir,
+	vPFloat bestMag, vPVect anyDir, vPFloat anyMag)
+{
+	for (vUI32 i = 0; i < axisCount; i++)
+	{
+		vFloat sourceMin, sourceMax, targMin, targMax;
+		PXShapeHullProject(source, axes[i], &sourceMin, &sourceMax);
+		PXShapeHullProject(target, axes[i], &targMin, &targMax);
+
+		/* a region of no overlap means no collision */
+		if (sourceMax < targMin || targMax < sourceMin) return FALSE;
+		vFloat overlap = min(sourceMax, targMax) - max(sourceMin, targMin);
+
+		/* each axis stands for both of its directions, only the	*/
+		/* one pointing from target to source may push				*/
+		vFloat along = vPXVectorDotProduct(axes[i], displacement);
+		if (along != 0.0f && overlap < *bestMag)
+		{
+			*bestMag = overlap;
+			*bestDir = (along > 0.0f) ? axes[i] :
+				vPXCreateVect(-axes[i].x, -axes[i].y);
+		}
+		if (overlap < *anyMag)
+		{
+			*anyMag = overlap;
+			*anyDir = axes[i];
+		}
+	}
+	return TRUE;
+}
+
+static vUI32 PXShapeHullRoundAxes(PPXShapeHull round, PPXShapeHull other,
+	vPVect axesOut)
+{
+	/* a rounded core is separated from a corner along the line	*/
+	/* between them, which no face normal covers				*/
+	vUI32 axisCount = 0;
+	for (vUI32 i = 0; i < round->pointCount; i++)
+	{
+		vVect  p = round->points[i];
+		vVect  closest = other->points[0];
+		vFloat closestDist = FLT_MAX;
+		for (vUI32 j = 0; j < other->pointCount; j++)
+		{
+			vFloat dx = other->points[j].x - p.x;
+			vFloat dy = other->points[j].y - p.y;
+			vFloat dist = dx * dx + dy * dy;
+			if (dist >= closestDist) continue;
+			closestDist = dist;
+			closest = other->points[j];
+		}
+
+		vVect axis = vPXCreateVect(closest.x - p.x, closest.y - p.y);
+		vFloat length = vPXVectorMagnitudePrecise(axis);
+		if (length < VPHYS_EPSILON) continue;
+		axesOut[axisCount++] = vPXVectorMultiplyCopy(axis, 1.0f / length);
+	}
+	return axisCount;
+}
+
+static vBOOL PXShapeHullSAT(PPXShapeHull source, PPXShapeHull target,
+	vPVect pushVector, vPFloat pushVectorMagnitude)
+{
+	vVect displacement = vPXCreateVect(source->center.x - target->center.x,
+		source->center.y - target->center.y);
+
+	vVect  bestDir = vPXCreateVect(0.0f, 0.0f), anyDir = bestDir;
+	vFloat bestMag = 0x10000, anyMag = 0x10000; /* large value */
+
+	if (PXShapeHullTestAxes(source, target, source->axes, source->axisCount,
+		displacement, &bestDir, &bestMag, &anyDir, &anyMag) == FALSE) return FALSE;
+	if (PXShapeHullTestAxes(source, target, target->axes, target->axisCount,
+		displacement, &bestDir, &bestMag, &anyDir, &anyMag) == FALSE) return FALSE;
+
+	vVect roundAxes[2];
+	vUI32 roundAxisCount = 0;
+	if (source->radius > 0.0f)
+		roundAxisCount = PXShapeHullRoundAxes(source, target, roundAxes);
+	else if (target->radius > 0.0f)
+		roundAxisCount = PXShapeHullRoundAxes(target, source, roundAxes);
+	if (PXShapeHullTestAxes(source, target, roundAxes, roundAxisCount,
+		displacement, &bestDir, &bestMag, &anyDir, &anyMag) == FALSE) return FALSE;
+
+	/* centers that coincide leave no preferred direction */
+	if (bestMag == 0x10000)
+	{
+		bestDir = anyDir;
+		bestMag = anyMag;
+	}
+
+	*pushVector = bestDir;
+	*pushVectorMagnitude = bestMag;
+	return TRUE;
+}
+
+static vBOOL PXShapeHullSeparated(PPXShapeHull a, PPXShapeHull b,
+	vPVect axes, vUI32 axisCount)
+{
+	for (vUI32 i = 0; i < axisCount; i++)
+	{
+		vFloat aMin, aMax, bMin, bMax;
+		PXShapeHullProject(a, axes[i], &aMin, &aMax);
+		PXShapeHullProject(b, axes[i], &bMin, &bMax);
+		if (aMax < bMin || bMax < aMin) return TRUE;
+	}
+	return FALSE;
+}
+
+static vBOOL PXShapeHullOverlap(PPXShapeHull a, PPXShapeHull b)
+{
+	/* SAT stopping at the first separating axis, no push search */
+	if (PXShapeHullSeparated(a, b, a->axes, a->axisCount)) return FALSE;
+	if (PXShapeHullSeparated(a, b, b->axes, b->axisCount)) return FALSE;
+
+	vVect roundAxes[2];
+	vUI32 roundAxisCount = 0;
+	if (a->radius > 0.0f)
+		roundAxisCount = PXShapeHullRoundAxes(a, b, roundAxes);
+	else if (b->radius > 0.0f)
+		roundAxisCount = PXShapeHullRoundAxes(b, a, roundAxes);
+	return PXShapeHullSeparated(a, b, roundAxes, roundAxisCount) == FALSE;
+}
+
+static void PXShapeHullFromMesh(PPXShapeHull hull, vPPXWorldBoundMesh worldBound)
+{
+	/* a rectangle's opposite faces share an axis, two suffice */
+	vMemCopy(hull->points, worldBound->mesh, sizeof(worldBound->mesh));
+	hull->pointCount = 4;
+	hull->axes[0] = vPXCreateVect(worldBound->mesh[3].x - worldBound->mesh[0].x,
+		worldBound->mesh[3].y - worldBound->mesh[0].y);
+	hull->axes[1] = vPXCreateVect(worldBound->mesh[1].x - worldBound->mesh[0].x,
+		worldBound->mesh[1].y - worldBound->mesh[0].y);
+	vPXVectorNormalize(hull->axes + 0);
+	vPXVectorNormalize(hull->axes + 1);
+	hull->axisCount = 2;
+	hull->radius    = 0.0f;
+	hull->center    = worldBound->center;
+}
+
+static void PXShapeHullBuild(PPXShapeHull hull, PPXShapeInstance inst)
+{
+	PPXShape shape = inst->shape;
+	vVect axis = inst->worldBound->axis;
+	hull->center = inst->worldBound->center;
+	hull->radius = shape->radius * inst->scale;
+
+	switch (shape->type)
+	{
+	case PX_SHAPE_TYPE_BOX:
+		/* the world mesh already holds the corners */
+		vMemCopy(hull->points, inst->worldBound->mesh,
+			sizeof(inst->worldBound->mesh));
+		hull->pointCount = 4;
+		hull->axes[0]    = axis;
+		hull->axes[1]    = vPXCreateVect(-axis.y, axis.x);
+		hull->axisCount  = 2;
+		hull->radius     = 0.0f;
+		break;
+
+	case PX_SHAPE_TYPE_CIRCLE:
+		hull->points[0]  = inst->origin;
+		hull->pointCount = 1;
+		hull->axisCount  = 0;
+		break;
+
+	default:
+		/* capsules and polygons, normals only need rotating */
+		hull->pointCount = shape->vertCount;
+		hull->axisCount  = (shape->type == PX_SHAPE_TYPE_CAPSULE) ? 1 :
+			shape->vertCount;
+		for (vUI32 i = 0; i < hull->pointCount; i++)
+			hull->points[i] = PXShapePoint(inst, shape->verts[i]);
+		for (vUI32 i = 0; i < hull->axisCount; i++)
+			hull->axes[i] = PXShapeRotate(axis, shape->normals[i]);
+		break;
+	}
+}
+
+static PPXShapeHull PXShapeHullOf(PPXShapeInstance inst, PPXShapeHull scratch)
+{
+	/* bodies' capsules and polygons come built from setup */
+	if (inst->hull != NULL) return inst->hull;
+	PXShapeHullBuild(scratch, inst);
+	return scratch;
+}
+
+
+/* ========== SHAPE PAIRS						==========	*/
+/* every pair function pushes source out of target			*/
+static vBOOL PXShapePairSAT(PPXShapeInstance source, PPXShapeInstance target,
+	vPVect pushVector, vPFloat pushVectorMagnitude)
+{
+	PXShapeHull sourceHull, targHull;
+	return PXShapeHullSAT(PXShapeHullOf(source, &sourceHull),
+		PXShapeHullOf(target, &targHull), pushVector, pushVectorMagnitude);
+}
+
+static vBOOL PXShapePairPoints(vVect sourcePoint, vFloat sourceRadius,
+	vVect targPoint, vFloat targRadius, vPVect pushVector,
+	vPFloat pushVectorMagnitude)
+{
+	/* two rounded points, the closed form under every round pair */
+	vFloat dx = sourcePoint.x - targPoint.x;
+	vFloat dy = sourcePoint.y - targPoint.y;
+	vFloat radii = sourceRadius + targRadius;
+	vFloat distSq = dx * dx + dy * dy;
+	if (distSq > radii * radii) return FALSE;
+
+	vFloat dist = sqrtf(distSq);
+	*pushVector = (dist > 0.0f) ? vPXCreateVect(dx / dist, dy / dist) :
+		vPXCreateVect(0.0f, 1.0f);
+	*pushVectorMagnitude = radii - dist;
+	return TRUE;
+}
+
+static vBOOL PXShapePairCircleCircle(PPXShapeInstance source,
+	PPXShapeInstance target, vPVect pushVector, vPFloat pushVectorMagnitude)
+{
+	return PXShapePairPoints(source->origin, source->shape->radius * source->scale,
+		target->origin, target->shape->radius * target->scale, pushVector,
+		pushVectorMagnitude);
+}
+
+static vBOOL PXShapePairCircleBox(PPXShapeInstance source,
+	PPXShapeInstance target, vPVect pushVector, vPFloat pushVectorMagnitude)
+{
+	/* work in the box's frame, half extents from its top right corner */
+	vPPXWorldBoundMesh box = target->worldBound;
+	vVect  axisX = box->axis;
+	vVect  axisY = vPXCreateVect(-axisX.y, axisX.x);
+	vVect  corner = vPXCreateVect(box->mesh[2].x - box->center.x,
+		box->mesh[2].y - box->center.y);
+	vFloat halfX = vPXVectorDotProduct(corner, axisX);
+	vFloat halfY = vPXVectorDotProduct(corner, axisY);
+
+	vFloat radius = source->shape->radius * source->scale;
+	vVect  rel = vPXCreateVect(source->origin.x - box->center.x,
+		source->origin.y - box->center.y);
+	vFloat localX = vPXVectorDotProduct(rel, axisX);
+	vFloat localY = vPXVectorDotProduct(rel, axisY);
+
+	/* center inside, leave through the nearest face */
+	if (vPXFastFabs(localX) <= halfX && vPXFastFabs(localY) <= halfY)
+	{
+		vFloat exitX = halfX - vPXFastFabs(localX);
+		vFloat exitY = halfY - vPXFastFabs(localY);
+		if (exitX < exitY)
+		{
+			*pushVector = vPXVectorMultiplyCopy(axisX, (localX < 0.0f) ? -1.0f : 1.0f);
+			*pushVectorMagnitude = exitX + radius;
+		}
+		else
+		{
+			*pushVector = vPXVectorMultiplyCopy(axisY, (localY < 0.0f) ? -1.0f : 1.0f);
+			*pushVectorMagnitude = exitY + radius;
+		}
+		return TRUE;
+	}
+
+	/* center outside, push away from the closest point */
+	vFloat dx = localX - PXClamp(localX, -halfX, halfX);
+	vFloat dy = localY - PXClamp(localY, -halfY, halfY);
+	vFloat distSq = dx * dx + dy * dy;
+	if (distSq > radius * radius) return FALSE;
+
+	vFloat dist = sqrtf(distSq);
+	*pushVector = vPXCreateVect((axisX.x * dx + axisY.x * dy) / dist,
+		(axisX.y * dx + axisY.y * dy) / dist);
+	*pushVectorMagnitude = radius - dist;
+	return TRUE;
+}
+
+static vBOOL PXShapePairCircleCapsule(PPXShapeInstance source,
+	PPXShapeInstance target, vPVect pushVector, vPFloat pushVectorMagnitude)
+{
+	vVect closest = PXClosestOnSegment(source->origin,
+		PXShapePoint(target, target->shape->verts[0]),
+		PXShapePoint(target, target->shape->verts[1]));
+
+	/* a center on the segment has no closest-point direction */
+	if (PXPointsCoincide(closest, source->origin))
+		return PXShapePairSAT(source, target, pushVector, pushVectorMagnitude);
+	return PXShapePairPoints(source->origin, source->shape->radius * source->scale,
+		closest, target->shape->radius * target->scale, pushVector,
+		pushVectorMagnitude);
+}
+
+static vBOOL PXShapePairCapsuleCapsule(PPXShapeInstance source,
+	PPXShapeInstance target, vPVect pushVector, vPFloat pushVectorMagnitude)
+{
+	vVect sourceClosest, targClosest;
+	PXClosestBetweenSegments(
+		PXShapePoint(source, source->shape->verts[0]),
+		PXShapePoint(source, source->shape->verts[1]),
+		PXShapePoint(target, target->shape->verts[0]),
+		PXShapePoint(target, target->shape->verts[1]),
+		&sourceClosest, &targClosest);
+
+	/* crossing segments have no closest-point direction */
+	if (PXPointsCoincide(sourceClosest, targClosest))
+		return PXShapePairSAT(source, target, pushVector, pushVectorMagnitude);
+	return PXShapePairPoints(sourceClosest, source->shape->radius * source->scale,
+		targClosest, target->shape->radius * target->scale, pushVector,
+		pushVectorMagnitude);
+}
+
+static vBOOL PXShapePairSwapped(PXPFSHAPEPAIRFUNC pairFunc,
+	PPXShapeInstance source, PPXShapeInstance target, vPVect pushVector,
+	vPFloat pushVectorMagnitude)
+{
+	/* pushing target out of source, reversed, pushes source out */
+	if (pairFunc(target, source, pushVector, pushVectorMagnitude) == FALSE)
+		return FALSE;
+	vPXVectorReverse(pushVector);
+	return TRUE;
+}
+
+static vBOOL PXShapePairBoxCircle(PPXShapeInstance source,
+	PPXShapeInstance target, vPVect pushVector, vPFloat pushVectorMagnitude)
 {
-	PXProjectionPlane plane;
-	plane.vert1 = v1;
-	plane.vert2 = v2;
-	plane.planeVector = vCreatePosition(v2.x - v1.x, v2.y - v1.y);
-	plane.planeVectorMag = vPXVectorMagnitudePrecise(plane.planeVector);
-	return plane;
+	return PXShapePairSwapped(PXShapePairCircleBox, source, target,
+		pushVector, pushVectorMagnitude);
 }
 
+static vBOOL PXShapePairCapsuleCircle(PPXShapeInstance source,
+	PPXShapeInstance target, vPVect pushVector, vPFloat pushVectorMagnitude)
+{
+	return PXShapePairSwapped(PXShapePairCircleCapsule, source, target,
+		pushVector, pushVectorMagnitude);
+}
+
+/* closed forms where one exists, general SAT otherwise */
+static const PXPFSHAPEPAIRFUNC __shapePairs[PX_SHAPE_TYPE_COUNT][PX_SHAPE_TYPE_COUNT] =
+{
+	/* source box */
+	{ PXShapePairSAT, PXShapePairBoxCircle, PXShapePairSAT, PXShapePairSAT },
+	/* source circle */
+	{ PXShapePairCircleBox, PXShapePairCircleCircle, PXShapePairCircleCapsule,
+		PXShapePairSAT },
+	/* source capsule */
+	{ PXShapePairSAT, PXShapePairCapsuleCircle, PXShapePairCapsuleCapsule,
+		PXShapePairSAT },
+	/* source polygon */
+	{ PXShapePairSAT, PXShapePairSAT, PXShapePairSAT, PXShapePairSAT },
+};
+
 
 /* ========== COLLISION FUNCTIONS				==========	*/
 VPHYSAPI vBOOL vPXDetectCollisionPreEstimate(vPPhysical p1, vPPhysical p2)
+{
+	return PXDetectCollisionPreEstimate(&p1->worldBound, &p2->worldBound);
+}
+
+VPHYSAPI vBOOL vPXDetectCollisionSAT(vPPhysical source, vPPhysical target,
+	vPVect pushVector, vPFloat pushVectorMagnitude)
+{
+	return PXDetectCollisionSAT(&source->worldBound, &target->worldBound,
+		pushVector, pushVectorMagnitude);
+}
+
+VPHYSAPI vBOOL vPXDetectCollision(vPPhysical source, vPPhysical target,
+	vPVect pushVector, vPFloat pushVectorMagnitude)
+{
+	PXShapeInstance sourceInst, targInst;
+	sourceInst.shape      = PXShapeLookup(source->world, source->shape);
+	sourceInst.worldBound = &source->worldBound;
+	sourceInst.origin     = source->anticipatedPos;
+	sourceInst.scale      = source->transform.scale;
+	sourceInst.hull       = NULL;
+	targInst.shape        = PXShapeLookup(target->world, target->shape);
+	targInst.worldBound   = &target->worldBound;
+	targInst.origin       = target->anticipatedPos;
+	targInst.scale        = target->transform.scale;
+	targInst.hull         = NULL;
+	return PXDetectCollisionShapes(&sourceInst, &targInst, pushVector,
+		pushVectorMagnitude);
+}
+
+vBOOL PXDetectCollisionPreEstimate(vPPXWorldBoundMesh wb1, vPPXWorldBoundMesh wb2)
 {
 	/* get approximate distance between two */
 	vFloat dh = vPXVectorMagnitudeF(
-		p1->worldBound.center.x - p2->worldBound.center.x,
-		p1->worldBound.center.y - p2->worldBound.center.y);
+		wb1->center.x - wb2->center.x,
+		wb1->center.y - wb2->center.y);
 
 	/* get maximum bounding box dimension of each object */
-	vFloat mx = max(p1->worldBound.boundingBoxDims.x,
-		p2->worldBound.boundingBoxDims.x);
-	vFloat my = max(p1->worldBound.boundingBoxDims.y,
-		p2->worldBound.boundingBoxDims.y);
+	vFloat mx = max(wb1->boundingBoxDims.x, wb2->boundingBoxDims.x);
+	vFloat my = max(wb1->boundingBoxDims.y, wb2->boundingBoxDims.y);
 
 	/* if the approx dist is less than the sum of the max,	*/
 	/* consider collision									*/
 	return (dh < (mx + my));
 }
 
-VPHYSAPI vBOOL vPXDetectCollisionSAT(vPPhysical source, vPPhysical target,
+vBOOL PXDetectCollisionSAT(vPPXWorldBoundMesh sourceWB, vPPXWorldBoundMesh targWB,
 	vPVect pushVector, vPFloat pushVectorMagnitude)
 {
 	/* if exists, reset pushvector and magnitude */
@@ -60,113 +525,314 @@ VPHYSAPI vBOOL vPXDetectCollisionSAT(vPPhysical source, vPPhysical target,
 	if (pushVectorMagnitude != NULL)
 		*pushVectorMagnitude = 0.0f;
 
-	/* grab worldbounds of target and source */
-	vPPXWorldBoundMesh targWB = &target->worldBound;
-	vPPXWorldBoundMesh sourceWB = &source->worldBound;
+	/* both meshes are rectangles, project onto 2 axes of each */
+	PXShapeHull sourceHull, targHull;
+	PXShapeHullFromMesh(&sourceHull, sourceWB);
+	PXShapeHullFromMesh(&targHull, targWB);
 
-	/* get displacement from target to source and normalize */
-	vVect displacementVect = vCreatePosition(sourceWB->center.x - targWB->center.x,
-		sourceWB->center.y - targWB->center.y);
-	vPXVectorNormalize(&displacementVect);
+	vVect pushBackVectorDir; vFloat pushBackVectorMag;
+	if (PXShapeHullSAT(&sourceHull, &targHull, &pushBackVectorDir,
+		&pushBackVectorMag) == FALSE) return FALSE;
+
+	/* on reached here, objects are colliding, assign pushvector and magnitude */
+	if (pushVector != NULL)
+		*pushVector = pushBackVectorDir;
+	if (pushVectorMagnitude != NULL)
+		*pushVectorMagnitude = pushBackVectorMag;
+		
+	return TRUE;
+}
 
-	/* generate edge normals to project vertexes onto	*/
-	/* since both meshes are rectangles (and therefore 2x symmetrical) */
-	/* only 2 of the 4 faces of each rect are required to project onto	*/
-	/* as they are parallel with their counterparts, and will generate	*/
-	/* identical numbers.	*/
+vBOOL PXDetectCollisionShapes(PPXShapeInstance source, PPXShapeInstance target,
+	vPVect pushVector, vPFloat pushVectorMagnitude)
+{
+	vVect pushBackVectorDir; vFloat pushBackVectorMag;
+	if (__shapePairs[source->shape->type][target->shape->type](source, target,
+		&pushBackVectorDir, &pushBackVectorMag) == FALSE) return FALSE;
 
-	/* generate projection planes (2 per mesh) */
-	PXProjectionPlane projectionPlanes[8];
-	for (int i = 0; i < 4; i++)
+	if (pushVector != NULL)
+		*pushVector = pushBackVectorDir;
+	if (pushVectorMagnitude != NULL)
+		*pushVectorMagnitude = pushBackVectorMag;
+	return TRUE;
+}
+
+vBOOL PXDetectCollision(vPPXWorld world, vUI32 source, vUI32 target,
+	vPVect pushVector, vPFloat pushVectorMagnitude)
+{
+	PXShapeInstance sourceInst, targInst;
+	PXShapeInstanceFromBody(world, source, &sourceInst);
+	PXShapeInstanceFromBody(world, target, &targInst);
+	return PXDetectCollisionShapes(&sourceInst, &targInst, pushVector,
+		pushVectorMagnitude);
+}
+
+
+/* ========== OVERLAP TESTS						==========	*/
+static vBOOL PXShapeIsRound(PPXShapeInstance inst)
+{
+	return inst->shape->type == PX_SHAPE_TYPE_CIRCLE ||
+		inst->shape->type == PX_SHAPE_TYPE_CAPSULE;
+}
+
+static void PXShapeSegment(PPXShapeInstance inst, vPVect a, vPVect b)
+{
+	/* a circle is a capsule with no length */
+	if (inst->shape->type == PX_SHAPE_TYPE_CIRCLE)
 	{
-		projectionPlanes[i] = 
-			PXGenerateProjectionPlane(sourceWB->mesh[i], sourceWB->mesh[(i + 1) & 0b11]);
-		projectionPlanes[i + 4] =
-			PXGenerateProjectionPlane(targWB->mesh[i], targWB->mesh[(i + 1) & 0b11]);
+		*a = *b = inst->origin;
+		return;
 	}
+	*a = PXShapePoint(inst, inst->shape->verts[0]);
+	*b = PXShapePoint(inst, inst->shape->verts[1]);
+}
 
-	/* project each mesh onto each projection plane and count	*/
-	/* the amount of planes which the two meshes overlap		*/
-	int projectionOverlapCount = 0;
+static vBOOL PXOverlapCircleBox(PPXShapeInstance circle, PPXShapeInstance box)
+{
+	vPPXWorldBoundMesh bound = box->worldBound;
+	vVect  axisX = bound->axis;
+	vVect  axisY = vPXCreateVect(-axisX.y, axisX.x);
+	vVect  corner = vPXCreateVect(bound->mesh[2].x - bound->center.x,
+		bound->mesh[2].y - bound->center.y);
+	vFloat halfX = vPXVectorDotProduct(corner, axisX);
+	vFloat halfY = vPXVectorDotProduct(corner, axisY);
+
+	vVect  rel = vPXCreateVect(circle->origin.x - bound->center.x,
+		circle->origin.y - bound->center.y);
+	vFloat localX = vPXVectorDotProduct(rel, axisX);
+	vFloat localY = vPXVectorDotProduct(rel, axisY);
+	vFloat dx = localX - PXClamp(localX, -halfX, halfX);
+	vFloat dy = localY - PXClamp(localY, -halfY, halfY);
+	vFloat radius = circle->shape->radius * circle->scale;
+	return dx * dx + dy * dy <= radius * radius;
+}
 
-	/* keep track of pushback vector */
-	vFloat pushBackVectorMag = 0x10000; /* large value */
-	vVect  pushBackVectorDir;
+vBOOL PXOverlapShapes(PPXShapeInstance a, PPXShapeInstance b)
+{
+	vBOOL aRound = PXShapeIsRound(a);
+	vBOOL bRound = PXShapeIsRound(b);
 
-	/* loop all projection planes */
-	for (int i = 0; i < 8; i++)
+	/* round pairs only need the distance between their cores */
+	if (aRound && bRound)
 	{
-		/* get projection plane and projection vector	*/
-		/* normalize the projection vector				*/
-		PPXProjectionPlane projPlane = projectionPlanes + i;
-		vVect projVect = projPlane->planeVector;
-		vPXVectorNormalize(&projVect);
-
-		/* project source verts onto plane and keep track of min/max */
-		vFloat sourceMin, sourceMax;
-		for (int j = 0; j < 4; j++)
-		{
-			vFloat sDot = vPXVectorDotProduct(sourceWB->mesh[j], projVect);
-			if (j == 0)
-			{
-				sourceMin = sDot;
-				sourceMax = sDot;
-				continue;
-			}
-			
-			sourceMin = min(sDot, sourceMin);
-			sourceMax = max(sDot, sourceMax);
-		}
-		
+		vVect a0, a1, b0, b1, ca, cb;
+		PXShapeSegment(a, &a0, &a1);
+		PXShapeSegment(b, &b0, &b1);
+		PXClosestBetweenSegments(a0, a1, b0, b1, &ca, &cb);
+		vFloat dx = ca.x - cb.x, dy = ca.y - cb.y;
+		vFloat radii = a->shape->radius * a->scale + b->shape->radius * b->scale;
+		return dx * dx + dy * dy <= radii * radii;
+	}
 
-		/* project source verts onto plane and keep track of min/max */
-		vFloat targMin, targMax;
-		for (int j = 0; j < 4; j++)
-		{
-			vFloat tDot = vPXVectorDotProduct(targWB->mesh[j], projVect);
-			if (j == 0)
-			{
-				targMin = tDot;
-				targMax = tDot;
-				continue;
-			}
+	if (a->shape->type == PX_SHAPE_TYPE_CIRCLE &&
+		b->shape->type == PX_SHAPE_TYPE_BOX) return PXOverlapCircleBox(a, b);
+	if (b->shape->type == PX_SHAPE_TYPE_CIRCLE &&
+		a->shape->type == PX_SHAPE_TYPE_BOX) return PXOverlapCircleBox(b, a);
 
-			targMin = min(tDot, targMin);
-			targMax = max(tDot, targMax);
-		}
+	PXShapeHull aHull, bHull;
+	return PXShapeHullOverlap(PXShapeHullOf(a, &aHull),
+		PXShapeHullOf(b, &bHull));
+}
 
-		/* check if projected min and max values overlap */
-		if (max(sourceMax, targMax) - min(sourceMin, targMin)
-			<= (sourceMax - sourceMin) + (targMax - targMin))
-		{
-			/* find overlap region */
-			vFloat overlapRegion = 
-				min(sourceMax, targMax) - max(sourceMin, targMin);
-
-			/* if in admissible direction, and */
-			/* if smaller than previous overlap, assign new */
-			if (vPXVectorDotProduct(projVect, displacementVect) > 0.0f
-				&& overlapRegion < pushBackVectorMag)
-			{
-				pushBackVectorMag = overlapRegion;
-				pushBackVectorDir = projVect;
-				vPXVectorNormalize(&pushBackVectorDir);
-			}
+vBOOL PXOverlapBodies(vPPXWorld world, vUI32 a, vUI32 b)
+{
+	PXShapeInstance aInst, bInst;
+	PXShapeInstanceFromBody(world, a, &aInst);
+	PXShapeInstanceFromBody(world, b, &bInst);
+	return PXOverlapShapes(&aInst, &bInst);
+}
+
+
+/* ========== SHAPE INSTANCES					==========	*/
+void PXShapeInstanceFromBody(vPPXWorld world, vUI32 body,
+	PPXShapeInstance instOut)
+{
+	PPXBodyStore store = &world->bodies;
+	instOut->shape      = store->shapes + store->shape[body];
+	instOut->worldBound = store->worldBound + body;
+	instOut->origin     = store->anticipatedPos[body];
+	instOut->scale      = store->scale[body];
+	instOut->hull       = (store->hull[body] == PX_BODY_NONE) ? NULL :
+		store->hulls + store->hull[body];
+}
+
+void PXShapeHullCache(vPPXWorld world, vUI32 body)
+{
+	/* boxes copy their mesh and circles have no hull to speak	*/
+	/* of, only rotated verts and normals are worth keeping		*/
+	PPXBodyStore store = &world->bodies;
+	vUI8 type = store->shapes[store->shape[body]].type;
+	if (type != PX_SHAPE_TYPE_CAPSULE && type != PX_SHAPE_TYPE_POLYGON)
+		return;
+
+	PXShapeInstance inst;
+	PXShapeInstanceFromBody(world, body, &inst);
+	PXShapeHullBuild(PXBodyStoreAddHull(world, body), &inst);
+}
+
+vGRect PXShapeInstanceBounds(PPXShapeInstance inst)
+{
+	/* a box is its mesh, which the bounding box already holds */
+	if (inst->shape->type == PX_SHAPE_TYPE_BOX)
+		return inst->worldBound->boundingBox;
+
+	PXShapeHull scratch;
+	PPXShapeHull hull = PXShapeHullOf(inst, &scratch);
+	vGRect bounds;
+	PXShapeHullProject(hull, vPXCreateVect(1.0f, 0.0f), &bounds.left,
+		&bounds.right);
+	PXShapeHullProject(hull, vPXCreateVect(0.0f, 1.0f), &bounds.bottom,
+		&bounds.top);
+	return bounds;
+}
+
+
+/* ========== COLLISION RESPONSE				==========	*/
+static vFloat PXWeightByMass(vFloat sVal, vFloat tVal,
+	vPPhysical source, vPPhysical target)
+{
+	vFloat massTotal = source->mass + target->mass;
+	sVal *= (source->mass / massTotal);
+	tVal *= (target->mass / massTotal);
+	return sVal + tVal;
+}
+
+vVect PXCalculateMomentumTransferVect(vPPXWorld world, vUI32 source, vUI32 target)
+{
+	PPXBodyStore store = &world->bodies;
+
+	/* get initial velocities  */
+	vVect v1 = store->velocity[source];
+	vVect v2 = store->velocity[target];
+
+	/* transform so that v2 = 0 */
+	vPXVectorAddV(&v1, vPXVectorMultiplyCopy(v2, -1.0f));
+
+	/* dampen by friction of target object */
+	vPXVectorMultiply(&v1, 1.0f - store->friction[target]);
+
+	/* find new v1 and v2 */
+	vFloat sMass = store->mass[source];
+	vFloat tMass = store->mass[target];
+	vVect v1Prime = vPXVectorMultiplyCopy(v1, (sMass - tMass) / (sMass + tMass));
+
+	/* shift back so that v2 no longer equals 0 */
+	vPXVectorAddV(&v1Prime, v2);
+
+	return v1Prime;
+}
+
+static vFloat PXArcLengthToAngle(vFloat arcLength, vFloat radius)
+{
+	return (180 * arcLength) / (radius * VPHYS_PI);
+}
+
+static vFloat PXAngleToArcLength(vFloat angle, vFloat radius)
+{
+	/* div by 180 */
+	return (VPHYS_PI * radius * angle) * 0.00555555555f;
+}
+
+PXAngularForceInfo PXCalculateAngularForce(vPPXWorld world,
+	PPXPushbackInfo pushInfo, vUI32 target, vUI32 source)
+{
+	PPXBodyStore store = &world->bodies;
+	vPPXWorldBoundMesh sourceWB = store->worldBound + source;
+	vPPXWorldBoundMesh targWB   = store->worldBound + target;
+
+	PXAngularForceInfo forceInfo;
+	forceInfo.angularForce = 0.0f;
+	forceInfo.linearEquivalent = 0.0f;
+
+	/* get velocities post collision transfer */
+	vVect sPrimeVel = PXCalculateMomentumTransferVect(world, source, target);
+	vVect tPrimeVel = PXCalculateMomentumTransferVect(world, target, source);
+
+	/* get velocity difference */
+	vVect velDiff = vPXVectorAddCopy(tPrimeVel,
+		vPXVectorMultiplyCopy(sPrimeVel, -1.0f));
+
+	/* get normal plane to vector */
+	vVect projPlane
+		= vCreatePosition(velDiff.y, -velDiff.x);
+	vPXVectorNormalize(&projPlane);
+
+	/* project each center to plane */
+	vFloat sourceCenter = vPXVectorDotProduct(projPlane, sourceWB->center);
+	vFloat targetCenter = vPXVectorDotProduct(projPlane, targWB->center);
 
-			projectionOverlapCount++;
+	/* cast "shadow" of both rects onto projection plane */
+	vFloat minPos = 0, maxPos = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		vFloat projVert = 
+			vPXVectorDotProduct(projPlane, sourceWB->mesh[i]);
+		
+		/* initial value */
+		if (i == 0)
+		{
+			minPos = projVert;
+			maxPos = projVert;
 		}
 		else
 		{
-			/* if there is a region of no overlap, then no collision. */
-			return FALSE;
+			minPos = min(projVert, minPos);
+			maxPos = max(projVert, maxPos);
 		}
 	}
+	for (int i = 0; i < 4; i++)
+	{
+		vFloat projVert =
+			vPXVectorDotProduct(projPlane, targWB->mesh[i]);
+		minPos = min(projVert, minPos);
+		maxPos = max(projVert, maxPos);
+	}
 
-	/* on reached here, objects are colliding, assign pushvector and magnitude */
-	if (pushVector != NULL)
-		*pushVector = pushBackVectorDir;
-	if (pushVectorMagnitude != NULL)
-		*pushVectorMagnitude = pushBackVectorMag;
-		
-	return TRUE;
+	/* find center of shadow for radius */
+	vFloat shadowCenter = (minPos + maxPos) * 0.5f;
+
+	/* get collision "radius" */
+	vFloat sColRadius = sourceCenter - shadowCenter;
+	vFloat tColRadius = targetCenter - shadowCenter;
+
+	/* if source radius is zero, consider no angular force */
+	if (vPXFastFabs(sColRadius) < VPHYS_EPSILON) return forceInfo;
+
+	/* get distance between each center */
+	vFloat projCenterDistance = vPXFastFabs(sourceCenter - targetCenter);
+	vFloat shadowSize = maxPos - minPos;
+
+	/* if collision is right on, no angular force */
+	if (projCenterDistance < VPHYS_EPSILON) return forceInfo;
+	if (vPXFastFabs(shadowSize) < VPHYS_EPSILON) return forceInfo;
+
+	/* get force scale factor (further from center means more force) */
+	vFloat scaleFactor = projCenterDistance / shadowSize;
+	scaleFactor = min(1.0f, scaleFactor);
+
+	/* generate magnitude */
+	vFloat deltaV = vPXVectorMagnitudeV(velDiff);
+	if (deltaV < VPHYS_EPSILON) return forceInfo;
+
+	/* rotation is arc length of velocity difference */
+	vFloat deltaR = PXArcLengthToAngle(deltaV,
+		sColRadius);
+
+	/* scale by opposite object's weight and scale factor */
+	deltaR *= store->mass[target] / (store->mass[source] + store->mass[target]);
+	deltaR *= scaleFactor;
+	deltaR *= (1.0f - store->friction[source]);
+
+	/* if angular velocity is already greater than deltaR	*/
+	/* then don't apply force								*/
+	vFloat angularVelocity = store->angularVelocity[source];
+	if (deltaR < 0.0f && angularVelocity < deltaR) return forceInfo;
+	if (deltaR > 0.0f && angularVelocity > deltaR) return forceInfo;
+
+	/* generate scaled arclength, caller applies the force */
+	vFloat deltaVScaled = PXAngleToArcLength(deltaR, sColRadius);
+	
+	forceInfo.linearEquivalent = deltaVScaled;
+	forceInfo.angularForce = deltaR;
+	return forceInfo;
 }
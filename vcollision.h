@@ -9,9 +9,68 @@
 /* ========== INCLUDES							==========	*/
 #include "vphys.h"
 
+/* ========== STRUCTURES						==========	*/
+typedef struct PXPushbackInfo
+{
+	vVect  accumulator;
+	vUI32 collisionCount;
+} PXPushbackInfo, *PPXPushbackInfo;
+
+typedef struct PXAngularForceInfo
+{
+	vFloat angularForce;
+	vFloat linearEquivalent;
+} PXAngularForceInfo, *PPXAngularForceInfo;
+
+typedef struct PXShapeInstance
+{
+	PPXShape shape;
+	vPPXWorldBoundMesh worldBound;	/* mesh, center and rotation axis	*/
+	vVect  origin;					/* shape's local origin in world	*/
+	vFloat scale;
+	PPXShapeHull hull;				/* built during setup, or NULL		*/
+} PXShapeInstance, *PPXShapeInstance;
+
+
 /* ========== COLLISION FUNCTIONS				==========	*/
 VPHYSAPI vBOOL vPXDetectCollisionPreEstimate(vPPhysical p1, vPPhysical p2);
 VPHYSAPI vBOOL vPXDetectCollisionSAT(vPPhysical source, vPPhysical target, 
 	vPVect pushVector, vPFloat pushVectorMagnitude);
+/* collides the bodies' shapes as of their last tick, the	*/
+/* push moves source out of target							*/
+VPHYSAPI vBOOL vPXDetectCollision(vPPhysical source, vPPhysical target,
+	vPVect pushVector, vPFloat pushVectorMagnitude);
+
+vBOOL PXDetectCollisionPreEstimate(vPPXWorldBoundMesh wb1, vPPXWorldBoundMesh wb2);
+vBOOL PXDetectCollisionSAT(vPPXWorldBoundMesh sourceWB, vPPXWorldBoundMesh targWB,
+	vPVect pushVector, vPFloat pushVectorMagnitude);
+vBOOL PXDetectCollisionShapes(PPXShapeInstance source, PPXShapeInstance target,
+	vPVect pushVector, vPFloat pushVectorMagnitude);
+vBOOL PXDetectCollision(vPPXWorld world, vUI32 source, vUI32 target,
+	vPVect pushVector, vPFloat pushVectorMagnitude);
+
+
+/* ========== OVERLAP TESTS						==========	*/
+/* boolean only, stops at the first separating axis			*/
+vBOOL PXOverlapShapes(PPXShapeInstance a, PPXShapeInstance b);
+vBOOL PXOverlapBodies(vPPXWorld world, vUI32 a, vUI32 b);
+
+
+/* ========== SHAPE INSTANCES					==========	*/
+/* as of the body's anticipated position this tick			*/
+void   PXShapeInstanceFromBody(vPPXWorld world, vUI32 body,
+	PPXShapeInstance instOut);
+/* tight world-space bounding box of the shape itself		*/
+vGRect PXShapeInstanceBounds(PPXShapeInstance inst);
+/* builds the world hull of a capsule or polygon body once,	*/
+/* for every test against it this tick						*/
+void   PXShapeHullCache(vPPXWorld world, vUI32 body);
+
+
+/* ========== COLLISION RESPONSE				==========	*/
+vVect PXCalculateMomentumTransferVect(vPPXWorld world, vUI32 source,
+	vUI32 target);
+PXAngularForceInfo PXCalculateAngularForce(vPPXWorld world,
+	PPXPushbackInfo pushInfo, vUI32 target, vUI32 source);
 
 #endif
@@ -12,6 +12,20 @@
 #include "vphysdefs.h"			/* physics definitions			*/
 #include "vphyscore.h"			/* core physics functions		*/
 #include "vphysrand.h"			/* random number generation		*/
+#include "vphystrace.h"			/* trace-event recording		*/
+#include "vphysquery.h"			/* spatial queries				*/
+#include "vphyssnapshot.h"		/* world snapshots				*/
+#include "vphysrecord.h"			/* flight recorder and replay	*/
+#include "vphysparticle.h"		/* lightweight particles		*/
+#include "vphysshape.h"			/* collision shapes				*/
+#include "vphystilemap.h"		/* tilemap terrain collider		*/
+#include "vphysfield.h"			/* gravity and force fields		*/
+#include "vphyssensor.h"			/* sensor volumes and events	*/
+#include "vphyslayer.h"			/* collision layer matrix		*/
+#include "vphysstream.h"			/* region streaming				*/
+#include "vphyslod.h"				/* interests and simulation LOD	*/
+#include "vphyspool.h"			/* helper threads				*/
+#include "vphysbudget.h"			/* tick time budget				*/
 
 
 #endif
@@ -0,0 +1,140 @@
+/* ========== <vphysbudget.c>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Tick time budget with staged degradation.				*/
+/* The projection is the smoothed cost of everything but		*/
+/* pair finding plus the smoothed cost of one candidate pair	*/
+/* times the pairs the partitions hold now, so a burst of	*/
+/* bodies is seen before its collision phase runs.			*/
+
+
+/* ========== INCLUDES							==========	*/
+#include "vphysbudget.h"
+#include "vphyscore.h"
+#include "vphystrace.h"
+
+
+/* ========== HELPERS							==========	*/
+static double PXBudgetSmooth(double smoothed, double sample)
+{
+	/* the first sample stands on its own */
+	if (smoothed <= 0.0) return sample;
+	return smoothed + (sample - smoothed) * PX_BUDGET_SMOOTHING;
+}
+
+static void PXBudgetSetLevel(vPPXWorld world, vUI32 level)
+{
+	PPXBudgetState budget = &world->budget;
+	if (level > budget->level) world->stats.degradeEscalations++;
+	if (level < budget->level) world->stats.degradeRecoveries++;
+	budget->level     = level;
+	budget->calmTicks = 0;
+}
+
+
+/* ========== BUDGET STATE						==========	*/
+void PXBudgetPlan(vPPXWorld world)
+{
+	PPXBudgetState budget = &world->budget;
+
+	/* off, or the tick must not depend on timing */
+	if (budget->budgetNs == 0 || world->deterministic == TRUE)
+	{
+		budget->level = PX_DEGRADE_NONE;
+		world->stats.degradeLevel    = PX_DEGRADE_NONE;
+		world->stats.projectedTimeNs = 0;
+		return;
+	}
+
+	/* pairs the binned bodies could form */
+	vUI64 candidates = 0;
+	for (vUI32 i = 0; i < world->partitionPoolCursor; i++)
+	{
+		vUI64 useage = world->partitionPool[i]->useage;
+		if (useage > 1) candidates += (useage * (useage - 1)) >> 1;
+	}
+	budget->candidates = candidates;
+
+	double projected = budget->baseNs +
+		budget->nsPerCandidate * (double)candidates;
+	double limit  = (double)budget->budgetNs;
+	double lastNs = (double)world->stats.tickTimeNs;
+
+	if (projected > limit * PX_BUDGET_PANIC)
+	{
+		if (budget->level < PX_DEGRADE_LEVEL_COUNT - 1)
+			PXBudgetSetLevel(world, PX_DEGRADE_LEVEL_COUNT - 1);
+	}
+	else if (projected > limit || lastNs > limit)
+	{
+		if (budget->level < PX_DEGRADE_LEVEL_COUNT - 1)
+			PXBudgetSetLevel(world, budget->level + 1);
+	}
+	else if (projected < limit * PX_BUDGET_RECOVER &&
+		lastNs < limit * PX_BUDGET_RECOVER)
+	{
+		/* give detail back slowly, or a burst just below budget	*/
+		/* would flip the level every tick							*/
+		if (budget->level > PX_DEGRADE_NONE &&
+			++budget->calmTicks >= PX_BUDGET_CALM_TICKS)
+			PXBudgetSetLevel(world, budget->level - 1);
+	}
+	else budget->calmTicks = 0;
+
+	/* a capped cell only reaches the bodies its loop starts	*/
+	/* with, so move the start every tick or the same bodies	*/
+	/* would never be tested. a golden ratio stride spreads	*/
+	/* the starts of any cell size evenly over the ticks		*/
+	if (PXBudgetDegraded(world, PX_DEGRADE_PAIR_CAP))
+		budget->pairCapStart += PX_BUDGET_PAIR_STRIDE;
+
+	world->stats.degradeLevel    = budget->level;
+	world->stats.projectedTimeNs = (vUI64)projected;
+	PXTRACE_COUNTER(world, PX_TRACE_COUNTER_BUDGET,
+		world->stats.projectedTimeNs / 1000, budget->level);
+}
+
+void PXBudgetLearn(vPPXWorld world)
+{
+	PPXBudgetState budget = &world->budget;
+	if (budget->budgetNs == 0 || world->deterministic == TRUE) return;
+
+	double pairNs = (double)budget->pairNs;
+	double tickNs = (double)world->stats.tickTimeNs;
+
+	/* capped pair tests say nothing about uncapped ones */
+	if (budget->candidates > 0 && budget->level < PX_DEGRADE_PAIR_CAP)
+	{
+		budget->nsPerCandidate = PXBudgetSmooth(budget->nsPerCandidate,
+			pairNs / (double)budget->candidates);
+	}
+	budget->baseNs = PXBudgetSmooth(budget->baseNs, max(0.0, tickNs - pairNs));
+}
+
+
+/* ========== TICK BUDGET						==========	*/
+VPHYSAPI void vPXWorldSetTickBudget(vPPXWorld world, vUI64 microseconds)
+{
+	vPXWorldLock(world);
+	world->budget.budgetNs = microseconds * 1000;
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI vUI64 vPXWorldGetTickBudget(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	vUI64 microseconds = world->budget.budgetNs / 1000;
+	vPXWorldUnlock(world);
+	return microseconds;
+}
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI void vPXSetTickBudget(vUI64 microseconds)
+{
+	vPXWorldSetTickBudget(&_vphys, microseconds);
+}
+
+VPHYSAPI vUI64 vPXGetTickBudget(void)
+{
+	return vPXWorldGetTickBudget(&_vphys);
+}
@@ -0,0 +1,53 @@
+/* ========== <vphysbudget.h>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Tick time budget with staged degradation.				*/
+/* Once the bodies are binned, the tick's cost is projected	*/
+/* from the pairs its partitions hold and what recent ticks	*/
+/* cost. While the projection or the last tick is over		*/
+/* budget the world gives up detail one level per tick, or	*/
+/* all at once when far over, in this order:				*/
+/*															*/
+/*	PX_DEGRADE_PARTICLES	particles stop colliding with	*/
+/*							each other						*/
+/*	PX_DEGRADE_LOD			HALF and QUARTER LOD bodies step	*/
+/*							one tier slower, QUARTER ones	*/
+/*							to PX_LOD_EIGHTH				*/
+/*	PX_DEGRADE_PAIR_CAP		each partition tests at most		*/
+/*							PX_BUDGET_CELL_PAIRS pairs,		*/
+/*							from a new body every tick		*/
+/*															*/
+/* Levels are given back one at a time after				*/
+/* PX_BUDGET_CALM_TICKS ticks well under budget. Every		*/
+/* decision shows in the stats. Deterministic worlds ignore	*/
+/* the budget, as wall clock time must not change what a	*/
+/* tick computes.											*/
+
+#ifndef _VPHYS_BUDGET_INCLUDE_
+#define _VPHYS_BUDGET_INCLUDE_
+
+/* ========== INCLUDES							==========	*/
+#include "vphysdefs.h"
+
+
+/* ========== TICK BUDGET						==========	*/
+/* 0, the default, turns the budget off						*/
+VPHYSAPI void  vPXWorldSetTickBudget(vPPXWorld world, vUI64 microseconds);
+VPHYSAPI vUI64 vPXWorldGetTickBudget(vPPXWorld world);
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI void  vPXSetTickBudget(vUI64 microseconds);
+VPHYSAPI vUI64 vPXGetTickBudget(void);
+
+
+/* ========== BUDGET STATE						==========	*/
+/* TRUE if the world is at or past the given PX_DEGRADE_ level	*/
+#define PXBudgetDegraded(world, degradeLevel)	\
+	((world)->budget.level >= (degradeLevel))
+
+/* after binning: projects the tick and picks its level		*/
+void PXBudgetPlan(vPPXWorld world);
+/* after the tick: learns what it cost						*/
+void PXBudgetLearn(vPPXWorld world);
+
+#endif
@@ -7,92 +7,327 @@
 #define _CRT_SECURE_NO_WARNINGS 
 #include "vphyscore.h"
 #include "vphysthread.h"
+#include "vbodystore.h"
+#include "vspacepart.h"
+#include "vphysparticle.h"
+#include "vphysshape.h"
+#include "vphystilemap.h"
+#include "vphysfield.h"
+#include "vphyssensor.h"
+#include "vphyslayer.h"
+#include "vphysstream.h"
+#include "vphyslod.h"
+#include "vphyspool.h"
 #include <stdio.h>
 #include <math.h>
 
 
-/* ========== BUFFER CALLBACKS					==========	*/
-static void vPPhysicsObjectList_initFunc(vHNDL buffer, vPPhysical* elementPtr,
-	vPPhysical input)
+/* ========== COMPONENT REGISTRATION			==========	*/
+/* one component type serves every world; each vPhysical	*/
+/* records the world it belongs to							*/
+static vUI16 __physComponent;
+static volatile LONG __physComponentState = 0;	/* 0 none, 1 busy, 2 ready */
+
+static void PXRegisterPhysicsComponent(void)
 {
-	input->physObjectListPtr = elementPtr;
-	*elementPtr = input;
+	if (InterlockedCompareExchange(&__physComponentState, 1, 0) != 0)
+	{
+		while (__physComponentState != 2) Sleep(0);
+		return;
+	}
+
+	__physComponent = vCreateComponent("vPhysical Component", NULL,
+		sizeof(vPhysical), NULL, vPXPhysical_initFunc, vPXPhysical_destroyFunc,
+		NULL, NULL);
+	InterlockedExchange(&__physComponentState, 2);
 }
 
+
 /* ========== INITIALIZATION					==========	*/
-VPHYSAPI vBOOL vPXInitialize(HANDLE debugOut, vUI64 flushInterval)
+static vBOOL PXWorldInitialize(vPPXWorld world, HANDLE debugOut,
+	vUI64 flushInterval, vBOOL createWorker)
 {
-	vZeroMemory(&_vphys, sizeof(_vPXInternals));
-	_vphys.isInitialized = TRUE;
-	_vphys.debugMode = FALSE;
+	vZeroMemory(world, sizeof(vPXWorld));
+	world->isInitialized = TRUE;
+	world->debugMode = FALSE;
 
 	/* initialize lock */
-	InitializeCriticalSection(&_vphys.lock);
-	EnterCriticalSection(&_vphys.lock);
+	InitializeCriticalSection(&world->lock);
+	EnterCriticalSection(&world->lock);
 
 	/* setup debug out */
-	vPXDebugAttatchOutputHandle(debugOut, flushInterval);
+	vPXWorldDebugAttatchOutputHandle(world, debugOut, flushInterval);
 
-	/* initialize physics object list */
-	_vphys.physObjectList = vCreateDBuffer("vPhysical Object List", sizeof(vPPhysical),
-		PHYSOBJECT_LIST_NODE_SIZE, vPPhysicsObjectList_initFunc, NULL);
+	/* initialize packed body store */
+	PXBodyStoreInit(world);
+	PXShapeTableInit(world);
+	PXParticleStoreInit(world);
+	PXTilemapInit(world);
+	PXFieldStoreInit(world);
+	PXLayerMatrixInit(world);
+	PXPoolInit(world);
 
-	/* initialize physics component */
-	_vphys.physComponent = vCreateComponent("vPhysical Component", NULL, sizeof(vPhysical),
-		NULL, vPXPhysical_initFunc, vPXPhysical_destroyFunc, NULL, NULL);
+	/* initialize physics component (once per process) */
+	PXRegisterPhysicsComponent();
 
 	/* initialize partition buffer */
-	_vphys.partitionSize = PARTITION_SIZE_DEFAULT;
-	_vphys.partitions = vCreateDBuffer("vPhysics Space Partitions", sizeof(vPXPartiton),
-		PARTITION_BUFFER_NODE_SIZE, NULL, NULL);
+	world->partitionSize = PARTITION_SIZE_DEFAULT;
+	world->partitions = vCreateDBuffer("vPhysics Space Partitions",
+		sizeof(vPXPartiton), PARTITION_BUFFER_NODE_SIZE, NULL, NULL);
 
-	/* initialize physics worker thread */
-	_vphys.physicsThread = vCreateWorker("vPhysics Worker", 10, vPXT_initFunc,
-		vPXT_exitFunc, vPXT_cycleFunc, NULL, NULL);
+	/* setup profiler timer */
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	world->timeFrequency = frequency.QuadPart;
 
-	/* initialize random number table */
-	vPXRandInit();
+	/* no query snapshot until first publish */
+	world->queryPublished = -1;
+
+	/* fixed tick length used by deterministic worker pacing */
+	world->tickInterval = PX_TICK_INTERVAL_DEFAULT;
+
+	/* every world starts from the same random stream */
+	vPXRandStreamSeed(&world->random, RAND_SEED_DEFAULT);
+
+	LeaveCriticalSection(&world->lock);
+
+	/* initialize physics worker thread (headless setups step manually) */
+	if (createWorker == TRUE)
+	{
+		world->physicsThread = vCreateWorker("vPhysics Worker", 10,
+			vPXT_initFunc, vPXT_exitFunc, vPXT_cycleFunc, world, NULL);
+	}
+
+	return TRUE;
+}
+
+VPHYSAPI vBOOL vPXInitialize(HANDLE debugOut, vUI64 flushInterval)
+{
+	return PXWorldInitialize(&_vphys, debugOut, flushInterval, TRUE);
+}
+
+VPHYSAPI vBOOL vPXInitializeHeadless(HANDLE debugOut, vUI64 flushInterval)
+{
+	return PXWorldInitialize(&_vphys, debugOut, flushInterval, FALSE);
+}
+
+
+/* ========== WORLDS							==========	*/
+VPHYSAPI vPPXWorld vPXWorldCreate(HANDLE debugOut, vUI64 flushInterval,
+	vBOOL createWorker)
+{
+	vPPXWorld world = vAllocZeroed(sizeof(vPXWorld));
+	PXWorldInitialize(world, debugOut, flushInterval, createWorker);
+	return world;
+}
+
+VPHYSAPI void vPXWorldDestroy(vPPXWorld world)
+{
+	if (world == NULL || world->isInitialized == FALSE) return;
+
+	/* stop the worker first, its cycle takes the world lock */
+	if (world->physicsThread != NULL)
+	{
+		vDestroyWorker(world->physicsThread);
+		world->physicsThread = NULL;
+	}
+
+	vPXWorldTraceEnd(world);
+	vPXWorldRecordEnd(world);
+
+	vPXWorldLock(world);
+	PXStreamFree(world);
+	PXShapeTableFree(world);
+	PXBodyStoreFree(world);
+	PXParticleStoreFree(world);
+	PXTilemapFree(world);
+	PXFieldStoreFree(world);
+	PXSensorStateFree(world);
+	PXLayerMatrixFree(world);
+	PXLODFree(world);
+	PXPoolFree(world);
+	PXPartFreePartitions(world);
+	PXQueryFree(world);
+	vFree(world->debugDraw.vertices);
+	vFree(world->contacts);
+	world->isInitialized = FALSE;
+	vPXWorldUnlock(world);
+
+	DeleteCriticalSection(&world->lock);
+
+	/* the default world is static, everything else was allocated */
+	if (world != &_vphys) vFree(world);
+}
+
+VPHYSAPI vPPXWorld vPXGetDefaultWorld(void)
+{
+	return &_vphys;
+}
+
+
+/* ========== SIMULATION						==========	*/
+VPHYSAPI void vPXWorldStep(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	PXTick(world);
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI void vPXWorldGetStats(vPPXWorld world, vPPXStats statsOut)
+{
+	vPXWorldLock(world);
+	*statsOut = world->stats;
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI void vPXWorldSetDeterministic(vPPXWorld world, vBOOL enable)
+{
+	vPXWorldLock(world);
+	world->deterministic = enable;
+	world->tickClock     = 0;
+	world->tickClockLast = 0;
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI vBOOL vPXWorldIsDeterministic(vPPXWorld world)
+{
+	return world->deterministic;
+}
+
+VPHYSAPI void vPXWorldSetTickInterval(vPPXWorld world, vUI64 microseconds)
+{
+	vPXWorldLock(world);
+	world->tickInterval = max(1, microseconds);
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI vUI64 vPXWorldGetStateHash(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	vUI64 hash = world->stats.stateHash;
+	vPXWorldUnlock(world);
+	return hash;
+}
+
+VPHYSAPI vUI64 vPXWorldComputeStateHash(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	vUI64 hash = PXComputeStateHash(world);
+	vPXWorldUnlock(world);
+	return hash;
+}
+
+VPHYSAPI void vPXStep(void)
+{
+	vPXWorldStep(&_vphys);
+}
+
+VPHYSAPI void vPXGetStats(vPPXStats statsOut)
+{
+	vPXWorldGetStats(&_vphys, statsOut);
 }
 
 
 /* ========== DEBUG LOGGING						==========	*/
+VPHYSAPI vBOOL vPXWorldIsDebug(vPPXWorld world)
+{
+	return world->debugMode;
+}
+
+VPHYSAPI void vPXWorldDebugMode(vPPXWorld world, vBOOL mode)
+{
+	vPXWorldLock(world);
+	world->debugMode = mode;
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI void vPXWorldDebugSetView(vPPXWorld world, vGRect view)
+{
+	vPXWorldLock(world);
+	world->debugDraw.view = view;
+	world->debugDraw.viewEnabled = TRUE;
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI void vPXWorldDebugClearView(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	world->debugDraw.viewEnabled = FALSE;
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI void vPXWorldDebugAttatchOutputHandle(vPPXWorld world, HANDLE hOut,
+	vUI64 flushInterval)
+{
+	vPXWorldLock(world);
+	world->debugModeOutput = hOut;
+	world->debugLogCount = 0;
+	world->debugFlushInterval = flushInterval;
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI void vPXWorldDebugRemoveOuputHandle(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	world->debugModeOutput = NULL;
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI void vPXWorldDebugLog(vPPXWorld world, vPCHAR message)
+{
+	if (world->debugMode == FALSE || world->debugModeOutput == NULL) return;
+	vFileWrite(world->debugModeOutput, vFileSize(world->debugModeOutput),
+		strlen(message), message);
+	world->debugLogCount++;
+
+	if (world->debugLogCount % world->debugFlushInterval == 0)
+		FlushFileBuffers(world->debugModeOutput);
+}
+
+VPHYSAPI void vPXWorldDebugLogFormatted(vPPXWorld world, vPCHAR message, ...)
+{
+	va_list args;
+
+	vCHAR strBuff[BUFF_MEDIUM];
+	va_start(args, message);
+	vsprintf_s(strBuff, sizeof(strBuff), message, args);
+	vPXWorldDebugLog(world, strBuff);
+	va_end(args);
+}
+
 VPHYSAPI vBOOL vPXIsDebug(void)
 {
-	return _vphys.debugMode;
+	return vPXWorldIsDebug(&_vphys);
 }
 
 VPHYSAPI void vPXDebugMode(vBOOL mode)
 {
-	vPXLock();
-	_vphys.debugMode = mode;
-	vPXUnlock();
+	vPXWorldDebugMode(&_vphys, mode);
+}
+
+VPHYSAPI void vPXDebugSetView(vGRect view)
+{
+	vPXWorldDebugSetView(&_vphys, view);
+}
+
+VPHYSAPI void vPXDebugClearView(void)
+{
+	vPXWorldDebugClearView(&_vphys);
 }
 
 VPHYSAPI void vPXDebugAttatchOutputHandle(HANDLE hOut, vUI64 flushInterval)
 {
-	vPXLock();
-	_vphys.debugModeOutput = hOut;
-	_vphys.debugLogCount = 0;
-	_vphys.debugFlushInterval = flushInterval;
-	vPXUnlock();
+	vPXWorldDebugAttatchOutputHandle(&_vphys, hOut, flushInterval);
 }
 
 VPHYSAPI void vPXDebugRemoveOuputHandle(void)
 {
-	vPXLock();
-	_vphys.debugModeOutput = NULL;
-	vPXUnlock();
+	vPXWorldDebugRemoveOuputHandle(&_vphys);
 }
 
 VPHYSAPI void vPXDebugLog(vPCHAR message)
 {
-	if (_vphys.debugMode == FALSE || _vphys.debugModeOutput == NULL) return;
-	vFileWrite(_vphys.debugModeOutput, vFileSize(_vphys.debugModeOutput),
-		strlen(message), message);
-	_vphys.debugLogCount++;
-
-	if (_vphys.debugLogCount % _vphys.debugFlushInterval == 0)
-		FlushFileBuffers(_vphys.debugModeOutput);
+	vPXWorldDebugLog(&_vphys, message);
 }
 
 VPHYSAPI void vPXDebugLogFormatted(vPCHAR message, ...)
@@ -102,14 +337,15 @@ VPHYSAPI void vPXDebugLogFormatted(vPCHAR message, ...)
 	vCHAR strBuff[BUFF_MEDIUM];
 	va_start(args, message);
 	vsprintf_s(strBuff, sizeof(strBuff), message, args);
-	vPXDebugLog(strBuff);
+	vPXWorldDebugLog(&_vphys, strBuff);
 	va_end(args);
 }
 
 VPHYSAPI void vPXDebugPhysicalToString(vPCHAR buffer, SIZE_T buffSize,
 	vPPhysical p)
 {
-	vPXLock();
+	vPPXWorld world = p->world;
+	if (world != NULL) vPXWorldLock(world);
 	sprintf_s(buffer, buffSize,
 		"PHYSICAL %p:\n"
 		"A: %I64u M: %f T:(%f, %f) S: %f R: %f\n"
@@ -119,21 +355,23 @@ VPHYSAPI void vPXDebugPhysicalToString(vPCHAR buffer, SIZE_T buffSize,
 		p->transform.scale, p->transform.rotation, 
 		p->velocity.x, p->velocity.y, p->acceleration.x, p->acceleration.y,
 		p->properties.collideLayer);
-	vPXUnlock();
+	if (world != NULL) vPXWorldUnlock(world);
 }
 
 /* ========== OBJECT CREATION					==========	*/
-VPHYSAPI vPPhysical vPXCreatePhysicsObject(vPObject object, vTransform transform,
-	vGRect boundingBox, vFloat drag, vFloat friction,
-	vFloat mass, vUI8 collideLayer)
+VPHYSAPI vPPhysical vPXWorldCreatePhysicsObject(vPPXWorld world,
+	vPObject object, vTransform transform, vGRect boundingBox, vFloat drag,
+	vFloat friction, vFloat mass, vUI8 collideLayer)
 {
 	/* create heap input copy */
 	vPPhysical targetCopy = vAllocZeroed(sizeof(vPhysical));
 
 	targetCopy->object = object;
+	targetCopy->world  = world;
 
 	targetCopy->properties.isActive			 = TRUE; /* mark object as active		*/
 	targetCopy->properties.collideLayer      = collideLayer;
+	targetCopy->properties.fieldLayer        = collideLayer;
 	targetCopy->renderableTransformOverride  = TRUE;
 
 	/* setup default transform */
@@ -143,12 +381,12 @@ VPHYSAPI vPPhysical vPXCreatePhysicsObject(vPObject object, vTransform transform
 	vPComponent renderComp = vObjectGetComponent(object, vGGetComponentHandle());
 	if (renderComp == NULL)
 	{
-		vPXDebugLog("No renderable found.\n");
+		vPXWorldDebugLog(world, "No renderable found.\n");
 	}
 	else
 	{
 		targetCopy->renderableCache = renderComp->objectAttribute;
-		vPXDebugLogFormatted("Found existing renderable: %p\n", 
+		vPXWorldDebugLogFormatted(world, "Found existing renderable: %p\n", 
 			targetCopy->renderableCache);
 	}
 
@@ -157,33 +395,185 @@ VPHYSAPI vPPhysical vPXCreatePhysicsObject(vPObject object, vTransform transform
 	targetCopy->mass  = max(VPHYS_EPSILON, mass); /* ensure min mass */
 	targetCopy->bound = boundingBox;
 
-	/* component add is synchronized */
-	vPXLock();
-	vPComponent comp = vObjectAddComponent(object, _vphys.physComponent, targetCopy);
-	vPXUnlock();
+	/* component add is synchronized with the owning world */
+	vPXWorldLock(world);
+	vPComponent comp = vObjectAddComponent(object, __physComponent, targetCopy);
+	vPXWorldUnlock(world);
 
 	/* if debug mode, log the creation */
-	if (vPXIsDebug())
+	if (vPXWorldIsDebug(world))
 	{
 		vPPhysical phys = comp->objectAttribute;
-		vPXDebugLogFormatted("Created New Object at <%f %f>\n",
+		vPXWorldDebugLogFormatted(world, "Created New Object at <%f %f>\n",
 			phys->transform.position.x, phys->transform.position.y);
 	}
 
 	return comp->objectAttribute;
 }
 
+VPHYSAPI vPPhysical vPXCreatePhysicsObject(vPObject object, vTransform transform,
+	vGRect boundingBox, vFloat drag, vFloat friction,
+	vFloat mass, vUI8 collideLayer)
+{
+	return vPXWorldCreatePhysicsObject(&_vphys, object, transform,
+		boundingBox, drag, friction, mass, collideLayer);
+}
+
 VPHYSAPI void vPXSetPhysicsObjectCallbacks(vPPhysical pObj,
 	vPXPFPHYSICALUPDATEFUNC updateFunc,
 	vPXPFPHYSICALCOLLISIONFUNC collisionCallback)
 {
 	pObj->updateFunc = updateFunc;
 	pObj->collisionFunc = collisionCallback;
+	vPXTouchPhysicsObject(pObj);
+}
+
+VPHYSAPI void vPXSetPhysicsObjectTransform(vPPhysical pObj,
+	vTransform transform)
+{
+	pObj->transform = transform;
+	vPXTouchPhysicsObject(pObj);
+}
+
+VPHYSAPI void vPXSetPhysicsObjectVelocity(vPPhysical pObj, vVect velocity,
+	vFloat angularVelocity)
+{
+	pObj->velocity        = velocity;
+	pObj->angularVelocity = angularVelocity;
+	vPXTouchPhysicsObject(pObj);
+}
+
+VPHYSAPI void vPXTouchPhysicsObject(vPPhysical pObj)
+{
+	/* the view is gathered at the start of the next tick */
+	vPPXWorld world = pObj->world;
+	if (world == NULL) return;
+
+	vPXWorldLock(world);
+	vUI32 body = PXBodyStoreResolve(world, pObj->handle);
+	if (body != PX_BODY_NONE) PXBodyStoreTouch(world, body);
+	vPXWorldUnlock(world);
 }
 
 VPHYSAPI void vPXDestroyPhysicsObject(vPObject object)
 {
-	vObjectRemoveComponent(object, _vphys.physComponent);
+	vPComponent comp = vObjectGetComponent(object, __physComponent);
+	if (comp == NULL) return;
+
+	/* component remove is synchronized with the owning world */
+	vPPXWorld world = ((vPPhysical)comp->objectAttribute)->world;
+	if (world != NULL) vPXWorldLock(world);
+	vObjectRemoveComponent(object, __physComponent);
+	if (world != NULL) vPXWorldUnlock(world);
+}
+
+
+/* ========== HEADLESS BODIES					==========	*/
+VPHYSAPI vPXHandle vPXWorldCreateBody(vPPXWorld world, vTransform transform,
+	vGRect boundingBox, vFloat drag, vFloat friction, vFloat mass,
+	vUI8 collideLayer)
+{
+	vPXWorldLock(world);
+
+	vPPhysical phys = PXBodyStoreAcquireView(world);
+	phys->properties.isActive     = TRUE;
+	phys->properties.collideLayer = collideLayer;
+	phys->properties.fieldLayer   = collideLayer;
+	phys->transform = transform;
+	phys->drag      = drag;
+	phys->friction  = friction;
+	phys->mass      = max(VPHYS_EPSILON, mass); /* ensure min mass */
+	phys->bound     = boundingBox;
+
+	PXBodyStoreAdd(world, phys);
+	vPXHandle handle = phys->handle;
+
+	vPXWorldUnlock(world);
+	return handle;
+}
+
+VPHYSAPI vPXHandle vPXCreateBody(vTransform transform, vGRect boundingBox,
+	vFloat drag, vFloat friction, vFloat mass, vUI8 collideLayer)
+{
+	return vPXWorldCreateBody(&_vphys, transform, boundingBox, drag,
+		friction, mass, collideLayer);
+}
+
+VPHYSAPI vBOOL vPXWorldDestroyBody(vPPXWorld world, vPXHandle handle)
+{
+	vPXWorldLock(world);
+
+	vUI32 body = PXBodyStoreResolve(world, handle);
+	if (body == PX_BODY_NONE || world->bodies.physical[body]->object != NULL)
+	{
+		vPXWorldUnlock(world);
+		return FALSE;
+	}
+
+	/* the view goes back to the pool for the next headless body */
+	vPPhysical phys = world->bodies.physical[body];
+	PXBodyStoreRemove(world, body);
+	PXBodyStoreReleaseView(world, phys);
+
+	vPXWorldUnlock(world);
+	return TRUE;
+}
+
+VPHYSAPI vBOOL vPXDestroyBody(vPXHandle handle)
+{
+	return vPXWorldDestroyBody(&_vphys, handle);
+}
+
+
+/* ========== HANDLES							==========	*/
+VPHYSAPI vPXHandle vPXGetPhysicsObjectHandle(vPPhysical pObj)
+{
+	return pObj->handle;
+}
+
+VPHYSAPI vPPXWorld vPXGetPhysicsObjectWorld(vPPhysical pObj)
+{
+	return pObj->world;
+}
+
+VPHYSAPI vPPhysical vPXWorldResolveHandle(vPPXWorld world, vPXHandle handle)
+{
+	vPXWorldLock(world);
+	vUI32 body = PXBodyStoreResolve(world, handle);
+	vPPhysical pObj = (body == PX_BODY_NONE) ? NULL : 
+		world->bodies.physical[body];
+	vPXWorldUnlock(world);
+	return pObj;
+}
+
+VPHYSAPI vBOOL vPXWorldIsHandleValid(vPPXWorld world, vPXHandle handle)
+{
+	vPXWorldLock(world);
+	vBOOL valid = PXBodyStoreResolve(world, handle) != PX_BODY_NONE;
+	vPXWorldUnlock(world);
+	return valid;
+}
+
+VPHYSAPI void vPXWorldSpatialSortEnable(vPPXWorld world, vBOOL enable)
+{
+	vPXWorldLock(world);
+	world->bodies.sortEnabled = enable;
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI vPPhysical vPXResolveHandle(vPXHandle handle)
+{
+	return vPXWorldResolveHandle(&_vphys, handle);
+}
+
+VPHYSAPI vBOOL vPXIsHandleValid(vPXHandle handle)
+{
+	return vPXWorldIsHandleValid(&_vphys, handle);
+}
+
+VPHYSAPI void vPXSpatialSortEnable(vBOOL enable)
+{
+	vPXWorldSpatialSortEnable(&_vphys, enable);
 }
 
 
@@ -368,12 +758,22 @@ VPHYSAPI void   vPXFastFabsP(vPFloat pf)
 
 
 /* ========== SYNCHRONIZATION					==========	*/
+VPHYSAPI void vPXWorldLock(vPPXWorld world)
+{
+	EnterCriticalSection(&world->lock);
+}
+
+VPHYSAPI void vPXWorldUnlock(vPPXWorld world)
+{
+	LeaveCriticalSection(&world->lock);
+}
+
 VPHYSAPI void vPXLock(void)
 {
-	EnterCriticalSection(&_vphys.lock);
+	vPXWorldLock(&_vphys);
 }
 
 VPHYSAPI void vPXUnlock(void)
 {
-	LeaveCriticalSection(&_vphys.lock);
+	vPXWorldUnlock(&_vphys);
 }
@@ -14,12 +14,53 @@
 
 
 /* ========== INITIALIZATION					==========	*/
+/* initializes the default world used by every function		*/
+/* without a world parameter								*/
 VPHYSAPI vBOOL vPXInitialize(HANDLE debugOut, vUI64 flushInterval);
+VPHYSAPI vBOOL vPXInitializeHeadless(HANDLE debugOut, vUI64 flushInterval);
+
+
+/* ========== WORLDS							==========	*/
+/* worlds share nothing mutable; each is locked, stepped	*/
+/* (by its own worker or by vPXWorldStep) and destroyed		*/
+/* independently of every other world						*/
+VPHYSAPI vPPXWorld vPXWorldCreate(HANDLE debugOut, vUI64 flushInterval,
+	vBOOL createWorker);
+VPHYSAPI void      vPXWorldDestroy(vPPXWorld world);
+VPHYSAPI vPPXWorld vPXGetDefaultWorld(void);
+
+
+/* ========== SIMULATION						==========	*/
+VPHYSAPI void vPXWorldStep(vPPXWorld world);
+VPHYSAPI void vPXWorldGetStats(vPPXWorld world, vPPXStats statsOut);
+/* deterministic worlds step bit-identically for identical	*/
+/* inputs: bodies keep creation order, contacts are resolved	*/
+/* in a fixed order, the worker runs whole fixed-length ticks	*/
+/* and a state hash is recorded after every tick				*/
+VPHYSAPI void  vPXWorldSetDeterministic(vPPXWorld world, vBOOL enable);
+VPHYSAPI vBOOL vPXWorldIsDeterministic(vPPXWorld world);
+VPHYSAPI void  vPXWorldSetTickInterval(vPPXWorld world, vUI64 microseconds);
+VPHYSAPI vUI64 vPXWorldGetStateHash(vPPXWorld world);
+VPHYSAPI vUI64 vPXWorldComputeStateHash(vPPXWorld world);
+VPHYSAPI void vPXStep(void);
+VPHYSAPI void vPXGetStats(vPPXStats statsOut);
 
 
 /* ========== DEBUG LOGGING						==========	*/
+VPHYSAPI vBOOL vPXWorldIsDebug(vPPXWorld world);
+VPHYSAPI void vPXWorldDebugMode(vPPXWorld world, vBOOL mode);
+VPHYSAPI void vPXWorldDebugSetView(vPPXWorld world, vGRect view);
+VPHYSAPI void vPXWorldDebugClearView(vPPXWorld world);
+VPHYSAPI void vPXWorldDebugAttatchOutputHandle(vPPXWorld world, HANDLE hOut,
+	vUI64 flushInterval);
+VPHYSAPI void vPXWorldDebugRemoveOuputHandle(vPPXWorld world);
+VPHYSAPI void vPXWorldDebugLog(vPPXWorld world, vPCHAR message);
+VPHYSAPI void vPXWorldDebugLogFormatted(vPPXWorld world, vPCHAR message, ...);
+
 VPHYSAPI vBOOL vPXIsDebug(void);
 VPHYSAPI void vPXDebugMode(vBOOL mode);
+VPHYSAPI void vPXDebugSetView(vGRect view);
+VPHYSAPI void vPXDebugClearView(void);
 VPHYSAPI void vPXDebugAttatchOutputHandle(HANDLE hOut, vUI64 flushInterval);
 VPHYSAPI void vPXDebugRemoveOuputHandle(void);
 VPHYSAPI void vPXDebugLog(vPCHAR message);
@@ -28,15 +69,50 @@ VPHYSAPI void vPXDebugPhysicalToString(vPCHAR buffer, SIZE_T buffSize,
 	vPPhysical physical);
 
 /* ========== OBJECT CREATION					==========	*/
+VPHYSAPI vPPhysical vPXWorldCreatePhysicsObject(vPPXWorld world,
+	vPObject object, vTransform transform, vGRect boundingBox, vFloat drag,
+	vFloat friction, vFloat mass, vUI8 collideLayer);
 VPHYSAPI vPPhysical vPXCreatePhysicsObject(vPObject object, vTransform transform,
 	vGRect boundingBox, vFloat drag, vFloat friction,
 	vFloat mass, vUI8 collideLayer);
 VPHYSAPI void vPXSetPhysicsObjectCallbacks(vPPhysical pObj,
 	vPXPFPHYSICALUPDATEFUNC updateFunc,
 	vPXPFPHYSICALCOLLISIONFUNC collisionCallback);
+VPHYSAPI void vPXSetPhysicsObjectTransform(vPPhysical pObj,
+	vTransform transform);
+VPHYSAPI void vPXSetPhysicsObjectVelocity(vPPhysical pObj, vVect velocity,
+	vFloat angularVelocity);
+/* marks a view written directly, so the next tick reads it */
+VPHYSAPI void vPXTouchPhysicsObject(vPPhysical pObj);
 VPHYSAPI void vPXDestroyPhysicsObject(vPObject object);
 
 
+/* ========== HEADLESS BODIES					==========	*/
+/* bodies with no object, named by handle. only these can	*/
+/* be paged out by streaming, see vphysstream.h				*/
+VPHYSAPI vPXHandle vPXWorldCreateBody(vPPXWorld world, vTransform transform,
+	vGRect boundingBox, vFloat drag, vFloat friction, vFloat mass,
+	vUI8 collideLayer);
+/* bodies owned by an object are destroyed with its			*/
+/* component instead, see vPXDestroyPhysicsObject			*/
+VPHYSAPI vBOOL vPXWorldDestroyBody(vPPXWorld world, vPXHandle handle);
+VPHYSAPI vPXHandle vPXCreateBody(vTransform transform, vGRect boundingBox,
+	vFloat drag, vFloat friction, vFloat mass, vUI8 collideLayer);
+VPHYSAPI vBOOL vPXDestroyBody(vPXHandle handle);
+
+
+/* ========== HANDLES							==========	*/
+/* handles are only meaningful to the world that issued them	*/
+VPHYSAPI vPXHandle  vPXGetPhysicsObjectHandle(vPPhysical pObj);
+VPHYSAPI vPPXWorld  vPXGetPhysicsObjectWorld(vPPhysical pObj);
+VPHYSAPI vPPhysical vPXWorldResolveHandle(vPPXWorld world, vPXHandle handle);
+VPHYSAPI vBOOL      vPXWorldIsHandleValid(vPPXWorld world, vPXHandle handle);
+VPHYSAPI void       vPXWorldSpatialSortEnable(vPPXWorld world, vBOOL enable);
+VPHYSAPI vPPhysical vPXResolveHandle(vPXHandle handle);
+VPHYSAPI vBOOL      vPXIsHandleValid(vPXHandle handle);
+VPHYSAPI void       vPXSpatialSortEnable(vBOOL enable);
+
+
 /* ========== VECTOR LOGIC						==========	*/
 VPHYSAPI vVect vPXCreateVect(vFloat x, vFloat y);
 VPHYSAPI void vPXEnforceEpsilonF(vPFloat f1);
@@ -67,6 +143,8 @@ VPHYSAPI void   vPXFastFabsP(vPFloat pf);
 
 
 /* ========== SYNCHRONIZATION					==========	*/
+VPHYSAPI void vPXWorldLock(vPPXWorld world);
+VPHYSAPI void vPXWorldUnlock(vPPXWorld world);
 VPHYSAPI void vPXLock(void);
 VPHYSAPI void vPXUnlock(void);
 
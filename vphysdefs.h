@@ -10,6 +10,7 @@
 #include "vcore.h"
 #include "vgfx.h"
 #include "vtypes.h"
+#include <stdio.h>
 
 
 /* ========== API DEFINITION					==========	*/
@@ -21,12 +22,194 @@
 
 
 /* ========== DEFINITIONS						==========	*/
-#define PHYSOBJECT_LIST_NODE_SIZE		0x200
 #define VPHYS_EPSILON					0.005f
 #define PARTITION_CAPACITY_MIN			0x20
 #define PARTITION_CAPACITY_STEP			0x40
 #define PARTITION_BUFFER_NODE_SIZE		0x80
 #define PARTITION_SIZE_DEFAULT			3.0f
+#define PARTITION_POOL_CAPACITY_MIN		0x80
+
+#define BODYSTORE_CAPACITY_MIN			0x100
+#define BODYSTORE_VIEW_BLOCK			0x400	/* headless views per block			*/
+#define BODYSORT_CHECK_INTERVAL			0x10	/* ticks between disorder checks	*/
+#define BODYSORT_INTERVAL_MIN			0x40	/* ticks between resorts			*/
+#define BODYSORT_DISORDER_THRESHOLD		0.2f
+
+#define PX_HANDLE_NULL					0
+#define PX_HANDLE_INDEX_BITS			22
+#define PX_HANDLE_INDEX_MASK			0x003FFFFF
+#define PX_HANDLE_GENERATION_MASK		0x3FF
+#define PX_BODY_NONE					0xFFFFFFFF
+#define PX_SLOT_PAGED					2		/* slot inUse while paged out	*/
+
+#define PX_BODY_ACTIVE					0x01	/* body is simulated		*/
+#define PX_BODY_NO_PARTITION_OPTIMIZE	0x02	/* never skip its partition	*/
+#define PX_BODY_SENSOR					0x04	/* overlap events only		*/
+#define PX_BODY_STATIC					0x08	/* staticPosition is set	*/
+#define PX_BODY_IDLE					0x10	/* LOD skips it this tick	*/
+#define PX_BODY_THREADSAFE_UPDATE		0x20	/* updateFunc may go wide	*/
+#define PX_BODY_UPDATED					0x40	/* updateFunc ran on pool	*/
+#define PX_BODY_TICK_FLAGS				(PX_BODY_IDLE | PX_BODY_UPDATED) /* not recorded */
+
+#define PX_VIEW_DIRTY					0x01	/* view written, gather it	*/
+#define PX_VIEW_BOUND					0x02	/* world bound rebuilt		*/
+
+#define QUERY_SNAPSHOT_COUNT			3
+#define QUERY_CAPACITY_MIN				0x100
+
+#define PX_RAY_ANY_HIT					0x01	/* stop at first hit found	*/
+
+#define PX_SHAPE_BOUND					0		/* each body's own bound rect	*/
+#define PX_SHAPE_TABLE_MAX				0xFFFF
+#define PX_SHAPE_TABLE_CAPACITY_MIN		0x10
+#define PX_SHAPE_VERTS_MAX				8
+
+#define PX_SHAPE_TYPE_BOX				0
+#define PX_SHAPE_TYPE_CIRCLE			1
+#define PX_SHAPE_TYPE_CAPSULE			2
+#define PX_SHAPE_TYPE_POLYGON			3
+#define PX_SHAPE_TYPE_COUNT				4
+
+#define CONTACT_CAPACITY_MIN			0x400
+
+#define PARTICLESTORE_CAPACITY_MIN		0x400
+#define PX_PARTICLE_LIFE_FOREVER		0xFFFFFFFF
+#define PX_PARTICLE_RESTITUTION_DEFAULT	0.3f
+#define PX_PARTICLE_CELLMASK_MAX		0x1000000	/* bits, else unfiltered	*/
+
+#define FIELDSTORE_CAPACITY_MIN			0x10
+#define FIELDSTORE_SCRATCH_MIN			0x400
+#define PX_FIELD_NONE					0			/* never a valid field id	*/
+#define PX_FIELD_LIFE_FOREVER			0xFFFFFFFF
+
+#define PX_FIELD_DIRECTIONAL			0			/* along a fixed direction	*/
+#define PX_FIELD_RADIAL					1			/* away from the center		*/
+#define PX_FIELD_VORTEX					2			/* counter clockwise around	*/
+#define PX_FIELD_TYPE_COUNT				3
+
+#define PX_FIELD_FALLOFF_NONE			0
+#define PX_FIELD_FALLOFF_LINEAR			1			/* 1 - d / radius			*/
+#define PX_FIELD_FALLOFF_QUADRATIC		2			/* (1 - d / radius)^2		*/
+#define PX_FIELD_FALLOFF_COUNT			3
+
+#define PX_FIELD_USE_MASS				0x01		/* strength is a force		*/
+
+#define SENSORSTATE_CAPACITY_MIN		0x40
+#define PX_SENSOR_EVENTS_MAX			0x100000	/* queued, then dropped		*/
+#define PX_SENSOR_ENTER					0
+#define PX_SENSOR_EXIT					1
+
+#define PX_LAYER_COUNT					8		/* bits of collideLayer		*/
+#define LAYERGROUP_NONE					0xFFFF
+
+#define PX_REGION_SIZE_DEFAULT			96.0f	/* region side, world units	*/
+#define PX_STREAM_INTERVAL				0x10	/* ticks between checks		*/
+#define PX_STREAM_EVICT_MARGIN			0.5f	/* regions past the radius	*/
+#define PX_STREAM_JOBS_MAX				0x20	/* page reads in flight		*/
+#define PX_STREAM_LOADER_INTERVAL		1		/* loader cycle, ms			*/
+#define STREAM_REGION_CAPACITY_MIN		0x40
+#define STREAM_SCRATCH_MIN				0x100
+#define PX_REGION_RESIDENT				0
+#define PX_REGION_PAGED					1		/* in the page file			*/
+#define PX_REGION_LOADING				2		/* page read in flight		*/
+#define PX_STREAM_JOB_FREE				0
+#define PX_STREAM_JOB_QUEUED			1
+#define PX_STREAM_JOB_DONE				2
+#define PX_STREAM_JOB_FAILED			3
+
+#define PX_INTERESTS_MAX				0x40
+#define PX_INTEREST_NONE				0
+#define PX_LOD_FULL						0		/* stepped every tick		*/
+#define PX_LOD_HALF						1		/* every 2nd, double step	*/
+#define PX_LOD_QUARTER					2		/* every 4th, 4x step		*/
+#define PX_LOD_EIGHTH					3		/* every 8th, tick budget	*/
+#define PX_LOD_FROZEN					4		/* not stepped				*/
+#define PX_LOD_TIER_COUNT				5
+#define PX_LOD_STEPS_MAX				(1 << PX_LOD_EIGHTH)	/* per tick	*/
+#define PX_LOD_HALF_RANGE_DEFAULT		32.0f	/* past interest radius		*/
+#define PX_LOD_QUARTER_RANGE_DEFAULT	96.0f	/* past interest radius		*/
+
+#define PX_POOL_THREADS_MAX				0x20	/* helpers per world		*/
+#define PX_UPDATE_CHUNK					0x20	/* bodies per pool task		*/
+
+#define PX_DEGRADE_NONE					0
+#define PX_DEGRADE_PARTICLES			1	/* no particle-particle tests	*/
+#define PX_DEGRADE_LOD					2	/* far LOD tiers one slower		*/
+#define PX_DEGRADE_PAIR_CAP				3	/* pair tests per cell capped	*/
+#define PX_DEGRADE_LEVEL_COUNT			4
+#define PX_BUDGET_PANIC					2.0f	/* over by this, go to the	*/
+												/* last level at once		*/
+#define PX_BUDGET_RECOVER				0.75f	/* under by this to recover	*/
+#define PX_BUDGET_CALM_TICKS			0x10	/* ticks under, per level	*/
+#define PX_BUDGET_SMOOTHING				0.25f	/* weight of the last tick	*/
+#define PX_BUDGET_CELL_PAIRS			0x100	/* pair tests per cell		*/
+#define PX_BUDGET_PAIR_STRIDE			0x9E3779B1	/* golden ratio, 2^32	*/
+
+#define PX_TICK_INTERVAL_DEFAULT		10000	/* fixed tick length, us	*/
+#define PX_TICK_CATCHUP_MAX				0x8		/* ticks per worker cycle	*/
+
+#define PX_HASH_OFFSET					0xcbf29ce484222325ull
+#define PX_HASH_PRIME					0x00000100000001b3ull
+
+#define PX_SNAPSHOT_MAGIC				0x53585056	/* "VPXS" little endian	*/
+#define PX_SNAPSHOT_VERSION				5
+#define PX_SNAPSHOT_ALIGN				0x40		/* section alignment	*/
+#define PX_SNAPSHOT_WRITE_BUFFER		0x100000
+#define PX_SNAPSHOT_STATIC_POSITION		0x01		/* body property bits	*/
+#define PX_SNAPSHOT_STATIC_ROTATION		0x02
+
+#define PX_SNAPSHOT_SECTION_SLOTS				0
+#define PX_SNAPSHOT_SECTION_PROPERTIES			1
+#define PX_SNAPSHOT_SECTION_HANDLE				2
+#define PX_SNAPSHOT_SECTION_POSITION			3
+#define PX_SNAPSHOT_SECTION_ROTATION			4
+#define PX_SNAPSHOT_SECTION_SCALE				5
+#define PX_SNAPSHOT_SECTION_VELOCITY			6
+#define PX_SNAPSHOT_SECTION_ACCELERATION		7
+#define PX_SNAPSHOT_SECTION_ANGULARVELOCITY		8
+#define PX_SNAPSHOT_SECTION_ANGULARACCELERATION	9
+#define PX_SNAPSHOT_SECTION_MASS				10
+#define PX_SNAPSHOT_SECTION_DRAG				11
+#define PX_SNAPSHOT_SECTION_FRICTION			12
+#define PX_SNAPSHOT_SECTION_BOUND				13
+#define PX_SNAPSHOT_SECTION_COLLIDELAYER		14
+#define PX_SNAPSHOT_SECTION_FLAGS				15
+#define PX_SNAPSHOT_SECTION_AGE					16
+#define PX_SNAPSHOT_SECTION_ANTICIPATEDPOS		17
+#define PX_SNAPSHOT_SECTION_WORLDBOUND			18
+#define PX_SNAPSHOT_SECTION_SHAPE				19
+#define PX_SNAPSHOT_SECTION_SHAPES				20
+#define PX_SNAPSHOT_SECTION_LASTSTEPTICK		21
+#define PX_SNAPSHOT_SECTION_FIELDLAYER			22
+#define PX_SNAPSHOT_SECTION_COUNT				23
+
+#define PX_RECORD_MAGIC					0x52585056	/* "VPXR" little endian	*/
+#define PX_RECORD_VERSION				1
+#define PX_RECORD_RING_DEFAULT			0x10		/* captured ticks		*/
+#define PX_RECORD_KEYFRAME_DEFAULT		0x40		/* frames per keyframe	*/
+#define PX_RECORD_DRAIN_INTERVAL		4			/* writer cycle, ms		*/
+#define PX_RECORD_WRITE_BUFFER			0x100000
+#define PX_RECORD_POSITION_SCALE		4096.0f		/* quanta per unit		*/
+#define PX_RECORD_ROTATION_SCALE		4096.0f
+#define PX_RECORD_VELOCITY_SCALE		4096.0f
+#define PX_RECORD_QUANT_LIMIT			4.0e18		/* clamp before rounding	*/
+#define PX_RECORD_QUANT_INVALID			0xFFFFFFFFFFFFFFFFull	/* NaN, zigzagged	*/
+#define PX_RECORD_ENTRY_MAX				0x40		/* encoded bytes per body	*/
+
+#define PX_RECORD_FRAME_KEY				0
+#define PX_RECORD_FRAME_DELTA			1
+
+#define PX_RECORD_FIELD_POSITION_X		0
+#define PX_RECORD_FIELD_POSITION_Y		1
+#define PX_RECORD_FIELD_ROTATION		2
+#define PX_RECORD_FIELD_VELOCITY_X		3
+#define PX_RECORD_FIELD_VELOCITY_Y		4
+#define PX_RECORD_FIELD_COUNT			5
+#define PX_RECORD_ENTRY_FLAGS			0x20		/* entry mask bits, the	*/
+#define PX_RECORD_ENTRY_REMOVED			0x40		/* low bits are fields	*/
+
+#define CELLMAP_CAPACITY_MIN			0x100
+#define CELLMAP_EMPTY					0xFFFFFFFF
 
 #define POS_DEINTERSECT_COEFF			0.75f
 
@@ -42,18 +225,67 @@
 #define PARTITION_LINESIZE				3.0f
 #define PUSHVECTOR_COLORb				200, 64, 64, 200
 #define PUSHVECTOR_LINESIZE				7.5f
+#define BOUND_CENTER_CROSSSIZE			0.05f
+
+#define DEBUGDRAW_COLORb				BOUND_MESH_COLORb
+#define DEBUGDRAW_LINESIZE				BOUND_MESH_LINESIZE
+#define DEBUGDRAW_BODY_VERTS			19	/* quad, cross, velocity, box	*/
+#define DEBUGDRAW_PARTITION_VERTS		5
+#define DEBUGDRAW_CAPACITY_MIN			0x400
+#define DEBUGDRAW_CAPACITY_MAX			0xFFFF	/* vGDrawLinesConnected limit	*/
 
 #define PARITION_MINVELOCITY			0.01f
 #define PARTITION_OPTIMIZE_MINAGE		0x100
 
 #define PROFILER_REFRESH_INTERVAL		0x40
 
-#define RAND_STARTSEED					2101232123.0f
-#define RAND_VAL_A						214013.0f
-#define RAND_VAL_C						2531011.0f
-#define RAND_VAL_M						4294968143.0f
-#define RAND_NUMTABLE_SIZE				0x800
-#define RAND_GRANULARITY				10000.0f
+#define PX_PHASE_PARTITION_RESET		0
+#define PX_PHASE_SETUP					1
+#define PX_PHASE_COLLISION				2
+#define PX_PHASE_DYNAMICS				3
+#define PX_PHASE_PARTICLES				4
+#define PX_PHASE_DEBUGDRAW				5
+#define PX_PHASE_COUNT					6
+
+#define TRACE_CAPACITY_DEFAULT			0x40000
+#define TRACE_CAPACITY_MAX				0x8000000	/* ring slots, power of two	*/
+#define TRACE_PROCESS_ID				1
+
+#define PX_TRACE_SPAN					0
+#define PX_TRACE_COUNTER				1
+
+#define PX_TRACE_TICK					0
+#define PX_TRACE_PARTITION_RESET		1
+#define PX_TRACE_SETUP					2
+#define PX_TRACE_COLLISION				3
+#define PX_TRACE_COLLISION_PARTITION	4
+#define PX_TRACE_DYNAMICS				5
+#define PX_TRACE_UPDATEFUNC				6
+#define PX_TRACE_DEBUGDRAW				7
+#define PX_TRACE_COUNTER_BODIES			8
+#define PX_TRACE_COUNTER_PAIRS			9
+#define PX_TRACE_PARTICLES				10
+#define PX_TRACE_TILEMAP				11
+#define PX_TRACE_FORCEFIELDS			12
+#define PX_TRACE_SENSORS				13
+#define PX_TRACE_STREAM					14
+#define PX_TRACE_LOD					15
+#define PX_TRACE_COUNTER_BUDGET			16
+#define PX_TRACE_NAME_COUNT				17
+
+#define RAND_LANES						8			/* interleaved generators	*/
+#define RAND_SEED_DEFAULT				0x5851f42d4c957f2dull
+#define RAND_FLOAT_SCALE				(1.0f / 16777216.0f)	/* 24 bit mantissa	*/
+
+#define PX_TILE_EMPTY					0
+#define PX_TILEMAP_SIDE_MAX				0x4000		/* tiles per row or column	*/
+#define PX_TILEMAP_RESTITUTION_DEFAULT	0.0f
+#define PX_TILEMAP_FRICTION_DEFAULT		0.05f
+
+#define PX_TILE_FACE_LEFT				0x01		/* exposed tile faces		*/
+#define PX_TILE_FACE_RIGHT				0x02
+#define PX_TILE_FACE_BOTTOM				0x04
+#define PX_TILE_FACE_TOP				0x08
 
 #define PX_LAYER_0		0x01
 #define PX_LAYER_1		0x02
@@ -65,11 +297,28 @@
 #define PX_LAYER_7		0x80
 
 
+/* SSE2 is always there on x64, bulk paths use it when set */
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define PX_SSE2
+#endif
+
+/* thread-local storage, the shim's __declspec is a no-op */
+#ifdef _MSC_VER
+#define PX_THREAD_LOCAL __declspec(thread)
+#else
+#define PX_THREAD_LOCAL __thread
+#endif
+
+
 /* ========== TYPEDEFS							==========	*/
 typedef vPosition vVect;
 typedef vVect*    vPVect;
 typedef float	  vFloat;
 typedef vFloat*   vPFloat;
+typedef vUI32	  vPXHandle;	/* generation << 22 | slot, never 0 */
+typedef vUI16	  vPXShapeID;	/* index into the world shape table	*/
+typedef vUI32	  vPXFieldID;	/* unique per world, never reused	*/
+typedef vUI32	  vPXInterestID;	/* slot + 1, reused once removed	*/
 typedef (*vPXPFPHYSICALUPDATEFUNC)(struct vPhysicial* object);
 typedef (*vPXPFPHYSICALCOLLISIONFUNC)(struct vPhysical* self,
 	struct vPhysical* collideObject);
@@ -82,23 +331,32 @@ typedef struct vPXWorldBoundMesh
 	vVect  center;			/* center vertex			*/
 	vGRect boundingBox;		/* world-space bounding box	*/
 	vVect  boundingBoxDims;
+	vVect  axis;			/* local x axis, rotated	*/
 } vPXWorldBoundMesh, *vPPXWorldBoundMesh;
 
 typedef struct vPXProperties
 {
 	vUI8  collideLayer;	/* collision layer (ranges from 0 - 255) */
+	vUI8  fieldLayer;	/* layers gravity and force fields reach */
 
 	vBOOL noPartitionOptimize;	/* ignore parition velocity optimizations			*/
 	vBOOL isActive;				/* whether the object should be updated				*/
 	vBOOL staticPosition;		/* whether the object can be moved					*/
 	vBOOL staticRotation;		/* whether the object can be rotated				*/
+	vBOOL isSensor;				/* reports overlaps, never collides					*/
+	vBOOL threadSafeUpdate;		/* updateFunc may run in parallel, see vphyspool.h	*/
 } vPXProperties, *vPPXProperties;
 
+/* the simulation reads a view at the start of the next tick	*/
+/* only once it is touched. the vPXSetPhysicsObject setters	*/
+/* touch it, direct writes need vPXTouchPhysicsObject.		*/
+/* update funcs may write their own view freely				*/
 typedef struct vPhysical
 {
 	/* ===== PHYSICS METADATA				===== */
 	vPObject object;
-	vPTR physObjectListPtr;			/* ptr to corresponding element in list				*/
+	struct vPXWorld* world;			/* world simulating this body						*/
+	vPXHandle handle;				/* stable handle to this body						*/
 	vUI64 age;						/* ticks spent active								*/
 
 	vBOOL renderableTransformOverride;	/* whether to copy phys transform to rtransform */
@@ -111,6 +369,7 @@ typedef struct vPhysical
 	
 	/* ==== OBJECT PHYSICS PROPERTIES		===== */
 	vGRect bound;					/* bounding rectangle			*/
+	vPXShapeID shape;				/* collision shape				*/
 	vTransform transform;			/* physics transform			*/
 	vFloat mass;					/* object mass					*/
 	vVect  velocity;				/* change in position			*/
@@ -135,14 +394,678 @@ typedef struct vPXPartition
 	vI32  x, y;	 /* partition coordinates	*/
 
 	vFloat totalVelocity;	/* for optimization */
+
+	vUI8 layerMask;			/* layers of its non-sensor bodies	*/
+	vUI8 layerRepeatMask;	/* layers held by more than one		*/
 	
-	vPPhysical* list;	/* "dyanmic" array of all elements  */
+	vPUI32 list;		/* "dyanmic" array of body indices  */
 	vUI16 capacity;		/* list capacity (can be increased) */
 	vUI16 useage;		/* list useage (always <= capacity) */
 
 } vPXPartiton, *vPPXPartition;
 
-typedef struct _vPXInternals
+typedef struct PXHandleSlot
+{
+	vUI32 body;			/* dense index, or next free slot	*/
+	vUI16 generation;	/* bumped on every release			*/
+	vUI16 inUse;
+} PXHandleSlot, *PPXHandleSlot;
+
+typedef struct PXBodyBlock
+{
+	struct PXBodyBlock* next;
+	vPPhysical views;		/* views of bodies with no object	*/
+	vUI32 count;
+} PXBodyBlock, *PPXBodyBlock;
+
+typedef struct PXShape
+{
+	vUI8   type;			/* PX_SHAPE_TYPE_ type					*/
+	vUI8   vertCount;		/* polygon verts, or 2 capsule ends		*/
+	vFloat radius;			/* circles and capsules					*/
+	vGRect bound;			/* local bounding rect					*/
+	vVect  verts[PX_SHAPE_VERTS_MAX];	/* local, counter clockwise	*/
+	vVect  normals[PX_SHAPE_VERTS_MAX];	/* outward, of edge i to i+1	*/
+} PXShape, *PPXShape;
+
+/* a shape in world space as SAT sees it: the points of its	*/
+/* core, grown by radius, and the axes it contributes		*/
+typedef struct PXShapeHull
+{
+	vVect  points[PX_SHAPE_VERTS_MAX];
+	vUI32  pointCount;
+	vVect  axes[PX_SHAPE_VERTS_MAX];
+	vUI32  axisCount;
+	vFloat radius;		/* 0 for polygonal shapes				*/
+	vVect  center;		/* decides which way a push may point	*/
+} PXShapeHull, *PPXShapeHull;
+
+typedef struct PXBodyStore
+{
+	vUI32 count;		/* bodies live in [0, count)			*/
+	vUI32 capacity;
+	vUI32 removed;		/* holes awaiting in-order compaction,	*/
+						/* a hole has a NULL physical view		*/
+
+	/* ===== HANDLES						===== */
+	PPXHandleSlot slots;			/* handle slot to dense index		*/
+	vUI32 slotCount;
+	vUI32 slotCapacity;
+	vUI32 freeSlot;					/* free slot list head				*/
+
+	/* ===== COLD DATA						===== */
+	vPPhysical* physical;			/* API view of each body			*/
+	vPXHandle*  handle;				/* handle of each body				*/
+	PPXBodyBlock viewBlocks;		/* bulk views of restored bodies	*/
+	vUI32 viewBlockUsed;			/* views handed out of the newest	*/
+	vPPhysical* freeViews;			/* views given back, for reuse		*/
+	vUI32 freeViewCount;
+	vUI32 freeViewCapacity;
+
+	/* ===== SIMULATION STATE				===== */
+	vPVect  position;
+	vPFloat rotation;
+	vPFloat scale;
+	vPVect  velocity;
+	vPVect  acceleration;
+	vPFloat angularVelocity;
+	vPFloat angularAcceleration;
+	vPFloat mass;
+	vPFloat drag;
+	vPFloat friction;
+	vPGRect bound;
+	vPXShapeID* shape;
+	vUI8*   collideLayer;
+	vUI8*   fieldLayer;				/* layers gravity and fields reach	*/
+	vUI8*   flags;					/* PX_BODY_ flags					*/
+	vPUI64  age;
+	vPUI64  lastStepTick;			/* tick count its steps reached		*/
+	vPXPFPHYSICALUPDATEFUNC* updateFunc;
+
+	/* ===== TICK INTERMEDIATE DATA			===== */
+	vPVect anticipatedPos;
+	vPPXWorldBoundMesh worldBound;
+	vPUI64 drawTick;				/* last tick drawn in debug overlay	*/
+	vPUI64 queryTick;				/* last tick published for queries	*/
+	vPUI32 querySlot;				/* index in last published snapshot	*/
+	vUI8*  lodTier;					/* PX_LOD_ tier this tick			*/
+	vUI8*  viewSync;				/* PX_VIEW_ flags					*/
+	vPUI32 hull;					/* index in hulls, or PX_BODY_NONE	*/
+	vPVect  boundOrigin;			/* anticipatedPos, rotation and		*/
+	vPFloat boundRotation;			/* scale the world bound was built	*/
+	vPFloat boundScale;				/* from								*/
+	vUI8*   boundDirty;				/* bound or shape changed since		*/
+
+	/* ===== SPATIAL ORDERING				===== */
+	vBOOL  sortEnabled;
+	vUI64  lastSortTick;
+	vFloat disorder;				/* last measured, see vbodystore.c	*/
+	vPUI32 sortKey;					/* Morton code of each body's cell	*/
+	vPUI32 sortOrder;
+	vPTR   sortScratch;
+
+	/* ===== SHAPES							===== */
+	PPXShape shapes;				/* entry 0 is PX_SHAPE_BOUND		*/
+	vUI32 shapeCount;
+	vUI32 shapeCapacity;
+	PPXShapeHull hulls;				/* world hulls of capsules and		*/
+	vUI32 hullCount;				/* polygons, built every setup		*/
+	vUI32 hullCapacity;
+} PXBodyStore, *PPXBodyStore;
+
+typedef struct vPXDebugDrawBuffer
+{
+	vPVect vertices;		/* one connected line strip for the overlay	*/
+	vUI32  capacity;		/* vertex capacity (grows, never shrinks)	*/
+	vUI32  count;			/* vertices written this tick				*/
+
+	vBOOL  viewEnabled;		/* cull against view rect when set			*/
+	vGRect view;
+} vPXDebugDrawBuffer, *vPPXDebugDrawBuffer;
+
+typedef struct vPXStats
+{
+	vUI64 tickCount;		/* ticks simulated since initialization	*/
+	vUI32 bodies;			/* bodies iterated last tick			*/
+	vUI32 activeBodies;		/* active bodies set up last tick		*/
+	vUI32 partitionsUsed;	/* partitions holding bodies last tick	*/
+	vUI32 pairTests;		/* narrowphase pair tests last tick		*/
+	vUI32 pairHits;			/* colliding pairs found last tick		*/
+	vUI32 bodySorts;		/* spatial re-sorts of body storage		*/
+	vFloat bodyDisorder;	/* body storage disorder, last measured	*/
+	vUI32 contacts;			/* contacts resolved last tick			*/
+	vUI64 stateHash;		/* world state after last tick			*/
+	vUI32 recordDrops;		/* ticks the recorder had no room for	*/
+	vUI32 particles;		/* particles alive after last tick		*/
+	vUI32 particleContacts;	/* particles pushed out last tick		*/
+	vUI32 tileContacts;		/* bodies pushed out of tiles last tick	*/
+	vUI32 fieldBodies;		/* field pushes on bodies last tick		*/
+	vUI32 sensorOverlaps;	/* sensor overlaps after last tick		*/
+	vUI32 sensorEventDrops;	/* events lost to a full queue			*/
+	vUI32 layerCellSkips;	/* cells skipped for layers last tick	*/
+	vUI32 regionsPaged;		/* regions out of memory after last tick	*/
+	vUI32 bodiesPaged;		/* bodies out of memory after last tick	*/
+	vUI32 regionLoads;		/* regions brought back last tick		*/
+	vUI32 regionEvictions;	/* regions paged out last tick			*/
+	vUI32 lodBodies[PX_LOD_TIER_COUNT];	/* active bodies in each tier	*/
+	vUI32 lodIdle;			/* bodies LOD did not step last tick	*/
+	vUI32 parallelUpdates;	/* updateFuncs run on the pool last tick	*/
+	vUI32 boundsReused;		/* world bounds kept as they were		*/
+	vFloat boundSkipFraction;	/* boundsReused over activeBodies	*/
+	vUI32 degradeLevel;		/* PX_DEGRADE_ level of last tick		*/
+	vUI64 projectedTimeNs;	/* full detail cost projected last tick	*/
+	vUI32 degradeEscalations;	/* times the level went up			*/
+	vUI32 degradeRecoveries;	/* times the level came down		*/
+	vUI32 lodDeferred;		/* bodies slowed a tier last tick		*/
+	vUI32 pairCapCells;		/* cells out of pair tests last tick	*/
+
+	vUI64 tickTimeNs;					/* duration of last tick		*/
+	vUI64 phaseTimeNs[PX_PHASE_COUNT];	/* duration of each phase		*/
+} vPXStats, *vPPXStats;
+
+typedef struct vPXTraceEvent
+{
+	vUI8  type;			/* span or counter						*/
+	vUI8  name;			/* index into trace name table			*/
+	vUI32 threadID;		/* recording thread						*/
+	vI64  timeStart;	/* performance counter value at start	*/
+	vI64  value;		/* span duration or counter value		*/
+	vI64  arg1, arg2;	/* event specific arguments				*/
+} vPXTraceEvent, *vPPXTraceEvent;
+
+typedef struct vPXTraceState
+{
+	volatile LONG enabled;	/* checked before recording any event	*/
+	volatile LONG writers;	/* recorders inside the event buffer	*/
+
+	FILE* outFile;			/* trace-event json output			*/
+	vI64  timeOrigin;		/* counter value at trace begin		*/
+	vI64  timeFrequency;	/* counter ticks per second			*/
+
+	vPPXTraceEvent events;	/* preallocated event ring buffer	*/
+	vUI32 capacity;			/* always a power of two			*/
+	volatile LONG64 writeCursor;	/* total events ever recorded	*/
+} vPXTraceState, *vPPXTraceState;
+
+typedef struct PXRecordFrame
+{
+	vUI64 tick;
+	vUI32 count;
+	vUI32 capacity;
+	vPXHandle* handle;
+	vPVect  position;
+	vPFloat rotation;
+	vPVect  velocity;
+	vUI8*   flags;
+} PXRecordFrame, *PPXRecordFrame;
+
+typedef struct PXRecordBodyState
+{
+	vPXHandle handle;		/* body owning this slot, 0 if none		*/
+	vUI8  flags;
+	vUI64 seen;				/* last frame the body was part of		*/
+	vUI64 value[PX_RECORD_FIELD_COUNT];	/* zigzagged quantized state	*/
+} PXRecordBodyState, *PPXRecordBodyState;
+
+typedef struct vPXRecordState
+{
+	vBOOL enabled;			/* checked by the tick under the lock	*/
+	FILE* outFile;
+	vPWorker writer;		/* encodes and writes captured frames	*/
+	vUI32 keyframeInterval;
+
+	PPXRecordFrame frames;	/* ring of captured ticks				*/
+	vUI32 frameCount;
+	volatile LONG writeCursor;	/* frames captured by the tick		*/
+	volatile LONG readCursor;	/* frames written by the writer		*/
+
+	PPXRecordBodyState bodies;	/* writer state, by handle slot		*/
+	vUI32 bodyCapacity;
+	vPXHandle* live;			/* bodies of last written frame		*/
+	vUI32 liveCount;
+	vUI32 liveCapacity;
+	vUI8* encodeBuffer;
+	vUI32 encodeCapacity;
+	vUI64 framesWritten;
+} vPXRecordState, *vPPXRecordState;
+
+typedef struct PXRecordHeader
+{
+	vUI32  magic;			/* PX_RECORD_MAGIC						*/
+	vUI32  version;			/* PX_RECORD_VERSION					*/
+	vUI32  keyframeInterval;
+	vUI32  reserved;
+	vFloat scale[PX_RECORD_FIELD_COUNT];	/* quanta per unit		*/
+	vUI32  reserved2[3];
+} PXRecordHeader, *PPXRecordHeader;
+
+typedef struct PXRecordFrameHeader
+{
+	vUI64 tick;
+	vUI32 type;				/* PX_RECORD_FRAME_ type				*/
+	vUI32 entryCount;
+	vUI32 bodyCount;		/* bodies alive after this frame		*/
+	vUI32 payloadSize;		/* encoded entries following			*/
+} PXRecordFrameHeader, *PPXRecordFrameHeader;
+
+typedef struct vPXReplayBody
+{
+	vPXHandle handle;		/* handle in the recorded world			*/
+	vVect  position;		/* quantized, NaN is kept				*/
+	vFloat rotation;
+	vVect  velocity;
+	vBOOL  active;
+} vPXReplayBody, *vPPXReplayBody;
+
+typedef struct vPXReplay
+{
+	HANDLE file;
+	HANDLE mapping;
+	const vUI8* data;		/* whole recording, mapped				*/
+	vUI64 size;
+	PPXRecordHeader header;
+
+	vPUI64 frameOffset;		/* every complete frame in the file		*/
+	vPUI64 frameTick;
+	vPUI32 frameKey;		/* keyframe each frame decodes from		*/
+	vUI32  frameCount;
+	vI64   current;			/* decoded frame, -1 before first seek	*/
+
+	PPXRecordBodyState bodies;	/* decoded state, by handle slot	*/
+	vUI32 bodyCapacity;
+	vUI32 bodyCount;
+} vPXReplay, *vPPXReplay;
+
+typedef struct vPXRandStream
+{
+	/* xoshiro128+ state of every lane, stored word-major so	*/
+	/* bulk fills can step all lanes together					*/
+	vUI32 state[4][RAND_LANES];
+	vUI32 lane;			/* lane the next single draw comes from	*/
+} vPXRandStream, *vPPXRandStream;
+
+typedef struct PXContact
+{
+	vUI32  source;		/* body receiving the response			*/
+	vUI32  target;
+	vVect  pushBack;	/* de-intersection direction			*/
+	vFloat pushBackMagnitude;
+	vFloat angularForce;
+	vVect  transfer;	/* source velocity after momentum transfer	*/
+} PXContact, *PPXContact;
+
+typedef struct vPXParticleEmitter
+{
+	vVect  position;
+	vVect  positionSpread;	/* half extents of the spawn box		*/
+	vVect  velocity;
+	vVect  velocitySpread;	/* half extents added to velocity		*/
+	vFloat radius;
+	vUI32  life;			/* ticks, or PX_PARTICLE_LIFE_FOREVER	*/
+	vUI8   collideLayer;
+} vPXParticleEmitter, *vPPXParticleEmitter;
+
+typedef struct vPXForceField
+{
+	vUI8   type;			/* PX_FIELD_ type						*/
+	vUI8   falloff;			/* PX_FIELD_FALLOFF_ curve				*/
+	vUI8   flags;			/* PX_FIELD_ flags						*/
+	vUI8   layerMask;		/* acts on anything sharing a layer		*/
+	vVect  center;
+	vFloat radius;			/* <= 0 covers the whole world			*/
+	vVect  direction;		/* directional fields only				*/
+	vFloat strength;		/* acceleration, negative pulls inward	*/
+	vUI32  life;			/* ticks, or PX_FIELD_LIFE_FOREVER		*/
+} vPXForceField, *vPPXForceField;
+
+typedef struct vPXSensorEvent
+{
+	vPXHandle sensor;
+	vPXHandle body;			/* may be stale on exit, if destroyed	*/
+	vUI64     tick;			/* tick the overlap began or ended on	*/
+	vUI8      type;			/* PX_SENSOR_ENTER or PX_SENSOR_EXIT	*/
+} vPXSensorEvent, *vPPXSensorEvent;
+
+typedef struct PXSnapshotHeader
+{
+	vUI32  magic;			/* PX_SNAPSHOT_MAGIC						*/
+	vUI32  version;			/* PX_SNAPSHOT_VERSION						*/
+	vUI32  headerSize;		/* header and section table					*/
+	vUI32  sectionCount;
+	vUI64  fileSize;
+	vUI64  tickCount;
+	vUI64  tickInterval;
+	vUI32  bodyCount;
+	vUI32  slotCount;		/* handle slots, so handles survive restore	*/
+	vUI32  freeSlot;
+	vUI32  shapeCount;		/* shape table entries					*/
+	vFloat partitionSize;
+	vUI32  deterministic;
+	vPXRandStream random;	/* world random stream					*/
+} PXSnapshotHeader, *PPXSnapshotHeader;
+
+typedef struct PXSnapshotSection
+{
+	vUI32 id;				/* PX_SNAPSHOT_SECTION_ id					*/
+	vUI32 elementSize;		/* bytes per body (or per slot)				*/
+	vUI64 offset;			/* from start of file						*/
+	vUI64 size;
+} PXSnapshotSection, *PPXSnapshotSection;
+
+typedef struct PXCellMap
+{
+	vPUI64 keys;		/* packed cell coordinates					*/
+	vPUI32 values;		/* CELLMAP_EMPTY marks an unused slot		*/
+	vUI32  capacity;	/* always a power of two					*/
+	vUI32  count;
+} PXCellMap, *PPXCellMap;
+
+typedef struct PXParticleStore
+{
+	vUI32 count;		/* particles are packed in [0, count)	*/
+	vUI32 capacity;
+
+	/* ===== SIMULATION STATE				===== */
+	vPFloat positionX;	/* one array per component, so the	*/
+	vPFloat positionY;	/* integration loop steps several	*/
+	vPFloat velocityX;	/* particles per instruction			*/
+	vPFloat velocityY;
+	vPFloat radius;
+	vPUI32  life;		/* ticks left							*/
+	vUI8*   collideLayer;
+
+	/* ===== SHARED PARAMETERS				===== */
+	vVect  gravity;		/* added to velocity every tick		*/
+	vFloat drag;
+	vFloat restitution;	/* bounce off bodies, 0 to 1			*/
+	vBOOL  selfCollide;	/* circle tests between particles	*/
+
+	/* ===== BODY CELL MASK					===== */
+	vPUI32 cellMask;		/* bit per partition holding bodies	*/
+	vUI32  cellMaskCapacity;	/* words						*/
+	vI32   cellMaskX;		/* first partition covered			*/
+	vI32   cellMaskY;
+	vUI32  cellMaskWidth;	/* 0 when the mask is not used		*/
+	vUI32  cellMaskHeight;
+
+	/* ===== SELF COLLISION					===== */
+	PXCellMap cellMap;	/* cell to first particle in cell	*/
+	vPUI32 cellNext;	/* next particle in the same cell	*/
+} PXParticleStore, *PPXParticleStore;
+
+typedef struct PXTilemap
+{
+	vUI8*  tiles;			/* tile id per tile, rows from the bottom	*/
+	vUI32  width;			/* 0 when the world has no tilemap			*/
+	vUI32  height;
+	vVect  origin;			/* bottom left corner of tile (0, 0)		*/
+	vFloat tileSize;
+	vUI8   collideLayer;
+	vFloat restitution;		/* bounce off tiles, 0 to 1					*/
+	vFloat friction;		/* tangential speed lost per contact		*/
+	vUI64  revision;		/* bumped on every edit, hashed for tiles	*/
+} PXTilemap, *PPXTilemap;
+
+typedef struct PXFieldStore
+{
+	vPXForceField* fields;	/* in creation order					*/
+	vPXFieldID*    ids;
+	vUI32 count;
+	vUI32 capacity;
+	vPXFieldID nextID;
+
+	vVect gravity;			/* every body's starting acceleration	*/
+	vUI8  gravityLayer;		/* bodies sharing a layer fall			*/
+
+	/* ===== GATHER SCRATCH					===== */
+	vPUI32  index;			/* bodies or particles inside a field	*/
+	vPFloat x;				/* their positions, packed so fields	*/
+	vPFloat y;				/* are evaluated several at a time		*/
+	vPFloat accelX;
+	vPFloat accelY;
+	vUI32   scratchCapacity;
+} PXFieldStore, *PPXFieldStore;
+
+typedef struct PXLayerGroup
+{
+	vUI8  layer;			/* collideLayer shared by the group		*/
+	vUI32 first;			/* start in PXLayerMatrix.groupBodies	*/
+	vUI32 count;
+} PXLayerGroup, *PPXLayerGroup;
+
+typedef struct PXLayerMatrix
+{
+	vUI8 rows[PX_LAYER_COUNT];	/* layers each layer collides with	*/
+	vUI8 collides[0x100];		/* layers any collideLayer value	*/
+								/* collides with, built from rows	*/
+
+	PXLayerGroup groups[0x100];	/* one cell's bodies by collideLayer	*/
+	vUI32  groupCount;
+	vUI16  groupOf[0x100];		/* LAYERGROUP_NONE when not present	*/
+	vPUI32 groupBodies;
+	vUI32  groupCapacity;
+} PXLayerMatrix, *PPXLayerMatrix;
+
+typedef struct PXPagedBody
+{
+	vPXHandle  handle;			/* kept reserved while paged out	*/
+	vVect      position;
+	vFloat     rotation;
+	vFloat     scale;
+	vVect      velocity;
+	vVect      acceleration;
+	vFloat     angularVelocity;
+	vFloat     angularAcceleration;
+	vFloat     mass;
+	vFloat     drag;
+	vFloat     friction;
+	vGRect     bound;
+	vUI64      age;
+	vPXShapeID shape;
+	vUI8       collideLayer;
+	vUI8       fieldLayer;
+	vUI8       flags;			/* PX_BODY_ flags					*/
+	vUI8       properties;		/* PX_SNAPSHOT_ view property bits	*/
+} PXPagedBody, *PPXPagedBody;
+
+typedef struct PXStreamRegion
+{
+	vI32  x, y;				/* region coordinates					*/
+	vUI8  state;			/* PX_REGION_ state						*/
+	vUI32 job;				/* job slot while loading				*/
+
+	vUI64 pageOffset;		/* extent in the page file, kept and	*/
+	vUI32 pageCount;		/* reused while it is large enough		*/
+	vUI32 pageCapacity;
+
+	PPXPagedBody handoff;	/* bodies that crossed in while paged	*/
+	vUI32 handoffCount;
+	vUI32 handoffCapacity;
+
+	vUI32 evictFirst;		/* staging range during a check			*/
+	vUI32 evictCount;
+} PXStreamRegion, *PPXStreamRegion;
+
+typedef struct PXStreamJob
+{
+	volatile LONG state;	/* PX_STREAM_JOB_ state, set by both	*/
+	vUI32  region;
+	vUI64  offset;
+	vUI32  count;
+	PPXPagedBody records;	/* filled by the loader					*/
+} PXStreamJob, *PPXStreamJob;
+
+typedef struct PXInterest
+{
+	vBOOL  inUse;
+	vVect  position;
+	vFloat radius;
+} PXInterest, *PPXInterest;
+
+typedef void (*PXPFPOOLTASK)(struct vPXWorld* world, vUI32 first,
+	vUI32 end, vPTR input);
+
+typedef struct PXPoolHelper
+{
+	struct vPXWorld* world;
+	vPWorker worker;
+	vUI64    batchSeen;		/* last batch this helper worked on		*/
+} PXPoolHelper, *PPXPoolHelper;
+
+typedef struct PXTaskPool
+{
+	vUI32 threadCount;			/* helpers, the caller works as well	*/
+	PPXPoolHelper helpers;
+	vBOOL allThreadSafe;		/* every updateFunc may go wide			*/
+
+	CRITICAL_SECTION   lock;
+	CONDITION_VARIABLE wake;	/* helpers wait here for a batch		*/
+	CONDITION_VARIABLE done;	/* the caller waits here for helpers	*/
+	vUI64 batch;				/* bumped for every batch				*/
+	vUI32 pending;				/* helpers yet to finish the batch		*/
+	vBOOL exiting;
+
+	PXPFPOOLTASK task;
+	vPTR  input;
+	vUI32 count;
+	vUI32 chunkSize;
+	volatile LONG nextChunk;	/* claimed by every thread				*/
+} PXTaskPool, *PPXTaskPool;
+
+typedef struct PXBudgetState
+{
+	vUI64  budgetNs;		/* 0 when off							*/
+	vUI32  level;			/* PX_DEGRADE_ level this tick			*/
+	vUI32  calmTicks;		/* ticks under budget at this level		*/
+	vUI64  candidates;		/* pairs the partitions hold this tick	*/
+	vUI64  pairNs;			/* spent finding pairs this tick		*/
+	vUI32  pairCapStart;	/* capped cells start their body loop	*/
+							/* here, modulo the cell's useage		*/
+	double nsPerCandidate;	/* smoothed collision cost				*/
+	double baseNs;			/* smoothed cost of everything else		*/
+} PXBudgetState, *PPXBudgetState;
+
+typedef struct PXLODState
+{
+	vBOOL  enabled;
+	vFloat halfRange;		/* past the radius, every 2nd tick		*/
+	vFloat quarterRange;	/* past the radius, every 4th tick		*/
+	vUI8*  cellTier;		/* tier of each partition in use		*/
+	vUI32  cellCapacity;
+} PXLODState, *PPXLODState;
+
+typedef struct PXStreamState
+{
+	vBOOL  enabled;
+	FILE*  pageFile;
+	vUI64  pageEnd;			/* end of the last extent				*/
+	vFloat regionSize;
+	vUI64  nextCheck;		/* tick of the next residency check		*/
+
+	PXCellMap regionMap;	/* region coordinates to index			*/
+	PPXStreamRegion regions;		/* every region that ever held a body	*/
+	vUI32 regionCount;
+	vUI32 regionCapacity;
+
+	PXStreamJob jobs[PX_STREAM_JOBS_MAX];
+
+	CRITICAL_SECTION fileLock;	/* page file, shared with the loader	*/
+	vPWorker loader;
+
+	vPUI32 bodyRegion;			/* region of each body during a check	*/
+	PPXPagedBody records;		/* records staged for writing			*/
+	vUI32 scratchCapacity;
+	vUI32 recordCapacity;
+} PXStreamState, *PPXStreamState;
+
+typedef struct PXSensorState
+{
+	vPUI64 overlaps;		/* sensor << 32 | body handles, sorted	*/
+	vUI32  overlapCount;
+	vUI32  overlapCapacity;
+
+	vPUI64 found;			/* overlaps found this tick				*/
+	vUI32  foundCount;
+	vUI32  foundCapacity;
+
+	vPPXSensorEvent events;	/* queued until read					*/
+	vUI32  eventCount;
+	vUI32  eventCapacity;
+} PXSensorState, *PPXSensorState;
+
+typedef struct vPXRay
+{
+	vVect  origin;
+	vVect  direction;	/* need not be normalized					*/
+	vFloat maxDistance;	/* <= 0 for unbounded						*/
+	vFloat radius;		/* > 0 sweeps a circle instead of a point	*/
+	vUI8   layerMask;	/* hits bodies sharing any collide layer	*/
+	vUI8   flags;		/* PX_RAY_ flags							*/
+} vPXRay, *vPPXRay;
+
+typedef struct vPXRayHit
+{
+	vBOOL      hit;
+	vPXHandle  body;		/* may be stale, resolve before use		*/
+	vVect      point;		/* ray point at time of contact			*/
+	vVect      normal;		/* surface normal at contact				*/
+	vFloat     distance;	/* along the normalized ray direction	*/
+} vPXRayHit, *vPPXRayHit;
+
+typedef struct vPXRegionQuery
+{
+	vVect  center;
+	vVect  halfExtents;
+	vFloat rotation;	/* 0 for an axis aligned box				*/
+	vUI8   layerMask;	/* matches bodies sharing any collide layer	*/
+} vPXRegionQuery, *vPPXRegionQuery;
+
+typedef struct vPXNearestQuery
+{
+	vVect  point;
+	vFloat maxDistance;	/* <= 0 for unbounded						*/
+	vUI32  k;			/* result slots reserved for this query		*/
+	vUI8   layerMask;
+} vPXNearestQuery, *vPPXNearestQuery;
+
+typedef struct vPXNearestHit
+{
+	vPXHandle  body;		/* may be stale, resolve before use		*/
+	vFloat     distance;	/* point to body surface, 0 if inside	*/
+} vPXNearestHit, *vPPXNearestHit;
+
+typedef struct PXQueryBody
+{
+	vPXHandle body;
+	vVect  mesh[4];
+	vVect  center;
+	vGRect boundingBox;
+	vUI8   collideLayer;
+} PXQueryBody, *PPXQueryBody;
+
+typedef struct PXQuerySnapshot
+{
+	volatile LONG readers;	/* active readers, -1 while being written	*/
+	vUI64  tick;			/* tick this snapshot was published on		*/
+	vFloat partitionSize;
+
+	PPXQueryBody bodies;	/* every body held by a partition			*/
+	vUI32 bodyCount;
+	vUI32 bodyCapacity;
+
+	PXCellMap cellMap;		/* cell coordinates to cell index			*/
+	vPUI32 cellStart;		/* first entry of each cell					*/
+	vPUI32 cellUseage;		/* entry count of each cell					*/
+	vUI32  cellCount;
+	vUI32  cellCapacity;
+	vI32   cellMinX, cellMinY, cellMaxX, cellMaxY;
+
+	vPUI32 entries;			/* body indices, grouped by cell			*/
+	vUI32  entryCount;
+	vUI32  entryCapacity;
+} PXQuerySnapshot, *PPXQuerySnapshot;
+
+typedef struct vPXWorld
 {
 	vBOOL  isInitialized;
 	vBOOL  debugMode;
@@ -152,17 +1075,58 @@ typedef struct _vPXInternals
 
 	CRITICAL_SECTION lock;			/* physics lock						*/
 
-	vPWorker physicsThread;			/* worker thread object				*/
-	vHNDL physObjectList;			/* dynamic list of phys objects		*/
+	vPWorker physicsThread;			/* worker thread, NULL if stepped	*/
+	PXBodyStore bodies;				/* packed simulation state			*/
+	PXParticleStore particles;		/* packed particle state			*/
+	PXTilemap tilemap;				/* static terrain grid				*/
+	PXFieldStore fields;			/* gravity and force fields			*/
+	PXSensorState sensors;			/* persistent sensor overlaps		*/
+	PXLayerMatrix layers;			/* which layers collide				*/
+	PXStreamState stream;			/* paged out regions				*/
+	PXInterest interests[PX_INTERESTS_MAX];	/* cameras, players		*/
+	PXLODState lod;					/* reduced rate far from interests	*/
+	PXTaskPool pool;				/* helper threads for wide work		*/
+	PXBudgetState budget;			/* tick time budget					*/
+
+	vPXRandStream random;			/* world random stream				*/
+
+	vBOOL deterministic;			/* bit-identical stepping, see		*/
+									/* vPXWorldSetDeterministic			*/
+	vUI64 tickInterval;				/* fixed tick length, microseconds	*/
+	vI64  tickClock;				/* worker time not yet simulated	*/
+	vI64  tickClockLast;
 
-	vUI16 physComponent;	/* physics component handle	*/
+	vUI64 profileTickNs;			/* worker tick time since last log	*/
+	vUI64 profileDrawNs;			/* worker draw time since last log	*/
+	vUI32 profileTicks;				/* ticks summed into the above		*/
 
-	vPFloat randomNumberTable;
+	PPXContact contacts;			/* deterministic contact buffer		*/
+	vUI32 contactCount;
+	vUI32 contactCapacity;
 
 	vFloat partitionSize;	/* space partition size			*/
 	vHNDL  partitions;		/* dbuffer of space partitions	*/
 
-} _vPXInternals, *vPPXInternals;
-_vPXInternals _vphys;	/* INSTANCE	*/
+	PXCellMap      partitionMap;	/* cell coordinates to pool index	*/
+	vPPXPartition* partitionPool;	/* every partition ever created		*/
+	vUI32 partitionPoolCount;
+	vUI32 partitionPoolCapacity;
+	vUI32 partitionPoolCursor;		/* partitions in use this tick		*/
+
+	vPXDebugDrawBuffer debugDraw;	/* batched debug overlay geometry	*/
+
+	vBOOL queryPublishing;			/* publish snapshots for queries	*/
+	volatile LONG queryPublished;	/* latest snapshot index, -1 if none	*/
+	vUI32 querySkippedPublishes;	/* no free snapshot to write into	*/
+	PXQuerySnapshot querySnapshots[QUERY_SNAPSHOT_COUNT];
+
+	vI64     timeFrequency;	/* performance counter ticks per second	*/
+	vPXStats stats;			/* counters and timings of last tick	*/
+
+	vPXTraceState trace;	/* chrome trace-event recorder	*/
+	vPXRecordState record;	/* per-tick delta recorder		*/
+
+} vPXWorld, *vPPXWorld;
+vPXWorld _vphys;	/* DEFAULT WORLD INSTANCE	*/
 
 #endif
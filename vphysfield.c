@@ -0,0 +1,600 @@
+/* ========== <vphysfield.c>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Built-in gravity and area force fields.					*/
+/* Each field gathers the positions it covers into packed	*/
+/* scratch arrays, evaluates them in bulk, then scatters	*/
+/* the accelerations back. The SSE2 and scalar paths do		*/
+/* the same operations in the same order, so results do		*/
+/* not depend on where a body falls in a batch.				*/
+
+
+/* ========== INCLUDES							==========	*/
+#include "vphysfield.h"
+#include "vphyscore.h"
+#include "vspacepart.h"
+#include "vbodystore.h"
+#include "vphystrace.h"
+#include <math.h>
+#ifdef PX_SSE2
+#include <emmintrin.h>
+#endif
+
+
+/* ========== HELPERS							==========	*/
+static void PXFieldReserveScratch(PPXFieldStore fs, vUI32 required)
+{
+	if (fs->scratchCapacity >= required) return;
+
+	vUI32 newCap = max(FIELDSTORE_SCRATCH_MIN, fs->scratchCapacity);
+	while (newCap < required) newCap <<= 1;
+
+	/* reserved before a field gathers, never during, so there	*/
+	/* is nothing to copy										*/
+	vFree(fs->index);  fs->index  = vAlloc(sizeof(vUI32) * newCap);
+	vFree(fs->x);      fs->x      = vAlloc(sizeof(vFloat) * newCap);
+	vFree(fs->y);      fs->y      = vAlloc(sizeof(vFloat) * newCap);
+	vFree(fs->accelX); fs->accelX = vAlloc(sizeof(vFloat) * newCap);
+	vFree(fs->accelY); fs->accelY = vAlloc(sizeof(vFloat) * newCap);
+	fs->scratchCapacity = newCap;
+}
+
+static void PXFieldReserve(PPXFieldStore fs, vUI32 required)
+{
+	if (fs->capacity >= required) return;
+
+	vUI32 newCap = max(FIELDSTORE_CAPACITY_MIN, fs->capacity);
+	while (newCap < required) newCap <<= 1;
+
+	vPXForceField* newFields = vAlloc(sizeof(vPXForceField) * newCap);
+	vPXFieldID*    newIDs    = vAlloc(sizeof(vPXFieldID) * newCap);
+	if (fs->fields != NULL)
+	{
+		vMemCopy(newFields, fs->fields, sizeof(vPXForceField) * fs->count);
+		vMemCopy(newIDs, fs->ids, sizeof(vPXFieldID) * fs->count);
+	}
+	vFree(fs->fields);
+	vFree(fs->ids);
+	fs->fields   = newFields;
+	fs->ids      = newIDs;
+	fs->capacity = newCap;
+}
+
+static vBOOL PXFieldSanitize(vPPXForceField field, vPPXForceField out)
+{
+	if (field == NULL || field->type >= PX_FIELD_TYPE_COUNT ||
+		field->falloff >= PX_FIELD_FALLOFF_COUNT || field->life == 0)
+		return FALSE;
+
+	/* zeroed so padding hashes the same everywhere */
+	vZeroMemory(out, sizeof(vPXForceField));
+	out->type      = field->type;
+	out->falloff   = field->falloff;
+	out->flags     = field->flags;
+	out->layerMask = field->layerMask;
+	out->center    = field->center;
+	out->radius    = max(0.0f, field->radius);
+	out->direction = field->direction;
+	out->strength  = field->strength;
+	out->life      = field->life;
+
+	if (out->direction.x != 0.0f || out->direction.y != 0.0f)
+		vPXVectorNormalize(&out->direction);
+	return TRUE;
+}
+
+static vI32 PXFieldFind(PPXFieldStore fs, vPXFieldID id)
+{
+	for (vUI32 i = 0; i < fs->count; i++)
+		if (fs->ids[i] == id) return (vI32)i;
+	return -1;
+}
+
+static void PXFieldRemoveAt(PPXFieldStore fs, vUI32 slot)
+{
+	/* shifted down, fields apply in creation order */
+	for (vUI32 i = slot + 1; i < fs->count; i++)
+	{
+		fs->fields[i - 1] = fs->fields[i];
+		fs->ids[i - 1]    = fs->ids[i];
+	}
+	fs->count--;
+}
+
+static vGRect PXFieldRect(vPPXForceField field)
+{
+	return vGCreateRect(field->center.x - field->radius,
+		field->center.x + field->radius, field->center.y - field->radius,
+		field->center.y + field->radius);
+}
+
+
+/* ========== EVALUATION						==========	*/
+static void PXFieldEvaluateScalar(vPPXForceField field, PPXFieldStore fs,
+	vUI32 begin, vUI32 end)
+{
+	vBOOL  bounded   = field->radius > 0.0f;
+	vFloat radiusSq  = field->radius * field->radius;
+	vFloat invRadius = bounded ? 1.0f / field->radius : 0.0f;
+
+	for (vUI32 i = begin; i < end; i++)
+	{
+		vFloat dx = fs->x[i] - field->center.x;
+		vFloat dy = fs->y[i] - field->center.y;
+		vFloat distSq = dx * dx + dy * dy;
+		vFloat dist   = sqrtf(distSq);
+		fs->accelX[i] = 0.0f;
+		fs->accelY[i] = 0.0f;
+		if (bounded && !(distSq < radiusSq)) continue;
+
+		vFloat weight = field->strength;
+		if (bounded && field->falloff != PX_FIELD_FALLOFF_NONE)
+		{
+			vFloat keep = 1.0f - dist * invRadius;
+			weight = weight * keep;
+			if (field->falloff == PX_FIELD_FALLOFF_QUADRATIC)
+				weight = weight * keep;
+		}
+
+		if (field->type == PX_FIELD_DIRECTIONAL)
+		{
+			fs->accelX[i] = field->direction.x * weight;
+			fs->accelY[i] = field->direction.y * weight;
+			continue;
+		}
+
+		/* no direction to push along at the center itself */
+		if (!(dist > 0.0f)) continue;
+		vFloat scale = weight / dist;
+		if (field->type == PX_FIELD_RADIAL)
+		{
+			fs->accelX[i] = dx * scale;
+			fs->accelY[i] = dy * scale;
+		}
+		else
+		{
+			fs->accelX[i] = -dy * scale;
+			fs->accelY[i] = dx * scale;
+		}
+	}
+}
+
+static void PXFieldEvaluate(vPPXForceField field, PPXFieldStore fs,
+	vUI32 count)
+{
+	vUI32 i = 0;
+
+#ifdef PX_SSE2
+	vBOOL  bounded   = field->radius > 0.0f;
+	vFloat invRadius = bounded ? 1.0f / field->radius : 0.0f;
+
+	__m128 vCenterX   = _mm_set1_ps(field->center.x);
+	__m128 vCenterY   = _mm_set1_ps(field->center.y);
+	__m128 vRadiusSq  = _mm_set1_ps(field->radius * field->radius);
+	__m128 vInvRadius = _mm_set1_ps(invRadius);
+	__m128 vStrength  = _mm_set1_ps(field->strength);
+	__m128 vDirX      = _mm_set1_ps(field->direction.x);
+	__m128 vDirY      = _mm_set1_ps(field->direction.y);
+	__m128 vOne       = _mm_set1_ps(1.0f);
+	__m128 vZero      = _mm_setzero_ps();
+	__m128 vSign      = _mm_set1_ps(-0.0f);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(fs->x + i), vCenterX);
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(fs->y + i), vCenterY);
+		__m128 distSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		__m128 dist   = _mm_sqrt_ps(distSq);
+		__m128 inside = bounded ? _mm_cmplt_ps(distSq, vRadiusSq) :
+			_mm_cmpeq_ps(vZero, vZero);
+
+		__m128 weight = vStrength;
+		if (bounded && field->falloff != PX_FIELD_FALLOFF_NONE)
+		{
+			__m128 keep = _mm_sub_ps(vOne, _mm_mul_ps(dist, vInvRadius));
+			weight = _mm_mul_ps(weight, keep);
+			if (field->falloff == PX_FIELD_FALLOFF_QUADRATIC)
+				weight = _mm_mul_ps(weight, keep);
+		}
+
+		__m128 ax, ay;
+		if (field->type == PX_FIELD_DIRECTIONAL)
+		{
+			ax = _mm_mul_ps(vDirX, weight);
+			ay = _mm_mul_ps(vDirY, weight);
+		}
+		else
+		{
+			/* lanes at the center divide by zero, then get masked */
+			inside = _mm_and_ps(inside, _mm_cmpgt_ps(dist, vZero));
+			__m128 scale = _mm_div_ps(weight, dist);
+			if (field->type == PX_FIELD_RADIAL)
+			{
+				ax = _mm_mul_ps(dx, scale);
+				ay = _mm_mul_ps(dy, scale);
+			}
+			else
+			{
+				ax = _mm_mul_ps(_mm_xor_ps(dy, vSign), scale);
+				ay = _mm_mul_ps(dx, scale);
+			}
+		}
+
+		_mm_storeu_ps(fs->accelX + i, _mm_and_ps(ax, inside));
+		_mm_storeu_ps(fs->accelY + i, _mm_and_ps(ay, inside));
+	}
+#endif
+
+	PXFieldEvaluateScalar(field, fs, i, count);
+}
+
+
+/* ========== GATHERING							==========	*/
+static void PXFieldGatherBody(vPPXWorld world, vUI32 body, vUI32* countIO)
+{
+	/* LOD is not stepping it, a push would go nowhere */
+	if (world->bodies.flags[body] & PX_BODY_IDLE) return;
+
+	PPXFieldStore fs = &world->fields;
+	vUI32 n = *countIO;
+	fs->index[n] = body;
+	fs->x[n]     = world->bodies.worldBound[body].center.x;
+	fs->y[n]     = world->bodies.worldBound[body].center.y;
+	*countIO = n + 1;
+}
+
+static void PXFieldGatherPartition(vPPXWorld world, vPPXForceField field,
+	vPPXPartition part, vI32 cellX0, vI32 cellY0, vUI32* countIO)
+{
+	PPXBodyStore store = &world->bodies;
+	for (vUI32 i = 0; i < part->useage; i++)
+	{
+		vUI32 body = part->list[i];
+		if ((store->fieldLayer[body] & field->layerMask) == ZERO) continue;
+
+		/* a body spanning several partitions is only taken by	*/
+		/* the one holding the min corner of its overlap with	*/
+		/* the field												*/
+		vPGRect box = &store->worldBound[body].boundingBox;
+		vI32 cx = max((vI32)floorf(box->left / world->partitionSize), cellX0);
+		vI32 cy = max((vI32)floorf(box->bottom / world->partitionSize), cellY0);
+		if (cx != part->x || cy != part->y) continue;
+
+		PXFieldGatherBody(world, body, countIO);
+	}
+}
+
+static vUI32 PXFieldGatherBodies(vPPXWorld world, vPPXForceField field)
+{
+	PPXBodyStore store = &world->bodies;
+	vUI32 count = 0;
+
+	/* no field takes a body twice */
+	PXFieldReserveScratch(&world->fields, store->count);
+
+	/* unbounded fields take every body */
+	if (field->radius <= 0.0f)
+	{
+		for (vUI32 body = 0; body < store->count; body++)
+		{
+			if ((store->flags[body] & PX_BODY_ACTIVE) == 0) continue;
+			if ((store->fieldLayer[body] & field->layerMask) == ZERO)
+				continue;
+			PXFieldGatherBody(world, body, &count);
+		}
+		return count;
+	}
+
+	vGRect rect = PXFieldRect(field);
+	vFloat cellScale = 1.0f / world->partitionSize;
+	vI32 cellX0 = (vI32)floorf(rect.left * cellScale);
+	vI32 cellY0 = (vI32)floorf(rect.bottom * cellScale);
+	vI32 cellX1 = (vI32)floorf(rect.right * cellScale);
+	vI32 cellY1 = (vI32)floorf(rect.top * cellScale);
+
+	/* look up each covered cell, unless the field covers more	*/
+	/* cells than there are partitions in use					*/
+	vUI64 cells = (vUI64)((vI64)cellX1 - cellX0 + 1) *
+		(vUI64)((vI64)cellY1 - cellY0 + 1);
+	if (cells <= world->partitionPoolCursor)
+	{
+		for (vI32 y = cellY0; y <= cellY1; y++)
+		{
+			for (vI32 x = cellX0; x <= cellX1; x++)
+			{
+				vUI32 poolIndex = PXCellMapFind(&world->partitionMap, x, y);
+				if (poolIndex == CELLMAP_EMPTY) continue;
+				PXFieldGatherPartition(world, field,
+					world->partitionPool[poolIndex], cellX0, cellY0, &count);
+			}
+		}
+		return count;
+	}
+
+	for (vUI32 i = 0; i < world->partitionPoolCursor; i++)
+	{
+		vPPXPartition part = world->partitionPool[i];
+		if (part->x < cellX0 || part->x > cellX1 ||
+			part->y < cellY0 || part->y > cellY1) continue;
+		PXFieldGatherPartition(world, field, part, cellX0, cellY0, &count);
+	}
+	return count;
+}
+
+static vUI32 PXFieldGatherParticles(vPPXWorld world, vPPXForceField field)
+{
+	PPXParticleStore particles = &world->particles;
+	PPXFieldStore fs = &world->fields;
+	PXFieldReserveScratch(fs, particles->count);
+
+	vBOOL  bounded = field->radius > 0.0f;
+	vGRect rect    = PXFieldRect(field);
+	vUI32  count   = 0;
+	for (vUI32 i = 0; i < particles->count; i++)
+	{
+		if ((particles->collideLayer[i] & field->layerMask) == ZERO) continue;
+
+		vFloat x = particles->positionX[i];
+		vFloat y = particles->positionY[i];
+		if (bounded && (x < rect.left || x > rect.right ||
+			y < rect.bottom || y > rect.top)) continue;
+
+		fs->index[count] = i;
+		fs->x[count]     = x;
+		fs->y[count]     = y;
+		count++;
+	}
+	return count;
+}
+
+
+/* ========== FIELD STORE						==========	*/
+void PXFieldStoreInit(vPPXWorld world)
+{
+	world->fields.gravityLayer = 0xFF;
+	world->fields.nextID       = PX_FIELD_NONE + 1;
+}
+
+void PXFieldStoreFree(vPPXWorld world)
+{
+	PPXFieldStore fs = &world->fields;
+	vFree(fs->fields);
+	vFree(fs->ids);
+	vFree(fs->index);
+	vFree(fs->x);
+	vFree(fs->y);
+	vFree(fs->accelX);
+	vFree(fs->accelY);
+	vZeroMemory(fs, sizeof(PXFieldStore));
+}
+
+void PXFieldApplyBodies(vPPXWorld world)
+{
+	PPXFieldStore fs = &world->fields;
+	world->stats.fieldBodies = 0;
+	if (fs->count == 0) return;
+
+	PXTRACE_SPAN_BEGIN(world, traceStart);
+	PPXBodyStore store = &world->bodies;
+
+	for (vUI32 f = 0; f < fs->count; f++)
+	{
+		vPPXForceField field = fs->fields + f;
+		vUI32 count = PXFieldGatherBodies(world, field);
+		PXFieldEvaluate(field, fs, count);
+
+		for (vUI32 i = 0; i < count; i++)
+		{
+			vFloat ax = fs->accelX[i];
+			vFloat ay = fs->accelY[i];
+			if (ax == 0.0f && ay == 0.0f) continue;
+
+			vUI32 body = fs->index[i];
+			if (field->flags & PX_FIELD_USE_MASS)
+			{
+				vFloat invMass = 1.0f / store->mass[body];
+				ax *= invMass;
+				ay *= invMass;
+			}
+			store->acceleration[body].x += ax;
+			store->acceleration[body].y += ay;
+			world->stats.fieldBodies++;
+		}
+	}
+
+	PXTRACE_SPAN_END(world, traceStart, PX_TRACE_FORCEFIELDS,
+		world->stats.fieldBodies, 0);
+}
+
+void PXFieldApplyParticles(vPPXWorld world)
+{
+	PPXFieldStore fs = &world->fields;
+	PPXParticleStore particles = &world->particles;
+
+	/* particles have no acceleration, fields go to velocity */
+	for (vUI32 f = 0; f < fs->count; f++)
+	{
+		vPPXForceField field = fs->fields + f;
+		vUI32 count = PXFieldGatherParticles(world, field);
+		PXFieldEvaluate(field, fs, count);
+
+		for (vUI32 i = 0; i < count; i++)
+		{
+			particles->velocityX[fs->index[i]] += fs->accelX[i];
+			particles->velocityY[fs->index[i]] += fs->accelY[i];
+		}
+	}
+}
+
+void PXFieldExpire(vPPXWorld world)
+{
+	PPXFieldStore fs = &world->fields;
+	for (vUI32 i = 0; i < fs->count;)
+	{
+		vUI32 life = fs->fields[i].life;
+		if (life == PX_FIELD_LIFE_FOREVER) { i++; continue; }
+		if (life > 1) { fs->fields[i].life = life - 1; i++; continue; }
+		PXFieldRemoveAt(fs, i);
+	}
+}
+
+vUI64 PXFieldHash(vPPXWorld world, vUI64 hash)
+{
+	PPXFieldStore fs = &world->fields;
+	hash = PXHashBytes(hash, &fs->gravity, sizeof(fs->gravity));
+	hash = PXHashBytes(hash, &fs->gravityLayer, sizeof(fs->gravityLayer));
+	hash = PXHashBytes(hash, &fs->count, sizeof(fs->count));
+	hash = PXHashBytes(hash, fs->fields, sizeof(vPXForceField) * fs->count);
+	return hash;
+}
+
+
+/* ========== BODY FIELD LAYERS					==========	*/
+VPHYSAPI void vPXSetPhysicsObjectFieldLayer(vPPhysical pObj,
+	vUI8 fieldLayer)
+{
+	pObj->properties.fieldLayer = fieldLayer;
+	vPXTouchPhysicsObject(pObj);
+}
+
+
+/* ========== GRAVITY							==========	*/
+VPHYSAPI void vPXWorldSetGravity(vPPXWorld world, vVect gravity,
+	vUI8 layerMask)
+{
+	vPXWorldLock(world);
+	world->fields.gravity      = gravity;
+	world->fields.gravityLayer = layerMask;
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI vVect vPXWorldGetGravity(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	vVect gravity = world->fields.gravity;
+	vPXWorldUnlock(world);
+	return gravity;
+}
+
+
+/* ========== FORCE FIELDS						==========	*/
+VPHYSAPI vPXFieldID vPXWorldAddForceField(vPPXWorld world,
+	vPPXForceField field)
+{
+	vPXForceField clean;
+	if (PXFieldSanitize(field, &clean) == FALSE)
+	{
+		vPXWorldDebugLog(world, "Invalid force field\n");
+		return PX_FIELD_NONE;
+	}
+
+	vPXWorldLock(world);
+	PPXFieldStore fs = &world->fields;
+	PXFieldReserve(fs, fs->count + 1);
+	vPXFieldID id = fs->nextID++;
+	if (fs->nextID == PX_FIELD_NONE) fs->nextID++;
+	fs->fields[fs->count] = clean;
+	fs->ids[fs->count]    = id;
+	fs->count++;
+	vPXWorldUnlock(world);
+	return id;
+}
+
+VPHYSAPI vBOOL vPXWorldSetForceField(vPPXWorld world, vPXFieldID id,
+	vPPXForceField field)
+{
+	vPXForceField clean;
+	if (PXFieldSanitize(field, &clean) == FALSE) return FALSE;
+
+	vPXWorldLock(world);
+	vI32 slot = PXFieldFind(&world->fields, id);
+	if (slot >= 0) world->fields.fields[slot] = clean;
+	vPXWorldUnlock(world);
+	return slot >= 0;
+}
+
+VPHYSAPI vBOOL vPXWorldGetForceField(vPPXWorld world, vPXFieldID id,
+	vPPXForceField fieldOut)
+{
+	vPXWorldLock(world);
+	vI32 slot = PXFieldFind(&world->fields, id);
+	if (slot >= 0) *fieldOut = world->fields.fields[slot];
+	vPXWorldUnlock(world);
+	return slot >= 0;
+}
+
+VPHYSAPI vBOOL vPXWorldRemoveForceField(vPPXWorld world, vPXFieldID id)
+{
+	vPXWorldLock(world);
+	vI32 slot = PXFieldFind(&world->fields, id);
+	if (slot >= 0) PXFieldRemoveAt(&world->fields, (vUI32)slot);
+	vPXWorldUnlock(world);
+	return slot >= 0;
+}
+
+VPHYSAPI void vPXWorldClearForceFields(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	world->fields.count = 0;
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI vPXFieldID vPXWorldAddExplosion(vPPXWorld world, vVect center,
+	vFloat radius, vFloat strength, vUI8 layerMask)
+{
+	if (!(radius > 0.0f)) return PX_FIELD_NONE;
+
+	vPXForceField field;
+	vZeroMemory(&field, sizeof(field));
+	field.type      = PX_FIELD_RADIAL;
+	field.falloff   = PX_FIELD_FALLOFF_LINEAR;
+	field.flags     = PX_FIELD_USE_MASS;
+	field.layerMask = layerMask;
+	field.center    = center;
+	field.radius    = radius;
+	field.strength  = strength;
+	field.life      = 1;
+	return vPXWorldAddForceField(world, &field);
+}
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI void vPXSetGravity(vVect gravity, vUI8 layerMask)
+{
+	vPXWorldSetGravity(&_vphys, gravity, layerMask);
+}
+
+VPHYSAPI vVect vPXGetGravity(void)
+{
+	return vPXWorldGetGravity(&_vphys);
+}
+
+VPHYSAPI vPXFieldID vPXAddForceField(vPPXForceField field)
+{
+	return vPXWorldAddForceField(&_vphys, field);
+}
+
+VPHYSAPI vBOOL vPXSetForceField(vPXFieldID id, vPPXForceField field)
+{
+	return vPXWorldSetForceField(&_vphys, id, field);
+}
+
+VPHYSAPI vBOOL vPXGetForceField(vPXFieldID id, vPPXForceField fieldOut)
+{
+	return vPXWorldGetForceField(&_vphys, id, fieldOut);
+}
+
+VPHYSAPI vBOOL vPXRemoveForceField(vPXFieldID id)
+{
+	return vPXWorldRemoveForceField(&_vphys, id);
+}
+
+VPHYSAPI void vPXClearForceFields(void)
+{
+	vPXWorldClearForceFields(&_vphys);
+}
+
+VPHYSAPI vPXFieldID vPXAddExplosion(vVect center, vFloat radius,
+	vFloat strength, vUI8 layerMask)
+{
+	return vPXWorldAddExplosion(&_vphys, center, radius, strength, layerMask);
+}
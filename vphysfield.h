@@ -0,0 +1,72 @@
+/* ========== <vphysfield.h>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Built-in gravity and area force fields.					*/
+/* Gravity is every body's starting acceleration each tick.	*/
+/* Fields add to it in one pass before dynamics, reaching	*/
+/* bodies through the partitions they cover and evaluated	*/
+/* several bodies at a time, so no per-body callback is		*/
+/* needed for the common forces. updateFunc still runs		*/
+/* after them and may change the result.					*/
+
+#ifndef _VPHYS_FIELD_INCLUDE_
+#define _VPHYS_FIELD_INCLUDE_
+
+/* ========== INCLUDES							==========	*/
+#include "vphysdefs.h"
+
+
+/* ========== GRAVITY							==========	*/
+/* bodies whose fieldLayer shares no layer with layerMask do	*/
+/* not fall, which is how heavy "static" bodies stay put		*/
+VPHYSAPI void  vPXWorldSetGravity(vPPXWorld world, vVect gravity,
+	vUI8 layerMask);
+VPHYSAPI vVect vPXWorldGetGravity(vPPXWorld world);
+
+
+/* ========== BODY FIELD LAYERS					==========	*/
+/* gravity and fields reach a body through its fieldLayer,	*/
+/* apart from the layers it collides on. it starts out as	*/
+/* the body's collideLayer									*/
+VPHYSAPI void vPXSetPhysicsObjectFieldLayer(vPPhysical pObj,
+	vUI8 fieldLayer);
+
+
+/* ========== FORCE FIELDS						==========	*/
+/* fields act on bodies and particles alike, in the order	*/
+/* they were added. particles count as mass 1. each returns	*/
+/* PX_FIELD_NONE or FALSE if the field is invalid or gone	*/
+VPHYSAPI vPXFieldID vPXWorldAddForceField(vPPXWorld world,
+	vPPXForceField field);
+VPHYSAPI vBOOL vPXWorldSetForceField(vPPXWorld world, vPXFieldID id,
+	vPPXForceField field);
+/* life is the number of ticks left							*/
+VPHYSAPI vBOOL vPXWorldGetForceField(vPPXWorld world, vPXFieldID id,
+	vPPXForceField fieldOut);
+VPHYSAPI vBOOL vPXWorldRemoveForceField(vPPXWorld world, vPXFieldID id);
+VPHYSAPI void  vPXWorldClearForceFields(vPPXWorld world);
+/* one tick radial push by mass with linear falloff			*/
+VPHYSAPI vPXFieldID vPXWorldAddExplosion(vPPXWorld world, vVect center,
+	vFloat radius, vFloat strength, vUI8 layerMask);
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI void  vPXSetGravity(vVect gravity, vUI8 layerMask);
+VPHYSAPI vVect vPXGetGravity(void);
+VPHYSAPI vPXFieldID vPXAddForceField(vPPXForceField field);
+VPHYSAPI vBOOL vPXSetForceField(vPXFieldID id, vPPXForceField field);
+VPHYSAPI vBOOL vPXGetForceField(vPXFieldID id, vPPXForceField fieldOut);
+VPHYSAPI vBOOL vPXRemoveForceField(vPXFieldID id);
+VPHYSAPI void  vPXClearForceFields(void);
+VPHYSAPI vPXFieldID vPXAddExplosion(vVect center, vFloat radius,
+	vFloat strength, vUI8 layerMask);
+
+
+/* ========== FIELD STORE						==========	*/
+void  PXFieldStoreInit(vPPXWorld world);
+void  PXFieldStoreFree(vPPXWorld world);
+void  PXFieldApplyBodies(vPPXWorld world);
+void  PXFieldApplyParticles(vPPXWorld world);
+void  PXFieldExpire(vPPXWorld world);
+vUI64 PXFieldHash(vPPXWorld world, vUI64 hash);
+
+#endif
@@ -5,6 +5,7 @@
 
 /* ========== INCLUDES							==========	*/
 #include "vphysical.h"
+#include "vbodystore.h"
 
 
 /* ========== COMPONENT CALLBACKS				==========	*/
@@ -18,13 +19,15 @@ void vPXPhysical_initFunc(vPObject object, vPComponent component, vPTR input)
 	vMemCopy(self, copy, sizeof(vPhysical));
 	vFree(copy);
 
-	/* add to internal physics object list buffer		*/
-	/* refer to <vphyscore.c> for add implementation	*/
-	vDBufferAdd(_vphys.physObjectList, self);
+	/* add to its world's body store, which hands out self's handle */
+	PXBodyStoreAdd(self->world, self);
 }
 
 void vPXPhysical_destroyFunc(vPObject object, vPComponent component)
 {
 	vPPhysical self = component->objectAttribute;
-	vDBufferRemove(_vphys.physObjectList, self->physObjectListPtr);
+
+	/* bodies outliving their world were already released with it */
+	if (self->world == NULL) return;
+	PXBodyStoreRemove(self->world, PXBodyStoreResolve(self->world, self->handle));
 }
@@ -0,0 +1,233 @@
+/* ========== <vphyslayer.c>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Collision layer matrix.									*/
+/* The 8x8 rows are folded into one mask per collideLayer	*/
+/* value whenever they change, so testing a pair is a		*/
+/* single lookup and AND, as cheap as the plain layer AND.	*/
+
+
+/* ========== INCLUDES							==========	*/
+#include "vphyslayer.h"
+#include "vphyscore.h"
+#include "vbodystore.h"
+#include <string.h>
+
+
+/* ========== HELPERS							==========	*/
+static void PXLayerMatrixBuild(PPXLayerMatrix matrix)
+{
+	for (vUI32 value = 0; value < 0x100; value++)
+	{
+		vUI8 collides = 0;
+		for (vUI32 layer = 0; layer < PX_LAYER_COUNT; layer++)
+		{
+			if (value & (1 << layer)) collides |= matrix->rows[layer];
+		}
+		matrix->collides[value] = collides;
+	}
+}
+
+static void PXLayerMatrixIdentity(PPXLayerMatrix matrix)
+{
+	for (vUI32 layer = 0; layer < PX_LAYER_COUNT; layer++)
+		matrix->rows[layer] = (vUI8)(1 << layer);
+	PXLayerMatrixBuild(matrix);
+}
+
+static void PXLayerReserveGroupBodies(PPXLayerMatrix matrix, vUI32 required)
+{
+	if (matrix->groupCapacity >= required) return;
+
+	vUI32 newCap = max(PARTITION_CAPACITY_MIN, matrix->groupCapacity);
+	while (newCap < required) newCap <<= 1;
+
+	/* holds nothing between cells, no copy needed */
+	vFree(matrix->groupBodies);
+	matrix->groupBodies   = vAlloc(sizeof(vUI32) * newCap);
+	matrix->groupCapacity = newCap;
+}
+
+
+/* ========== LAYER FILTERING					==========	*/
+void PXLayerMatrixInit(vPPXWorld world)
+{
+	PPXLayerMatrix matrix = &world->layers;
+	vZeroMemory(matrix, sizeof(PXLayerMatrix));
+	memset(matrix->groupOf, 0xFF, sizeof(matrix->groupOf));
+	PXLayerMatrixIdentity(matrix);
+}
+
+void PXLayerMatrixFree(vPPXWorld world)
+{
+	vFree(world->layers.groupBodies);
+	world->layers.groupBodies   = NULL;
+	world->layers.groupCapacity = 0;
+}
+
+vBOOL PXLayerCellCollides(vPPXWorld world, vPPXPartition part)
+{
+	PPXLayerMatrix matrix = &world->layers;
+
+	for (vUI32 layer = 0; layer < PX_LAYER_COUNT; layer++)
+	{
+		vUI8 bit = (vUI8)(1 << layer);
+		if ((part->layerMask & bit) == ZERO) continue;
+
+		/* another layer present: the bodies may differ, assume so	*/
+		vUI8 partners = matrix->rows[layer] & part->layerMask;
+		if (partners & ~bit) return TRUE;
+
+		/* own layer only collides when two bodies hold it		*/
+		if (partners & part->layerRepeatMask) return TRUE;
+	}
+
+	return FALSE;
+}
+
+vUI32 PXLayerGroupCell(vPPXWorld world, vPPXPartition part)
+{
+	PPXLayerMatrix matrix = &world->layers;
+	PPXBodyStore store = &world->bodies;
+	PXLayerReserveGroupBodies(matrix, part->useage);
+
+	/* count each collideLayer value, groups in first-seen order */
+	matrix->groupCount = 0;
+	for (vUI32 i = 0; i < part->useage; i++)
+	{
+		vUI32 body = part->list[i];
+		if (store->flags[body] & PX_BODY_SENSOR) continue;
+
+		vUI8 layer = store->collideLayer[body];
+		if (matrix->groupOf[layer] == LAYERGROUP_NONE)
+		{
+			PPXLayerGroup group = matrix->groups + matrix->groupCount;
+			group->layer = layer;
+			group->count = 0;
+			matrix->groupOf[layer] = (vUI16)matrix->groupCount++;
+		}
+		matrix->groups[matrix->groupOf[layer]].count++;
+	}
+
+	vUI32 first = 0;
+	for (vUI32 g = 0; g < matrix->groupCount; g++)
+	{
+		matrix->groups[g].first = first;
+		first += matrix->groups[g].count;
+		matrix->groups[g].count = 0;
+	}
+
+	/* place bodies, keeping cell order within each group */
+	for (vUI32 i = 0; i < part->useage; i++)
+	{
+		vUI32 body = part->list[i];
+		if (store->flags[body] & PX_BODY_SENSOR) continue;
+
+		PPXLayerGroup group = matrix->groups +
+			matrix->groupOf[store->collideLayer[body]];
+		matrix->groupBodies[group->first + group->count++] = body;
+	}
+
+	/* leave the lookup clear for the next cell */
+	for (vUI32 g = 0; g < matrix->groupCount; g++)
+		matrix->groupOf[matrix->groups[g].layer] = LAYERGROUP_NONE;
+
+	return matrix->groupCount;
+}
+
+vUI64 PXLayerHash(vPPXWorld world, vUI64 hash)
+{
+	return PXHashBytes(hash, world->layers.rows, sizeof(world->layers.rows));
+}
+
+
+/* ========== LAYER MATRIX						==========	*/
+VPHYSAPI void vPXWorldSetLayersCollide(vPPXWorld world, vUI8 layersA,
+	vUI8 layersB, vBOOL collide)
+{
+	vPXWorldLock(world);
+	PPXLayerMatrix matrix = &world->layers;
+	for (vUI32 layer = 0; layer < PX_LAYER_COUNT; layer++)
+	{
+		vUI8 bit = (vUI8)(1 << layer);
+		vUI8 partners = ZERO;
+		if (layersA & bit) partners |= layersB;
+		if (layersB & bit) partners |= layersA;
+
+		if (collide) matrix->rows[layer] |= partners;
+		else         matrix->rows[layer] &= ~partners;
+	}
+	PXLayerMatrixBuild(matrix);
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI vBOOL vPXWorldGetLayersCollide(vPPXWorld world, vUI8 layersA,
+	vUI8 layersB)
+{
+	vPXWorldLock(world);
+	vBOOL collide = PXLayersCollide(world, layersA, layersB);
+	vPXWorldUnlock(world);
+	return collide;
+}
+
+VPHYSAPI void vPXWorldSetLayerMatrix(vPPXWorld world,
+	const vUI8 rows[PX_LAYER_COUNT])
+{
+	vPXWorldLock(world);
+	PPXLayerMatrix matrix = &world->layers;
+	for (vUI32 layer = 0; layer < PX_LAYER_COUNT; layer++)
+	{
+		matrix->rows[layer] = rows[layer];
+
+		/* add column to row, so either direction sets both */
+		for (vUI32 other = 0; other < PX_LAYER_COUNT; other++)
+		{
+			if (rows[other] & (1 << layer))
+				matrix->rows[layer] |= (vUI8)(1 << other);
+		}
+	}
+	PXLayerMatrixBuild(matrix);
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI void vPXWorldGetLayerMatrix(vPPXWorld world,
+	vUI8 rowsOut[PX_LAYER_COUNT])
+{
+	vPXWorldLock(world);
+	vMemCopy(rowsOut, world->layers.rows, sizeof(world->layers.rows));
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI void vPXWorldResetLayerMatrix(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	PXLayerMatrixIdentity(&world->layers);
+	vPXWorldUnlock(world);
+}
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI void vPXSetLayersCollide(vUI8 layersA, vUI8 layersB,
+	vBOOL collide)
+{
+	vPXWorldSetLayersCollide(&_vphys, layersA, layersB, collide);
+}
+
+VPHYSAPI vBOOL vPXGetLayersCollide(vUI8 layersA, vUI8 layersB)
+{
+	return vPXWorldGetLayersCollide(&_vphys, layersA, layersB);
+}
+
+VPHYSAPI void vPXSetLayerMatrix(const vUI8 rows[PX_LAYER_COUNT])
+{
+	vPXWorldSetLayerMatrix(&_vphys, rows);
+}
+
+VPHYSAPI void vPXGetLayerMatrix(vUI8 rowsOut[PX_LAYER_COUNT])
+{
+	vPXWorldGetLayerMatrix(&_vphys, rowsOut);
+}
+
+VPHYSAPI void vPXResetLayerMatrix(void)
+{
+	vPXWorldResetLayerMatrix(&_vphys);
+}
@@ -0,0 +1,60 @@
+/* ========== <vphyslayer.h>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Collision layer matrix.									*/
+/* Two bodies collide when any layer of one is set to		*/
+/* collide with any layer of the other. By default each		*/
+/* layer collides only with itself, which is the same as	*/
+/* sharing a layer. Cells remember which layers they hold	*/
+/* so a cell with no colliding layers is skipped whole, and	*/
+/* the bodies of the rest are grouped by collideLayer so	*/
+/* only groups that collide are paired.						*/
+
+#ifndef _VPHYS_LAYER_INCLUDE_
+#define _VPHYS_LAYER_INCLUDE_
+
+/* ========== INCLUDES							==========	*/
+#include "vphysdefs.h"
+
+
+/* ========== LAYER MATRIX						==========	*/
+/* sets every layer in layersA to collide, or not, with		*/
+/* every layer in layersB, and the other way round			*/
+VPHYSAPI void  vPXWorldSetLayersCollide(vPPXWorld world, vUI8 layersA,
+	vUI8 layersB, vBOOL collide);
+/* TRUE if any layer in layersA collides with any in layersB	*/
+VPHYSAPI vBOOL vPXWorldGetLayersCollide(vPPXWorld world, vUI8 layersA,
+	vUI8 layersB);
+/* row i holds the layers PX_LAYER_i collides with. rows are	*/
+/* made symmetric: either direction set sets both			*/
+VPHYSAPI void  vPXWorldSetLayerMatrix(vPPXWorld world,
+	const vUI8 rows[PX_LAYER_COUNT]);
+VPHYSAPI void  vPXWorldGetLayerMatrix(vPPXWorld world,
+	vUI8 rowsOut[PX_LAYER_COUNT]);
+/* back to each layer colliding only with itself				*/
+VPHYSAPI void  vPXWorldResetLayerMatrix(vPPXWorld world);
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI void  vPXSetLayersCollide(vUI8 layersA, vUI8 layersB,
+	vBOOL collide);
+VPHYSAPI vBOOL vPXGetLayersCollide(vUI8 layersA, vUI8 layersB);
+VPHYSAPI void  vPXSetLayerMatrix(const vUI8 rows[PX_LAYER_COUNT]);
+VPHYSAPI void  vPXGetLayerMatrix(vUI8 rowsOut[PX_LAYER_COUNT]);
+VPHYSAPI void  vPXResetLayerMatrix(void);
+
+
+/* ========== LAYER FILTERING					==========	*/
+/* TRUE if collideLayer values a and b collide				*/
+#define PXLayersCollide(world, a, b)	\
+	(((world)->layers.collides[(a)] & (b)) != ZERO)
+
+void  PXLayerMatrixInit(vPPXWorld world);
+void  PXLayerMatrixFree(vPPXWorld world);
+/* FALSE if no two bodies binned into the cell can collide	*/
+vBOOL PXLayerCellCollides(vPPXWorld world, vPPXPartition part);
+/* groups the cell's non-sensor bodies by collideLayer into	*/
+/* world->layers, in cell order, returns the group count		*/
+vUI32 PXLayerGroupCell(vPPXWorld world, vPPXPartition part);
+vUI64 PXLayerHash(vPPXWorld world, vUI64 hash);
+
+#endif
@@ -0,0 +1,316 @@
+/* ========== <vphyslod.c>						==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Interest points and distance based simulation LOD.		*/
+/* Distances are measured once per partition in use, then	*/
+/* each body takes the finest tier of the partitions it was	*/
+/* binned into, so the cost follows cells, not bodies.		*/
+
+
+/* ========== INCLUDES							==========	*/
+#include "vphyslod.h"
+#include "vphyscore.h"
+#include "vbodystore.h"
+#include "vphystrace.h"
+#include "vphysbudget.h"
+#include <math.h>
+#include <string.h>
+
+
+/* ========== HELPERS							==========	*/
+static vBOOL PXLODAnyInterest(vPPXWorld world)
+{
+	for (vUI32 i = 0; i < PX_INTERESTS_MAX; i++)
+		if (world->interests[i].inUse == TRUE) return TRUE;
+	return FALSE;
+}
+
+static vUI8 PXLODCellTier(vPPXWorld world, vPPXPartition part)
+{
+	PPXLODState lod = &world->lod;
+	vFloat left   = part->x * world->partitionSize;
+	vFloat bottom = part->y * world->partitionSize;
+
+	vUI8 tier = PX_LOD_FROZEN;
+	for (vUI32 i = 0; i < PX_INTERESTS_MAX; i++)
+	{
+		PPXInterest interest = world->interests + i;
+		if (interest->inUse == FALSE) continue;
+
+		/* distance from the interest's edge to the cell's rectangle */
+		vVect point = interest->position;
+		vFloat dx = max(0.0f, max(left - point.x,
+			point.x - (left + world->partitionSize)));
+		vFloat dy = max(0.0f, max(bottom - point.y,
+			point.y - (bottom + world->partitionSize)));
+		vFloat distance = sqrtf(dx * dx + dy * dy) - interest->radius;
+
+		if (distance <= 0.0f) return PX_LOD_FULL;
+		vUI8 reach = (distance <= lod->halfRange) ? PX_LOD_HALF :
+			(distance <= lod->quarterRange) ? PX_LOD_QUARTER : PX_LOD_FROZEN;
+		tier = min(tier, reach);
+	}
+	return tier;
+}
+
+static vBOOL PXLODDue(vPPXWorld world, vUI32 body, vUI8 tier)
+{
+	if (tier == PX_LOD_FROZEN) return FALSE;
+
+	/* the handle slot staggers bodies of a tier over its ticks */
+	vUI32 phase = world->bodies.handle[body] & PX_HANDLE_INDEX_MASK;
+	return ((world->stats.tickCount + phase) & ((1u << tier) - 1)) == 0;
+}
+
+static void PXLODReserveCells(PPXLODState lod, vUI32 cells)
+{
+	if (lod->cellCapacity >= cells) return;
+
+	vUI32 newCap = max(PARTITION_CAPACITY_MIN, lod->cellCapacity);
+	while (newCap < cells) newCap <<= 1;
+
+	/* refilled every tick, no copy needed */
+	vFree(lod->cellTier);
+	lod->cellTier     = vAlloc(sizeof(vUI8) * newCap);
+	lod->cellCapacity = newCap;
+}
+
+
+/* ========== LOD STATE							==========	*/
+void PXLODFree(vPPXWorld world)
+{
+	vFree(world->lod.cellTier);
+	world->lod.cellTier     = NULL;
+	world->lod.cellCapacity = 0;
+}
+
+void PXLODAssign(vPPXWorld world)
+{
+	PPXBodyStore store = &world->bodies;
+	PPXLODState lod = &world->lod;
+	vZeroMemory(world->stats.lodBodies, sizeof(world->stats.lodBodies));
+	world->stats.lodIdle     = 0;
+	world->stats.lodDeferred = 0;
+
+	/* off, or nothing to measure from: everything at full rate */
+	if (lod->enabled == FALSE || PXLODAnyInterest(world) == FALSE)
+	{
+		memset(store->lodTier, PX_LOD_FULL, store->count);
+		world->stats.lodBodies[PX_LOD_FULL] = world->stats.activeBodies;
+		return;
+	}
+
+	PXTRACE_SPAN_BEGIN(world, traceStart);
+
+	/* one distance test per partition in use */
+	vUI32 cells = world->partitionPoolCursor;
+	PXLODReserveCells(lod, cells);
+	for (vUI32 i = 0; i < cells; i++)
+		lod->cellTier[i] = PXLODCellTier(world, world->partitionPool[i]);
+
+	/* each body takes the finest tier of its partitions */
+	memset(store->lodTier, PX_LOD_FROZEN, store->count);
+	for (vUI32 i = 0; i < cells; i++)
+	{
+		vPPXPartition part = world->partitionPool[i];
+		vUI8 tier = lod->cellTier[i];
+		for (vUI32 j = 0; j < part->useage; j++)
+		{
+			vUI32 body = part->list[j];
+			if (tier < store->lodTier[body]) store->lodTier[body] = tier;
+		}
+	}
+
+	for (vUI32 body = 0; body < store->count; body++)
+	{
+		/* inactive bodies were never binned, they step as before */
+		if ((store->flags[body] & PX_BODY_ACTIVE) == 0)
+		{
+			store->lodTier[body] = PX_LOD_FULL;
+			continue;
+		}
+
+		/* over budget, far bodies step one tier slower. only	*/
+		/* the budget uses PX_LOD_EIGHTH, so none start there	*/
+		vUI8 tier = store->lodTier[body];
+		if (PXBudgetDegraded(world, PX_DEGRADE_LOD) &&
+			(tier == PX_LOD_HALF || tier == PX_LOD_QUARTER))
+		{
+			store->lodTier[body] = ++tier;
+			world->stats.lodDeferred++;
+		}
+
+		world->stats.lodBodies[tier]++;
+		if (PXLODDue(world, body, tier) == TRUE) continue;
+
+		/* time stands still for frozen bodies, they owe nothing */
+		if (tier == PX_LOD_FROZEN)
+			store->lastStepTick[body] = world->stats.tickCount + 1;
+
+		store->flags[body] |= PX_BODY_IDLE;
+		world->stats.lodIdle++;
+	}
+
+	PXTRACE_SPAN_END(world, traceStart, PX_TRACE_LOD,
+		world->stats.lodIdle, cells);
+}
+
+vUI32 PXLODSteps(vPPXWorld world, vUI32 body)
+{
+	/* the tier only says when a body is due, what it owes is	*/
+	/* the ticks since it last stepped, which differ from the	*/
+	/* tier's step after the body changes tier					*/
+	vPUI64 lastStep = world->bodies.lastStepTick + body;
+	vUI64  reached  = world->stats.tickCount + 1;
+	vUI64  owed     = (reached > *lastStep) ? reached - *lastStep : 1;
+	*lastStep = reached;
+	return (vUI32)min(owed, PX_LOD_STEPS_MAX);
+}
+
+vUI64 PXLODHash(vPPXWorld world, vUI64 hash)
+{
+	/* interests only change the simulation while LOD is on */
+	PPXLODState lod = &world->lod;
+	if (lod->enabled == FALSE) return hash;
+
+	hash = PXHashBytes(hash, &lod->halfRange, sizeof(vFloat));
+	hash = PXHashBytes(hash, &lod->quarterRange, sizeof(vFloat));
+	for (vUI32 i = 0; i < PX_INTERESTS_MAX; i++)
+	{
+		PPXInterest interest = world->interests + i;
+		if (interest->inUse == FALSE) continue;
+		hash = PXHashBytes(hash, &interest->position, sizeof(vVect));
+		hash = PXHashBytes(hash, &interest->radius, sizeof(vFloat));
+	}
+	return hash;
+}
+
+
+/* ========== INTEREST POINTS					==========	*/
+VPHYSAPI vPXInterestID vPXWorldAddInterest(vPPXWorld world, vVect position,
+	vFloat radius)
+{
+	vPXWorldLock(world);
+	vPXInterestID id = PX_INTEREST_NONE;
+	for (vUI32 i = 0; i < PX_INTERESTS_MAX; i++)
+	{
+		PPXInterest interest = world->interests + i;
+		if (interest->inUse == TRUE) continue;
+
+		interest->inUse    = TRUE;
+		interest->position = position;
+		interest->radius   = max(0.0f, radius);
+		id = i + 1;
+		break;
+	}
+	vPXWorldUnlock(world);
+	return id;
+}
+
+VPHYSAPI vBOOL vPXWorldMoveInterest(vPPXWorld world, vPXInterestID id,
+	vVect position, vFloat radius)
+{
+	if (id == PX_INTEREST_NONE || id > PX_INTERESTS_MAX) return FALSE;
+
+	vPXWorldLock(world);
+	PPXInterest interest = world->interests + (id - 1);
+	vBOOL result = interest->inUse;
+	if (result == TRUE)
+	{
+		interest->position = position;
+		interest->radius   = max(0.0f, radius);
+	}
+	vPXWorldUnlock(world);
+	return result;
+}
+
+VPHYSAPI vBOOL vPXWorldRemoveInterest(vPPXWorld world, vPXInterestID id)
+{
+	if (id == PX_INTEREST_NONE || id > PX_INTERESTS_MAX) return FALSE;
+
+	vPXWorldLock(world);
+	PPXInterest interest = world->interests + (id - 1);
+	vBOOL result = interest->inUse;
+	interest->inUse = FALSE;
+	vPXWorldUnlock(world);
+	return result;
+}
+
+
+/* ========== LEVEL OF DETAIL					==========	*/
+VPHYSAPI void vPXWorldEnableLOD(vPPXWorld world, vFloat halfRange,
+	vFloat quarterRange)
+{
+	vPXWorldLock(world);
+	PPXLODState lod = &world->lod;
+	lod->halfRange = (halfRange > 0.0f) ?
+		halfRange : PX_LOD_HALF_RANGE_DEFAULT;
+	lod->quarterRange = (quarterRange > 0.0f) ?
+		quarterRange : PX_LOD_QUARTER_RANGE_DEFAULT;
+	lod->quarterRange = max(lod->quarterRange, lod->halfRange);
+	lod->enabled = TRUE;
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI void vPXWorldDisableLOD(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	world->lod.enabled = FALSE;
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI vBOOL vPXWorldIsLOD(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	vBOOL enabled = world->lod.enabled;
+	vPXWorldUnlock(world);
+	return enabled;
+}
+
+VPHYSAPI vUI8 vPXWorldGetBodyLOD(vPPXWorld world, vPXHandle handle)
+{
+	vPXWorldLock(world);
+	vUI8 tier = PX_LOD_FULL;
+	vUI32 body = PXBodyStoreResolve(world, handle);
+	if (world->lod.enabled == TRUE && body < world->bodies.count)
+		tier = world->bodies.lodTier[body];
+	vPXWorldUnlock(world);
+	return tier;
+}
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI vPXInterestID vPXAddInterest(vVect position, vFloat radius)
+{
+	return vPXWorldAddInterest(&_vphys, position, radius);
+}
+
+VPHYSAPI vBOOL vPXMoveInterest(vPXInterestID id, vVect position,
+	vFloat radius)
+{
+	return vPXWorldMoveInterest(&_vphys, id, position, radius);
+}
+
+VPHYSAPI vBOOL vPXRemoveInterest(vPXInterestID id)
+{
+	return vPXWorldRemoveInterest(&_vphys, id);
+}
+
+VPHYSAPI void vPXEnableLOD(vFloat halfRange, vFloat quarterRange)
+{
+	vPXWorldEnableLOD(&_vphys, halfRange, quarterRange);
+}
+
+VPHYSAPI void vPXDisableLOD(void)
+{
+	vPXWorldDisableLOD(&_vphys);
+}
+
+VPHYSAPI vBOOL vPXIsLOD(void)
+{
+	return vPXWorldIsLOD(&_vphys);
+}
+
+VPHYSAPI vUI8 vPXGetBodyLOD(vPXHandle handle)
+{
+	return vPXWorldGetBodyLOD(&_vphys, handle);
+}
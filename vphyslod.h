@@ -0,0 +1,69 @@
+/* ========== <vphyslod.h>						==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Interest points and distance based simulation LOD.		*/
+/* Interests mark where detail matters, a camera or a		*/
+/* player. Streaming keeps regions near them in memory, and	*/
+/* with LOD on, bodies further away are stepped less often:	*/
+/* every 2nd or every 4th tick, by that many ticks at once,	*/
+/* or not at all. Tiers are found per partition, so a body	*/
+/* takes the finest tier of the cells it touches.			*/
+/*															*/
+/* Reduced rate bodies are spread over the ticks by handle,	*/
+/* so the work per tick stays flat. A body not stepped this	*/
+/* tick still blocks others, but does not respond to			*/
+/* contacts, fields or tiles, and its updateFunc is only		*/
+/* called on the ticks it is stepped.						*/
+
+#ifndef _VPHYS_LOD_INCLUDE_
+#define _VPHYS_LOD_INCLUDE_
+
+/* ========== INCLUDES							==========	*/
+#include "vphysdefs.h"
+
+
+/* ========== INTEREST POINTS					==========	*/
+/* returns PX_INTEREST_NONE when full						*/
+VPHYSAPI vPXInterestID vPXWorldAddInterest(vPPXWorld world, vVect position,
+	vFloat radius);
+VPHYSAPI vBOOL vPXWorldMoveInterest(vPPXWorld world, vPXInterestID id,
+	vVect position, vFloat radius);
+VPHYSAPI vBOOL vPXWorldRemoveInterest(vPPXWorld world, vPXInterestID id);
+
+
+/* ========== LEVEL OF DETAIL					==========	*/
+/* bodies within an interest's radius are stepped every		*/
+/* tick, within radius + halfRange every 2nd tick, within		*/
+/* radius + quarterRange every 4th, and frozen further out.	*/
+/* ranges <= 0 use the PX_LOD_ defaults. with no interests	*/
+/* every body is stepped every tick							*/
+VPHYSAPI void  vPXWorldEnableLOD(vPPXWorld world, vFloat halfRange,
+	vFloat quarterRange);
+VPHYSAPI void  vPXWorldDisableLOD(vPPXWorld world);
+VPHYSAPI vBOOL vPXWorldIsLOD(vPPXWorld world);
+/* PX_LOD_ tier of the body last tick, PX_LOD_FULL if LOD is	*/
+/* off or the handle does not resolve						*/
+VPHYSAPI vUI8  vPXWorldGetBodyLOD(vPPXWorld world, vPXHandle handle);
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI vPXInterestID vPXAddInterest(vVect position, vFloat radius);
+VPHYSAPI vBOOL vPXMoveInterest(vPXInterestID id, vVect position,
+	vFloat radius);
+VPHYSAPI vBOOL vPXRemoveInterest(vPXInterestID id);
+VPHYSAPI void  vPXEnableLOD(vFloat halfRange, vFloat quarterRange);
+VPHYSAPI void  vPXDisableLOD(void);
+VPHYSAPI vBOOL vPXIsLOD(void);
+VPHYSAPI vUI8  vPXGetBodyLOD(vPXHandle handle);
+
+
+/* ========== LOD STATE							==========	*/
+void  PXLODFree(vPPXWorld world);
+/* after setup: tiers every binned body, marks those not due	*/
+/* this tick PX_BODY_IDLE and fills the LOD stats			*/
+void  PXLODAssign(vPPXWorld world);
+/* ticks of motion a due body covers this tick: every tick	*/
+/* since its last step, up to PX_LOD_STEPS_MAX				*/
+vUI32 PXLODSteps(vPPXWorld world, vUI32 body);
+vUI64 PXLODHash(vPPXWorld world, vUI64 hash);
+
+#endif
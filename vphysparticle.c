@@ -0,0 +1,690 @@
+/* ========== <vphysparticle.c>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Lightweight particles for debris and sparks.				*/
+/* Each tick expires, integrates and then collides every	*/
+/* particle, first with each other and then with bodies.	*/
+/* Body contacts look up the partitions the bodies were		*/
+/* sorted into this tick and resolve only the deepest		*/
+/* contact, so a particle spanning cells is never pushed	*/
+/* twice by the same body.									*/
+
+
+/* ========== INCLUDES							==========	*/
+#include "vphysparticle.h"
+#include "vphyscore.h"
+#include "vphysrand.h"
+#include "vspacepart.h"
+#include "vbodystore.h"
+#include "vphystilemap.h"
+#include "vphysfield.h"
+#include "vphyslayer.h"
+#include "vphysbudget.h"
+#include <stddef.h>
+#include <math.h>
+#ifdef PX_SSE2
+#include <emmintrin.h>
+#endif
+
+
+/* ========== INTERNAL STRUCTS					==========	*/
+typedef struct PXParticleContact
+{
+	vUI32  body;		/* body pushing the particle			*/
+	vVect  normal;		/* out of the body						*/
+	vFloat depth;
+} PXParticleContact, *PPXParticleContact;
+
+
+/* ========== FIELD TABLE						==========	*/
+/* every per-particle array in the store					*/
+typedef struct PXParticleField
+{
+	SIZE_T offset;	/* offset of array pointer in PXParticleStore	*/
+	SIZE_T size;	/* element size									*/
+} PXParticleField;
+
+#define PXPARTICLEFIELD(name, type) { offsetof(PXParticleStore, name), sizeof(type) }
+
+static const PXParticleField __particleFields[] =
+{
+	PXPARTICLEFIELD(positionX,		vFloat),
+	PXPARTICLEFIELD(positionY,		vFloat),
+	PXPARTICLEFIELD(velocityX,		vFloat),
+	PXPARTICLEFIELD(velocityY,		vFloat),
+	PXPARTICLEFIELD(radius,			vFloat),
+	PXPARTICLEFIELD(life,			vUI32),
+	PXPARTICLEFIELD(collideLayer,	vUI8),
+	PXPARTICLEFIELD(cellNext,		vUI32),
+};
+
+#define PARTICLEFIELD_COUNT (sizeof(__particleFields) / sizeof(PXParticleField))
+
+static vUI8** PXParticleFieldArray(PPXParticleStore store, vUI32 field)
+{
+	return (vUI8**)((vUI8*)store + __particleFields[field].offset);
+}
+
+
+/* ========== HELPERS							==========	*/
+static void PXParticleStoreEnsureCapacity(vPPXWorld world, vUI32 required)
+{
+	PPXParticleStore store = &world->particles;
+	if (store->capacity >= required) return;
+
+	vUI32 newCap = max(PARTICLESTORE_CAPACITY_MIN, store->capacity);
+	while (newCap < required) newCap <<= 1;
+
+	for (vUI32 f = 0; f < PARTICLEFIELD_COUNT; f++)
+	{
+		vUI8** array = PXParticleFieldArray(store, f);
+		vUI8*  newArray = vAlloc(__particleFields[f].size * newCap);
+		if (*array != NULL)
+			vMemCopy(newArray, *array, __particleFields[f].size * store->count);
+		vFree(*array);
+		*array = newArray;
+	}
+
+	store->capacity = newCap;
+}
+
+static void PXParticleMove(PPXParticleStore store, vUI32 dst, vUI32 src)
+{
+	store->positionX[dst]    = store->positionX[src];
+	store->positionY[dst]    = store->positionY[src];
+	store->velocityX[dst]    = store->velocityX[src];
+	store->velocityY[dst]    = store->velocityY[src];
+	store->radius[dst]       = store->radius[src];
+	store->life[dst]         = store->life[src];
+	store->collideLayer[dst] = store->collideLayer[src];
+}
+
+static vI32 PXParticleCell(vFloat value)
+{
+	/* floorf without the library call, exact for cell ranges */
+	vI32 truncated = (vI32)value;
+	return truncated - (value < (vFloat)truncated);
+}
+
+static vUI32 PXParticleClaim(vPPXWorld world, vUI32 count)
+{
+	/* returns the first of count new particles */
+	PPXParticleStore store = &world->particles;
+	vUI32 first = store->count;
+	PXParticleStoreEnsureCapacity(world, first + count);
+	store->count += count;
+	return first;
+}
+
+
+/* ========== SIMULATION PASSES					==========	*/
+static void PXParticleExpire(PPXParticleStore store)
+{
+	/* the last particle fills each hole, so order is not kept */
+	for (vUI32 i = 0; i < store->count;)
+	{
+		vUI32 life = store->life[i];
+		if (life == PX_PARTICLE_LIFE_FOREVER) { i++; continue; }
+		if (life > 1) { store->life[i] = life - 1; i++; continue; }
+		PXParticleMove(store, i, --store->count);
+	}
+}
+
+static void PXParticleIntegrate(PPXParticleStore store)
+{
+	/* same order of operations as body dynamics: drag,	*/
+	/* then acceleration, then position					*/
+	vFloat dragScale = 1.0f - store->drag;
+	vFloat gravityX  = store->gravity.x;
+	vFloat gravityY  = store->gravity.y;
+	vUI32 count = store->count;
+	vUI32 i = 0;
+
+#ifdef PX_SSE2
+	__m128 vDrag     = _mm_set1_ps(dragScale);
+	__m128 vGravityX = _mm_set1_ps(gravityX);
+	__m128 vGravityY = _mm_set1_ps(gravityY);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 vx = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(store->velocityX + i),
+			vDrag), vGravityX);
+		__m128 vy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(store->velocityY + i),
+			vDrag), vGravityY);
+		_mm_storeu_ps(store->velocityX + i, vx);
+		_mm_storeu_ps(store->velocityY + i, vy);
+		_mm_storeu_ps(store->positionX + i,
+			_mm_add_ps(_mm_loadu_ps(store->positionX + i), vx));
+		_mm_storeu_ps(store->positionY + i,
+			_mm_add_ps(_mm_loadu_ps(store->positionY + i), vy));
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		vFloat vx = store->velocityX[i] * dragScale + gravityX;
+		vFloat vy = store->velocityY[i] * dragScale + gravityY;
+		store->velocityX[i] = vx;
+		store->velocityY[i] = vy;
+		store->positionX[i] += vx;
+		store->positionY[i] += vy;
+	}
+}
+
+
+/* ========== BODY CONTACTS						==========	*/
+static vBOOL PXParticleContactBody(vPPXWorldBoundMesh worldBound, vFloat x,
+	vFloat y, vFloat radius, PPXParticleContact contactOut)
+{
+	vPGRect box = &worldBound->boundingBox;
+	if (x + radius < box->left || x - radius > box->right ||
+		y + radius < box->bottom || y - radius > box->top) return FALSE;
+
+	/* box axes from the quad edges; the mesh runs up the left	*/
+	/* side and then along the top, see vPXBoundToMesh			*/
+	vPVect mesh = worldBound->mesh;
+	vVect  axisU = vPXCreateVect(mesh[3].x - mesh[0].x, mesh[3].y - mesh[0].y);
+	vVect  axisV = vPXCreateVect(mesh[1].x - mesh[0].x, mesh[1].y - mesh[0].y);
+	vFloat lengthU = vPXVectorMagnitudePrecise(axisU);
+	vFloat lengthV = vPXVectorMagnitudePrecise(axisV);
+	if (lengthU < VPHYS_EPSILON || lengthV < VPHYS_EPSILON) return FALSE;
+	vPXVectorMultiply(&axisU, 1.0f / lengthU);
+	vPXVectorMultiply(&axisV, 1.0f / lengthV);
+	vFloat halfU = lengthU * 0.5f;
+	vFloat halfV = lengthV * 0.5f;
+
+	/* particle center in box space */
+	vFloat dx = x - worldBound->center.x;
+	vFloat dy = y - worldBound->center.y;
+	vFloat u  = dx * axisU.x + dy * axisU.y;
+	vFloat v  = dx * axisV.x + dy * axisV.y;
+	vFloat absU = vPXFastFabs(u), absV = vPXFastFabs(v);
+	if (absU > halfU + radius || absV > halfV + radius) return FALSE;
+
+	/* center inside the box, leave through the nearest face */
+	if (absU < halfU && absV < halfV)
+	{
+		vFloat exitU = halfU - absU;
+		vFloat exitV = halfV - absV;
+		if (exitU < exitV)
+		{
+			contactOut->normal = vPXVectorMultiplyCopy(axisU, u < 0.0f ? -1.0f : 1.0f);
+			contactOut->depth  = exitU + radius;
+		}
+		else
+		{
+			contactOut->normal = vPXVectorMultiplyCopy(axisV, v < 0.0f ? -1.0f : 1.0f);
+			contactOut->depth  = exitV + radius;
+		}
+		return TRUE;
+	}
+
+	/* otherwise away from the closest point on the box */
+	vFloat closestU = max(-halfU, min(halfU, u));
+	vFloat closestV = max(-halfV, min(halfV, v));
+	vFloat offsetX = dx - (closestU * axisU.x + closestV * axisV.x);
+	vFloat offsetY = dy - (closestU * axisU.y + closestV * axisV.y);
+	vFloat distanceSq = offsetX * offsetX + offsetY * offsetY;
+	if (distanceSq >= radius * radius || distanceSq <= 0.0f) return FALSE;
+
+	vFloat distance = sqrtf(distanceSq);
+	contactOut->normal = vPXCreateVect(offsetX / distance, offsetY / distance);
+	contactOut->depth  = radius - distance;
+	return TRUE;
+}
+
+static void PXParticleBuildCellMask(vPPXWorld world)
+{
+	/* most particles are nowhere near a body. one bit per	*/
+	/* cell, set around every partition in use, rejects a		*/
+	/* particle smaller than a cell from its center alone		*/
+	PPXParticleStore store = &world->particles;
+	store->cellMaskWidth  = 0;
+	store->cellMaskHeight = 0;
+	if (world->partitionPoolCursor == 0) return;
+
+	vI32 minX = world->partitionPool[0]->x, maxX = minX;
+	vI32 minY = world->partitionPool[0]->y, maxY = minY;
+	for (vUI32 i = 1; i < world->partitionPoolCursor; i++)
+	{
+		vPPXPartition part = world->partitionPool[i];
+		minX = min(minX, part->x); maxX = max(maxX, part->x);
+		minY = min(minY, part->y); maxY = max(maxY, part->y);
+	}
+
+	/* bodies spread too far apart to be worth a mask */
+	minX--; minY--;
+	vUI64 width  = (vUI64)((vI64)maxX - minX + 2);
+	vUI64 height = (vUI64)((vI64)maxY - minY + 2);
+	if (width * height > PX_PARTICLE_CELLMASK_MAX) return;
+
+	vUI32 words = (vUI32)((width * height + 31) >> 5);
+	if (store->cellMaskCapacity < words)
+	{
+		vFree(store->cellMask);
+		store->cellMask = vAlloc(sizeof(vUI32) * words);
+		store->cellMaskCapacity = words;
+	}
+	vZeroMemory(store->cellMask, sizeof(vUI32) * words);
+
+	for (vUI32 i = 0; i < world->partitionPoolCursor; i++)
+	{
+		vPPXPartition part = world->partitionPool[i];
+		for (vUI32 my = part->y - minY - 1; my <= part->y - minY + 1; my++)
+		{
+			for (vUI32 mx = part->x - minX - 1; mx <= part->x - minX + 1; mx++)
+			{
+				vUI32 bit = my * (vUI32)width + mx;
+				store->cellMask[bit >> 5] |= 1u << (bit & 31);
+			}
+		}
+	}
+
+	store->cellMaskX      = minX;
+	store->cellMaskY      = minY;
+	store->cellMaskWidth  = (vUI32)width;
+	store->cellMaskHeight = (vUI32)height;
+}
+
+static vBOOL PXParticleNearBodies(PPXParticleStore store, vI32 cx, vI32 cy)
+{
+	/* wraps for cells below the mask, rejected with the rest */
+	vUI32 mx = (vUI32)cx - (vUI32)store->cellMaskX;
+	vUI32 my = (vUI32)cy - (vUI32)store->cellMaskY;
+	if (mx >= store->cellMaskWidth || my >= store->cellMaskHeight) return FALSE;
+
+	vUI32 bit = my * store->cellMaskWidth + mx;
+	return (store->cellMask[bit >> 5] >> (bit & 31)) & 1;
+}
+
+static void PXParticleCollideBodies(vPPXWorld world)
+{
+	PPXParticleStore store  = &world->particles;
+	PPXBodyStore     bodies = &world->bodies;
+	if (world->partitionMap.count == 0) return;
+	PXParticleBuildCellMask(world);
+
+	vFloat cellScale = 1.0f / world->partitionSize;
+	for (vUI32 i = 0; i < store->count; i++)
+	{
+		vFloat x = store->positionX[i];
+		vFloat y = store->positionY[i];
+		vFloat r = store->radius[i];
+		if (store->cellMaskWidth != 0 && r < world->partitionSize &&
+			PXParticleNearBodies(store, PXParticleCell(x * cellScale),
+				PXParticleCell(y * cellScale)) == FALSE) continue;
+
+		vI32 xMin = PXParticleCell((x - r) * cellScale);
+		vI32 xMax = PXParticleCell((x + r) * cellScale);
+		vI32 yMin = PXParticleCell((y - r) * cellScale);
+		vI32 yMax = PXParticleCell((y + r) * cellScale);
+
+		PXParticleContact deepest = { 0 };
+		for (vI32 cx = xMin; cx <= xMax; cx++)
+		{
+			for (vI32 cy = yMin; cy <= yMax; cy++)
+			{
+				vUI32 poolIndex = PXCellMapFind(&world->partitionMap, cx, cy);
+				if (poolIndex == CELLMAP_EMPTY) continue;
+				vPPXPartition part = world->partitionPool[poolIndex];
+				if (PXLayersCollide(world, store->collideLayer[i],
+					part->layerMask) == FALSE) continue;
+
+				for (vUI32 j = 0; j < part->useage; j++)
+				{
+					vUI32 body = part->list[j];
+					if (bodies->physical[body] == NULL) continue;
+					if (PXLayersCollide(world, store->collideLayer[i],
+						bodies->collideLayer[body]) == FALSE) continue;
+					if (bodies->flags[body] & PX_BODY_SENSOR) continue;
+
+					PXParticleContact contact;
+					if (PXParticleContactBody(bodies->worldBound + body, x, y, r,
+						&contact) == FALSE) continue;
+					if (contact.depth <= deepest.depth) continue;
+
+					contact.body = body;
+					deepest = contact;
+				}
+			}
+		}
+		if (deepest.depth <= 0.0f) continue;
+
+		/* push out, then bounce the velocity relative to the body */
+		store->positionX[i] = x + deepest.normal.x * deepest.depth;
+		store->positionY[i] = y + deepest.normal.y * deepest.depth;
+
+		vVect bodyVelocity = bodies->velocity[deepest.body];
+		vFloat relativeX = store->velocityX[i] - bodyVelocity.x;
+		vFloat relativeY = store->velocityY[i] - bodyVelocity.y;
+		vFloat approach  = relativeX * deepest.normal.x +
+			relativeY * deepest.normal.y;
+		if (approach < 0.0f)
+		{
+			vFloat impulse = -(1.0f + store->restitution) * approach;
+			store->velocityX[i] += deepest.normal.x * impulse;
+			store->velocityY[i] += deepest.normal.y * impulse;
+		}
+		world->stats.particleContacts++;
+	}
+}
+
+
+/* ========== PARTICLE CONTACTS					==========	*/
+static void PXParticleResolvePair(vPPXWorld world, vUI32 a, vUI32 b)
+{
+	PPXParticleStore store = &world->particles;
+	if (PXLayersCollide(world, store->collideLayer[a],
+		store->collideLayer[b]) == FALSE) return;
+
+	vFloat dx = store->positionX[b] - store->positionX[a];
+	vFloat dy = store->positionY[b] - store->positionY[a];
+	vFloat reach = store->radius[a] + store->radius[b];
+	vFloat distanceSq = dx * dx + dy * dy;
+	if (distanceSq >= reach * reach) return;
+
+	/* coincident particles separate along x */
+	vFloat distance = sqrtf(distanceSq);
+	vVect normal = (distance > 0.0f) ?
+		vPXCreateVect(dx / distance, dy / distance) : vPXCreateVect(1.0f, 0.0f);
+
+	/* equal mass: split the push, exchange approach velocity */
+	vFloat push = (reach - distance) * 0.5f;
+	store->positionX[a] -= normal.x * push;
+	store->positionY[a] -= normal.y * push;
+	store->positionX[b] += normal.x * push;
+	store->positionY[b] += normal.y * push;
+
+	vFloat approach = (store->velocityX[b] - store->velocityX[a]) * normal.x +
+		(store->velocityY[b] - store->velocityY[a]) * normal.y;
+	if (approach < 0.0f)
+	{
+		vFloat impulse = -(1.0f + store->restitution) * approach * 0.5f;
+		store->velocityX[a] -= normal.x * impulse;
+		store->velocityY[a] -= normal.y * impulse;
+		store->velocityX[b] += normal.x * impulse;
+		store->velocityY[b] += normal.y * impulse;
+	}
+	world->stats.particleContacts++;
+}
+
+static void PXParticleCollideParticles(vPPXWorld world)
+{
+	PPXParticleStore store = &world->particles;
+	if (store->selfCollide == FALSE || store->count < 2) return;
+
+	/* cells at least a particle diameter wide, so touching	*/
+	/* particles are never more than one cell apart			*/
+	vFloat radiusMax = 0.0f;
+	for (vUI32 i = 0; i < store->count; i++)
+		radiusMax = max(radiusMax, store->radius[i]);
+	if (radiusMax <= 0.0f) return;
+	vFloat cellScale = 1.0f / (radiusMax * 2.0f);
+
+	/* chain every particle into its cell */
+	PPXCellMap map = &store->cellMap;
+	if (map->capacity == 0) PXCellMapInit(map, CELLMAP_CAPACITY_MIN);
+	PXCellMapClear(map);
+	for (vUI32 i = 0; i < store->count; i++)
+	{
+		vI32 cx = PXParticleCell(store->positionX[i] * cellScale);
+		vI32 cy = PXParticleCell(store->positionY[i] * cellScale);
+		store->cellNext[i] = PXCellMapFind(map, cx, cy);
+		PXCellMapInsert(map, cx, cy, i);
+	}
+
+	/* each cell against itself and half its neighbours, so	*/
+	/* every pair of cells is visited once					*/
+	static const vI32 neighbours[4][2] = { { 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 } };
+	for (vUI32 slot = 0; slot < map->capacity; slot++)
+	{
+		vUI32 head = map->values[slot];
+		if (head == CELLMAP_EMPTY) continue;
+		vI32 cx = (vI32)(vUI32)(map->keys[slot] >> 32);
+		vI32 cy = (vI32)(vUI32)map->keys[slot];
+
+		for (vUI32 a = head; a != CELLMAP_EMPTY; a = store->cellNext[a])
+			for (vUI32 b = store->cellNext[a]; b != CELLMAP_EMPTY; b = store->cellNext[b])
+				PXParticleResolvePair(world, a, b);
+
+		for (int n = 0; n < 4; n++)
+		{
+			vUI32 other = PXCellMapFind(map, cx + neighbours[n][0],
+				cy + neighbours[n][1]);
+			if (other == CELLMAP_EMPTY) continue;
+
+			for (vUI32 a = head; a != CELLMAP_EMPTY; a = store->cellNext[a])
+				for (vUI32 b = other; b != CELLMAP_EMPTY; b = store->cellNext[b])
+					PXParticleResolvePair(world, a, b);
+		}
+	}
+}
+
+
+/* ========== PARTICLE STORE					==========	*/
+void PXParticleStoreInit(vPPXWorld world)
+{
+	PPXParticleStore store = &world->particles;
+	vZeroMemory(store, sizeof(PXParticleStore));
+	store->restitution = PX_PARTICLE_RESTITUTION_DEFAULT;
+}
+
+void PXParticleStoreFree(vPPXWorld world)
+{
+	PPXParticleStore store = &world->particles;
+	for (vUI32 f = 0; f < PARTICLEFIELD_COUNT; f++)
+		vFree(*PXParticleFieldArray(store, f));
+	vFree(store->cellMask);
+	if (store->cellMap.capacity > 0) PXCellMapFree(&store->cellMap);
+	vZeroMemory(store, sizeof(PXParticleStore));
+}
+
+void PXParticleTick(vPPXWorld world)
+{
+	PPXParticleStore store = &world->particles;
+	world->stats.particleContacts = 0;
+
+	PXParticleExpire(store);
+	PXFieldApplyParticles(world);
+	PXParticleIntegrate(store);
+	/* bodies last, so particles piled on a body end the tick	*/
+	/* outside of it rather than pushed in by their neighbours	*/
+	if (PXBudgetDegraded(world, PX_DEGRADE_PARTICLES) == FALSE)
+		PXParticleCollideParticles(world);
+	PXParticleCollideBodies(world);
+	PXTilemapCollideParticles(world);
+
+	world->stats.particles = store->count;
+}
+
+
+/* ========== PARAMETERS						==========	*/
+VPHYSAPI void vPXWorldSetParticleMotion(vPPXWorld world, vVect gravity,
+	vFloat drag)
+{
+	vPXWorldLock(world);
+	world->particles.gravity = gravity;
+	world->particles.drag    = drag;
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI void vPXWorldSetParticleCollision(vPPXWorld world,
+	vFloat restitution, vBOOL selfCollide)
+{
+	vPXWorldLock(world);
+	world->particles.restitution = max(0.0f, min(1.0f, restitution));
+	world->particles.selfCollide = selfCollide;
+	vPXWorldUnlock(world);
+}
+
+
+/* ========== EMISSION							==========	*/
+VPHYSAPI vUI32 vPXWorldEmitParticles(vPPXWorld world,
+	vPPXParticleEmitter emitter, vUI32 count)
+{
+	if (count == 0) return 0;
+
+	vPXWorldLock(world);
+	PPXParticleStore store = &world->particles;
+	vUI32 first = PXParticleClaim(world, count);
+
+	/* offsets are filled in bulk straight into the store */
+	vPPXRandStream random = &world->random;
+	vPXRandStreamFill(random, store->positionX + first, count,
+		-emitter->positionSpread.x, emitter->positionSpread.x);
+	vPXRandStreamFill(random, store->positionY + first, count,
+		-emitter->positionSpread.y, emitter->positionSpread.y);
+	vPXRandStreamFill(random, store->velocityX + first, count,
+		-emitter->velocitySpread.x, emitter->velocitySpread.x);
+	vPXRandStreamFill(random, store->velocityY + first, count,
+		-emitter->velocitySpread.y, emitter->velocitySpread.y);
+
+	for (vUI32 i = first; i < first + count; i++)
+	{
+		store->positionX[i]   += emitter->position.x;
+		store->positionY[i]   += emitter->position.y;
+		store->velocityX[i]   += emitter->velocity.x;
+		store->velocityY[i]   += emitter->velocity.y;
+		store->radius[i]       = emitter->radius;
+		store->life[i]         = emitter->life;
+		store->collideLayer[i] = emitter->collideLayer;
+	}
+
+	vPXWorldUnlock(world);
+	return count;
+}
+
+VPHYSAPI vUI32 vPXWorldAddParticles(vPPXWorld world, vPVect positions,
+	vPVect velocities, vUI32 count, vFloat radius, vUI32 life,
+	vUI8 collideLayer)
+{
+	if (count == 0) return 0;
+
+	vPXWorldLock(world);
+	PPXParticleStore store = &world->particles;
+	vUI32 first = PXParticleClaim(world, count);
+
+	for (vUI32 i = 0; i < count; i++)
+	{
+		vUI32 particle = first + i;
+		store->positionX[particle]    = positions[i].x;
+		store->positionY[particle]    = positions[i].y;
+		store->velocityX[particle]    = (velocities == NULL) ? 0.0f : velocities[i].x;
+		store->velocityY[particle]    = (velocities == NULL) ? 0.0f : velocities[i].y;
+		store->radius[particle]       = radius;
+		store->life[particle]         = life;
+		store->collideLayer[particle] = collideLayer;
+	}
+
+	vPXWorldUnlock(world);
+	return count;
+}
+
+
+/* ========== REMOVAL							==========	*/
+VPHYSAPI vUI32 vPXWorldKillParticlesInRect(vPPXWorld world, vGRect region,
+	vUI8 layerMask)
+{
+	vPXWorldLock(world);
+	PPXParticleStore store = &world->particles;
+
+	vUI32 killed = 0;
+	for (vUI32 i = 0; i < store->count;)
+	{
+		vFloat x = store->positionX[i];
+		vFloat y = store->positionY[i];
+		if ((store->collideLayer[i] & layerMask) == ZERO ||
+			x < region.left || x > region.right ||
+			y < region.bottom || y > region.top)
+		{
+			i++;
+			continue;
+		}
+
+		PXParticleMove(store, i, --store->count);
+		killed++;
+	}
+
+	vPXWorldUnlock(world);
+	return killed;
+}
+
+VPHYSAPI void vPXWorldClearParticles(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	world->particles.count = 0;
+	vPXWorldUnlock(world);
+}
+
+
+/* ========== READBACK							==========	*/
+VPHYSAPI vUI32 vPXWorldGetParticles(vPPXWorld world, vPVect positionsOut,
+	vPFloat radiusOut, vUI32 capacity)
+{
+	vPXWorldLock(world);
+	PPXParticleStore store = &world->particles;
+
+	vUI32 count = store->count;
+	vUI32 written = min(count, capacity);
+	for (vUI32 i = 0; i < written; i++)
+	{
+		positionsOut[i].x = store->positionX[i];
+		positionsOut[i].y = store->positionY[i];
+	}
+	if (radiusOut != NULL && written > 0)
+		vMemCopy(radiusOut, store->radius, sizeof(vFloat) * written);
+
+	vPXWorldUnlock(world);
+	return count;
+}
+
+VPHYSAPI vUI32 vPXWorldGetParticleCount(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	vUI32 count = world->particles.count;
+	vPXWorldUnlock(world);
+	return count;
+}
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI void vPXSetParticleMotion(vVect gravity, vFloat drag)
+{
+	vPXWorldSetParticleMotion(&_vphys, gravity, drag);
+}
+
+VPHYSAPI void vPXSetParticleCollision(vFloat restitution, vBOOL selfCollide)
+{
+	vPXWorldSetParticleCollision(&_vphys, restitution, selfCollide);
+}
+
+VPHYSAPI vUI32 vPXEmitParticles(vPPXParticleEmitter emitter, vUI32 count)
+{
+	return vPXWorldEmitParticles(&_vphys, emitter, count);
+}
+
+VPHYSAPI vUI32 vPXAddParticles(vPVect positions, vPVect velocities,
+	vUI32 count, vFloat radius, vUI32 life, vUI8 collideLayer)
+{
+	return vPXWorldAddParticles(&_vphys, positions, velocities, count, radius,
+		life, collideLayer);
+}
+
+VPHYSAPI vUI32 vPXKillParticlesInRect(vGRect region, vUI8 layerMask)
+{
+	return vPXWorldKillParticlesInRect(&_vphys, region, layerMask);
+}
+
+VPHYSAPI void vPXClearParticles(void)
+{
+	vPXWorldClearParticles(&_vphys);
+}
+
+VPHYSAPI vUI32 vPXGetParticles(vPVect positionsOut, vPFloat radiusOut,
+	vUI32 capacity)
+{
+	return vPXWorldGetParticles(&_vphys, positionsOut, radiusOut, capacity);
+}
+
+VPHYSAPI vUI32 vPXGetParticleCount(void)
+{
+	return vPXWorldGetParticleCount(&_vphys);
+}
@@ -0,0 +1,73 @@
+/* ========== <vphysparticle.h>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Lightweight particles for debris and sparks.				*/
+/* Particles are circles with no rotation, mass or			*/
+/* callbacks, kept in packed arrays and stepped in bulk		*/
+/* after the bodies each tick. They are pushed out of		*/
+/* bodies found through the body partitions and out of the	*/
+/* tilemap, but never push bodies back, and are not part	*/
+/* of snapshots or recordings.								*/
+
+#ifndef _VPHYS_PARTICLE_INCLUDE_
+#define _VPHYS_PARTICLE_INCLUDE_
+
+/* ========== INCLUDES							==========	*/
+#include "vphysdefs.h"
+
+
+/* ========== PARAMETERS						==========	*/
+/* shared by every particle in the world					*/
+VPHYSAPI void vPXWorldSetParticleMotion(vPPXWorld world, vVect gravity,
+	vFloat drag);
+/* self collision costs a grid build every tick, cells are	*/
+/* as wide as the largest particle							*/
+VPHYSAPI void vPXWorldSetParticleCollision(vPPXWorld world,
+	vFloat restitution, vBOOL selfCollide);
+
+
+/* ========== EMISSION							==========	*/
+/* spreads are drawn from the world random stream			*/
+VPHYSAPI vUI32 vPXWorldEmitParticles(vPPXWorld world,
+	vPPXParticleEmitter emitter, vUI32 count);
+/* velocities may be NULL									*/
+VPHYSAPI vUI32 vPXWorldAddParticles(vPPXWorld world, vPVect positions,
+	vPVect velocities, vUI32 count, vFloat radius, vUI32 life,
+	vUI8 collideLayer);
+
+
+/* ========== REMOVAL							==========	*/
+/* kills particles centered in region sharing any layer		*/
+/* with layerMask, returns the number killed				*/
+VPHYSAPI vUI32 vPXWorldKillParticlesInRect(vPPXWorld world, vGRect region,
+	vUI8 layerMask);
+VPHYSAPI void  vPXWorldClearParticles(vPPXWorld world);
+
+
+/* ========== READBACK							==========	*/
+/* particles have no identity, their order changes as		*/
+/* others expire. returns the number alive, at most			*/
+/* capacity are written; radiusOut may be NULL				*/
+VPHYSAPI vUI32 vPXWorldGetParticles(vPPXWorld world, vPVect positionsOut,
+	vPFloat radiusOut, vUI32 capacity);
+VPHYSAPI vUI32 vPXWorldGetParticleCount(vPPXWorld world);
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI void  vPXSetParticleMotion(vVect gravity, vFloat drag);
+VPHYSAPI void  vPXSetParticleCollision(vFloat restitution, vBOOL selfCollide);
+VPHYSAPI vUI32 vPXEmitParticles(vPPXParticleEmitter emitter, vUI32 count);
+VPHYSAPI vUI32 vPXAddParticles(vPVect positions, vPVect velocities,
+	vUI32 count, vFloat radius, vUI32 life, vUI8 collideLayer);
+VPHYSAPI vUI32 vPXKillParticlesInRect(vGRect region, vUI8 layerMask);
+VPHYSAPI void  vPXClearParticles(void);
+VPHYSAPI vUI32 vPXGetParticles(vPVect positionsOut, vPFloat radiusOut,
+	vUI32 capacity);
+VPHYSAPI vUI32 vPXGetParticleCount(void);
+
+
+/* ========== PARTICLE STORE					==========	*/
+void  PXParticleStoreInit(vPPXWorld world);
+void  PXParticleStoreFree(vPPXWorld world);
+void  PXParticleTick(vPPXWorld world);
+
+#endif
@@ -0,0 +1,186 @@
+/* ========== <vphyspool.c>						==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Helper threads for the physics tick.						*/
+/* Every thread claims chunks off one shared counter until	*/
+/* none are left. The caller waits for every helper to		*/
+/* check in, even one with nothing left to take, so no		*/
+/* helper can mistake the next batch's state for its own.	*/
+
+
+/* ========== INCLUDES							==========	*/
+#include "vphyspool.h"
+#include "vphyscore.h"
+
+
+/* ========== HELPERS							==========	*/
+static void PXPoolRunChunks(vPPXWorld world)
+{
+	PPXTaskPool pool = &world->pool;
+	for (;;)
+	{
+		vUI32 chunk = (vUI32)InterlockedIncrement(&pool->nextChunk) - 1;
+		vUI64 first = (vUI64)chunk * pool->chunkSize;
+		if (first >= pool->count) return;
+
+		vUI32 end = (vUI32)min((vUI64)pool->count, first + pool->chunkSize);
+		pool->task(world, (vUI32)first, end, pool->input);
+	}
+}
+
+static void PXPoolHelperCycle(vPWorker worker, vPTR workerData)
+{
+	PPXPoolHelper helper = workerData;
+	vPPXWorld world = helper->world;
+	PPXTaskPool pool = &world->pool;
+
+	/* sleep until there is a batch this helper has not seen */
+	EnterCriticalSection(&pool->lock);
+	while (pool->exiting == FALSE && pool->batch == helper->batchSeen)
+		SleepConditionVariableCS(&pool->wake, &pool->lock, INFINITE);
+	if (pool->exiting == TRUE)
+	{
+		LeaveCriticalSection(&pool->lock);
+		return;
+	}
+	helper->batchSeen = pool->batch;
+	LeaveCriticalSection(&pool->lock);
+
+	PXPoolRunChunks(world);
+
+	EnterCriticalSection(&pool->lock);
+	if (--pool->pending == 0) WakeConditionVariable(&pool->done);
+	LeaveCriticalSection(&pool->lock);
+}
+
+static void PXPoolStopHelpers(vPPXWorld world)
+{
+	PPXTaskPool pool = &world->pool;
+	if (pool->threadCount == 0) return;
+
+	EnterCriticalSection(&pool->lock);
+	pool->exiting = TRUE;
+	WakeAllConditionVariable(&pool->wake);
+	LeaveCriticalSection(&pool->lock);
+
+	for (vUI32 i = 0; i < pool->threadCount; i++)
+		vDestroyWorker(pool->helpers[i].worker);
+
+	vFree(pool->helpers);
+	pool->helpers     = NULL;
+	pool->threadCount = 0;
+	pool->exiting     = FALSE;
+}
+
+static void PXPoolStartHelpers(vPPXWorld world, vUI32 threads)
+{
+	PPXTaskPool pool = &world->pool;
+	if (threads == 0) return;
+
+	pool->helpers = vAllocZeroed(sizeof(PXPoolHelper) * threads);
+	for (vUI32 i = 0; i < threads; i++)
+	{
+		PPXPoolHelper helper = pool->helpers + i;
+		helper->world     = world;
+		helper->batchSeen = pool->batch;
+
+		/* no cycle interval, the helper sleeps on the pool itself */
+		helper->worker = vCreateWorker("vPhysics Pool Helper", 0, NULL,
+			NULL, PXPoolHelperCycle, helper, NULL);
+	}
+	pool->threadCount = threads;
+}
+
+
+/* ========== POOL STATE						==========	*/
+void PXPoolInit(vPPXWorld world)
+{
+	PPXTaskPool pool = &world->pool;
+	InitializeCriticalSection(&pool->lock);
+	InitializeConditionVariable(&pool->wake);
+	InitializeConditionVariable(&pool->done);
+}
+
+void PXPoolFree(vPPXWorld world)
+{
+	PXPoolStopHelpers(world);
+	DeleteCriticalSection(&world->pool.lock);
+}
+
+void PXPoolRun(vPPXWorld world, vUI32 count, vUI32 chunkSize,
+	PXPFPOOLTASK task, vPTR input)
+{
+	PPXTaskPool pool = &world->pool;
+
+	/* nothing to share, or nobody to share it with */
+	if (pool->threadCount == 0 || count <= chunkSize)
+	{
+		task(world, 0, count, input);
+		return;
+	}
+
+	EnterCriticalSection(&pool->lock);
+	pool->task      = task;
+	pool->input     = input;
+	pool->count     = count;
+	pool->chunkSize = max(1, chunkSize);
+	pool->nextChunk = 0;
+	pool->pending   = pool->threadCount;
+	pool->batch++;
+	WakeAllConditionVariable(&pool->wake);
+	LeaveCriticalSection(&pool->lock);
+
+	PXPoolRunChunks(world);
+
+	EnterCriticalSection(&pool->lock);
+	while (pool->pending > 0)
+		SleepConditionVariableCS(&pool->done, &pool->lock, INFINITE);
+	LeaveCriticalSection(&pool->lock);
+}
+
+
+/* ========== THREAD POOL						==========	*/
+VPHYSAPI void vPXWorldSetThreadCount(vPPXWorld world, vUI32 threads)
+{
+	threads = min(threads, PX_POOL_THREADS_MAX);
+
+	/* no tick runs while the world is locked, the pool is idle */
+	vPXWorldLock(world);
+	if (threads != world->pool.threadCount)
+	{
+		PXPoolStopHelpers(world);
+		PXPoolStartHelpers(world, threads);
+	}
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI vUI32 vPXWorldGetThreadCount(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	vUI32 threads = world->pool.threadCount;
+	vPXWorldUnlock(world);
+	return threads;
+}
+
+VPHYSAPI void vPXWorldSetThreadSafeUpdates(vPPXWorld world, vBOOL enable)
+{
+	vPXWorldLock(world);
+	world->pool.allThreadSafe = enable;
+	vPXWorldUnlock(world);
+}
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI void vPXSetThreadCount(vUI32 threads)
+{
+	vPXWorldSetThreadCount(&_vphys, threads);
+}
+
+VPHYSAPI vUI32 vPXGetThreadCount(void)
+{
+	return vPXWorldGetThreadCount(&_vphys);
+}
+
+VPHYSAPI void vPXSetThreadSafeUpdates(vBOOL enable)
+{
+	vPXWorldSetThreadSafeUpdates(&_vphys, enable);
+}
@@ -0,0 +1,49 @@
+/* ========== <vphyspool.h>						==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Helper threads for the physics tick.						*/
+/* A world can keep a few helper threads that split wide	*/
+/* per-body work with the thread running the tick. They		*/
+/* sleep between batches, so an idle pool costs nothing.		*/
+/*															*/
+/* Body update callbacks marked thread-safe, through		*/
+/* properties.threadSafeUpdate or for the whole world, all	*/
+/* run on the pool before any unmarked callback, which then	*/
+/* run one by one on the tick thread as before. A			*/
+/* thread-safe updateFunc may read and write its own body's	*/
+/* view and anything else only it touches, and may use the	*/
+/* lock-free queries in vphysquery.h. It must not touch		*/
+/* other bodies, create or destroy bodies, or call anything	*/
+/* that takes the world lock: the tick holds it while the	*/
+/* pool runs.												*/
+
+#ifndef _VPHYS_POOL_INCLUDE_
+#define _VPHYS_POOL_INCLUDE_
+
+/* ========== INCLUDES							==========	*/
+#include "vphysdefs.h"
+
+
+/* ========== THREAD POOL						==========	*/
+/* helper threads besides the tick's own, up to				*/
+/* PX_POOL_THREADS_MAX. 0, the default, runs all on the tick	*/
+VPHYSAPI void  vPXWorldSetThreadCount(vPPXWorld world, vUI32 threads);
+VPHYSAPI vUI32 vPXWorldGetThreadCount(vPPXWorld world);
+/* treat every body's updateFunc as thread-safe				*/
+VPHYSAPI void  vPXWorldSetThreadSafeUpdates(vPPXWorld world, vBOOL enable);
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI void  vPXSetThreadCount(vUI32 threads);
+VPHYSAPI vUI32 vPXGetThreadCount(void);
+VPHYSAPI void  vPXSetThreadSafeUpdates(vBOOL enable);
+
+
+/* ========== POOL STATE						==========	*/
+void PXPoolInit(vPPXWorld world);
+void PXPoolFree(vPPXWorld world);
+/* splits [0, count) into chunks of chunkSize and returns	*/
+/* once task has run on all of them							*/
+void PXPoolRun(vPPXWorld world, vUI32 count, vUI32 chunkSize,
+	PXPFPOOLTASK task, vPTR input);
+
+#endif
@@ -0,0 +1,971 @@
+/* ========== <vphysquery.c>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Spatial queries against the latest published tick.		*/
+
+
+/* ========== INCLUDES							==========	*/
+#include "vphysquery.h"
+#include "vphyscore.h"
+#include "vspacepart.h"
+#include <math.h>
+#include <float.h>
+
+
+/* ========== INTERNAL STRUCTS					==========	*/
+typedef struct PXRayWalk
+{
+	vVect  origin;
+	vVect  direction;	/* normalized					*/
+	vFloat maxDistance;
+	vFloat radius;
+	vUI8   layerMask;
+	vUI8   flags;
+} PXRayWalk, *PPXRayWalk;
+
+typedef struct PXQueryBatch
+{
+	vPUI32 keys;		/* Morton key of each query's cell		*/
+	vPUI32 order;		/* query indices, sorted by key			*/
+	vPUI32 scratch;		/* sort scratch, then free for the caller	*/
+	vUI32  count;
+} PXQueryBatch, *PPXQueryBatch;
+
+
+/* ========== HELPERS							==========	*/
+static vPTR PXQueryGrow(vPTR block, vUI32 elementSize, vPUI32 capacity,
+	vUI32 required)
+{
+	if (*capacity >= required) return block;
+
+	vUI32 newCapacity = max(QUERY_CAPACITY_MIN, *capacity);
+	while (newCapacity < required) newCapacity <<= 1;
+
+	vPTR newBlock = vAlloc((SIZE_T)elementSize * newCapacity);
+	if (block != NULL) vMemCopy(newBlock, block, (SIZE_T)elementSize * (*capacity));
+	vFree(block);
+	*capacity = newCapacity;
+	return newBlock;
+}
+
+static vBOOL PXQueryLayerMatch(vUI8 bodyLayer, vUI8 mask)
+{
+	return (bodyLayer & mask) != ZERO;
+}
+
+static void PXQueryCell(PPXQuerySnapshot snap, vFloat x, vFloat y,
+	vPI32 cxOut, vPI32 cyOut)
+{
+	/* snapshot keeps the partition size it was built with */
+	*cxOut = (vI32)floorf(x / snap->partitionSize);
+	*cyOut = (vI32)floorf(y / snap->partitionSize);
+}
+
+static vBOOL PXQueryBodyFrame(PPXQueryBody qBody, vPVect axisXOut,
+	vPVect axisYOut, vPFloat hxOut, vPFloat hyOut)
+{
+	/* get box frame from world mesh (see vPXBoundToMesh for order) */
+	vVect axisX = vPXVectorAddCopy(qBody->mesh[3],
+		vPXVectorMultiplyCopy(qBody->mesh[0], -1.0f));
+	vVect axisY = vPXVectorAddCopy(qBody->mesh[1],
+		vPXVectorMultiplyCopy(qBody->mesh[0], -1.0f));
+	vFloat hx = vPXVectorMagnitudePrecise(axisX) * 0.5f;
+	vFloat hy = vPXVectorMagnitudePrecise(axisY) * 0.5f;
+	if (hx < FLT_EPSILON || hy < FLT_EPSILON) return FALSE;
+	vPXVectorMultiply(&axisX, 0.5f / hx);
+	vPXVectorMultiply(&axisY, 0.5f / hy);
+
+	*axisXOut = axisX; *axisYOut = axisY;
+	*hxOut = hx; *hyOut = hy;
+	return TRUE;
+}
+
+
+/* ========== BATCH ORDER						==========	*/
+/* batches answer their queries in Morton order of the cell	*/
+/* each starts in. queries sharing a partition run back to	*/
+/* back and neighbouring partitions run close together, so	*/
+/* the cells and bodies a query reads are mostly still in	*/
+/* cache from the query before it							*/
+static void PXBatchBegin(PPXQueryBatch batch, vUI32 count)
+{
+	vPUI32 block = vAlloc(sizeof(vUI32) * max(1, count) * 3);
+	batch->keys    = block;
+	batch->order   = block + count;
+	batch->scratch = block + count * 2;
+	batch->count   = count;
+}
+
+static void PXBatchKey(PPXQuerySnapshot snap, PPXQueryBatch batch,
+	vUI32 query, vVect point)
+{
+	vI32 cx = 0, cy = 0;
+	if (snap != NULL) PXQueryCell(snap, point.x, point.y, &cx, &cy);
+	batch->keys[query] = PXCellMortonKey(cx, cy);
+}
+
+static void PXBatchSort(PPXQueryBatch batch)
+{
+	PXCellSortByKey(batch->keys, batch->count, batch->order, batch->scratch);
+}
+
+static void PXBatchEnd(PPXQueryBatch batch)
+{
+	vFree(batch->keys);
+}
+
+
+/* ========== SNAPSHOT PUBLISHING				==========	*/
+static void PXQueryEnsureCells(PPXQuerySnapshot snap, vUI32 required)
+{
+	if (snap->cellCapacity >= required) return;
+
+	/* start and useage arrays share one capacity */
+	vUI32 capacity = snap->cellCapacity;
+	snap->cellStart  = PXQueryGrow(snap->cellStart, sizeof(vUI32),
+		&capacity, required);
+	capacity = snap->cellCapacity;
+	snap->cellUseage = PXQueryGrow(snap->cellUseage, sizeof(vUI32),
+		&capacity, required);
+	snap->cellCapacity = capacity;
+}
+
+void PXQueryPublish(vPPXWorld world)
+{
+	if (world->queryPublishing == FALSE) return;
+
+	/* claim a snapshot nobody is reading, never wait for readers */
+	PPXQuerySnapshot snap = NULL;
+	for (int i = 0; i < QUERY_SNAPSHOT_COUNT; i++)
+	{
+		if (i == world->queryPublished) continue;
+		if (InterlockedCompareExchange(&world->querySnapshots[i].readers, -1, 0) != 0)
+			continue;
+		snap = world->querySnapshots + i;
+		break;
+	}
+	if (snap == NULL)
+	{
+		world->querySkippedPublishes++;
+		return;
+	}
+
+	snap->tick          = world->stats.tickCount;
+	snap->partitionSize = world->partitionSize;
+	snap->bodyCount     = 0;
+	snap->cellCount     = 0;
+	snap->entryCount    = 0;
+	snap->cellMinX = snap->cellMinY = INT32_MAX;
+	snap->cellMaxX = snap->cellMaxY = INT32_MIN;
+
+	if (snap->cellMap.capacity == 0) PXCellMapInit(&snap->cellMap, 0);
+	PXCellMapClear(&snap->cellMap);
+
+	/* copy every partition in use, and the bodies they hold */
+	PPXBodyStore store = &world->bodies;
+	for (vUI32 p = 0; p < world->partitionPoolCursor; p++)
+	{
+		vPPXPartition part = world->partitionPool[p];
+		if (part->inUse == FALSE) continue;
+
+		vUI32 cellIndex = snap->cellCount++;
+		PXQueryEnsureCells(snap, snap->cellCount);
+		PXCellMapInsert(&snap->cellMap, part->x, part->y, cellIndex);
+		snap->cellStart[cellIndex]  = snap->entryCount;
+		snap->cellUseage[cellIndex] = part->useage;
+
+		snap->cellMinX = min(snap->cellMinX, part->x);
+		snap->cellMinY = min(snap->cellMinY, part->y);
+		snap->cellMaxX = max(snap->cellMaxX, part->x);
+		snap->cellMaxY = max(snap->cellMaxY, part->y);
+
+		snap->entries = PXQueryGrow(snap->entries, sizeof(vUI32),
+			&snap->entryCapacity, snap->entryCount + part->useage);
+
+		for (int i = 0; i < part->useage; i++)
+		{
+			vUI32 body = part->list[i];
+
+			/* bodies destroyed since the partitions were filled */
+			if (store->physical[body] == NULL)
+			{
+				snap->cellUseage[cellIndex]--;
+				continue;
+			}
+
+			/* first time this body is seen this tick, copy it */
+			if (store->queryTick[body] != snap->tick + 1)
+			{
+				store->queryTick[body] = snap->tick + 1;
+				store->querySlot[body] = snap->bodyCount++;
+
+				snap->bodies = PXQueryGrow(snap->bodies, sizeof(PXQueryBody),
+					&snap->bodyCapacity, snap->bodyCount);
+
+				vPPXWorldBoundMesh worldBound = store->worldBound + body;
+				PPXQueryBody qBody = snap->bodies + store->querySlot[body];
+				qBody->body         = store->handle[body];
+				vMemCopy(qBody->mesh, worldBound->mesh, sizeof(qBody->mesh));
+				qBody->center       = worldBound->center;
+				qBody->boundingBox  = worldBound->boundingBox;
+				qBody->collideLayer = store->collideLayer[body];
+			}
+
+			snap->entries[snap->entryCount++] = store->querySlot[body];
+		}
+	}
+
+	/* hand snapshot over to readers */
+	InterlockedExchange(&snap->readers, 0);
+	InterlockedExchange(&world->queryPublished,
+		(LONG)(snap - world->querySnapshots));
+}
+
+void PXQueryFree(vPPXWorld world)
+{
+	for (vUI32 i = 0; i < QUERY_SNAPSHOT_COUNT; i++)
+	{
+		PPXQuerySnapshot snap = world->querySnapshots + i;
+		vFree(snap->bodies);
+		vFree(snap->cellStart);
+		vFree(snap->cellUseage);
+		vFree(snap->entries);
+		PXCellMapFree(&snap->cellMap);
+		vZeroMemory(snap, sizeof(PXQuerySnapshot));
+	}
+	world->queryPublished = -1;
+}
+
+PPXQuerySnapshot PXQueryAcquire(vPPXWorld world)
+{
+	for (;;)
+	{
+		LONG published = world->queryPublished;
+		if (published < 0) return NULL;
+
+		/* snapshot may be reclaimed by the writer between reads, */
+		/* in which case the published index has moved on		  */
+		PPXQuerySnapshot snap = world->querySnapshots + published;
+		LONG readers = snap->readers;
+		if (readers < 0) continue;
+		if (InterlockedCompareExchange(&snap->readers, readers + 1, readers)
+			== readers) return snap;
+	}
+}
+
+void PXQueryRelease(PPXQuerySnapshot snapshot)
+{
+	if (snapshot != NULL) InterlockedDecrement(&snapshot->readers);
+}
+
+
+/* ========== RAY INTERSECTION					==========	*/
+static vBOOL PXRaySlab(vFloat e, vFloat f, vFloat h, vVect axis,
+	vPFloat tMin, vPFloat tMax, vPVect normal)
+{
+	/* ray parallel to slab, hit only if already inside */
+	if (vPXFastFabs(f) < FLT_EPSILON) return (e >= -h && e <= h);
+
+	vFloat t1 = (-h - e) / f;
+	vFloat t2 = ( h - e) / f;
+	vVect  n  = vPXVectorMultiplyCopy(axis, -1.0f);
+	if (t1 > t2)
+	{
+		vFloat swap = t1; t1 = t2; t2 = swap;
+		n = axis;
+	}
+
+	if (t1 > *tMin)
+	{
+		*tMin = t1;
+		*normal = n;
+	}
+	*tMax = min(*tMax, t2);
+	return *tMin <= *tMax;
+}
+
+static vBOOL PXRayBox(vVect rel, vVect dir, vVect ux, vVect uy, vFloat hx,
+	vFloat hy, vFloat maxT, vPFloat tOut, vPVect normalOut)
+{
+	/* slab test in the box's local frame */
+	vFloat tMin = 0.0f, tMax = maxT;
+	vVect  normal = vPXVectorMultiplyCopy(dir, -1.0f);
+
+	if (PXRaySlab(vPXVectorDotProduct(ux, rel), vPXVectorDotProduct(ux, dir),
+		hx, ux, &tMin, &tMax, &normal) == FALSE) return FALSE;
+	if (PXRaySlab(vPXVectorDotProduct(uy, rel), vPXVectorDotProduct(uy, dir),
+		hy, uy, &tMin, &tMax, &normal) == FALSE) return FALSE;
+
+	*tOut = tMin;
+	*normalOut = normal;
+	return TRUE;
+}
+
+static vBOOL PXRayCircle(vVect rel, vVect dir, vFloat radius, vFloat maxT,
+	vPFloat tOut, vPVect normalOut)
+{
+	/* rel is ray origin relative to circle center */
+	vFloat b = vPXVectorDotProduct(rel, dir);
+	vFloat c = vPXVectorDotProduct(rel, rel) - radius * radius;
+	if (c > 0.0f && b > 0.0f) return FALSE;
+
+	vFloat disc = b * b - c;
+	if (disc < 0.0f) return FALSE;
+
+	vFloat t = max(0.0f, -b - sqrtf(disc));
+	if (t > maxT) return FALSE;
+
+	vVect point = vPXVectorAddCopy(rel, vPXVectorMultiplyCopy(dir, t));
+	if (vPXVectorDotProduct(point, point) > FLT_EPSILON) vPXVectorNormalize(&point);
+	else point = vPXVectorMultiplyCopy(dir, -1.0f);
+
+	*tOut = t;
+	*normalOut = point;
+	return TRUE;
+}
+
+static vBOOL PXRayIntersectBody(PPXQueryBody qBody, PPXRayWalk walk,
+	vFloat maxT, vPFloat tOut, vPVect normalOut)
+{
+	vVect axisX, axisY;
+	vFloat hx, hy;
+	if (PXQueryBodyFrame(qBody, &axisX, &axisY, &hx, &hy) == FALSE) return FALSE;
+
+	vVect rel = vPXVectorAddCopy(walk->origin,
+		vPXVectorMultiplyCopy(qBody->center, -1.0f));
+
+	/* point rays test the box itself */
+	if (walk->radius <= 0.0f)
+		return PXRayBox(rel, walk->direction, axisX, axisY, hx, hy, maxT,
+			tOut, normalOut);
+
+	/* swept circles test the box rounded by the radius, which is two */
+	/* boxes extended along each axis plus a circle at each corner	 */
+	vBOOL  hit = FALSE;
+	vFloat t;
+	vVect  n;
+	vFloat r = walk->radius;
+	if (PXRayBox(rel, walk->direction, axisX, axisY, hx + r, hy, maxT, &t, &n))
+	{
+		hit = TRUE; maxT = t; *tOut = t; *normalOut = n;
+	}
+	if (PXRayBox(rel, walk->direction, axisX, axisY, hx, hy + r, maxT, &t, &n))
+	{
+		hit = TRUE; maxT = t; *tOut = t; *normalOut = n;
+	}
+	for (int i = 0; i < 4; i++)
+	{
+		vVect cornerRel = vPXVectorAddCopy(walk->origin,
+			vPXVectorMultiplyCopy(qBody->mesh[i], -1.0f));
+		if (PXRayCircle(cornerRel, walk->direction, r, maxT, &t, &n))
+		{
+			hit = TRUE; maxT = t; *tOut = t; *normalOut = n;
+		}
+	}
+	return hit;
+}
+
+
+/* ========== GRID WALK							==========	*/
+static vBOOL PXRayTestCell(PPXQuerySnapshot snap, vI32 cx, vI32 cy,
+	PPXRayWalk walk, vPPXRayHit best)
+{
+	vUI32 cellIndex = PXCellMapFind(&snap->cellMap, cx, cy);
+	if (cellIndex == CELLMAP_EMPTY) return FALSE;
+
+	vBOOL found = FALSE;
+	vPUI32 entry = snap->entries + snap->cellStart[cellIndex];
+	for (vUI32 i = 0; i < snap->cellUseage[cellIndex]; i++)
+	{
+		PPXQueryBody qBody = snap->bodies + entry[i];
+		if (PXQueryLayerMatch(qBody->collideLayer, walk->layerMask) == FALSE)
+			continue;
+
+		vFloat t; vVect n;
+		vFloat maxT = best->hit ? best->distance : walk->maxDistance;
+		if (PXRayIntersectBody(qBody, walk, maxT, &t, &n) == FALSE) continue;
+		if (best->hit && t >= best->distance) continue;
+
+		best->hit      = TRUE;
+		best->body     = qBody->body;
+		best->distance = t;
+		best->normal   = n;
+		found = TRUE;
+
+		if (walk->flags & PX_RAY_ANY_HIT) return TRUE;
+	}
+	return found;
+}
+
+static void PXRaycastSnapshot(PPXQuerySnapshot snap, vPPXRay ray,
+	vPPXRayHit hitOut)
+{
+	vZeroMemory(hitOut, sizeof(vPXRayHit));
+	if (snap == NULL || snap->cellCount == 0) return;
+
+	/* setup normalized walk */
+	PXRayWalk walk;
+	walk.origin      = ray->origin;
+	walk.direction   = ray->direction;
+	walk.maxDistance = (ray->maxDistance > 0.0f) ? ray->maxDistance : FLT_MAX;
+	walk.radius      = ray->radius;
+	walk.layerMask   = ray->layerMask;
+	walk.flags       = ray->flags;
+
+	vFloat dirMag = vPXVectorMagnitudePrecise(walk.direction);
+	if (dirMag < FLT_EPSILON) return;
+	vPXVectorMultiply(&walk.direction, 1.0f / dirMag);
+
+	/* clip ray against the occupied grid (padded by cast radius) */
+	vFloat size = snap->partitionSize;
+	vFloat pad  = max(0.0f, walk.radius);
+	vFloat gridMin[2] = { snap->cellMinX * size - pad, snap->cellMinY * size - pad };
+	vFloat gridMax[2] = { (snap->cellMaxX + 1) * size + pad,
+		(snap->cellMaxY + 1) * size + pad };
+	vFloat o[2] = { walk.origin.x, walk.origin.y };
+	vFloat d[2] = { walk.direction.x, walk.direction.y };
+
+	vFloat tEnter = 0.0f, tLeave = walk.maxDistance;
+	for (int a = 0; a < 2; a++)
+	{
+		if (vPXFastFabs(d[a]) < FLT_EPSILON)
+		{
+			if (o[a] < gridMin[a] || o[a] > gridMax[a]) return;
+			continue;
+		}
+		vFloat t1 = (gridMin[a] - o[a]) / d[a];
+		vFloat t2 = (gridMax[a] - o[a]) / d[a];
+		tEnter = max(tEnter, min(t1, t2));
+		tLeave = min(tLeave, max(t1, t2));
+	}
+	if (tEnter > tLeave) return;
+
+	/* setup DDA from grid entry point */
+	vI32 cx, cy;
+	PXQueryCell(snap, o[0] + d[0] * tEnter, o[1] + d[1] * tEnter, &cx, &cy);
+	vI32 stepX = (d[0] > 0.0f) ? 1 : -1;
+	vI32 stepY = (d[1] > 0.0f) ? 1 : -1;
+	vFloat tDeltaX = (vPXFastFabs(d[0]) < FLT_EPSILON) ? FLT_MAX : size / vPXFastFabs(d[0]);
+	vFloat tDeltaY = (vPXFastFabs(d[1]) < FLT_EPSILON) ? FLT_MAX : size / vPXFastFabs(d[1]);
+	vFloat tMaxX = (vPXFastFabs(d[0]) < FLT_EPSILON) ? FLT_MAX :
+		(((cx + (stepX > 0)) * size) - o[0]) / d[0];
+	vFloat tMaxY = (vPXFastFabs(d[1]) < FLT_EPSILON) ? FLT_MAX :
+		(((cy + (stepY > 0)) * size) - o[1]) / d[1];
+
+	/* cells within cast radius of the walked cell must be tested too */
+	vI32 reach = (vI32)ceilf(pad / size);
+
+	for (;;)
+	{
+		for (vI32 nx = cx - reach; nx <= cx + reach; nx++)
+		{
+			for (vI32 ny = cy - reach; ny <= cy + reach; ny++)
+			{
+				if (PXRayTestCell(snap, nx, ny, &walk, hitOut) &&
+					(walk.flags & PX_RAY_ANY_HIT)) goto walkDone;
+			}
+		}
+
+		/* any hit before leaving this cell cannot be beaten */
+		vFloat tCellExit = min(tMaxX, tMaxY);
+		if (hitOut->hit && hitOut->distance <= tCellExit) break;
+		if (tCellExit > tLeave) break;
+
+		if (tMaxX < tMaxY)
+		{
+			cx += stepX;
+			tMaxX += tDeltaX;
+		}
+		else
+		{
+			cy += stepY;
+			tMaxY += tDeltaY;
+		}
+	}
+
+walkDone:
+	if (hitOut->hit)
+	{
+		hitOut->point = vPXVectorAddCopy(walk.origin,
+			vPXVectorMultiplyCopy(walk.direction, hitOut->distance));
+	}
+}
+
+
+/* ========== REGION OVERLAP					==========	*/
+typedef struct PXRegion
+{
+	vVect  corners[4];		/* same winding as body meshes	*/
+	vGRect boundingBox;
+	vUI8   layerMask;
+} PXRegion, *PPXRegion;
+
+static void PXRegionFromQuery(vPPXRegionQuery query, PPXRegion regionOut)
+{
+	vVect hx = vPXCreateVect(query->halfExtents.x, 0.0f);
+	vVect hy = vPXCreateVect(0.0f, query->halfExtents.y);
+	if (query->rotation != 0.0f)
+	{
+		vPXVectorRotatePrecise(&hx, query->rotation);
+		vPXVectorRotatePrecise(&hy, query->rotation);
+	}
+
+	vVect c = query->center;
+	regionOut->corners[0] = vPXCreateVect(c.x - hx.x - hy.x, c.y - hx.y - hy.y);
+	regionOut->corners[1] = vPXCreateVect(c.x - hx.x + hy.x, c.y - hx.y + hy.y);
+	regionOut->corners[2] = vPXCreateVect(c.x + hx.x + hy.x, c.y + hx.y + hy.y);
+	regionOut->corners[3] = vPXCreateVect(c.x + hx.x - hy.x, c.y + hx.y - hy.y);
+
+	vGRect box = { c.x, c.x, c.y, c.y };
+	for (int i = 0; i < 4; i++)
+	{
+		box.left   = min(box.left,   regionOut->corners[i].x);
+		box.right  = max(box.right,  regionOut->corners[i].x);
+		box.bottom = min(box.bottom, regionOut->corners[i].y);
+		box.top    = max(box.top,    regionOut->corners[i].y);
+	}
+	regionOut->boundingBox = box;
+	regionOut->layerMask   = query->layerMask;
+}
+
+static vBOOL PXQuadsSeparated(vPVect a, vPVect b, vVect edge)
+{
+	/* project both quads onto the edge normal */
+	vVect axis = vPXCreateVect(-edge.y, edge.x);
+	vFloat aMin = FLT_MAX, aMax = -FLT_MAX;
+	vFloat bMin = FLT_MAX, bMax = -FLT_MAX;
+	for (int i = 0; i < 4; i++)
+	{
+		vFloat aDot = vPXVectorDotProduct(a[i], axis);
+		vFloat bDot = vPXVectorDotProduct(b[i], axis);
+		aMin = min(aMin, aDot); aMax = max(aMax, aDot);
+		bMin = min(bMin, bDot); bMax = max(bMax, bDot);
+	}
+	return (aMax < bMin || bMax < aMin);
+}
+
+static vBOOL PXQuadsOverlap(vPVect a, vPVect b)
+{
+	/* two edge directions per rectangle are enough for SAT */
+	for (int i = 0; i < 2; i++)
+	{
+		vVect aEdge = vPXVectorAddCopy(a[i + 1], vPXVectorMultiplyCopy(a[i], -1.0f));
+		vVect bEdge = vPXVectorAddCopy(b[i + 1], vPXVectorMultiplyCopy(b[i], -1.0f));
+		if (PXQuadsSeparated(a, b, aEdge)) return FALSE;
+		if (PXQuadsSeparated(a, b, bEdge)) return FALSE;
+	}
+	return TRUE;
+}
+
+static vBOOL PXRectsOverlap(vGRect a, vGRect b)
+{
+	return !(a.right < b.left || b.right < a.left ||
+		a.top < b.bottom || b.top < a.bottom);
+}
+
+static vUI32 PXRegionQuerySnapshot(PPXQuerySnapshot snap, PPXRegion region,
+	vPXHandle* resultsOut, vUI32 resultCapacity)
+{
+	if (snap == NULL || snap->cellCount == 0) return 0;
+
+	/* walk only cells that exist in the snapshot */
+	vI32 xMin, yMin, xMax, yMax;
+	PXQueryCell(snap, region->boundingBox.left, region->boundingBox.bottom,
+		&xMin, &yMin);
+	PXQueryCell(snap, region->boundingBox.right, region->boundingBox.top,
+		&xMax, &yMax);
+	xMin = max(xMin, snap->cellMinX); xMax = min(xMax, snap->cellMaxX);
+	yMin = max(yMin, snap->cellMinY); yMax = min(yMax, snap->cellMaxY);
+
+	vUI32 found = 0;
+	for (vI32 cx = xMin; cx <= xMax; cx++)
+	{
+		for (vI32 cy = yMin; cy <= yMax; cy++)
+		{
+			vUI32 cellIndex = PXCellMapFind(&snap->cellMap, cx, cy);
+			if (cellIndex == CELLMAP_EMPTY) continue;
+
+			vPUI32 entry = snap->entries + snap->cellStart[cellIndex];
+			for (vUI32 i = 0; i < snap->cellUseage[cellIndex]; i++)
+			{
+				PPXQueryBody qBody = snap->bodies + entry[i];
+				if (PXQueryLayerMatch(qBody->collideLayer, region->layerMask) == FALSE)
+					continue;
+				if (PXRectsOverlap(qBody->boundingBox, region->boundingBox) == FALSE)
+					continue;
+
+				/* a body spanning several cells is only reported from the */
+				/* cell holding the min corner of both boxes' intersection */
+				vI32 ownerX, ownerY;
+				PXQueryCell(snap,
+					max(qBody->boundingBox.left, region->boundingBox.left),
+					max(qBody->boundingBox.bottom, region->boundingBox.bottom),
+					&ownerX, &ownerY);
+				if (ownerX != cx || ownerY != cy) continue;
+
+				if (PXQuadsOverlap(qBody->mesh, region->corners) == FALSE)
+					continue;
+
+				resultsOut[found++] = qBody->body;
+				if (found == resultCapacity) return found;
+			}
+		}
+	}
+
+	return found;
+}
+
+
+/* ========== NEAREST NEIGHBORS					==========	*/
+static vFloat PXQueryBodyDistance(PPXQueryBody qBody, vVect point)
+{
+	vVect axisX, axisY;
+	vFloat hx, hy;
+	vVect rel = vPXVectorAddCopy(point, vPXVectorMultiplyCopy(qBody->center, -1.0f));
+	if (PXQueryBodyFrame(qBody, &axisX, &axisY, &hx, &hy) == FALSE)
+		return vPXVectorMagnitudePrecise(rel);
+
+	/* distance outside the box along each local axis */
+	vFloat dx = max(0.0f, vPXFastFabs(vPXVectorDotProduct(rel, axisX)) - hx);
+	vFloat dy = max(0.0f, vPXFastFabs(vPXVectorDotProduct(rel, axisY)) - hy);
+	return sqrtf(dx * dx + dy * dy);
+}
+
+static void PXNearestConsider(PPXQueryBody qBody, vFloat distance,
+	vPPXNearestHit results, vPUI32 found, vUI32 k)
+{
+	/* bodies spanning several cells are seen more than once */
+	for (vUI32 i = 0; i < *found; i++)
+		if (results[i].body == qBody->body) return;
+
+	if (*found == k && distance >= results[k - 1].distance) return;
+
+	/* insertion into results sorted by distance */
+	vUI32 slot = (*found < k) ? (*found)++ : k - 1;
+	while (slot > 0 && results[slot - 1].distance > distance)
+	{
+		results[slot] = results[slot - 1];
+		slot--;
+	}
+	results[slot].body     = qBody->body;
+	results[slot].distance = distance;
+}
+
+static void PXNearestTestCell(PPXQuerySnapshot snap, vI32 cx, vI32 cy,
+	vPPXNearestQuery query, vFloat maxDistance, vPPXNearestHit results,
+	vPUI32 found)
+{
+	vUI32 cellIndex = PXCellMapFind(&snap->cellMap, cx, cy);
+	if (cellIndex == CELLMAP_EMPTY) return;
+
+	vPUI32 entry = snap->entries + snap->cellStart[cellIndex];
+	for (vUI32 i = 0; i < snap->cellUseage[cellIndex]; i++)
+	{
+		PPXQueryBody qBody = snap->bodies + entry[i];
+		if (PXQueryLayerMatch(qBody->collideLayer, query->layerMask) == FALSE)
+			continue;
+
+		vFloat distance = PXQueryBodyDistance(qBody, query->point);
+		if (distance > maxDistance) continue;
+		PXNearestConsider(qBody, distance, results, found, query->k);
+	}
+}
+
+static vUI32 PXNearestQuerySnapshot(PPXQuerySnapshot snap,
+	vPPXNearestQuery query, vPPXNearestHit resultsOut)
+{
+	if (snap == NULL || snap->cellCount == 0 || query->k == 0) return 0;
+
+	vFloat size = snap->partitionSize;
+	vFloat maxDistance = (query->maxDistance > 0.0f) ? query->maxDistance : FLT_MAX;
+	vVect  p = query->point;
+
+	vI32 cx, cy;
+	PXQueryCell(snap, p.x, p.y, &cx, &cy);
+
+	/* distance from point to the walls of its own cell */
+	vFloat wallDist = min(min(p.x - cx * size, (cx + 1) * size - p.x),
+		min(p.y - cy * size, (cy + 1) * size - p.y));
+
+	/* rings closer than the occupied grid are empty, skip them */
+	vI32 ringStart = max(max(snap->cellMinX - cx, cx - snap->cellMaxX),
+		max(snap->cellMinY - cy, cy - snap->cellMaxY));
+	ringStart = max(0, ringStart);
+
+	/* expand square rings of cells outward, nearest ring first */
+	vUI32 found = 0;
+	for (vI32 ring = ringStart; ; ring++)
+	{
+		/* nothing in this ring or beyond can be closer than this */
+		vFloat ringDist = (ring == 0) ? 0.0f : wallDist + (ring - 1) * size;
+		if (ringDist > maxDistance) break;
+		if (found == query->k && resultsOut[found - 1].distance <= ringDist) break;
+
+		/* ring lies fully outside the occupied grid */
+		if (cx - ring < snap->cellMinX && cx + ring > snap->cellMaxX &&
+			cy - ring < snap->cellMinY && cy + ring > snap->cellMaxY) break;
+
+		if (ring == 0)
+		{
+			PXNearestTestCell(snap, cx, cy, query, maxDistance, resultsOut, &found);
+			continue;
+		}
+
+		for (vI32 dx = -ring; dx <= ring; dx++)
+		{
+			PXNearestTestCell(snap, cx + dx, cy - ring, query, maxDistance,
+				resultsOut, &found);
+			PXNearestTestCell(snap, cx + dx, cy + ring, query, maxDistance,
+				resultsOut, &found);
+		}
+		for (vI32 dy = -ring + 1; dy <= ring - 1; dy++)
+		{
+			PXNearestTestCell(snap, cx - ring, cy + dy, query, maxDistance,
+				resultsOut, &found);
+			PXNearestTestCell(snap, cx + ring, cy + dy, query, maxDistance,
+				resultsOut, &found);
+		}
+	}
+
+	return found;
+}
+
+
+/* ========== QUERY CONTROL						==========	*/
+VPHYSAPI void vPXWorldQueryEnable(vPPXWorld world, vBOOL enable)
+{
+	vPXWorldLock(world);
+	world->queryPublishing = enable;
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI vUI64 vPXWorldQueryGetPublishedTick(vPPXWorld world)
+{
+	PPXQuerySnapshot snap = PXQueryAcquire(world);
+	vUI64 tick = (snap == NULL) ? 0 : snap->tick;
+	PXQueryRelease(snap);
+	return tick;
+}
+
+
+/* ========== RAYCASTS							==========	*/
+VPHYSAPI vBOOL vPXWorldRaycast(vPPXWorld world, vPPXRay ray, vPPXRayHit hitOut)
+{
+	PPXQuerySnapshot snap = PXQueryAcquire(world);
+	PXRaycastSnapshot(snap, ray, hitOut);
+	PXQueryRelease(snap);
+	return hitOut->hit;
+}
+
+VPHYSAPI vUI32 vPXWorldRaycastBatch(vPPXWorld world, vPPXRay rays,
+	vPPXRayHit hitsOut, vUI32 count)
+{
+	/* whole batch reads the same snapshot */
+	PPXQuerySnapshot snap = PXQueryAcquire(world);
+
+	PXQueryBatch batch;
+	PXBatchBegin(&batch, count);
+	for (vUI32 i = 0; i < count; i++)
+		PXBatchKey(snap, &batch, i, rays[i].origin);
+	PXBatchSort(&batch);
+
+	vUI32 hitCount = 0;
+	for (vUI32 i = 0; i < count; i++)
+	{
+		vUI32 ray = batch.order[i];
+		PXRaycastSnapshot(snap, rays + ray, hitsOut + ray);
+		if (hitsOut[ray].hit) hitCount++;
+	}
+
+	PXBatchEnd(&batch);
+	PXQueryRelease(snap);
+	return hitCount;
+}
+
+
+/* ========== REGION QUERIES					==========	*/
+VPHYSAPI vUI32 vPXWorldQueryAABB(vPPXWorld world, vGRect rect, vUI8 layerMask,
+	vPXHandle* resultsOut, vUI32 resultCapacity)
+{
+	vPXRegionQuery query;
+	query.center      = vPXCreateVect((rect.left + rect.right) * 0.5f,
+		(rect.bottom + rect.top) * 0.5f);
+	query.halfExtents = vPXCreateVect((rect.right - rect.left) * 0.5f,
+		(rect.top - rect.bottom) * 0.5f);
+	query.rotation    = 0.0f;
+	query.layerMask   = layerMask;
+	return vPXWorldQueryRegion(world, &query, resultsOut, resultCapacity);
+}
+
+VPHYSAPI vUI32 vPXWorldQueryRegion(vPPXWorld world, vPPXRegionQuery query,
+	vPXHandle* resultsOut, vUI32 resultCapacity)
+{
+	if (resultCapacity == 0) return 0;
+
+	PXRegion region;
+	PXRegionFromQuery(query, &region);
+
+	PPXQuerySnapshot snap = PXQueryAcquire(world);
+	vUI32 found = PXRegionQuerySnapshot(snap, &region, resultsOut, resultCapacity);
+	PXQueryRelease(snap);
+	return found;
+}
+
+VPHYSAPI vUI32 vPXWorldQueryRegionBatch(vPPXWorld world,
+	vPPXRegionQuery queries, vUI32 count, vPXHandle* resultsOut,
+	vUI32 resultCapacity, vPUI32 countsOut)
+{
+	for (vUI32 i = 0; i < count; i++) countsOut[i] = 0;
+	if (resultCapacity == 0) return 0;
+
+	PPXQuerySnapshot snap = PXQueryAcquire(world);
+	if (snap == NULL) return 0;
+
+	PXQueryBatch batch;
+	PXBatchBegin(&batch, count);
+	for (vUI32 i = 0; i < count; i++)
+		PXBatchKey(snap, &batch, i, queries[i].center);
+	PXBatchSort(&batch);
+
+	/* answers collect out of query order, so they go to scratch	*/
+	/* first. one query never finds more than the snapshot holds	*/
+	vPUI32 first = batch.scratch;
+	vUI32 perQuery = min(resultCapacity, max(1, snap->bodyCount));
+	vPXHandle* found = NULL;
+	vUI32 foundCount = 0, foundCapacity = 0;
+	for (vUI32 i = 0; i < count; i++)
+	{
+		vUI32 query = batch.order[i];
+		found = PXQueryGrow(found, sizeof(vPXHandle), &foundCapacity,
+			foundCount + perQuery);
+
+		PXRegion region;
+		PXRegionFromQuery(queries + query, &region);
+		first[query] = foundCount;
+		countsOut[query] = PXRegionQuerySnapshot(snap, &region,
+			found + foundCount, perQuery);
+		foundCount += countsOut[query];
+	}
+	PXQueryRelease(snap);
+
+	/* pack back to back in query order, the first queries get	*/
+	/* the capacity when there is not enough for every answer	*/
+	vUI32 total = 0;
+	for (vUI32 query = 0; query < count; query++)
+	{
+		countsOut[query] = min(countsOut[query], resultCapacity - total);
+		vMemCopy(resultsOut + total, found + first[query],
+			sizeof(vPXHandle) * countsOut[query]);
+		total += countsOut[query];
+	}
+
+	vFree(found);
+	PXBatchEnd(&batch);
+	return total;
+}
+
+
+/* ========== NEAREST QUERIES					==========	*/
+VPHYSAPI vUI32 vPXWorldQueryNearest(vPPXWorld world, vVect point, vUI32 k,
+	vUI8 layerMask, vPPXNearestHit resultsOut)
+{
+	vPXNearestQuery query;
+	query.point       = point;
+	query.maxDistance = 0.0f;
+	query.k           = k;
+	query.layerMask   = layerMask;
+
+	PPXQuerySnapshot snap = PXQueryAcquire(world);
+	vUI32 found = PXNearestQuerySnapshot(snap, &query, resultsOut);
+	PXQueryRelease(snap);
+	return found;
+}
+
+VPHYSAPI vUI32 vPXWorldQueryNearestBatch(vPPXWorld world,
+	vPPXNearestQuery queries, vUI32 count, vPPXNearestHit resultsOut,
+	vPUI32 countsOut)
+{
+	PPXQuerySnapshot snap = PXQueryAcquire(world);
+
+	PXQueryBatch batch;
+	PXBatchBegin(&batch, count);
+	for (vUI32 i = 0; i < count; i++)
+		PXBatchKey(snap, &batch, i, queries[i].point);
+	PXBatchSort(&batch);
+
+	/* each query's slots follow those of the queries before it */
+	vPUI32 first = batch.scratch;
+	vUI32 slots = 0;
+	for (vUI32 query = 0; query < count; query++)
+	{
+		first[query] = slots;
+		slots += queries[query].k;
+	}
+
+	vUI32 total = 0;
+	for (vUI32 i = 0; i < count; i++)
+	{
+		vUI32 query = batch.order[i];
+		countsOut[query] = PXNearestQuerySnapshot(snap, queries + query,
+			resultsOut + first[query]);
+		total += countsOut[query];
+	}
+
+	PXBatchEnd(&batch);
+	PXQueryRelease(snap);
+	return total;
+}
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI void vPXQueryEnable(vBOOL enable)
+{
+	vPXWorldQueryEnable(&_vphys, enable);
+}
+
+VPHYSAPI vUI64 vPXQueryGetPublishedTick(void)
+{
+	return vPXWorldQueryGetPublishedTick(&_vphys);
+}
+
+VPHYSAPI vBOOL vPXRaycast(vPPXRay ray, vPPXRayHit hitOut)
+{
+	return vPXWorldRaycast(&_vphys, ray, hitOut);
+}
+
+VPHYSAPI vUI32 vPXRaycastBatch(vPPXRay rays, vPPXRayHit hitsOut, vUI32 count)
+{
+	return vPXWorldRaycastBatch(&_vphys, rays, hitsOut, count);
+}
+
+VPHYSAPI vUI32 vPXQueryAABB(vGRect rect, vUI8 layerMask, vPXHandle* resultsOut,
+	vUI32 resultCapacity)
+{
+	return vPXWorldQueryAABB(&_vphys, rect, layerMask, resultsOut,
+		resultCapacity);
+}
+
+VPHYSAPI vUI32 vPXQueryRegion(vPPXRegionQuery query, vPXHandle* resultsOut,
+	vUI32 resultCapacity)
+{
+	return vPXWorldQueryRegion(&_vphys, query, resultsOut, resultCapacity);
+}
+
+VPHYSAPI vUI32 vPXQueryRegionBatch(vPPXRegionQuery queries, vUI32 count,
+	vPXHandle* resultsOut, vUI32 resultCapacity, vPUI32 countsOut)
+{
+	return vPXWorldQueryRegionBatch(&_vphys, queries, count, resultsOut,
+		resultCapacity, countsOut);
+}
+
+VPHYSAPI vUI32 vPXQueryNearest(vVect point, vUI32 k, vUI8 layerMask,
+	vPPXNearestHit resultsOut)
+{
+	return vPXWorldQueryNearest(&_vphys, point, k, layerMask, resultsOut);
+}
+
+VPHYSAPI vUI32 vPXQueryNearestBatch(vPPXNearestQuery queries, vUI32 count,
+	vPPXNearestHit resultsOut, vPUI32 countsOut)
+{
+	return vPXWorldQueryNearestBatch(&_vphys, queries, count, resultsOut,
+		countsOut);
+}
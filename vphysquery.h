@@ -0,0 +1,79 @@
+/* ========== <vphysquery.h>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Spatial queries against the latest published tick.		*/
+/* Queries never take the physics lock; they read a			*/
+/* snapshot the physics thread publishes after each tick	*/
+/* (once query publishing is enabled for that world) and	*/
+/* may run concurrently with simulation from any number	*/
+/* of threads.												*/
+/*															*/
+/* Batch forms read one snapshot for the whole batch and	*/
+/* answer their queries sorted by the partition each starts	*/
+/* in, so queries in the same area run together while that	*/
+/* part of the snapshot is in cache. They allocate a little	*/
+/* scratch for the order; single queries allocate nothing.	*/
+
+#ifndef _VPHYS_QUERY_INCLUDE_
+#define _VPHYS_QUERY_INCLUDE_
+
+/* ========== INCLUDES							==========	*/
+#include "vphysdefs.h"
+
+
+/* ========== QUERY CONTROL						==========	*/
+VPHYSAPI void  vPXWorldQueryEnable(vPPXWorld world, vBOOL enable);
+VPHYSAPI vUI64 vPXWorldQueryGetPublishedTick(vPPXWorld world);
+
+
+/* ========== RAYCASTS							==========	*/
+VPHYSAPI vBOOL vPXWorldRaycast(vPPXWorld world, vPPXRay ray, vPPXRayHit hitOut);
+VPHYSAPI vUI32 vPXWorldRaycastBatch(vPPXWorld world, vPPXRay rays,
+	vPPXRayHit hitsOut, vUI32 count);
+
+
+/* ========== REGION QUERIES					==========	*/
+VPHYSAPI vUI32 vPXWorldQueryAABB(vPPXWorld world, vGRect rect, vUI8 layerMask,
+	vPXHandle* resultsOut, vUI32 resultCapacity);
+VPHYSAPI vUI32 vPXWorldQueryRegion(vPPXWorld world, vPPXRegionQuery query,
+	vPXHandle* resultsOut, vUI32 resultCapacity);
+/* results are packed back to back in query order,			*/
+/* countsOut gives each query's share. when resultCapacity	*/
+/* cannot hold every answer, later queries get what is left	*/
+VPHYSAPI vUI32 vPXWorldQueryRegionBatch(vPPXWorld world,
+	vPPXRegionQuery queries, vUI32 count, vPXHandle* resultsOut,
+	vUI32 resultCapacity, vPUI32 countsOut);
+
+
+/* ========== NEAREST QUERIES					==========	*/
+VPHYSAPI vUI32 vPXWorldQueryNearest(vPPXWorld world, vVect point, vUI32 k,
+	vUI8 layerMask, vPPXNearestHit resultsOut);
+/* each query owns k consecutive result slots				*/
+VPHYSAPI vUI32 vPXWorldQueryNearestBatch(vPPXWorld world,
+	vPPXNearestQuery queries, vUI32 count, vPPXNearestHit resultsOut,
+	vPUI32 countsOut);
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI void  vPXQueryEnable(vBOOL enable);
+VPHYSAPI vUI64 vPXQueryGetPublishedTick(void);
+VPHYSAPI vBOOL vPXRaycast(vPPXRay ray, vPPXRayHit hitOut);
+VPHYSAPI vUI32 vPXRaycastBatch(vPPXRay rays, vPPXRayHit hitsOut, vUI32 count);
+VPHYSAPI vUI32 vPXQueryAABB(vGRect rect, vUI8 layerMask, vPXHandle* resultsOut,
+	vUI32 resultCapacity);
+VPHYSAPI vUI32 vPXQueryRegion(vPPXRegionQuery query, vPXHandle* resultsOut,
+	vUI32 resultCapacity);
+VPHYSAPI vUI32 vPXQueryRegionBatch(vPPXRegionQuery queries, vUI32 count,
+	vPXHandle* resultsOut, vUI32 resultCapacity, vPUI32 countsOut);
+VPHYSAPI vUI32 vPXQueryNearest(vVect point, vUI32 k, vUI8 layerMask,
+	vPPXNearestHit resultsOut);
+VPHYSAPI vUI32 vPXQueryNearestBatch(vPPXNearestQuery queries, vUI32 count,
+	vPPXNearestHit resultsOut, vPUI32 countsOut);
+
+
+/* ========== SNAPSHOT PUBLISHING				==========	*/
+void PXQueryPublish(vPPXWorld world);
+void PXQueryFree(vPPXWorld world);
+PPXQuerySnapshot PXQueryAcquire(vPPXWorld world);
+void PXQueryRelease(PPXQuerySnapshot snapshot);
+
+#endif
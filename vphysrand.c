@@ -1,63 +1,253 @@
-
 /* ========== <vphysrand.h>						==========	*/
 /* Bailey Jia-Tao Brown							2022		*/
 /* Random number generator									*/
+/* Streams run RAND_LANES interleaved xoshiro128+ lanes.	*/
+/* Single draws take turns between lanes; bulk fills step	*/
+/* every lane at once, four at a time with SSE2, and		*/
+/* produce exactly what the same single draws would.		*/
 
 /* ========== INCLUDES							==========	*/
 #include "vphysrand.h"
 #include <math.h>
 #include <stdio.h>
+#ifdef PX_SSE2
+#include <emmintrin.h>
+#endif
+
+
+/* ========== INTERNAL DATA						==========	*/
+/* xoshiro128 jump polynomials, 2^64 and 2^96 steps			*/
+static const vUI32 __randJump[4] =
+	{ 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+static const vUI32 __randLongJump[4] =
+	{ 0xb523952e, 0x0b6f099f, 0xccf5a0ef, 0x1c580662 };
+
+static PX_THREAD_LOCAL vPXRandStream __threadStream;
+static PX_THREAD_LOCAL vBOOL __threadStreamSeeded;
+static volatile LONG __threadStreamCount = 0;
+
+
+/* ========== HELPERS							==========	*/
+static vUI32 PXRandRotl(vUI32 x, vUI32 k)
+{
+	return (x << k) | (x >> (32 - k));
+}
+
+static vUI64 PXRandSplitMix(vPUI64 state)
+{
+	vUI64 z = (*state += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+static vUI32 PXRandStep(vPPXRandStream stream, vUI32 lane)
+{
+	vUI32 s0 = stream->state[0][lane], s1 = stream->state[1][lane];
+	vUI32 s2 = stream->state[2][lane], s3 = stream->state[3][lane];
+	vUI32 result = s0 + s3;
+
+	vUI32 t = s1 << 9;
+	s2 ^= s0; s3 ^= s1; s1 ^= s2; s0 ^= s3;
+	s2 ^= t;  s3 = PXRandRotl(s3, 11);
+
+	stream->state[0][lane] = s0; stream->state[1][lane] = s1;
+	stream->state[2][lane] = s2; stream->state[3][lane] = s3;
+	return result;
+}
+
+#ifdef PX_SSE2
+static __m128i PXRandStep4(__m128i* s0, __m128i* s1, __m128i* s2, __m128i* s3)
+{
+	/* PXRandStep on four lanes */
+	__m128i result = _mm_add_epi32(*s0, *s3);
+	__m128i t = _mm_slli_epi32(*s1, 9);
+	*s2 = _mm_xor_si128(*s2, *s0); *s3 = _mm_xor_si128(*s3, *s1);
+	*s1 = _mm_xor_si128(*s1, *s2); *s0 = _mm_xor_si128(*s0, *s3);
+	*s2 = _mm_xor_si128(*s2, t);
+	*s3 = _mm_or_si128(_mm_slli_epi32(*s3, 11), _mm_srli_epi32(*s3, 21));
+	return result;
+}
+#endif
+
+static void PXRandJumpLane(vPPXRandStream stream, vUI32 lane,
+	const vUI32* polynomial)
+{
+	vUI32 s[4] = { 0, 0, 0, 0 };
+	for (vUI32 word = 0; word < 4; word++)
+	{
+		for (vUI32 bit = 0; bit < 32; bit++)
+		{
+			if (polynomial[word] & (1u << bit))
+			{
+				for (vUI32 i = 0; i < 4; i++) s[i] ^= stream->state[i][lane];
+			}
+			PXRandStep(stream, lane);
+		}
+	}
+	for (vUI32 i = 0; i < 4; i++) stream->state[i][lane] = s[i];
+}
+
+static vFloat PXRandToUnit(vUI32 value)
+{
+	/* top 24 bits, the low bits of xoshiro128+ are weak */
+	return (vFloat)(vI32)(value >> 8) * RAND_FLOAT_SCALE;
+}
+
 
 /* ========== RANDOM NUMBER GENERATION			==========	*/
 VPHYSAPI void vPXRandInit(void)
 {
-	/* allocate table */
-	vLogInfo(__func__, "Initializing Physics random number table.");
-	_vphys.randomNumberTable = vAllocZeroed(sizeof(vFloat) * RAND_NUMTABLE_SIZE);
+	vPXWorldRandSeed(&_vphys, RAND_SEED_DEFAULT);
+}
 
-	/* setup first random number */
-	_vphys.randomNumberTable[0] = RAND_STARTSEED;
+VPHYSAPI vFloat vPXRandNormalizedSeed(vUI32 seed)
+{
+	vUI64 state = seed;
+	return PXRandToUnit((vUI32)(PXRandSplitMix(&state) >> 32)) * 2.0f - 1.0f;
+}
+
+VPHYSAPI vFloat vPXRandRangeSeed(vUI32 seed, vFloat low, vFloat high)
+{
+	vUI64 state = seed;
+	return low + PXRandToUnit((vUI32)(PXRandSplitMix(&state) >> 32)) * (high - low);
+}
+
+
+/* ========== RANDOM STREAMS					==========	*/
+VPHYSAPI void vPXRandStreamSeed(vPPXRandStream stream, vUI64 seed)
+{
+	/* first lane from the seed, never the all zero state */
+	vUI64 mix = seed;
+	vUI64 a = PXRandSplitMix(&mix), b = PXRandSplitMix(&mix);
+	stream->state[0][0] = (vUI32)a; stream->state[1][0] = (vUI32)(a >> 32);
+	stream->state[2][0] = (vUI32)b; stream->state[3][0] = (vUI32)(b >> 32);
+	if ((a | b) == 0) stream->state[0][0] = 1;
 
-	/* generate large random numbers */
-	for (int i = 1; i < RAND_NUMTABLE_SIZE; i++)
+	/* every further lane 2^96 draws on, so lanes never overlap */
+	for (vUI32 lane = 1; lane < RAND_LANES; lane++)
 	{
-		vFloat num = _vphys.randomNumberTable[i - 1];
-		num = fmodf(RAND_VAL_A * num + RAND_VAL_C, RAND_VAL_M);
-		_vphys.randomNumberTable[i] = num;
+		for (vUI32 i = 0; i < 4; i++)
+			stream->state[i][lane] = stream->state[i][lane - 1];
+		PXRandJumpLane(stream, lane, __randLongJump);
 	}
+	stream->lane = 0;
+}
+
+VPHYSAPI vUI32 vPXRandStreamNext(vPPXRandStream stream)
+{
+	vUI32 lane = stream->lane;
+	stream->lane = (lane + 1) & (RAND_LANES - 1);
+	return PXRandStep(stream, lane);
+}
+
+VPHYSAPI vFloat vPXRandStreamNormalized(vPPXRandStream stream)
+{
+	return PXRandToUnit(vPXRandStreamNext(stream)) * 2.0f - 1.0f;
+}
+
+VPHYSAPI vFloat vPXRandStreamRange(vPPXRandStream stream, vFloat low,
+	vFloat high)
+{
+	return low + PXRandToUnit(vPXRandStreamNext(stream)) * (high - low);
+}
 
-	/* mod and normalize (range -1 to 1) */
-	for (int i = 0; i < RAND_NUMTABLE_SIZE; i++)
+VPHYSAPI void vPXRandStreamFill(vPPXRandStream stream, vPFloat buffer,
+	vUI32 count, vFloat low, vFloat high)
+{
+	vFloat range = high - low;
+	vUI32 i = 0;
+
+	/* single draws until the next draw is from the first lane */
+	for (; i < count && stream->lane != 0; i++)
+		buffer[i] = vPXRandStreamRange(stream, low, high);
+
+	/* then every lane at once, same arithmetic as single draws */
+#ifdef PX_SSE2
+	__m128i s[4][RAND_LANES / 4];
+	for (vUI32 word = 0; word < 4; word++)
+		for (vUI32 v = 0; v < RAND_LANES / 4; v++)
+			s[word][v] = _mm_loadu_si128((__m128i*)(stream->state[word] + v * 4));
+
+	__m128 vScale = _mm_set1_ps(RAND_FLOAT_SCALE);
+	__m128 vRange = _mm_set1_ps(range);
+	__m128 vLow   = _mm_set1_ps(low);
+	for (; i + RAND_LANES <= count; i += RAND_LANES)
 	{
-		vFloat num = _vphys.randomNumberTable[i];
-		num = fabsf(num);
-		num = fmodf(num, RAND_GRANULARITY * 2);
+		for (vUI32 v = 0; v < RAND_LANES / 4; v++)
+		{
+			__m128i result = PXRandStep4(&s[0][v], &s[1][v], &s[2][v], &s[3][v]);
+			__m128 unit = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(result, 8)), vScale);
+			_mm_storeu_ps(buffer + i + v * 4, _mm_add_ps(vLow, _mm_mul_ps(unit, vRange)));
+		}
+	}
 
-		num -= RAND_GRANULARITY;
-		num /= RAND_GRANULARITY;
-		_vphys.randomNumberTable[i] = num;
+	for (vUI32 word = 0; word < 4; word++)
+		for (vUI32 v = 0; v < RAND_LANES / 4; v++)
+			_mm_storeu_si128((__m128i*)(stream->state[word] + v * 4), s[word][v]);
+#else
+	for (; i + RAND_LANES <= count; i += RAND_LANES)
+	{
+		for (vUI32 lane = 0; lane < RAND_LANES; lane++)
+			buffer[i + lane] = low + PXRandToUnit(PXRandStep(stream, lane)) * range;
 	}
+#endif
+
+	for (; i < count; i++)
+		buffer[i] = vPXRandStreamRange(stream, low, high);
 }
 
-VPHYSAPI vFloat vPXRandNormalizedSeed(vUI32 seed)
+VPHYSAPI void vPXRandStreamJump(vPPXRandStream stream)
 {
-	return _vphys.randomNumberTable[seed % RAND_NUMTABLE_SIZE];
+	for (vUI32 lane = 0; lane < RAND_LANES; lane++)
+		PXRandJumpLane(stream, lane, __randJump);
 }
 
-static vUI32 __internalRNSeed = 0;
-VPHYSAPI vFloat vPXRandNormalized(void)
+
+/* ========== WORLD STREAMS						==========	*/
+VPHYSAPI void vPXWorldRandSeed(vPPXWorld world, vUI64 seed)
 {
-	return vPXRandNormalizedSeed(__internalRNSeed++);
+	vPXWorldLock(world);
+	vPXRandStreamSeed(&world->random, seed);
+	vPXWorldUnlock(world);
 }
 
-VPHYSAPI vFloat vPXRandRangeSeed(vUI32 seed, vFloat low, vFloat high)
+VPHYSAPI vFloat vPXWorldRandNormalized(vPPXWorld world)
 {
-	vFloat range = high - low;
-	return low + (vPXFastFabs(vPXRandNormalizedSeed(seed)) * range);
+	return vPXRandStreamNormalized(&world->random);
+}
+
+VPHYSAPI vFloat vPXWorldRandRange(vPPXWorld world, vFloat low, vFloat high)
+{
+	return vPXRandStreamRange(&world->random, low, high);
+}
+
+
+/* ========== THREAD STREAMS					==========	*/
+VPHYSAPI vPPXRandStream vPXRandGetThreadStream(void)
+{
+	if (__threadStreamSeeded == FALSE)
+	{
+		/* the nth thread gets the default stream jumped n times */
+		LONG jumps = InterlockedIncrement(&__threadStreamCount);
+		vPXRandStreamSeed(&__threadStream, RAND_SEED_DEFAULT);
+		for (LONG i = 0; i < jumps; i++) vPXRandStreamJump(&__threadStream);
+		__threadStreamSeeded = TRUE;
+	}
+	return &__threadStream;
+}
+
+VPHYSAPI vFloat vPXRandNormalized(void)
+{
+	return vPXRandStreamNormalized(vPXRandGetThreadStream());
 }
 
-static vUI32 __internalRRSeed = 0;
 VPHYSAPI vFloat vPXRandRange(vFloat low, vFloat high)
 {
-	return vPXRandRangeSeed(__internalRRSeed++, low, high);
+	return vPXRandStreamRange(vPXRandGetThreadStream(), low, high);
+}
+
+VPHYSAPI void vPXRandFill(vPFloat buffer, vUI32 count, vFloat low, vFloat high)
+{
+	vPXRandStreamFill(vPXRandGetThreadStream(), buffer, count, low, high);
 }
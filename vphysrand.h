@@ -1,19 +1,54 @@
-
 /* ========== <vphysrand.h>						==========	*/
 /* Bailey Jia-Tao Brown							2022		*/
 /* Random number generator									*/
 
 #ifndef _VPHYS_RAND_INCLUDE_
-#define _VPHYS_RAND_INCLUDE_ 
+#define _VPHYS_RAND_INCLUDE_
 
 /* ========== INCLUDES							==========	*/
 #include "vphys.h"
 
 /* ========== RANDOM NUMBER GENERATION			==========	*/
+/* restarts the default world's stream from its default	*/
+/* seed, as a freshly initialized world has it				*/
 VPHYSAPI void vPXRandInit(void);
+/* stateless, the same seed always gives the same value	*/
 VPHYSAPI vFloat vPXRandNormalizedSeed(vUI32 seed);
-VPHYSAPI vFloat vPXRandNormalized(void);
 VPHYSAPI vFloat vPXRandRangeSeed(vUI32 seed, vFloat low, vFloat high);
+
+
+/* ========== RANDOM STREAMS					==========	*/
+/* a stream is only safe to use from one thread at a time;	*/
+/* its output depends only on its seed and the values		*/
+/* drawn from it. normalized values are in [-1, 1) and		*/
+/* ranges in [low, high)									*/
+VPHYSAPI void   vPXRandStreamSeed(vPPXRandStream stream, vUI64 seed);
+VPHYSAPI vUI32  vPXRandStreamNext(vPPXRandStream stream);
+VPHYSAPI vFloat vPXRandStreamNormalized(vPPXRandStream stream);
+VPHYSAPI vFloat vPXRandStreamRange(vPPXRandStream stream, vFloat low,
+	vFloat high);
+/* gives the same values as count single draws				*/
+VPHYSAPI void   vPXRandStreamFill(vPPXRandStream stream, vPFloat buffer,
+	vUI32 count, vFloat low, vFloat high);
+/* advances the stream 2^64 draws per lane; copy a stream	*/
+/* then jump the original to hand out independent streams	*/
+VPHYSAPI void   vPXRandStreamJump(vPPXRandStream stream);
+
+
+/* ========== WORLD STREAMS						==========	*/
+/* saved with snapshots and part of the state hash, use		*/
+/* under the world lock or from the physics thread			*/
+VPHYSAPI void   vPXWorldRandSeed(vPPXWorld world, vUI64 seed);
+VPHYSAPI vFloat vPXWorldRandNormalized(vPPXWorld world);
+VPHYSAPI vFloat vPXWorldRandRange(vPPXWorld world, vFloat low, vFloat high);
+
+
+/* ========== THREAD STREAMS					==========	*/
+/* every thread draws from its own stream, each jumped		*/
+/* ahead of the ones handed to earlier threads				*/
+VPHYSAPI vPPXRandStream vPXRandGetThreadStream(void);
+VPHYSAPI vFloat vPXRandNormalized(void);
 VPHYSAPI vFloat vPXRandRange(vFloat low, vFloat high);
+VPHYSAPI void   vPXRandFill(vPFloat buffer, vUI32 count, vFloat low, vFloat high);
 
 #endif
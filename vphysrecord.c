@@ -0,0 +1,633 @@
+/* ========== <vphysrecord.c>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Per-tick flight recorder and replay reader.				*/
+/* File layout: PXRecordHeader, then frames of one			*/
+/* PXRecordFrameHeader followed by its entries. An entry is	*/
+/* a varint handle and a mask byte, then for each field		*/
+/* in the mask the varint XOR of the zigzagged quantized	*/
+/* value with the body's last written one, then the flags	*/
+/* byte if masked. Keyframes start from an empty world so	*/
+/* every body is written in full.							*/
+
+
+/* ========== INCLUDES							==========	*/
+#define _CRT_SECURE_NO_WARNINGS
+#include "vphysrecord.h"
+#include "vphyscore.h"
+#include <math.h>
+#include <stdio.h>
+
+
+/* ========== INTERNAL DATA						==========	*/
+static const vFloat __recordScales[PX_RECORD_FIELD_COUNT] =
+{
+	PX_RECORD_POSITION_SCALE,
+	PX_RECORD_POSITION_SCALE,
+	PX_RECORD_ROTATION_SCALE,
+	PX_RECORD_VELOCITY_SCALE,
+	PX_RECORD_VELOCITY_SCALE,
+};
+
+
+/* ========== HELPERS							==========	*/
+static vPTR PXRecordRealloc(vPTR block, SIZE_T oldSize, SIZE_T newSize)
+{
+	vPTR newBlock = vAllocZeroed(newSize);
+	if (block != NULL) vMemCopy(newBlock, block, oldSize);
+	vFree(block);
+	return newBlock;
+}
+
+static void PXRecordEnsureBodies(PPXRecordBodyState* bodies, vPUI32 capacity,
+	vUI32 slot)
+{
+	if (slot < *capacity) return;
+
+	vUI32 newCapacity = max(BODYSTORE_CAPACITY_MIN, *capacity);
+	while (newCapacity <= slot) newCapacity <<= 1;
+	*bodies = PXRecordRealloc(*bodies, sizeof(PXRecordBodyState) * *capacity,
+		sizeof(PXRecordBodyState) * newCapacity);
+	*capacity = newCapacity;
+}
+
+static vUI64 PXRecordQuantize(vFloat value, vFloat scale)
+{
+	/* NaN gets its own code so blown up bodies survive replay */
+	double scaled = (double)value * scale;
+	if (scaled != scaled) return PX_RECORD_QUANT_INVALID;
+	scaled = max(-PX_RECORD_QUANT_LIMIT, min(PX_RECORD_QUANT_LIMIT, scaled));
+
+	/* zigzag, so small values of either sign have few set bits */
+	vI64 quantized = llround(scaled);
+	return ((vUI64)quantized << 1) ^ (vUI64)(quantized >> 63);
+}
+
+static vFloat PXRecordDequantize(vUI64 value, vFloat scale)
+{
+	if (value == PX_RECORD_QUANT_INVALID) return NAN;
+	vI64 quantized = (vI64)(value >> 1) ^ -(vI64)(value & 1);
+	return (vFloat)((double)quantized / scale);
+}
+
+static vUI8* PXRecordPutVarint(vUI8* out, vUI64 value)
+{
+	while (value >= 0x80)
+	{
+		*out++ = (vUI8)value | 0x80;
+		value >>= 7;
+	}
+	*out++ = (vUI8)value;
+	return out;
+}
+
+static const vUI8* PXRecordGetVarint(const vUI8* in, const vUI8* end,
+	vPUI64 valueOut)
+{
+	vUI64 value = 0;
+	for (vUI32 shift = 0; shift < 64; shift += 7)
+	{
+		if (in >= end) return NULL;
+		vUI8 byte = *in++;
+		value |= (vUI64)(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			*valueOut = value;
+			return in;
+		}
+	}
+	return NULL;
+}
+
+
+/* ========== WRITER							==========	*/
+static void PXRecordWriteFrame(vPPXRecordState record, PPXRecordFrame frame)
+{
+	vBOOL key = (record->framesWritten % record->keyframeInterval) == 0;
+	vUI64 serial = record->framesWritten + 1;
+
+	/* worst case every body is written and every old one removed */
+	vUI32 required = (frame->count + record->liveCount) * PX_RECORD_ENTRY_MAX;
+	if (record->encodeCapacity < required)
+	{
+		vFree(record->encodeBuffer);
+		record->encodeBuffer   = vAlloc(required);
+		record->encodeCapacity = required;
+	}
+
+	vUI8* out = record->encodeBuffer;
+	vUI32 entries = 0;
+
+	for (vUI32 i = 0; i < frame->count; i++)
+	{
+		vPXHandle handle = frame->handle[i];
+		PXRecordEnsureBodies(&record->bodies, &record->bodyCapacity,
+			handle & PX_HANDLE_INDEX_MASK);
+		PPXRecordBodyState state = record->bodies + (handle & PX_HANDLE_INDEX_MASK);
+
+		/* keyframes and new bodies are written against zero */
+		vBOOL full = key || state->handle != handle;
+		if (full)
+		{
+			vZeroMemory(state, sizeof(PXRecordBodyState));
+			state->handle = handle;
+		}
+		state->seen = serial;
+
+		vUI64 value[PX_RECORD_FIELD_COUNT];
+		value[PX_RECORD_FIELD_POSITION_X] = PXRecordQuantize(frame->position[i].x,
+			PX_RECORD_POSITION_SCALE);
+		value[PX_RECORD_FIELD_POSITION_Y] = PXRecordQuantize(frame->position[i].y,
+			PX_RECORD_POSITION_SCALE);
+		value[PX_RECORD_FIELD_ROTATION]   = PXRecordQuantize(frame->rotation[i],
+			PX_RECORD_ROTATION_SCALE);
+		value[PX_RECORD_FIELD_VELOCITY_X] = PXRecordQuantize(frame->velocity[i].x,
+			PX_RECORD_VELOCITY_SCALE);
+		value[PX_RECORD_FIELD_VELOCITY_Y] = PXRecordQuantize(frame->velocity[i].y,
+			PX_RECORD_VELOCITY_SCALE);
+
+		vUI8 mask = 0;
+		for (vUI32 f = 0; f < PX_RECORD_FIELD_COUNT; f++)
+			if (full || value[f] != state->value[f]) mask |= (1 << f);
+		if (full || frame->flags[i] != state->flags) mask |= PX_RECORD_ENTRY_FLAGS;
+
+		/* unchanged since the last written frame */
+		if (mask == 0) continue;
+
+		out = PXRecordPutVarint(out, handle);
+		*out++ = mask;
+		for (vUI32 f = 0; f < PX_RECORD_FIELD_COUNT; f++)
+		{
+			if ((mask & (1 << f)) == 0) continue;
+			out = PXRecordPutVarint(out, value[f] ^ state->value[f]);
+			state->value[f] = value[f];
+		}
+		if (mask & PX_RECORD_ENTRY_FLAGS)
+		{
+			*out++ = frame->flags[i];
+			state->flags = frame->flags[i];
+		}
+		entries++;
+	}
+
+	/* bodies of the last frame missing from this one were removed, */
+	/* a slot taken over by a new body was already overwritten		*/
+	for (vUI32 i = 0; i < record->liveCount; i++)
+	{
+		vPXHandle handle = record->live[i];
+		PPXRecordBodyState state = record->bodies + (handle & PX_HANDLE_INDEX_MASK);
+		if (state->handle != handle || state->seen == serial) continue;
+
+		state->handle = PX_HANDLE_NULL;
+		if (key) continue;
+
+		out = PXRecordPutVarint(out, handle);
+		*out++ = PX_RECORD_ENTRY_REMOVED;
+		entries++;
+	}
+
+	/* this frame is what the next one is compared against */
+	if (record->liveCapacity < frame->count)
+	{
+		vFree(record->live);
+		record->liveCapacity = frame->capacity;
+		record->live = vAlloc(sizeof(vPXHandle) * record->liveCapacity);
+	}
+	if (frame->count > 0)
+		vMemCopy(record->live, frame->handle, sizeof(vPXHandle) * frame->count);
+	record->liveCount = frame->count;
+
+	PXRecordFrameHeader header;
+	header.tick        = frame->tick;
+	header.type        = key ? PX_RECORD_FRAME_KEY : PX_RECORD_FRAME_DELTA;
+	header.entryCount  = entries;
+	header.bodyCount   = frame->count;
+	header.payloadSize = (vUI32)(out - record->encodeBuffer);
+	fwrite(&header, sizeof(header), 1, record->outFile);
+	fwrite(record->encodeBuffer, 1, header.payloadSize, record->outFile);
+
+	record->framesWritten++;
+}
+
+static void PXRecordDrain(vPPXRecordState record)
+{
+	vBOOL wrote = FALSE;
+	while (record->readCursor != record->writeCursor)
+	{
+		LONG read = record->readCursor;
+		PXRecordWriteFrame(record,
+			record->frames + ((vUI32)read % record->frameCount));
+
+		/* hand the slot back to the tick */
+		InterlockedExchange(&record->readCursor, read + 1);
+		wrote = TRUE;
+	}
+
+	/* a crash then loses at most what is still in the ring */
+	if (wrote == TRUE) fflush(record->outFile);
+}
+
+static void PXRecordWriterCycle(vPWorker worker, vPTR workerData)
+{
+	PXRecordDrain(&((vPPXWorld)workerData)->record);
+}
+
+static void PXRecordWriterExit(vPWorker worker, vPTR workerData)
+{
+	PXRecordDrain(&((vPPXWorld)workerData)->record);
+}
+
+
+/* ========== RECORD CONTROL					==========	*/
+VPHYSAPI vBOOL vPXWorldRecordBegin(vPPXWorld world, vPCHAR filePath,
+	vUI32 keyframeInterval, vUI32 ringFrames)
+{
+	vPXWorldLock(world);
+
+	/* only one recording per world at once */
+	if (world->record.enabled == TRUE)
+	{
+		vPXWorldUnlock(world);
+		return FALSE;
+	}
+
+	FILE* file = fopen(filePath, "wb");
+	if (file == NULL)
+	{
+		vPXWorldDebugLogFormatted(world, "Could not open recording file %s\n",
+			filePath);
+		vPXWorldUnlock(world);
+		return FALSE;
+	}
+	setvbuf(file, NULL, _IOFBF, PX_RECORD_WRITE_BUFFER);
+
+	if (keyframeInterval == 0) keyframeInterval = PX_RECORD_KEYFRAME_DEFAULT;
+	if (ringFrames == 0) ringFrames = PX_RECORD_RING_DEFAULT;
+
+	PXRecordHeader header;
+	vZeroMemory(&header, sizeof(header));
+	header.magic   = PX_RECORD_MAGIC;
+	header.version = PX_RECORD_VERSION;
+	header.keyframeInterval = keyframeInterval;
+	vMemCopy(header.scale, __recordScales, sizeof(__recordScales));
+	fwrite(&header, sizeof(header), 1, file);
+
+	/* frame arrays are sized on first capture */
+	vPPXRecordState record = &world->record;
+	vZeroMemory(record, sizeof(vPXRecordState));
+	record->outFile          = file;
+	record->keyframeInterval = keyframeInterval;
+	record->frames     = vAllocZeroed(sizeof(PXRecordFrame) * ringFrames);
+	record->frameCount = ringFrames;
+
+	record->writer = vCreateWorker("vPhysics Recorder", PX_RECORD_DRAIN_INTERVAL,
+		NULL, PXRecordWriterExit, PXRecordWriterCycle, world, NULL);
+	record->enabled = TRUE;
+
+	vPXWorldUnlock(world);
+	return TRUE;
+}
+
+VPHYSAPI vBOOL vPXWorldRecordEnd(vPPXWorld world)
+{
+	vPPXRecordState record = &world->record;
+
+	/* stop capturing, the tick checks this under the lock */
+	vPXWorldLock(world);
+	if (record->enabled == FALSE)
+	{
+		vPXWorldUnlock(world);
+		return FALSE;
+	}
+	record->enabled = FALSE;
+	vPXWorldUnlock(world);
+
+	/* the writer drains the ring on exit */
+	vDestroyWorker(record->writer);
+	fclose(record->outFile);
+
+	for (vUI32 i = 0; i < record->frameCount; i++)
+	{
+		PPXRecordFrame frame = record->frames + i;
+		vFree(frame->handle);
+		vFree(frame->position);
+		vFree(frame->rotation);
+		vFree(frame->velocity);
+		vFree(frame->flags);
+	}
+	vFree(record->frames);
+	vFree(record->bodies);
+	vFree(record->live);
+	vFree(record->encodeBuffer);
+	vZeroMemory(record, sizeof(vPXRecordState));
+	return TRUE;
+}
+
+VPHYSAPI vBOOL vPXWorldRecordIsEnabled(vPPXWorld world)
+{
+	return world->record.enabled;
+}
+
+
+/* ========== REPLAY							==========	*/
+static void PXReplayIndex(vPPXReplay replay)
+{
+	/* first pass counts complete frames, second fills the index */
+	for (vUI32 pass = 0; pass < 2; pass++)
+	{
+		vUI64 offset = sizeof(PXRecordHeader);
+		vUI32 count  = 0;
+		vUI32 key    = 0;
+
+		while (offset + sizeof(PXRecordFrameHeader) <= replay->size)
+		{
+			PXRecordFrameHeader header;
+			vMemCopy(&header, replay->data + offset, sizeof(header));
+
+			/* stop at a frame cut short by a crash */
+			vUI64 next = offset + sizeof(header) + header.payloadSize;
+			if (next > replay->size) break;
+
+			if (header.type == PX_RECORD_FRAME_KEY) key = count;
+			if (pass == 1)
+			{
+				replay->frameOffset[count] = offset;
+				replay->frameTick[count]   = header.tick;
+				replay->frameKey[count]    = key;
+			}
+
+			count++;
+			offset = next;
+		}
+
+		if (pass == 0)
+		{
+			replay->frameOffset = vAlloc(sizeof(vUI64) * max(1, count));
+			replay->frameTick   = vAlloc(sizeof(vUI64) * max(1, count));
+			replay->frameKey    = vAlloc(sizeof(vUI32) * max(1, count));
+		}
+		replay->frameCount = count;
+	}
+}
+
+static vBOOL PXReplayDecodeFrame(vPPXReplay replay, vUI32 index)
+{
+	PXRecordFrameHeader header;
+	const vUI8* in = replay->data + replay->frameOffset[index];
+	vMemCopy(&header, in, sizeof(header));
+	in += sizeof(header);
+	const vUI8* end = in + header.payloadSize;
+
+	/* keyframes start from an empty world */
+	if (header.type == PX_RECORD_FRAME_KEY && replay->bodies != NULL)
+	{
+		vZeroMemory(replay->bodies, sizeof(PXRecordBodyState) * replay->bodyCapacity);
+		replay->bodyCount = 0;
+	}
+
+	for (vUI32 entry = 0; entry < header.entryCount; entry++)
+	{
+		vUI64 handle;
+		in = PXRecordGetVarint(in, end, &handle);
+		if (in == NULL || in >= end) return FALSE;
+		vUI8 mask = *in++;
+
+		vUI32 slot = (vUI32)handle & PX_HANDLE_INDEX_MASK;
+		PXRecordEnsureBodies(&replay->bodies, &replay->bodyCapacity, slot);
+		PPXRecordBodyState state = replay->bodies + slot;
+
+		if (mask & PX_RECORD_ENTRY_REMOVED)
+		{
+			if (state->handle != (vPXHandle)handle) continue;
+			state->handle = PX_HANDLE_NULL;
+			replay->bodyCount--;
+			continue;
+		}
+
+		/* a new body in this slot was written against zero */
+		if (state->handle != (vPXHandle)handle)
+		{
+			if (state->handle == PX_HANDLE_NULL) replay->bodyCount++;
+			vZeroMemory(state, sizeof(PXRecordBodyState));
+			state->handle = (vPXHandle)handle;
+		}
+
+		for (vUI32 f = 0; f < PX_RECORD_FIELD_COUNT; f++)
+		{
+			if ((mask & (1 << f)) == 0) continue;
+			vUI64 delta;
+			in = PXRecordGetVarint(in, end, &delta);
+			if (in == NULL) return FALSE;
+			state->value[f] ^= delta;
+		}
+		if (mask & PX_RECORD_ENTRY_FLAGS)
+		{
+			if (in >= end) return FALSE;
+			state->flags = *in++;
+		}
+	}
+
+	replay->current = index;
+	return TRUE;
+}
+
+VPHYSAPI vPPXReplay vPXReplayOpen(vPCHAR filePath)
+{
+	HANDLE file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return NULL;
+
+	LARGE_INTEGER fileSize;
+	fileSize.QuadPart = 0;
+	GetFileSizeEx(file, &fileSize);
+
+	HANDLE mapping = NULL;
+	const vUI8* view = NULL;
+	if (fileSize.QuadPart >= (vI64)sizeof(PXRecordHeader))
+	{
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping != NULL) view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	}
+
+	PPXRecordHeader header = (PPXRecordHeader)view;
+	if (view == NULL || header->magic != PX_RECORD_MAGIC ||
+		header->version != PX_RECORD_VERSION || header->keyframeInterval == 0)
+	{
+		if (view != NULL) UnmapViewOfFile(view);
+		if (mapping != NULL) CloseHandle(mapping);
+		CloseHandle(file);
+		return NULL;
+	}
+
+	vPPXReplay replay = vAllocZeroed(sizeof(vPXReplay));
+	replay->file    = file;
+	replay->mapping = mapping;
+	replay->data    = view;
+	replay->size    = (vUI64)fileSize.QuadPart;
+	replay->header  = header;
+	replay->current = -1;
+
+	PXReplayIndex(replay);
+	return replay;
+}
+
+VPHYSAPI void vPXReplayClose(vPPXReplay replay)
+{
+	if (replay == NULL) return;
+
+	UnmapViewOfFile(replay->data);
+	CloseHandle(replay->mapping);
+	CloseHandle(replay->file);
+
+	vFree(replay->frameOffset);
+	vFree(replay->frameTick);
+	vFree(replay->frameKey);
+	vFree(replay->bodies);
+	vFree(replay);
+}
+
+VPHYSAPI vUI32 vPXReplayGetFrameCount(vPPXReplay replay)
+{
+	return replay->frameCount;
+}
+
+VPHYSAPI vBOOL vPXReplayGetTickRange(vPPXReplay replay, vPUI64 firstOut,
+	vPUI64 lastOut)
+{
+	if (replay->frameCount == 0) return FALSE;
+	*firstOut = replay->frameTick[0];
+	*lastOut  = replay->frameTick[replay->frameCount - 1];
+	return TRUE;
+}
+
+VPHYSAPI vBOOL vPXReplaySeek(vPPXReplay replay, vUI64 tick)
+{
+	if (replay->frameCount == 0 || tick < replay->frameTick[0]) return FALSE;
+
+	/* last frame at or before tick */
+	vUI32 low = 0, high = replay->frameCount;
+	while (high - low > 1)
+	{
+		vUI32 mid = (low + high) >> 1;
+		if (replay->frameTick[mid] <= tick) low = mid;
+		else high = mid;
+	}
+
+	/* carry on from the decoded frame when it is on the way, so	*/
+	/* playing forward decodes one frame per tick					*/
+	vUI32 start = replay->frameKey[low];
+	if (replay->current >= (vI64)start && replay->current <= (vI64)low)
+		start = (vUI32)replay->current + 1;
+
+	for (vUI32 frame = start; frame <= low; frame++)
+	{
+		if (PXReplayDecodeFrame(replay, frame) == TRUE) continue;
+		replay->current = -1;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+VPHYSAPI vUI64 vPXReplayGetTick(vPPXReplay replay)
+{
+	if (replay->current < 0) return 0;
+	return replay->frameTick[replay->current];
+}
+
+VPHYSAPI vUI32 vPXReplayGetBodies(vPPXReplay replay, vPPXReplayBody bodiesOut,
+	vUI32 capacity)
+{
+	const vFloat* scale = replay->header->scale;
+	vUI32 written = 0;
+
+	for (vUI32 slot = 0; slot < replay->bodyCapacity && written < capacity; slot++)
+	{
+		PPXRecordBodyState state = replay->bodies + slot;
+		if (state->handle == PX_HANDLE_NULL) continue;
+
+		vPPXReplayBody body = bodiesOut + written++;
+		body->handle     = state->handle;
+		body->position.x = PXRecordDequantize(state->value[PX_RECORD_FIELD_POSITION_X],
+			scale[PX_RECORD_FIELD_POSITION_X]);
+		body->position.y = PXRecordDequantize(state->value[PX_RECORD_FIELD_POSITION_Y],
+			scale[PX_RECORD_FIELD_POSITION_Y]);
+		body->rotation   = PXRecordDequantize(state->value[PX_RECORD_FIELD_ROTATION],
+			scale[PX_RECORD_FIELD_ROTATION]);
+		body->velocity.x = PXRecordDequantize(state->value[PX_RECORD_FIELD_VELOCITY_X],
+			scale[PX_RECORD_FIELD_VELOCITY_X]);
+		body->velocity.y = PXRecordDequantize(state->value[PX_RECORD_FIELD_VELOCITY_Y],
+			scale[PX_RECORD_FIELD_VELOCITY_Y]);
+		body->active     = (state->flags & PX_BODY_ACTIVE) != 0;
+	}
+
+	return replay->bodyCount;
+}
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI vBOOL vPXRecordBegin(vPCHAR filePath, vUI32 keyframeInterval,
+	vUI32 ringFrames)
+{
+	return vPXWorldRecordBegin(&_vphys, filePath, keyframeInterval, ringFrames);
+}
+
+VPHYSAPI vBOOL vPXRecordEnd(void)
+{
+	return vPXWorldRecordEnd(&_vphys);
+}
+
+VPHYSAPI vBOOL vPXRecordIsEnabled(void)
+{
+	return vPXWorldRecordIsEnabled(&_vphys);
+}
+
+
+/* ========== CAPTURE							==========	*/
+void PXRecordCapture(vPPXWorld world)
+{
+	vPPXRecordState record = &world->record;
+	PPXBodyStore store = &world->bodies;
+
+	/* never wait on the writer, drop the tick when the ring is full */
+	LONG write = record->writeCursor;
+	if ((vUI32)(write - record->readCursor) >= record->frameCount)
+	{
+		world->stats.recordDrops++;
+		return;
+	}
+
+	/* the slot is only touched here until it is published */
+	PPXRecordFrame frame = record->frames + ((vUI32)write % record->frameCount);
+	if (frame->capacity < store->count)
+	{
+		vFree(frame->handle);
+		vFree(frame->position);
+		vFree(frame->rotation);
+		vFree(frame->velocity);
+		vFree(frame->flags);
+		frame->capacity = store->capacity;
+		frame->handle   = vAlloc(sizeof(vPXHandle) * frame->capacity);
+		frame->position = vAlloc(sizeof(vVect) * frame->capacity);
+		frame->rotation = vAlloc(sizeof(vFloat) * frame->capacity);
+		frame->velocity = vAlloc(sizeof(vVect) * frame->capacity);
+		frame->flags    = vAlloc(sizeof(vUI8) * frame->capacity);
+	}
+
+	vUI32 count = 0;
+	for (vUI32 body = 0; body < store->count; body++)
+	{
+		/* skip bodies removed since the last compaction */
+		if (store->physical[body] == NULL) continue;
+
+		frame->handle[count]   = store->handle[body];
+		frame->position[count] = store->position[body];
+		frame->rotation[count] = store->rotation[body];
+		frame->velocity[count] = store->velocity[body];
+		frame->flags[count]    = store->flags[body] & ~PX_BODY_TICK_FLAGS;
+		count++;
+	}
+	frame->count = count;
+	frame->tick  = world->stats.tickCount;
+
+	/* publish the frame to the writer */
+	InterlockedExchange(&record->writeCursor, write + 1);
+}
@@ -0,0 +1,53 @@
+/* ========== <vphysrecord.h>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Per-tick flight recorder and replay reader.				*/
+/* While recording, each tick copies body state into a		*/
+/* bounded ring; a writer thread quantizes it and writes	*/
+/* only what changed since the last written frame, with a	*/
+/* full keyframe every keyframeInterval frames. Ticks are	*/
+/* dropped (and counted in stats) rather than waiting on	*/
+/* the writer.												*/
+
+#ifndef _VPHYS_RECORD_INCLUDE_
+#define _VPHYS_RECORD_INCLUDE_
+
+/* ========== INCLUDES							==========	*/
+#include "vphysdefs.h"
+
+
+/* ========== RECORD CONTROL					==========	*/
+/* 0 picks the default keyframe interval and ring length	*/
+VPHYSAPI vBOOL vPXWorldRecordBegin(vPPXWorld world, vPCHAR filePath,
+	vUI32 keyframeInterval, vUI32 ringFrames);
+VPHYSAPI vBOOL vPXWorldRecordEnd(vPPXWorld world);
+VPHYSAPI vBOOL vPXWorldRecordIsEnabled(vPPXWorld world);
+
+
+/* ========== REPLAY							==========	*/
+/* recordings may be read while still being written or		*/
+/* after a crash; a trailing partial frame is ignored		*/
+VPHYSAPI vPPXReplay vPXReplayOpen(vPCHAR filePath);
+VPHYSAPI void  vPXReplayClose(vPPXReplay replay);
+VPHYSAPI vUI32 vPXReplayGetFrameCount(vPPXReplay replay);
+VPHYSAPI vBOOL vPXReplayGetTickRange(vPPXReplay replay, vPUI64 firstOut,
+	vPUI64 lastOut);
+/* decodes the last recorded tick at or before tick		*/
+VPHYSAPI vBOOL vPXReplaySeek(vPPXReplay replay, vUI64 tick);
+VPHYSAPI vUI64 vPXReplayGetTick(vPPXReplay replay);
+/* bodies are listed in handle slot order; returns the		*/
+/* number of bodies alive, at most capacity are written	*/
+VPHYSAPI vUI32 vPXReplayGetBodies(vPPXReplay replay, vPPXReplayBody bodiesOut,
+	vUI32 capacity);
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI vBOOL vPXRecordBegin(vPCHAR filePath, vUI32 keyframeInterval,
+	vUI32 ringFrames);
+VPHYSAPI vBOOL vPXRecordEnd(void);
+VPHYSAPI vBOOL vPXRecordIsEnabled(void);
+
+
+/* ========== CAPTURE							==========	*/
+void PXRecordCapture(vPPXWorld world);
+
+#endif
@@ -0,0 +1,276 @@
+/* ========== <vphyssensor.c>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Sensor volumes with enter and exit events.				*/
+/* Overlaps are kept as sorted pairs of handles, so one		*/
+/* merge of last tick's pairs with this tick's finds every	*/
+/* enter and exit, and bodies moving in storage do not		*/
+/* disturb them.											*/
+
+
+/* ========== INCLUDES							==========	*/
+#include "vphyssensor.h"
+#include "vphyscore.h"
+#include "vspacepart.h"
+#include "vcollision.h"
+#include "vphystrace.h"
+#include "vphyslayer.h"
+#include <math.h>
+#include <stdlib.h>
+
+
+/* ========== HELPERS							==========	*/
+static vUI64 PXSensorKey(vPXHandle sensor, vPXHandle body)
+{
+	return ((vUI64)sensor << 32) | (vUI64)body;
+}
+
+static int PXSensorKeyCompare(const void* k1, const void* k2)
+{
+	vUI64 a = *(const vUI64*)k1;
+	vUI64 b = *(const vUI64*)k2;
+	return (a < b) ? -1 : (a > b) ? 1 : 0;
+}
+
+static void PXSensorReserve(vPUI64* keys, vUI32* capacity, vUI32 count,
+	vUI32 required)
+{
+	if (*capacity >= required) return;
+
+	vUI32 newCap = max(SENSORSTATE_CAPACITY_MIN, *capacity);
+	while (newCap < required) newCap <<= 1;
+
+	vPUI64 newKeys = vAlloc(sizeof(vUI64) * newCap);
+	if (*keys != NULL) vMemCopy(newKeys, *keys, sizeof(vUI64) * count);
+	vFree(*keys);
+	*keys = newKeys;
+	*capacity = newCap;
+}
+
+static void PXSensorPushEvent(vPPXWorld world, vUI64 key, vUI8 type)
+{
+	PPXSensorState state = &world->sensors;
+	if (state->eventCount >= PX_SENSOR_EVENTS_MAX)
+	{
+		world->stats.sensorEventDrops++;
+		return;
+	}
+
+	if (state->eventCount == state->eventCapacity)
+	{
+		vUI32 newCap = max(SENSORSTATE_CAPACITY_MIN, state->eventCapacity << 1);
+		vPPXSensorEvent newEvents = vAlloc(sizeof(vPXSensorEvent) * newCap);
+		if (state->events != NULL)
+		{
+			vMemCopy(newEvents, state->events,
+				sizeof(vPXSensorEvent) * state->eventCount);
+		}
+		vFree(state->events);
+		state->events = newEvents;
+		state->eventCapacity = newCap;
+	}
+
+	vPPXSensorEvent event = state->events + state->eventCount++;
+	vZeroMemory(event, sizeof(vPXSensorEvent));
+	event->sensor = (vPXHandle)(key >> 32);
+	event->body   = (vPXHandle)key;
+	event->tick   = world->stats.tickCount;
+	event->type   = type;
+}
+
+static void PXSensorFindInPartition(vPPXWorld world, vUI32 sensor,
+	vPPXPartition part)
+{
+	PPXBodyStore store = &world->bodies;
+	PPXSensorState state = &world->sensors;
+	vPGRect sensorBox = &store->worldBound[sensor].boundingBox;
+
+	for (vUI32 i = 0; i < part->useage; i++)
+	{
+		vUI32 body = part->list[i];
+		if (body == sensor) continue;
+		if (store->flags[body] & (PX_BODY_SENSOR | PX_BODY_STATIC)) continue;
+		if (PXLayersCollide(world, store->collideLayer[sensor],
+			store->collideLayer[body]) == FALSE) continue;
+
+		/* boxes must meet, and a pair sharing several partitions	*/
+		/* is only tested by the one holding their overlap's min	*/
+		/* corner														*/
+		vPGRect bodyBox = &store->worldBound[body].boundingBox;
+		vFloat left   = max(sensorBox->left, bodyBox->left);
+		vFloat bottom = max(sensorBox->bottom, bodyBox->bottom);
+		if (left > min(sensorBox->right, bodyBox->right) ||
+			bottom > min(sensorBox->top, bodyBox->top)) continue;
+		if ((vI32)floorf(left / world->partitionSize) != part->x ||
+			(vI32)floorf(bottom / world->partitionSize) != part->y) continue;
+
+		if (PXOverlapBodies(world, sensor, body) == FALSE) continue;
+
+		PXSensorReserve(&state->found, &state->foundCapacity,
+			state->foundCount, state->foundCount + 1);
+		state->found[state->foundCount++] = PXSensorKey(store->handle[sensor],
+			store->handle[body]);
+	}
+}
+
+
+/* ========== SENSOR STATE						==========	*/
+void PXSensorStateFree(vPPXWorld world)
+{
+	PPXSensorState state = &world->sensors;
+	vFree(state->overlaps);
+	vFree(state->found);
+	vFree(state->events);
+	vZeroMemory(state, sizeof(PXSensorState));
+}
+
+void PXSensorTick(vPPXWorld world)
+{
+	PPXSensorState state = &world->sensors;
+	PPXBodyStore store = &world->bodies;
+	state->foundCount = 0;
+
+	/* nothing to find and nothing to end, skip the merge */
+	vBOOL anySensor = FALSE;
+	for (vUI32 body = 0; body < store->count && anySensor == FALSE; body++)
+		anySensor = (store->flags[body] & PX_BODY_SENSOR) != 0;
+	if (anySensor == FALSE && state->overlapCount == 0) return;
+
+	PXTRACE_SPAN_BEGIN(world, traceStart);
+
+	/* sensors find their bodies through the partitions they	*/
+	/* cover, whether or not anything in them is moving			*/
+	vFloat cellScale = 1.0f / world->partitionSize;
+	for (vUI32 sensor = 0; sensor < store->count; sensor++)
+	{
+		if ((store->flags[sensor] & (PX_BODY_SENSOR | PX_BODY_ACTIVE)) !=
+			(PX_BODY_SENSOR | PX_BODY_ACTIVE)) continue;
+
+		vPGRect box = &store->worldBound[sensor].boundingBox;
+		vI32 cellX0 = (vI32)floorf(box->left * cellScale);
+		vI32 cellY0 = (vI32)floorf(box->bottom * cellScale);
+		vI32 cellX1 = (vI32)floorf(box->right * cellScale);
+		vI32 cellY1 = (vI32)floorf(box->top * cellScale);
+		for (vI32 y = cellY0; y <= cellY1; y++)
+		{
+			for (vI32 x = cellX0; x <= cellX1; x++)
+			{
+				vUI32 poolIndex = PXCellMapFind(&world->partitionMap, x, y);
+				if (poolIndex == CELLMAP_EMPTY) continue;
+				PXSensorFindInPartition(world, sensor,
+					world->partitionPool[poolIndex]);
+			}
+		}
+	}
+
+	if (state->foundCount > 1)
+		qsort(state->found, state->foundCount, sizeof(vUI64),
+			PXSensorKeyCompare);
+
+	/* merge both sorted sets, pairs in only one changed */
+	vUI32 i = 0, j = 0;
+	while (i < state->overlapCount || j < state->foundCount)
+	{
+		if (j == state->foundCount ||
+			(i < state->overlapCount && state->overlaps[i] < state->found[j]))
+		{
+			PXSensorPushEvent(world, state->overlaps[i++], PX_SENSOR_EXIT);
+			continue;
+		}
+		if (i == state->overlapCount || state->found[j] < state->overlaps[i])
+		{
+			PXSensorPushEvent(world, state->found[j++], PX_SENSOR_ENTER);
+			continue;
+		}
+		i++; j++;
+	}
+
+	/* this tick's pairs become the persistent set */
+	vPUI64 swapKeys = state->overlaps;
+	vUI32  swapCap  = state->overlapCapacity;
+	state->overlaps        = state->found;
+	state->overlapCount    = state->foundCount;
+	state->overlapCapacity = state->foundCapacity;
+	state->found           = swapKeys;
+	state->foundCapacity   = swapCap;
+	state->foundCount      = 0;
+
+	world->stats.sensorOverlaps = state->overlapCount;
+	PXTRACE_SPAN_END(world, traceStart, PX_TRACE_SENSORS,
+		state->overlapCount, 0);
+}
+
+
+/* ========== EVENTS							==========	*/
+VPHYSAPI vUI32 vPXWorldReadSensorEvents(vPPXWorld world,
+	vPPXSensorEvent eventsOut, vUI32 capacity)
+{
+	vPXWorldLock(world);
+	PPXSensorState state = &world->sensors;
+	vUI32 count = min(capacity, state->eventCount);
+	if (count > 0)
+	{
+		vMemCopy(eventsOut, state->events, sizeof(vPXSensorEvent) * count);
+
+		/* the unread rest moves up to the front */
+		state->eventCount -= count;
+		for (vUI32 i = 0; i < state->eventCount; i++)
+			state->events[i] = state->events[i + count];
+	}
+	vPXWorldUnlock(world);
+	return count;
+}
+
+VPHYSAPI vUI32 vPXWorldGetSensorEventCount(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	vUI32 count = world->sensors.eventCount;
+	vPXWorldUnlock(world);
+	return count;
+}
+
+
+/* ========== OVERLAPS							==========	*/
+VPHYSAPI vUI32 vPXWorldGetSensorOverlaps(vPPXWorld world, vPXHandle sensor,
+	vPXHandle* bodiesOut, vUI32 capacity)
+{
+	vPXWorldLock(world);
+	PPXSensorState state = &world->sensors;
+
+	/* first pair of this sensor, the set is sorted by sensor */
+	vUI64 first = PXSensorKey(sensor, 0);
+	vUI32 low = 0, high = state->overlapCount;
+	while (low < high)
+	{
+		vUI32 mid = low + ((high - low) >> 1);
+		if (state->overlaps[mid] < first) low = mid + 1;
+		else high = mid;
+	}
+
+	vUI32 count = 0;
+	for (vUI32 i = low; i < state->overlapCount; i++, count++)
+	{
+		if ((vPXHandle)(state->overlaps[i] >> 32) != sensor) break;
+		if (count < capacity) bodiesOut[count] = (vPXHandle)state->overlaps[i];
+	}
+
+	vPXWorldUnlock(world);
+	return count;
+}
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI vUI32 vPXReadSensorEvents(vPPXSensorEvent eventsOut, vUI32 capacity)
+{
+	return vPXWorldReadSensorEvents(&_vphys, eventsOut, capacity);
+}
+
+VPHYSAPI vUI32 vPXGetSensorEventCount(void)
+{
+	return vPXWorldGetSensorEventCount(&_vphys);
+}
+
+VPHYSAPI vUI32 vPXGetSensorOverlaps(vPXHandle sensor, vPXHandle* bodiesOut,
+	vUI32 capacity)
+{
+	return vPXWorldGetSensorOverlaps(&_vphys, sensor, bodiesOut, capacity);
+}
@@ -0,0 +1,45 @@
+/* ========== <vphyssensor.h>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Sensor volumes with enter and exit events.				*/
+/* A body with properties.isSensor set never collides:		*/
+/* nothing pushes it and it pushes nothing. Instead each	*/
+/* tick it is overlap tested against the other bodies in	*/
+/* its partitions, skipping sensors and bodies with			*/
+/* staticPosition set, and the changes to its overlaps are	*/
+/* queued as events.										*/
+
+#ifndef _VPHYS_SENSOR_INCLUDE_
+#define _VPHYS_SENSOR_INCLUDE_
+
+/* ========== INCLUDES							==========	*/
+#include "vphysdefs.h"
+
+
+/* ========== EVENTS							==========	*/
+/* events are queued in tick order, sorted by sensor then	*/
+/* body within a tick. reading removes them from the queue,	*/
+/* returns the number written								*/
+VPHYSAPI vUI32 vPXWorldReadSensorEvents(vPPXWorld world,
+	vPPXSensorEvent eventsOut, vUI32 capacity);
+VPHYSAPI vUI32 vPXWorldGetSensorEventCount(vPPXWorld world);
+
+
+/* ========== OVERLAPS							==========	*/
+/* bodies overlapping a sensor as of the last tick, returns	*/
+/* the number overlapping, at most capacity are written		*/
+VPHYSAPI vUI32 vPXWorldGetSensorOverlaps(vPPXWorld world, vPXHandle sensor,
+	vPXHandle* bodiesOut, vUI32 capacity);
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI vUI32 vPXReadSensorEvents(vPPXSensorEvent eventsOut, vUI32 capacity);
+VPHYSAPI vUI32 vPXGetSensorEventCount(void);
+VPHYSAPI vUI32 vPXGetSensorOverlaps(vPXHandle sensor, vPXHandle* bodiesOut,
+	vUI32 capacity);
+
+
+/* ========== SENSOR STATE						==========	*/
+void PXSensorStateFree(vPPXWorld world);
+void PXSensorTick(vPPXWorld world);
+
+#endif
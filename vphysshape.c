@@ -0,0 +1,224 @@
+/* ========== <vphysshape.c>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Collision shapes shared between bodies.					*/
+/* Shapes are immutable once created, so the table only		*/
+/* ever grows and an id stays valid for the world's life.	*/
+
+
+/* ========== INCLUDES							==========	*/
+#include "vphysshape.h"
+#include "vphyscore.h"
+#include <math.h>
+
+
+/* ========== STATIC SHAPES						==========	*/
+/* what bodies of a world-less view collide as				*/
+static PXShape __boundShape = { PX_SHAPE_TYPE_BOX };
+
+
+/* ========== HELPERS							==========	*/
+static vPXShapeID PXShapeClaim(vPPXWorld world, PPXShape shape)
+{
+	PPXBodyStore store = &world->bodies;
+	if (store->shapeCount >= PX_SHAPE_TABLE_MAX) return PX_SHAPE_BOUND;
+
+	PXShapeTableReserve(world, store->shapeCount + 1);
+	store->shapes[store->shapeCount] = *shape;
+	return (vPXShapeID)store->shapeCount++;
+}
+
+static vPXShapeID PXShapeAdd(vPPXWorld world, PPXShape shape)
+{
+	/* the table may move while growing, so never during a tick */
+	vPXWorldLock(world);
+	vPXShapeID id = PXShapeClaim(world, shape);
+	vPXWorldUnlock(world);
+
+	if (id == PX_SHAPE_BOUND)
+		vPXWorldDebugLog(world, "Shape table is full\n");
+	return id;
+}
+
+static vFloat PXShapeCross(vVect o, vVect a, vVect b)
+{
+	return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+
+/* ========== SHAPE CREATION					==========	*/
+VPHYSAPI vPXShapeID vPXWorldCreateCircleShape(vPPXWorld world, vFloat radius)
+{
+	if (!(radius > 0.0f)) return PX_SHAPE_BOUND;
+
+	/* zeroed so padding hashes the same everywhere */
+	PXShape shape;
+	vZeroMemory(&shape, sizeof(shape));
+	shape.type      = PX_SHAPE_TYPE_CIRCLE;
+	shape.vertCount = 1;
+	shape.radius    = radius;
+	shape.bound     = vGCreateRect(-radius, radius, -radius, radius);
+	return PXShapeAdd(world, &shape);
+}
+
+VPHYSAPI vPXShapeID vPXWorldCreateCapsuleShape(vPPXWorld world,
+	vFloat halfLength, vFloat radius)
+{
+	if (!(radius > 0.0f) || !(halfLength >= 0.0f)) return PX_SHAPE_BOUND;
+
+	PXShape shape;
+	vZeroMemory(&shape, sizeof(shape));
+	shape.type       = PX_SHAPE_TYPE_CAPSULE;
+	shape.vertCount  = 2;
+	shape.radius     = radius;
+	shape.verts[0]   = vPXCreateVect(-halfLength, 0.0f);
+	shape.verts[1]   = vPXCreateVect(halfLength, 0.0f);
+	shape.normals[0] = vPXCreateVect(0.0f, 1.0f);
+	shape.bound      = vGCreateRect(-halfLength - radius, halfLength + radius,
+		-radius, radius);
+	return PXShapeAdd(world, &shape);
+}
+
+VPHYSAPI vPXShapeID vPXWorldCreatePolygonShape(vPPXWorld world, vPVect verts,
+	vUI32 count)
+{
+	if (verts == NULL || count < 3 || count > PX_SHAPE_VERTS_MAX)
+	{
+		vPXWorldDebugLogFormatted(world, "Polygon shapes need 3 to %d verts\n",
+			PX_SHAPE_VERTS_MAX);
+		return PX_SHAPE_BOUND;
+	}
+
+	PXShape shape;
+	vZeroMemory(&shape, sizeof(shape));
+	shape.type      = PX_SHAPE_TYPE_POLYGON;
+	shape.vertCount = (vUI8)count;
+
+	/* store counter clockwise, whichever winding was given */
+	vFloat area = 0.0f;
+	for (vUI32 i = 0; i < count; i++)
+		area += PXShapeCross(verts[0], verts[i], verts[(i + 1) % count]);
+	for (vUI32 i = 0; i < count; i++)
+		shape.verts[i] = (area >= 0.0f) ? verts[i] : verts[count - 1 - i];
+
+	/* every corner must turn left, which also rejects	*/
+	/* repeated and collinear verts						*/
+	for (vUI32 i = 0; i < count; i++)
+	{
+		if (PXShapeCross(shape.verts[i], shape.verts[(i + 1) % count],
+			shape.verts[(i + 2) % count]) > 0.0f) continue;
+
+		vPXWorldDebugLog(world, "Polygon shape is not strictly convex\n");
+		return PX_SHAPE_BOUND;
+	}
+
+	/* outward edge normals and local bounds */
+	vFloat minX = shape.verts[0].x, maxX = minX;
+	vFloat minY = shape.verts[0].y, maxY = minY;
+	for (vUI32 i = 0; i < count; i++)
+	{
+		vVect a = shape.verts[i];
+		vVect b = shape.verts[(i + 1) % count];
+		vVect normal = vPXCreateVect(b.y - a.y, a.x - b.x);
+		vPXVectorNormalize(&normal);
+		shape.normals[i] = normal;
+
+		minX = min(minX, a.x); maxX = max(maxX, a.x);
+		minY = min(minY, a.y); maxY = max(maxY, a.y);
+	}
+	shape.bound = vGCreateRect(minX, maxX, minY, maxY);
+	return PXShapeAdd(world, &shape);
+}
+
+VPHYSAPI vUI8 vPXWorldGetShapeType(vPPXWorld world, vPXShapeID shape)
+{
+	vPXWorldLock(world);
+	vUI8 type = PXShapeLookup(world, shape)->type;
+	vPXWorldUnlock(world);
+	return type;
+}
+
+
+/* ========== BODY SHAPES						==========	*/
+VPHYSAPI vBOOL vPXSetPhysicsObjectShape(vPPhysical pObj, vPXShapeID shape)
+{
+	vPPXWorld world = pObj->world;
+	if (world == NULL) return FALSE;
+
+	/* picked up from the view on the next tick */
+	vPXWorldLock(world);
+	vBOOL valid = shape < world->bodies.shapeCount;
+	if (valid)
+	{
+		pObj->shape = shape;
+		vPXTouchPhysicsObject(pObj);
+	}
+	vPXWorldUnlock(world);
+	return valid;
+}
+
+VPHYSAPI vPXShapeID vPXGetPhysicsObjectShape(vPPhysical pObj)
+{
+	return pObj->shape;
+}
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI vPXShapeID vPXCreateCircleShape(vFloat radius)
+{
+	return vPXWorldCreateCircleShape(&_vphys, radius);
+}
+
+VPHYSAPI vPXShapeID vPXCreateCapsuleShape(vFloat halfLength, vFloat radius)
+{
+	return vPXWorldCreateCapsuleShape(&_vphys, halfLength, radius);
+}
+
+VPHYSAPI vPXShapeID vPXCreatePolygonShape(vPVect verts, vUI32 count)
+{
+	return vPXWorldCreatePolygonShape(&_vphys, verts, count);
+}
+
+VPHYSAPI vUI8 vPXGetShapeType(vPXShapeID shape)
+{
+	return vPXWorldGetShapeType(&_vphys, shape);
+}
+
+
+/* ========== SHAPE TABLE						==========	*/
+void PXShapeTableInit(vPPXWorld world)
+{
+	/* entry 0 is a box sized by each body's bound */
+	PXShape bound = __boundShape;
+	PXShapeClaim(world, &bound);
+}
+
+void PXShapeTableFree(vPPXWorld world)
+{
+	PPXBodyStore store = &world->bodies;
+	vFree(store->shapes);
+	store->shapes        = NULL;
+	store->shapeCount    = 0;
+	store->shapeCapacity = 0;
+}
+
+void PXShapeTableReserve(vPPXWorld world, vUI32 count)
+{
+	PPXBodyStore store = &world->bodies;
+	if (store->shapeCapacity >= count) return;
+
+	vUI32 newCapacity = max(PX_SHAPE_TABLE_CAPACITY_MIN, store->shapeCapacity);
+	while (newCapacity < count) newCapacity <<= 1;
+
+	PPXShape newShapes = vAllocZeroed(sizeof(PXShape) * newCapacity);
+	if (store->shapes != NULL)
+		vMemCopy(newShapes, store->shapes, sizeof(PXShape) * store->shapeCount);
+	vFree(store->shapes);
+	store->shapes        = newShapes;
+	store->shapeCapacity = newCapacity;
+}
+
+PPXShape PXShapeLookup(vPPXWorld world, vPXShapeID shape)
+{
+	if (world == NULL || shape >= world->bodies.shapeCount) return &__boundShape;
+	return world->bodies.shapes + shape;
+}
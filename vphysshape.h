@@ -0,0 +1,51 @@
+/* ========== <vphysshape.h>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Collision shapes shared between bodies.					*/
+/* Shapes are kept in a per-world table with their edge		*/
+/* normals precomputed in local space, so a tick only has	*/
+/* to rotate them. Entry PX_SHAPE_BOUND stands for each		*/
+/* body's own bound rectangle.								*/
+
+#ifndef _VPHYS_SHAPE_INCLUDE_
+#define _VPHYS_SHAPE_INCLUDE_
+
+/* ========== INCLUDES							==========	*/
+#include "vphysdefs.h"
+
+
+/* ========== SHAPE CREATION					==========	*/
+/* shapes live as long as the world and may be used by any	*/
+/* number of its bodies. each returns PX_SHAPE_BOUND if the	*/
+/* shape is invalid or the table is full					*/
+VPHYSAPI vPXShapeID vPXWorldCreateCircleShape(vPPXWorld world, vFloat radius);
+/* capsules lie along the local x axis						*/
+VPHYSAPI vPXShapeID vPXWorldCreateCapsuleShape(vPPXWorld world,
+	vFloat halfLength, vFloat radius);
+/* convex, either winding, 3 to PX_SHAPE_VERTS_MAX verts	*/
+VPHYSAPI vPXShapeID vPXWorldCreatePolygonShape(vPPXWorld world, vPVect verts,
+	vUI32 count);
+VPHYSAPI vUI8 vPXWorldGetShapeType(vPPXWorld world, vPXShapeID shape);
+
+
+/* ========== BODY SHAPES						==========	*/
+/* a body collides as its shape in place of its bound. the	*/
+/* shape's bounding rect is what partitions, queries and	*/
+/* particles see of it										*/
+VPHYSAPI vBOOL      vPXSetPhysicsObjectShape(vPPhysical pObj, vPXShapeID shape);
+VPHYSAPI vPXShapeID vPXGetPhysicsObjectShape(vPPhysical pObj);
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI vPXShapeID vPXCreateCircleShape(vFloat radius);
+VPHYSAPI vPXShapeID vPXCreateCapsuleShape(vFloat halfLength, vFloat radius);
+VPHYSAPI vPXShapeID vPXCreatePolygonShape(vPVect verts, vUI32 count);
+VPHYSAPI vUI8       vPXGetShapeType(vPXShapeID shape);
+
+
+/* ========== SHAPE TABLE						==========	*/
+void     PXShapeTableInit(vPPXWorld world);
+void     PXShapeTableFree(vPPXWorld world);
+void     PXShapeTableReserve(vPPXWorld world, vUI32 count);
+PPXShape PXShapeLookup(vPPXWorld world, vPXShapeID shape);
+
+#endif
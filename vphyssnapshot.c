@@ -0,0 +1,403 @@
+/* ========== <vphyssnapshot.c>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Binary world snapshots for checkpointing and forking.	*/
+/* Layout: PXSnapshotHeader, the section table, then each	*/
+/* section as one packed array in body order, aligned to	*/
+/* PX_SNAPSHOT_ALIGN. Sections are found by id, so a		*/
+/* loader ignores sections it does not know about.			*/
+
+
+/* ========== INCLUDES							==========	*/
+#include "vphyssnapshot.h"
+#include "vphyscore.h"
+#include "vphysthread.h"
+#include "vbodystore.h"
+#include "vphysshape.h"
+#include "vphysstream.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+
+/* ========== SECTION TABLE						==========	*/
+/* store array and element size of every section, indexed	*/
+/* by section id. properties are built from the views		*/
+typedef struct PXSnapshotField
+{
+	SIZE_T offset;	/* offset of array pointer in PXBodyStore	*/
+	SIZE_T size;	/* element size								*/
+} PXSnapshotField;
+
+#define PXSNAPSHOTFIELD(name, type) { offsetof(PXBodyStore, name), sizeof(type) }
+
+static const PXSnapshotField __snapshotFields[PX_SNAPSHOT_SECTION_COUNT] =
+{
+	PXSNAPSHOTFIELD(slots,				 PXHandleSlot),
+	{ 0, sizeof(vUI8) },
+	PXSNAPSHOTFIELD(handle,				 vPXHandle),
+	PXSNAPSHOTFIELD(position,			 vVect),
+	PXSNAPSHOTFIELD(rotation,			 vFloat),
+	PXSNAPSHOTFIELD(scale,				 vFloat),
+	PXSNAPSHOTFIELD(velocity,			 vVect),
+	PXSNAPSHOTFIELD(acceleration,		 vVect),
+	PXSNAPSHOTFIELD(angularVelocity,	 vFloat),
+	PXSNAPSHOTFIELD(angularAcceleration, vFloat),
+	PXSNAPSHOTFIELD(mass,				 vFloat),
+	PXSNAPSHOTFIELD(drag,				 vFloat),
+	PXSNAPSHOTFIELD(friction,			 vFloat),
+	PXSNAPSHOTFIELD(bound,				 vGRect),
+	PXSNAPSHOTFIELD(collideLayer,		 vUI8),
+	PXSNAPSHOTFIELD(flags,				 vUI8),
+	PXSNAPSHOTFIELD(age,				 vUI64),
+	PXSNAPSHOTFIELD(anticipatedPos,		 vVect),
+	PXSNAPSHOTFIELD(worldBound,			 vPXWorldBoundMesh),
+	PXSNAPSHOTFIELD(shape,				 vPXShapeID),
+	PXSNAPSHOTFIELD(shapes,				 PXShape),
+	PXSNAPSHOTFIELD(lastStepTick,		 vUI64),
+	PXSNAPSHOTFIELD(fieldLayer,			 vUI8),
+};
+
+static vUI8** PXSnapshotFieldArray(PPXBodyStore store, vUI32 section)
+{
+	return (vUI8**)((vUI8*)store + __snapshotFields[section].offset);
+}
+
+static vUI32 PXSnapshotSectionCount(PPXSnapshotHeader header, vUI32 section)
+{
+	if (section == PX_SNAPSHOT_SECTION_SLOTS)  return header->slotCount;
+	if (section == PX_SNAPSHOT_SECTION_SHAPES) return header->shapeCount;
+	return header->bodyCount;
+}
+
+
+/* ========== HELPERS							==========	*/
+static vUI64 PXSnapshotAlign(vUI64 offset)
+{
+	return (offset + PX_SNAPSHOT_ALIGN - 1) & ~(vUI64)(PX_SNAPSHOT_ALIGN - 1);
+}
+
+static vUI64 PXSnapshotPad(FILE* file, vUI64 written, vUI64 target)
+{
+	static const vUI8 zeros[PX_SNAPSHOT_ALIGN];
+	fwrite(zeros, 1, target - written, file);
+	return target;
+}
+
+static vUI8 PXSnapshotBodyProperties(vPPhysical phys)
+{
+	vUI8 properties = 0;
+	if (phys->properties.staticPosition) properties |= PX_SNAPSHOT_STATIC_POSITION;
+	if (phys->properties.staticRotation) properties |= PX_SNAPSHOT_STATIC_ROTATION;
+	return properties;
+}
+
+static const vUI8* PXSnapshotFindSection(const vUI8* data,
+	PPXSnapshotHeader header, vUI32 section)
+{
+	PPXSnapshotSection table = (PPXSnapshotSection)(data + sizeof(PXSnapshotHeader));
+	vUI64 required = (vUI64)__snapshotFields[section].size *
+		PXSnapshotSectionCount(header, section);
+
+	for (vUI32 i = 0; i < header->sectionCount; i++)
+	{
+		if (table[i].id != section) continue;
+
+		/* reject sections that do not match this build's layout */
+		if (table[i].elementSize != __snapshotFields[section].size) return NULL;
+		if (table[i].size < required) return NULL;
+		if (table[i].offset + table[i].size > header->fileSize) return NULL;
+		return data + table[i].offset;
+	}
+	return NULL;
+}
+
+static vBOOL PXSnapshotValidateHeader(PPXSnapshotHeader header, vUI64 size)
+{
+	if (size < sizeof(PXSnapshotHeader)) return FALSE;
+	if (header->magic != PX_SNAPSHOT_MAGIC) return FALSE;
+	if (header->version != PX_SNAPSHOT_VERSION) return FALSE;
+	if (header->fileSize != size) return FALSE;
+	if (header->headerSize > size) return FALSE;
+	if (sizeof(PXSnapshotHeader) + sizeof(PXSnapshotSection) *
+		(vUI64)header->sectionCount > header->headerSize) return FALSE;
+	if (header->bodyCount > header->slotCount) return FALSE;
+	if (header->shapeCount == 0 || header->shapeCount > PX_SHAPE_TABLE_MAX)
+		return FALSE;
+	return TRUE;
+}
+
+static vBOOL PXSnapshotRestore(vPPXWorld world, const vUI8* data, vUI64 size)
+{
+	PPXSnapshotHeader header = (PPXSnapshotHeader)data;
+	if (PXSnapshotValidateHeader(header, size) == FALSE)
+	{
+		vPXWorldDebugLog(world, "Snapshot is not a valid snapshot of this version\n");
+		return FALSE;
+	}
+
+	/* find and check every section before touching the world */
+	const vUI8* sections[PX_SNAPSHOT_SECTION_COUNT];
+	for (vUI32 section = 0; section < PX_SNAPSHOT_SECTION_COUNT; section++)
+	{
+		sections[section] = PXSnapshotFindSection(data, header, section);
+		if (sections[section] != NULL) continue;
+
+		vPXWorldDebugLogFormatted(world, "Snapshot section %d is missing or invalid\n",
+			section);
+		return FALSE;
+	}
+
+	const PXHandleSlot* slots = (const PXHandleSlot*)sections[PX_SNAPSHOT_SECTION_SLOTS];
+	for (vUI32 slot = 0; slot < header->slotCount; slot++)
+	{
+		/* saves bring paged bodies back, so none are paged here */
+		if (slots[slot].inUse == TRUE && slots[slot].body < header->bodyCount)
+			continue;
+		if (!slots[slot].inUse && (slots[slot].body < header->slotCount ||
+			slots[slot].body == PX_BODY_NONE)) continue;
+
+		vPXWorldDebugLog(world, "Snapshot handle table is corrupt\n");
+		return FALSE;
+	}
+
+	/* every shape must be one this build can collide */
+	const PXShape* shapes = (const PXShape*)sections[PX_SNAPSHOT_SECTION_SHAPES];
+	for (vUI32 shape = 0; shape < header->shapeCount; shape++)
+	{
+		if (shapes[shape].type < PX_SHAPE_TYPE_COUNT &&
+			shapes[shape].vertCount <= PX_SHAPE_VERTS_MAX) continue;
+
+		vPXWorldDebugLog(world, "Snapshot shape table is corrupt\n");
+		return FALSE;
+	}
+
+	const vPXShapeID* bodyShapes =
+		(const vPXShapeID*)sections[PX_SNAPSHOT_SECTION_SHAPE];
+	for (vUI32 body = 0; body < header->bodyCount; body++)
+	{
+		if (bodyShapes[body] < header->shapeCount) continue;
+
+		vPXWorldDebugLog(world, "Snapshot body shapes are corrupt\n");
+		return FALSE;
+	}
+
+	PXBodyStoreCompact(world);
+	if (world->bodies.count != 0 || PXStreamAnyPaged(world) == TRUE)
+	{
+		vPXWorldDebugLog(world, "Snapshots can only be loaded into an empty world\n");
+		return FALSE;
+	}
+
+	/* bulk copy every section into the store */
+	PPXBodyStore store = &world->bodies;
+	vUI32 bodyCount = header->bodyCount;
+	PXBodyStoreReserve(world, bodyCount, header->slotCount);
+
+	/* the snapshot's shape table replaces the world's */
+	PXShapeTableReserve(world, header->shapeCount);
+
+	for (vUI32 section = 0; section < PX_SNAPSHOT_SECTION_COUNT; section++)
+	{
+		if (section == PX_SNAPSHOT_SECTION_PROPERTIES) continue;
+		SIZE_T bytes = __snapshotFields[section].size *
+			PXSnapshotSectionCount(header, section);
+		if (bytes > 0) vMemCopy(*PXSnapshotFieldArray(store, section),
+			sections[section], bytes);
+	}
+
+	store->count      = bodyCount;
+	store->removed    = 0;
+	store->slotCount  = header->slotCount;
+	store->freeSlot   = header->freeSlot;
+	store->shapeCount = header->shapeCount;
+
+	if (bodyCount > 0)
+	{
+		vZeroMemory(store->updateFunc, sizeof(vPXPFPHYSICALUPDATEFUNC) * bodyCount);
+		vZeroMemory(store->drawTick, sizeof(vUI64) * bodyCount);
+		vZeroMemory(store->queryTick, sizeof(vUI64) * bodyCount);
+		vZeroMemory(store->querySlot, sizeof(vUI32) * bodyCount);
+		vZeroMemory(store->viewSync, sizeof(vUI8) * bodyCount);
+
+		/* shapes may have changed under the same IDs */
+		memset(store->boundDirty, TRUE, bodyCount);
+		memset(store->hull, 0xFF, sizeof(vUI32) * bodyCount);
+	}
+
+	/* restored bodies have no object, so their views are one block */
+	const vUI8* properties = sections[PX_SNAPSHOT_SECTION_PROPERTIES];
+	vPPhysical views = PXBodyStoreAllocateViews(world, bodyCount);
+	for (vUI32 body = 0; body < bodyCount; body++)
+	{
+		vPPhysical phys = views + body;
+		phys->world = world;
+		phys->properties.staticPosition =
+			(properties[body] & PX_SNAPSHOT_STATIC_POSITION) != 0;
+		phys->properties.staticRotation =
+			(properties[body] & PX_SNAPSHOT_STATIC_ROTATION) != 0;
+
+		store->physical[body] = phys;
+		PXBodyStoreFillView(world, body);
+	}
+
+	world->partitionSize    = header->partitionSize;
+	world->random           = header->random;
+	world->stats.tickCount  = header->tickCount;
+	world->deterministic    = header->deterministic;
+	world->tickInterval     = max(1, header->tickInterval);
+	world->tickClock        = 0;
+	world->tickClockLast    = 0;
+	world->stats.stateHash  = world->deterministic ? PXComputeStateHash(world) : 0;
+
+	vPXWorldDebugLogFormatted(world, "Loaded snapshot of %d bodies at tick %llu\n",
+		bodyCount, header->tickCount);
+	return TRUE;
+}
+
+
+/* ========== SNAPSHOTS							==========	*/
+VPHYSAPI vBOOL vPXWorldSaveSnapshot(vPPXWorld world, vPCHAR filePath)
+{
+	FILE* file = fopen(filePath, "wb");
+	if (file == NULL)
+	{
+		vPXWorldDebugLogFormatted(world, "Could not open snapshot file %s\n",
+			filePath);
+		return FALSE;
+	}
+	setvbuf(file, NULL, _IOFBF, PX_SNAPSHOT_WRITE_BUFFER);
+
+	vPXWorldLock(world);
+
+	/* paged bodies have no place in the store's sections, and	*/
+	/* their page file extents mean nothing to another world	*/
+	PXStreamLoadAll(world);
+
+	/* pack the store and pick up edits made through views */
+	PXBodyStoreCompact(world);
+	PXBodyStoreGatherTouched(world);
+	PPXBodyStore store = &world->bodies;
+
+	PXSnapshotHeader header;
+	vZeroMemory(&header, sizeof(header));
+	header.magic         = PX_SNAPSHOT_MAGIC;
+	header.version       = PX_SNAPSHOT_VERSION;
+	header.sectionCount  = PX_SNAPSHOT_SECTION_COUNT;
+	header.tickCount     = world->stats.tickCount;
+	header.tickInterval  = world->tickInterval;
+	header.bodyCount     = store->count;
+	header.slotCount     = store->slotCount;
+	header.freeSlot      = store->freeSlot;
+	header.shapeCount    = store->shapeCount;
+	header.random        = world->random;
+	header.partitionSize = world->partitionSize;
+	header.deterministic = world->deterministic;
+
+	/* lay out every section up front so the file is written */
+	/* front to back in one pass								 */
+	PXSnapshotSection sections[PX_SNAPSHOT_SECTION_COUNT];
+	header.headerSize = sizeof(header) + sizeof(sections);
+	vUI64 offset = PXSnapshotAlign(header.headerSize);
+	for (vUI32 section = 0; section < PX_SNAPSHOT_SECTION_COUNT; section++)
+	{
+		sections[section].id          = section;
+		sections[section].elementSize = (vUI32)__snapshotFields[section].size;
+		sections[section].offset      = offset;
+		sections[section].size        = __snapshotFields[section].size *
+			(vUI64)PXSnapshotSectionCount(&header, section);
+		offset = PXSnapshotAlign(offset + sections[section].size);
+	}
+	header.fileSize = offset;
+
+	fwrite(&header, sizeof(header), 1, file);
+	fwrite(sections, sizeof(sections), 1, file);
+	vUI64 written = header.headerSize;
+
+	for (vUI32 section = 0; section < PX_SNAPSHOT_SECTION_COUNT; section++)
+	{
+		written = PXSnapshotPad(file, written, sections[section].offset);
+
+		if (section == PX_SNAPSHOT_SECTION_PROPERTIES)
+		{
+			/* view-only properties, staged a chunk at a time */
+			vUI8 chunk[BUFF_LARGE];
+			for (vUI32 body = 0; body < store->count; body += BUFF_LARGE)
+			{
+				vUI32 chunkCount = min(BUFF_LARGE, store->count - body);
+				for (vUI32 i = 0; i < chunkCount; i++)
+					chunk[i] = PXSnapshotBodyProperties(store->physical[body + i]);
+				fwrite(chunk, 1, chunkCount, file);
+			}
+		}
+		else if (sections[section].size > 0)
+		{
+			fwrite(*PXSnapshotFieldArray(store, section), 1,
+				sections[section].size, file);
+		}
+		written += sections[section].size;
+	}
+	PXSnapshotPad(file, written, header.fileSize);
+
+	vPXWorldUnlock(world);
+
+	vBOOL result = (ferror(file) == 0);
+	if (fclose(file) != 0) result = FALSE;
+	if (result == FALSE)
+		vPXWorldDebugLogFormatted(world, "Failed writing snapshot %s\n", filePath);
+	return result;
+}
+
+VPHYSAPI vBOOL vPXWorldLoadSnapshot(vPPXWorld world, vPCHAR filePath)
+{
+	HANDLE file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		vPXWorldDebugLogFormatted(world, "Could not open snapshot file %s\n",
+			filePath);
+		return FALSE;
+	}
+
+	/* map the whole file, sections are copied straight out of it */
+	LARGE_INTEGER fileSize;
+	fileSize.QuadPart = 0;
+	GetFileSizeEx(file, &fileSize);
+
+	HANDLE mapping = NULL;
+	const vUI8* view = NULL;
+	if (fileSize.QuadPart >= (vI64)sizeof(PXSnapshotHeader))
+	{
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping != NULL) view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	}
+
+	vBOOL result = FALSE;
+	if (view != NULL)
+	{
+		vPXWorldLock(world);
+		result = PXSnapshotRestore(world, view, (vUI64)fileSize.QuadPart);
+		vPXWorldUnlock(world);
+		UnmapViewOfFile(view);
+	}
+	else
+	{
+		vPXWorldDebugLogFormatted(world, "Could not map snapshot file %s\n",
+			filePath);
+	}
+
+	if (mapping != NULL) CloseHandle(mapping);
+	CloseHandle(file);
+	return result;
+}
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI vBOOL vPXSaveSnapshot(vPCHAR filePath)
+{
+	return vPXWorldSaveSnapshot(&_vphys, filePath);
+}
+
+VPHYSAPI vBOOL vPXLoadSnapshot(vPCHAR filePath)
+{
+	return vPXWorldLoadSnapshot(&_vphys, filePath);
+}
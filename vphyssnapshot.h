@@ -0,0 +1,35 @@
+/* ========== <vphyssnapshot.h>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Binary world snapshots for checkpointing and forking.	*/
+/* A snapshot holds every body's state and properties, the	*/
+/* handle table, partition size, tick count and random		*/
+/* stream. It is written as one sequential stream and		*/
+/* loaded by mapping the file and copying each section		*/
+/* straight into the body store.							*/
+/*															*/
+/* Restored bodies are not attached to any vObject; their	*/
+/* views live in one block owned by the world and are		*/
+/* destroyed with vPXWorldDestroyBody, see vphyscore.h.		*/
+
+#ifndef _VPHYS_SNAPSHOT_INCLUDE_
+#define _VPHYS_SNAPSHOT_INCLUDE_
+
+/* ========== INCLUDES							==========	*/
+#include "vphysdefs.h"
+
+
+/* ========== SNAPSHOTS							==========	*/
+/* regions paged out by streaming are read back first, and	*/
+/* paged out again on the next tick							*/
+VPHYSAPI vBOOL vPXWorldSaveSnapshot(vPPXWorld world, vPCHAR filePath);
+/* the world must hold no bodies; handles saved with the	*/
+/* snapshot resolve to the same bodies after loading, and	*/
+/* its shape table replaces the world's						*/
+VPHYSAPI vBOOL vPXWorldLoadSnapshot(vPPXWorld world, vPCHAR filePath);
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI vBOOL vPXSaveSnapshot(vPCHAR filePath);
+VPHYSAPI vBOOL vPXLoadSnapshot(vPCHAR filePath);
+
+#endif
@@ -0,0 +1,679 @@
+/* ========== <vphysstream.c>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Region streaming for very large worlds.					*/
+/* Each region owns one extent of the page file, sized to a	*/
+/* power of two records and reused while its bodies fit, so	*/
+/* the file only grows when a region does. Writes happen on	*/
+/* the tick thread and land in the OS file cache; reads		*/
+/* may go to disk, so they are queued as jobs for the		*/
+/* loader thread, which touches nothing but its job and the	*/
+/* file. Deterministic worlds wait for their reads, so the	*/
+/* tick a region returns on does not depend on the disk.	*/
+
+
+/* ========== INCLUDES							==========	*/
+#include "vphysstream.h"
+#include "vphyscore.h"
+#include "vspacepart.h"
+#include "vbodystore.h"
+#include "vphystrace.h"
+#include <math.h>
+
+
+/* ========== HELPERS							==========	*/
+static vBOOL PXStreamBodyPinned(vPPXWorld world, vUI32 body)
+{
+	/* objects and callbacks cannot be written to disk */
+	vPPhysical phys = world->bodies.physical[body];
+	return phys->object != NULL || phys->updateFunc != NULL ||
+		phys->collisionFunc != NULL;
+}
+
+static vFloat PXStreamRegionDistance(PPXStreamState stream, PPXStreamRegion region,
+	vVect point)
+{
+	/* distance from point to the region's rectangle */
+	vFloat left   = region->x * stream->regionSize;
+	vFloat bottom = region->y * stream->regionSize;
+	vFloat dx = max(0.0f, max(left - point.x,
+		point.x - (left + stream->regionSize)));
+	vFloat dy = max(0.0f, max(bottom - point.y,
+		point.y - (bottom + stream->regionSize)));
+	return sqrtf(dx * dx + dy * dy);
+}
+
+static vBOOL PXStreamRegionNear(vPPXWorld world, PPXStreamRegion region,
+	vFloat margin)
+{
+	PPXStreamState stream = &world->stream;
+	for (vUI32 i = 0; i < PX_INTERESTS_MAX; i++)
+	{
+		PPXInterest interest = world->interests + i;
+		if (interest->inUse == FALSE) continue;
+		if (PXStreamRegionDistance(stream, region, interest->position) <=
+			interest->radius + margin) return TRUE;
+	}
+	return FALSE;
+}
+
+static vUI32 PXStreamRegionOf(PPXStreamState stream, vVect position)
+{
+	vI32 x = (vI32)floorf(position.x / stream->regionSize);
+	vI32 y = (vI32)floorf(position.y / stream->regionSize);
+
+	vUI32 index = PXCellMapFind(&stream->regionMap, x, y);
+	if (index != CELLMAP_EMPTY) return index;
+
+	/* first body seen here, regions start out resident */
+	if (stream->regionCount == stream->regionCapacity)
+	{
+		vUI32 newCap = max(STREAM_REGION_CAPACITY_MIN,
+			stream->regionCapacity << 1);
+		PPXStreamRegion newRegions = vAlloc(sizeof(PXStreamRegion) * newCap);
+		if (stream->regions != NULL)
+		{
+			vMemCopy(newRegions, stream->regions,
+				sizeof(PXStreamRegion) * stream->regionCount);
+		}
+		vFree(stream->regions);
+		stream->regions = newRegions;
+		stream->regionCapacity = newCap;
+	}
+
+	index = stream->regionCount++;
+	PPXStreamRegion region = stream->regions + index;
+	vZeroMemory(region, sizeof(PXStreamRegion));
+	region->x = x;
+	region->y = y;
+	region->state = PX_REGION_RESIDENT;
+	PXCellMapInsert(&stream->regionMap, x, y, index);
+	return index;
+}
+
+static void PXStreamReserveScratch(PPXStreamState stream, vUI32 bodies)
+{
+	if (stream->scratchCapacity >= bodies) return;
+
+	vUI32 newCap = max(STREAM_SCRATCH_MIN, stream->scratchCapacity);
+	while (newCap < bodies) newCap <<= 1;
+
+	/* holds nothing between checks, no copy needed */
+	vFree(stream->bodyRegion);
+	stream->bodyRegion = vAlloc(sizeof(vUI32) * newCap);
+	stream->scratchCapacity = newCap;
+}
+
+static void PXStreamReserveRecords(PPXStreamState stream, vUI32 records)
+{
+	if (stream->recordCapacity >= records) return;
+
+	vUI32 newCap = max(STREAM_SCRATCH_MIN, stream->recordCapacity);
+	while (newCap < records) newCap <<= 1;
+
+	vFree(stream->records);
+	stream->records = vAlloc(sizeof(PXPagedBody) * newCap);
+	stream->recordCapacity = newCap;
+}
+
+
+/* ========== RECORDS							==========	*/
+static void PXStreamRecordBody(vPPXWorld world, vUI32 body,
+	PPXPagedBody record)
+{
+	PPXBodyStore store = &world->bodies;
+	vPPhysical phys = store->physical[body];
+
+	vZeroMemory(record, sizeof(PXPagedBody));
+	record->handle              = store->handle[body];
+	record->position            = store->position[body];
+	record->rotation            = store->rotation[body];
+	record->scale               = store->scale[body];
+	record->velocity            = store->velocity[body];
+	record->acceleration        = store->acceleration[body];
+	record->angularVelocity     = store->angularVelocity[body];
+	record->angularAcceleration = store->angularAcceleration[body];
+	record->mass                = store->mass[body];
+	record->drag                = store->drag[body];
+	record->friction            = store->friction[body];
+	record->bound               = store->bound[body];
+	record->age                 = store->age[body];
+	record->shape               = store->shape[body];
+	record->collideLayer        = store->collideLayer[body];
+	record->fieldLayer          = store->fieldLayer[body];
+	record->flags               = store->flags[body];
+	if (phys->properties.staticPosition)
+		record->properties |= PX_SNAPSHOT_STATIC_POSITION;
+	if (phys->properties.staticRotation)
+		record->properties |= PX_SNAPSHOT_STATIC_ROTATION;
+}
+
+static void PXStreamPageBody(vPPXWorld world, vUI32 body)
+{
+	/* the view goes back to the pool, the handle stays reserved */
+	PXBodyStoreReleaseView(world, world->bodies.physical[body]);
+	PXBodyStorePage(world, body);
+}
+
+static void PXStreamRestoreBody(vPPXWorld world, PPXPagedBody record)
+{
+	vPPhysical phys = PXBodyStoreAcquireView(world);
+	phys->transform.position  = record->position;
+	phys->transform.rotation  = record->rotation;
+	phys->transform.scale     = record->scale;
+	phys->velocity            = record->velocity;
+	phys->acceleration        = record->acceleration;
+	phys->angularVelocity     = record->angularVelocity;
+	phys->angularAcceleration = record->angularAcceleration;
+	phys->mass                = record->mass;
+	phys->drag                = record->drag;
+	phys->friction            = record->friction;
+	phys->bound               = record->bound;
+	phys->age                 = record->age;
+	phys->shape               = record->shape;
+	phys->properties.collideLayer        = record->collideLayer;
+	phys->properties.fieldLayer          = record->fieldLayer;
+	phys->properties.isActive            =
+		(record->flags & PX_BODY_ACTIVE) != 0;
+	phys->properties.noPartitionOptimize =
+		(record->flags & PX_BODY_NO_PARTITION_OPTIMIZE) != 0;
+	phys->properties.isSensor            =
+		(record->flags & PX_BODY_SENSOR) != 0;
+	phys->properties.staticPosition      =
+		(record->properties & PX_SNAPSHOT_STATIC_POSITION) != 0;
+	phys->properties.staticRotation      =
+		(record->properties & PX_SNAPSHOT_STATIC_ROTATION) != 0;
+
+	if (PXBodyStoreUnpage(world, phys, record->handle) == PX_BODY_NONE)
+	{
+		vPXWorldDebugLog(world, "Paged body lost its handle\n");
+		PXBodyStoreReleaseView(world, phys);
+	}
+}
+
+static void PXStreamHandoff(PPXStreamRegion region, PPXPagedBody record)
+{
+	if (region->handoffCount == region->handoffCapacity)
+	{
+		vUI32 newCap = max(STREAM_SCRATCH_MIN, region->handoffCapacity << 1);
+		PPXPagedBody newHandoff = vAlloc(sizeof(PXPagedBody) * newCap);
+		if (region->handoff != NULL)
+		{
+			vMemCopy(newHandoff, region->handoff,
+				sizeof(PXPagedBody) * region->handoffCount);
+		}
+		vFree(region->handoff);
+		region->handoff = newHandoff;
+		region->handoffCapacity = newCap;
+	}
+	region->handoff[region->handoffCount++] = *record;
+}
+
+
+/* ========== PAGE FILE							==========	*/
+static vBOOL PXStreamWriteRegion(vPPXWorld world, PPXStreamRegion region,
+	PPXPagedBody records)
+{
+	PPXStreamState stream = &world->stream;
+
+	/* outgrown extents are abandoned for a larger one at the end */
+	if (region->pageCount > region->pageCapacity)
+	{
+		vUI32 capacity = STREAM_SCRATCH_MIN;
+		while (capacity < region->pageCount) capacity <<= 1;
+		region->pageOffset   = stream->pageEnd;
+		region->pageCapacity = capacity;
+		stream->pageEnd += (vUI64)capacity * sizeof(PXPagedBody);
+	}
+	if (region->pageCount == 0) return TRUE;
+
+	EnterCriticalSection(&stream->fileLock);
+	vBOOL result =
+		_fseeki64(stream->pageFile, region->pageOffset, SEEK_SET) == 0 &&
+		fwrite(records, sizeof(PXPagedBody), region->pageCount,
+			stream->pageFile) == region->pageCount &&
+		fflush(stream->pageFile) == 0;
+	LeaveCriticalSection(&stream->fileLock);
+	return result;
+}
+
+static vBOOL PXStreamReadExtent(PPXStreamState stream, vUI64 offset,
+	vUI32 count, PPXPagedBody records)
+{
+	EnterCriticalSection(&stream->fileLock);
+	vBOOL result =
+		_fseeki64(stream->pageFile, offset, SEEK_SET) == 0 &&
+		fread(records, sizeof(PXPagedBody), count, stream->pageFile) == count;
+	LeaveCriticalSection(&stream->fileLock);
+	return result;
+}
+
+
+/* ========== LOADER THREAD						==========	*/
+static void PXStreamLoaderInit(vPWorker worker, vPTR workerData, vPTR input)
+{
+
+}
+
+static void PXStreamLoaderExit(vPWorker worker, vPTR workerData)
+{
+
+}
+
+static void PXStreamLoaderCycle(vPWorker worker, vPTR workerData)
+{
+	PPXStreamState stream = workerData;
+
+	for (vUI32 i = 0; i < PX_STREAM_JOBS_MAX; i++)
+	{
+		PPXStreamJob job = stream->jobs + i;
+		if (job->state != PX_STREAM_JOB_QUEUED) continue;
+
+		vBOOL result = PXStreamReadExtent(stream, job->offset, job->count,
+			job->records);
+		InterlockedExchange(&job->state,
+			result ? PX_STREAM_JOB_DONE : PX_STREAM_JOB_FAILED);
+	}
+}
+
+
+/* ========== LOADING							==========	*/
+static void PXStreamRestoreRegion(vPPXWorld world, vUI32 index,
+	PPXPagedBody records, vUI32 count)
+{
+	PPXStreamRegion region = world->stream.regions + index;
+
+	/* paged bodies first, then those that crossed in since */
+	for (vUI32 i = 0; i < count; i++)
+		PXStreamRestoreBody(world, records + i);
+	for (vUI32 i = 0; i < region->handoffCount; i++)
+		PXStreamRestoreBody(world, region->handoff + i);
+
+	region->handoffCount = 0;
+	region->pageCount    = 0;
+	region->state        = PX_REGION_RESIDENT;
+	world->stats.regionLoads++;
+}
+
+static void PXStreamQueueLoad(vPPXWorld world, vUI32 index)
+{
+	PPXStreamState stream = &world->stream;
+	PPXStreamRegion region = stream->regions + index;
+
+	/* nothing on disk, only handoffs to bring back */
+	if (region->pageCount == 0)
+	{
+		PXStreamRestoreRegion(world, index, NULL, 0);
+		return;
+	}
+
+	for (vUI32 i = 0; i < PX_STREAM_JOBS_MAX; i++)
+	{
+		PPXStreamJob job = stream->jobs + i;
+		if (job->state != PX_STREAM_JOB_FREE) continue;
+
+		job->region  = index;
+		job->offset  = region->pageOffset;
+		job->count   = region->pageCount;
+		job->records = vAlloc(sizeof(PXPagedBody) * region->pageCount);
+		region->state = PX_REGION_LOADING;
+		region->job   = i;
+		InterlockedExchange(&job->state, PX_STREAM_JOB_QUEUED);
+		return;
+	}
+
+	/* every job busy, the next check tries again */
+}
+
+static void PXStreamFinishLoads(vPPXWorld world, vBOOL wait)
+{
+	PPXStreamState stream = &world->stream;
+
+	for (vUI32 i = 0; i < PX_STREAM_JOBS_MAX; i++)
+	{
+		PPXStreamJob job = stream->jobs + i;
+		if (job->state == PX_STREAM_JOB_FREE) continue;
+
+		while (wait && job->state == PX_STREAM_JOB_QUEUED)
+			Sleep(0);
+
+		if (job->state == PX_STREAM_JOB_DONE)
+		{
+			PXStreamRestoreRegion(world, job->region, job->records,
+				job->count);
+		}
+		else if (job->state == PX_STREAM_JOB_FAILED)
+		{
+			vPXWorldDebugLogFormatted(world,
+				"Failed reading region [%d %d] from page file\n",
+				stream->regions[job->region].x,
+				stream->regions[job->region].y);
+			stream->regions[job->region].state = PX_REGION_PAGED;
+		}
+		else continue;
+
+		vFree(job->records);
+		job->records = NULL;
+		InterlockedExchange(&job->state, PX_STREAM_JOB_FREE);
+	}
+}
+
+
+/* ========== RESIDENCY CHECK					==========	*/
+static void PXStreamCheck(vPPXWorld world)
+{
+	PPXStreamState stream = &world->stream;
+	PPXBodyStore store = &world->bodies;
+
+	/* close holes and pick up view edits before reading bodies */
+	PXBodyStoreCompact(world);
+	PXBodyStoreGatherTouched(world);
+	PXStreamReserveScratch(stream, store->count);
+
+	for (vUI32 body = 0; body < store->count; body++)
+	{
+		stream->bodyRegion[body] = PXStreamBodyPinned(world, body) ?
+			PX_BODY_NONE : PXStreamRegionOf(stream, store->position[body]);
+	}
+
+	/* far resident regions are paged out. the margin keeps a		*/
+	/* region near an edge from being paged out and in again each	*/
+	/* check. loads wait until the bodies above are done with, as	*/
+	/* a load with nothing on disk lands in the store at once		*/
+	vFloat margin = stream->regionSize * PX_STREAM_EVICT_MARGIN;
+	for (vUI32 index = 0; index < stream->regionCount; index++)
+	{
+		PPXStreamRegion region = stream->regions + index;
+		region->evictCount = 0;
+		region->evictFirst = PX_BODY_NONE;
+
+		if (region->state == PX_REGION_RESIDENT &&
+			PXStreamRegionNear(world, region, margin) == FALSE)
+			region->evictFirst = 0;
+	}
+
+	/* count each outgoing region's bodies, then give each a range */
+	for (vUI32 body = 0; body < store->count; body++)
+	{
+		vUI32 index = stream->bodyRegion[body];
+		if (index == PX_BODY_NONE) continue;
+		if (stream->regions[index].evictFirst != PX_BODY_NONE)
+			stream->regions[index].evictCount++;
+	}
+
+	vUI32 records = 0;
+	for (vUI32 index = 0; index < stream->regionCount; index++)
+	{
+		PPXStreamRegion region = stream->regions + index;
+		if (region->evictFirst == PX_BODY_NONE) continue;
+		region->evictFirst = records;
+		region->pageCount  = region->evictCount;
+		records += region->evictCount;
+	}
+	PXStreamReserveRecords(stream, records);
+
+	/* page bodies out from the back, so a body swapped into a	*/
+	/* hole was already visited, and fill each range from its end	*/
+	/* so records keep body order									*/
+	for (vUI32 body = store->count; body-- > 0;)
+	{
+		vUI32 index = stream->bodyRegion[body];
+		if (index == PX_BODY_NONE) continue;
+		PPXStreamRegion region = stream->regions + index;
+
+		PXPagedBody record;
+		if (region->evictFirst != PX_BODY_NONE)
+		{
+			PXStreamRecordBody(world, body, stream->records +
+				region->evictFirst + --region->evictCount);
+		}
+		else if (region->state != PX_REGION_RESIDENT)
+		{
+			/* crossed into a paged region, it goes with the region */
+			PXStreamRecordBody(world, body, &record);
+			PXStreamHandoff(region, &record);
+		}
+		else continue;
+
+		PXStreamPageBody(world, body);
+	}
+
+	for (vUI32 index = 0; index < stream->regionCount; index++)
+	{
+		PPXStreamRegion region = stream->regions + index;
+		if (region->evictFirst == PX_BODY_NONE) continue;
+
+		if (PXStreamWriteRegion(world, region,
+			stream->records + region->evictFirst) == FALSE)
+		{
+			/* the bodies are gone from the store, keep them in memory */
+			vPXWorldDebugLogFormatted(world,
+				"Failed writing region [%d %d] to page file\n",
+				region->x, region->y);
+			for (vUI32 i = 0; i < region->pageCount; i++)
+				PXStreamHandoff(region, stream->records + region->evictFirst + i);
+			region->pageCount = 0;
+		}
+
+		region->state = PX_REGION_PAGED;
+		region->evictFirst = PX_BODY_NONE;
+		world->stats.regionEvictions++;
+	}
+
+	/* near paged regions are loaded. none just paged out is near */
+	for (vUI32 index = 0; index < stream->regionCount; index++)
+	{
+		PPXStreamRegion region = stream->regions + index;
+		if (region->state == PX_REGION_PAGED &&
+			PXStreamRegionNear(world, region, 0.0f) == TRUE)
+			PXStreamQueueLoad(world, index);
+	}
+}
+
+
+/* ========== STREAM STATE						==========	*/
+static void PXStreamRelease(vPPXWorld world)
+{
+	PPXStreamState stream = &world->stream;
+
+	vDestroyWorker(stream->loader);
+	for (vUI32 i = 0; i < PX_STREAM_JOBS_MAX; i++)
+	{
+		vFree(stream->jobs[i].records);
+		stream->jobs[i].records = NULL;
+		stream->jobs[i].state   = PX_STREAM_JOB_FREE;
+	}
+	for (vUI32 index = 0; index < stream->regionCount; index++)
+		vFree(stream->regions[index].handoff);
+
+	fclose(stream->pageFile);
+	DeleteCriticalSection(&stream->fileLock);
+	PXCellMapFree(&stream->regionMap);
+	vFree(stream->regions);
+	vFree(stream->bodyRegion);
+	vFree(stream->records);
+
+	vZeroMemory(stream, sizeof(PXStreamState));
+
+	world->stats.regionsPaged = 0;
+	world->stats.bodiesPaged  = 0;
+}
+
+void PXStreamLoadAll(vPPXWorld world)
+{
+	PPXStreamState stream = &world->stream;
+	if (stream->enabled == FALSE) return;
+
+	/* land reads in flight, then read the rest directly */
+	PXStreamFinishLoads(world, TRUE);
+	for (vUI32 index = 0; index < stream->regionCount; index++)
+	{
+		PPXStreamRegion region = stream->regions + index;
+		if (region->state == PX_REGION_RESIDENT) continue;
+
+		PPXPagedBody records = vAlloc(sizeof(PXPagedBody) *
+			max(1, region->pageCount));
+		if (PXStreamReadExtent(stream, region->pageOffset, region->pageCount,
+			records) == FALSE)
+		{
+			vPXWorldDebugLogFormatted(world,
+				"Failed reading region [%d %d] from page file\n",
+				region->x, region->y);
+			region->pageCount = 0;
+		}
+		PXStreamRestoreRegion(world, index, records, region->pageCount);
+		vFree(records);
+	}
+
+	/* anything still far goes back out on the next tick */
+	stream->nextCheck = world->stats.tickCount;
+}
+
+vBOOL PXStreamAnyPaged(vPPXWorld world)
+{
+	PPXStreamState stream = &world->stream;
+	if (stream->enabled == FALSE) return FALSE;
+
+	for (vUI32 index = 0; index < stream->regionCount; index++)
+	{
+		PPXStreamRegion region = stream->regions + index;
+		if (region->state != PX_REGION_RESIDENT &&
+			region->pageCount + region->handoffCount > 0) return TRUE;
+	}
+	return FALSE;
+}
+
+void PXStreamFree(vPPXWorld world)
+{
+	/* paged bodies go down with the world */
+	if (world->stream.enabled == TRUE) PXStreamRelease(world);
+}
+
+void PXStreamTick(vPPXWorld world)
+{
+	PPXStreamState stream = &world->stream;
+	world->stats.regionLoads     = 0;
+	world->stats.regionEvictions = 0;
+	if (stream->enabled == FALSE) return;
+
+	PXTRACE_SPAN_BEGIN(world, traceStart);
+
+	/* finished reads rejoin before anything else this tick */
+	PXStreamFinishLoads(world, world->deterministic);
+
+	if (world->stats.tickCount >= stream->nextCheck)
+	{
+		PXStreamCheck(world);
+		stream->nextCheck = world->stats.tickCount + PX_STREAM_INTERVAL;
+		if (world->deterministic == TRUE) PXStreamFinishLoads(world, TRUE);
+	}
+
+	vUI32 regionsPaged = 0, bodiesPaged = 0;
+	for (vUI32 index = 0; index < stream->regionCount; index++)
+	{
+		PPXStreamRegion region = stream->regions + index;
+		if (region->state == PX_REGION_RESIDENT) continue;
+		regionsPaged++;
+		bodiesPaged += region->pageCount + region->handoffCount;
+	}
+	world->stats.regionsPaged = regionsPaged;
+	world->stats.bodiesPaged  = bodiesPaged;
+
+	PXTRACE_SPAN_END(world, traceStart, PX_TRACE_STREAM,
+		world->stats.regionLoads, world->stats.regionEvictions);
+}
+
+
+/* ========== STREAMING							==========	*/
+VPHYSAPI vBOOL vPXWorldEnableStreaming(vPPXWorld world, vPCHAR pageFilePath,
+	vFloat regionSize)
+{
+	vPXWorldLock(world);
+	PPXStreamState stream = &world->stream;
+	if (stream->enabled == TRUE)
+	{
+		vPXWorldDebugLog(world, "Streaming is already enabled\n");
+		vPXWorldUnlock(world);
+		return FALSE;
+	}
+
+	FILE* file = fopen(pageFilePath, "w+b");
+	if (file == NULL)
+	{
+		vPXWorldDebugLogFormatted(world, "Could not open page file %s\n",
+			pageFilePath);
+		vPXWorldUnlock(world);
+		return FALSE;
+	}
+
+	stream->enabled    = TRUE;
+	stream->pageFile   = file;
+	stream->pageEnd    = 0;
+	stream->regionSize = (regionSize > 0.0f) ? regionSize : PX_REGION_SIZE_DEFAULT;
+	stream->nextCheck  = world->stats.tickCount;
+	PXCellMapInit(&stream->regionMap, 0);
+	InitializeCriticalSection(&stream->fileLock);
+	stream->loader = vCreateWorker("vPhysics Stream Loader",
+		PX_STREAM_LOADER_INTERVAL, PXStreamLoaderInit, PXStreamLoaderExit,
+		PXStreamLoaderCycle, stream, NULL);
+
+	vPXWorldUnlock(world);
+	return TRUE;
+}
+
+VPHYSAPI void vPXWorldDisableStreaming(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	PPXStreamState stream = &world->stream;
+	if (stream->enabled == FALSE)
+	{
+		vPXWorldUnlock(world);
+		return;
+	}
+
+	PXStreamLoadAll(world);
+	PXStreamRelease(world);
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI vBOOL vPXWorldIsStreaming(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	vBOOL enabled = world->stream.enabled;
+	vPXWorldUnlock(world);
+	return enabled;
+}
+
+VPHYSAPI void vPXWorldStreamFlush(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	if (world->stream.enabled == TRUE)
+	{
+		PXStreamFinishLoads(world, TRUE);
+		PXStreamCheck(world);
+		PXStreamFinishLoads(world, TRUE);
+		world->stream.nextCheck = world->stats.tickCount + PX_STREAM_INTERVAL;
+	}
+	vPXWorldUnlock(world);
+}
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI vBOOL vPXEnableStreaming(vPCHAR pageFilePath, vFloat regionSize)
+{
+	return vPXWorldEnableStreaming(&_vphys, pageFilePath, regionSize);
+}
+
+VPHYSAPI void vPXDisableStreaming(void)
+{
+	vPXWorldDisableStreaming(&_vphys);
+}
+
+VPHYSAPI vBOOL vPXIsStreaming(void)
+{
+	return vPXWorldIsStreaming(&_vphys);
+}
+
+VPHYSAPI void vPXStreamFlush(void)
+{
+	vPXWorldStreamFlush(&_vphys);
+}
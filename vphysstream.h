@@ -0,0 +1,61 @@
+/* ========== <vphysstream.h>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Region streaming for very large worlds.					*/
+/* The world is cut into square regions. Every few ticks,	*/
+/* regions far from every interest point are written to a	*/
+/* page file and their bodies leave memory; regions coming	*/
+/* within an interest's radius are read back on a loader	*/
+/* thread and rejoin the world on a later tick. A body		*/
+/* belongs to the region holding its position, so a body	*/
+/* moving into a paged region is handed off to it and		*/
+/* returns with it.											*/
+/*															*/
+/* Only headless bodies with no callbacks are paged, see	*/
+/* vPXWorldCreateBody; the rest always stay resident. Paged	*/
+/* bodies keep their handles, which resolve to NULL until	*/
+/* the body is back. Their views are reused, so name		*/
+/* streamed bodies by handle, never by view.				*/
+/*															*/
+/* Interest points are shared with simulation LOD, see		*/
+/* vphyslod.h. Regions further than radius plus				*/
+/* PX_STREAM_EVICT_MARGIN regions from all of them are		*/
+/* paged out, all of them if there are no interests.		*/
+
+#ifndef _VPHYS_STREAM_INCLUDE_
+#define _VPHYS_STREAM_INCLUDE_
+
+/* ========== INCLUDES							==========	*/
+#include "vphysdefs.h"
+
+
+/* ========== STREAMING							==========	*/
+/* the page file is created or truncated, and left in place	*/
+/* when streaming stops. regionSize <= 0 uses				*/
+/* PX_REGION_SIZE_DEFAULT									*/
+VPHYSAPI vBOOL vPXWorldEnableStreaming(vPPXWorld world, vPCHAR pageFilePath,
+	vFloat regionSize);
+/* brings every paged region back before returning			*/
+VPHYSAPI void  vPXWorldDisableStreaming(vPPXWorld world);
+VPHYSAPI vBOOL vPXWorldIsStreaming(vPPXWorld world);
+/* checks residency now and waits for every load to land,	*/
+/* for teleports and loading screens						*/
+VPHYSAPI void  vPXWorldStreamFlush(vPPXWorld world);
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI vBOOL vPXEnableStreaming(vPCHAR pageFilePath, vFloat regionSize);
+VPHYSAPI void  vPXDisableStreaming(void);
+VPHYSAPI vBOOL vPXIsStreaming(void);
+VPHYSAPI void  vPXStreamFlush(void);
+
+
+/* ========== STREAM STATE						==========	*/
+void  PXStreamFree(vPPXWorld world);
+void  PXStreamTick(vPPXWorld world);
+/* brings every paged region back now, they are checked		*/
+/* again on the next tick									*/
+void  PXStreamLoadAll(vPPXWorld world);
+/* TRUE if any body is out of the store						*/
+vBOOL PXStreamAnyPaged(vPPXWorld world);
+
+#endif
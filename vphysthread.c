@@ -8,316 +8,322 @@
 #include "vphysthread.h"
 #include "vspacepart.h"
 #include "vcollision.h"
+#include "vphystrace.h"
+#include "vphysquery.h"
+#include "vbodystore.h"
+#include "vphysrecord.h"
+#include "vphysparticle.h"
+#include "vphystilemap.h"
+#include "vphysfield.h"
+#include "vphyssensor.h"
+#include "vphyslayer.h"
+#include "vphysstream.h"
+#include "vphyslod.h"
+#include "vphyspool.h"
+#include "vphysbudget.h"
 #include <math.h>
 #include <float.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 
 /* ========== INTERNAL STRUCTS					==========	*/
 typedef struct PXCollisionInfo
 {
-	vPPhysical collidedObject;
+	vUI32  collidedBody;
 	vVect  pushBackVector;
 	vFloat pushBackMagnitude;
 } PXCollisionInfo, *PPXCollisionInfo;
 
-typedef struct PXPushbackInfo
-{
-	vVect  accumulator;
-	vUI32 collisionCount;
-} PXPushbackInfo, *PPXPushbackInfo;
 
-typedef struct PXAngularForceInfo
+/* ========== DEBUG DRAW FUNCS				==========	*/
+static vBOOL PXDebugDrawRectVisible(vPPXWorld world, vGRect rect)
 {
-	vFloat angularForce;
-	vFloat linearEquivalent;
-} PXAngularForceInfo, *PPXAngularForceInfo;
+	if (world->debugDraw.viewEnabled == FALSE) return TRUE;
 
-
-/* ========== DEBUG DRAW FUNCS				==========	*/
-static void PXDebugDrawBound(vPPhysical pObj)
-{
-	/* draw bounds of world-mesh */
-	vGDrawLinesConnected(pObj->worldBound.mesh, 4,
-		vGCreateColorB(BOUND_MESH_COLORb), BOUND_MESH_LINESIZE);
-
-	/* draw center of world mesh */
-	vGDrawCross(pObj->worldBound.center, 0.05f,
-		vGCreateColorB(BOUND_MESH_COLORb), BOUND_MESH_LINESIZE);
-
-	/* draw velocity vector */
-	vVect velVectDraw = pObj->worldBound.center;
-	vPXVectorAddV(&velVectDraw, pObj->velocity);
-	vGDrawLineV(pObj->worldBound.center, velVectDraw,
-		vGCreateColorB(BOUND_MESH_COLORb), BOUND_MESH_LINESIZE);
-
-	/* draw bounding box of mesh */
-	vPVect boundingBoxMesh[4];
-	vPXBoundToMesh(boundingBoxMesh, pObj->worldBound.boundingBox);
-	vGDrawLinesConnected(boundingBoxMesh, 4,
-		vGCreateColorB(BOUND_BOX_COLORb), BOUND_BOX_LINESIZE);
+	vPGRect view = &world->debugDraw.view;
+	return rect.right >= view->left && rect.left <= view->right &&
+		rect.top >= view->bottom && rect.bottom <= view->top;
 }
 
-static void vPXDebugDrawIterateFunc(vHNDL dBuffer, vPPXPartition part, vPTR input)
+static void PXDebugDrawEnsureCapacity(vPPXWorld world, vUI32 partitions,
+	vUI32 bodies)
 {
-	/* skip unused partitions */
-	if (part->inUse == FALSE) return;
-
-	/* calculate bounding box of partition */
-	vFloat rootX = part->x * _vphys.partitionSize;
-	vFloat rootY = part->y * _vphys.partitionSize;
-	vGRect pBound = vGCreateRect(rootX, rootX + _vphys.partitionSize,
-		rootY, rootY + _vphys.partitionSize);
-
-	/* convert to mesh and draw */
-	vPosition drawMesh[4];
-	vPXBoundToMesh(drawMesh, pBound);
-	vGDrawLinesConnected(drawMesh, 4, vGCreateColorB(PARTITION_COLORb),
-		PARTITION_LINESIZE);
-
-	/* draw all objects within it */
-	for (int i = 0; i < part->useage; i++)
+	vUI64 required = (vUI64)partitions * DEBUGDRAW_PARTITION_VERTS +
+		(vUI64)bodies * DEBUGDRAW_BODY_VERTS;
+	required = min(required, DEBUGDRAW_CAPACITY_MAX);
+	
+	/* grow only, so steady state never allocates */
+	if (world->debugDraw.capacity < required)
 	{
-		PXDebugDrawBound(part->list[i]);
+		vUI32 newCapacity = max(DEBUGDRAW_CAPACITY_MIN,
+			world->debugDraw.capacity);
+		while (newCapacity < required) newCapacity <<= 1;
+		newCapacity = min(newCapacity, DEBUGDRAW_CAPACITY_MAX);
+
+		vFree(world->debugDraw.vertices);
+		world->debugDraw.vertices = vAlloc(sizeof(vVect) * newCapacity);
+		world->debugDraw.capacity = newCapacity;
 	}
-}
-
-/* ========== HELPER FUNCS						==========	*/
-static void PXApplyFriction(vPPhysical phys, vFloat coeff)
-{
-	vPXVectorMultiply(&phys->velocity, (1.0f - coeff));
-}
 
-static vFloat PXWeightByMass(vFloat sVal, vFloat tVal,
-	vPPhysical source, vPPhysical target)
-{
-	vFloat massTotal = source->mass + target->mass;
-	sVal *= (source->mass / massTotal);
-	tVal *= (target->mass / massTotal);
-	return sVal + tVal;
+	world->debugDraw.count = 0;
 }
 
-static vVect PXCalculateMomentumTransferVect(vPPhysical source, vPPhysical target)
+static vBOOL PXDebugDrawHasRoom(vPPXWorld world, vUI32 verts)
 {
-	/* get initial velocities  */
-	vVect v1 = source->velocity;
-	vVect v2 = target->velocity;
-
-	/* transform so that v2 = 0 */
-	vPXVectorAddV(&v1, vPXVectorMultiplyCopy(v2, -1.0f));
-
-	/* dampen by friction of target object */
-	vPXVectorMultiply(&v1, 1.0f - target->friction);
-
-	/* find new v1 and v2 */
-	vVect v1Prime = vPXVectorMultiplyCopy(v1,
-		(source->mass - target->mass) / (source->mass + target->mass));
-
-	/* shift back so that v2 no longer equals 0 */
-	vPXVectorAddV(&v1Prime, v2);
-
-	return v1Prime;
+	return world->debugDraw.count + verts <= world->debugDraw.capacity;
 }
 
-static vFloat PXArcLengthToAngle(vFloat arcLength, vFloat radius)
+static vPVect PXDebugDrawQuad(vPVect out, vPVect quad)
 {
-	return (180 * arcLength) / (radius * VPHYS_PI);
+	/* write quad outline as a closed loop of the strip */
+	for (int i = 0; i < 4; i++)
+		*out++ = quad[i];
+	*out++ = quad[0];
+	return out;
 }
 
-static vFloat PXAngleToArcLength(vFloat angle, vFloat radius)
+static void PXDebugDrawBound(vPPXWorld world, vUI32 body)
 {
-	/* div by 180 */
-	return (VPHYS_PI * radius * angle) * 0.00555555555f;
+	vPPXWorldBoundMesh worldBound = world->bodies.worldBound + body;
+	vPVect out    = world->debugDraw.vertices + world->debugDraw.count;
+	vVect  center = worldBound->center;
+
+	/* bounding box of mesh, the strip enters at its first corner */
+	vVect boundingBoxMesh[4];
+	vPXBoundToMesh(boundingBoxMesh, worldBound->boundingBox);
+	out = PXDebugDrawQuad(out, boundingBoxMesh);
+
+	/* bounds of world-mesh */
+	out = PXDebugDrawQuad(out, worldBound->mesh);
+
+	/* center cross and velocity vector, each returning to the	*/
+	/* center so the strip never leaves the body between them	*/
+	*out++ = center;
+	*out++ = vPXCreateVect(center.x - BOUND_CENTER_CROSSSIZE,
+		center.y - BOUND_CENTER_CROSSSIZE);
+	*out++ = vPXCreateVect(center.x + BOUND_CENTER_CROSSSIZE,
+		center.y + BOUND_CENTER_CROSSSIZE);
+	*out++ = center;
+	*out++ = vPXCreateVect(center.x - BOUND_CENTER_CROSSSIZE,
+		center.y + BOUND_CENTER_CROSSSIZE);
+	*out++ = vPXCreateVect(center.x + BOUND_CENTER_CROSSSIZE,
+		center.y - BOUND_CENTER_CROSSSIZE);
+	*out++ = center;
+	*out++ = vPXVectorAddCopy(center, world->bodies.velocity[body]);
+	*out++ = center;
+
+	world->debugDraw.count += DEBUGDRAW_BODY_VERTS;
 }
 
-static PXAngularForceInfo PXCalculateAngularForce(PPXPushbackInfo pushInfo,
-	vPPhysical target, vPPhysical source)
+static void vPXDebugDrawIterateFunc(vHNDL dBuffer, vPPXPartition part, vPTR input)
 {
-	PXAngularForceInfo forceInfo;
-	forceInfo.angularForce = 0.0f;
-	forceInfo.linearEquivalent = 0.0f;
+	vPPXWorld world = input;
 
-	/* get velocities post collision transfer */
-	vVect sPrimeVel = PXCalculateMomentumTransferVect(source, target);
-	vVect tPrimeVel = PXCalculateMomentumTransferVect(target, source);
+	/* skip unused partitions */
+	if (part->inUse == FALSE) return;
 
-	/* get velocity difference */
-	vVect velDiff = vPXVectorAddCopy(tPrimeVel,
-		vPXVectorMultiplyCopy(sPrimeVel, -1.0f));
+	/* calculate bounding box of partition */
+	vFloat rootX = part->x * world->partitionSize;
+	vFloat rootY = part->y * world->partitionSize;
+	vGRect pBound = vGCreateRect(rootX, rootX + world->partitionSize,
+		rootY, rootY + world->partitionSize);
+
+	/* partitions outside the view hold nothing visible that */
+	/* another visible partition won't also hold			 */
+	if (PXDebugDrawRectVisible(world, pBound) == FALSE) return;
+	if (PXDebugDrawHasRoom(world, DEBUGDRAW_PARTITION_VERTS) == FALSE) return;
+
+	/* convert to mesh and add */
+	vVect drawMesh[4];
+	vPXBoundToMesh(drawMesh, pBound);
+	PXDebugDrawQuad(world->debugDraw.vertices + world->debugDraw.count,
+		drawMesh);
+	world->debugDraw.count += DEBUGDRAW_PARTITION_VERTS;
 
-	/* get normal plane to vector */
-	vVect projPlane
-		= vCreatePosition(velDiff.y, -velDiff.x);
-	vPXVectorNormalize(&projPlane);
+	/* add all objects within it, each body only once per tick */
+	for (int i = 0; i < part->useage; i++)
+	{
+		vUI32 body = part->list[i];
+		if (world->bodies.physical[body] == NULL) continue;
+		if (world->bodies.drawTick[body] == world->stats.tickCount + 1) continue;
+		world->bodies.drawTick[body] = world->stats.tickCount + 1;
 
-	/* project each center to plane */
-	vFloat sourceCenter = vPXVectorDotProduct(projPlane, source->worldBound.center);
-	vFloat targetCenter = vPXVectorDotProduct(projPlane, target->worldBound.center);
+		if (PXDebugDrawRectVisible(world, world->bodies.worldBound[body].boundingBox)
+			== FALSE) continue;
+		if (PXDebugDrawHasRoom(world, DEBUGDRAW_BODY_VERTS) == FALSE) return;
 
-	/* cast "shadow" of both rects onto projection plane */
-	vFloat minPos = 0, maxPos = 0;
-	for (int i = 0; i < 4; i++)
-	{
-		vFloat projVert = 
-			vPXVectorDotProduct(projPlane, source->worldBound.mesh[i]);
-		
-		/* initial value */
-		if (i == 0)
-		{
-			minPos = projVert;
-			maxPos = projVert;
-		}
-		else
-		{
-			minPos = min(projVert, minPos);
-			maxPos = max(projVert, maxPos);
-		}
+		PXDebugDrawBound(world, body);
 	}
-	for (int i = 0; i < 4; i++)
+}
+
+static void PXDebugDraw(vPPXWorld world)
+{
+	/* collect all overlay geometry into one connected strip. each	*/
+	/* outline is a closed loop and consecutive loops are joined	*/
+	/* by one segment, so a single vGDrawLinesConnected call draws	*/
+	/* the whole overlay. the strip is capped at the vUI16 count	*/
+	/* the call takes; bodies past the cap are left out				*/
+	PXDebugDrawEnsureCapacity(world, world->stats.partitionsUsed,
+		world->stats.activeBodies);
+	vDBufferIterate(world->partitions, vPXDebugDrawIterateFunc, world);
+
+	if (world->debugDraw.count > 1)
 	{
-		vFloat projVert =
-			vPXVectorDotProduct(projPlane, target->worldBound.mesh[i]);
-		minPos = min(projVert, minPos);
-		maxPos = max(projVert, maxPos);
+		vGDrawLinesConnected(world->debugDraw.vertices,
+			(vUI16)world->debugDraw.count, vGCreateColorB(DEBUGDRAW_COLORb),
+			DEBUGDRAW_LINESIZE);
 	}
-
-	/* find center of shadow for radius */
-	vFloat shadowCenter = (minPos + maxPos) * 0.5f;
-
-	/* get collision "radius" */
-	vFloat sColRadius = sourceCenter - shadowCenter;
-	vFloat tColRadius = targetCenter - shadowCenter;
-
-	/* if source radius is zero, consider no angular force */
-	if (vPXFastFabs(sColRadius) < VPHYS_EPSILON) return forceInfo;
-
-	/* get distance between each center */
-	vFloat projCenterDistance = vPXFastFabs(sourceCenter - targetCenter);
-	vFloat shadowSize = maxPos - minPos;
-
-	/* if collision is right on, no angular force */
-	if (projCenterDistance < VPHYS_EPSILON) return forceInfo;
-	if (vPXFastFabs(shadowSize) < VPHYS_EPSILON) return forceInfo;
-
-	/* get force scale factor (further from center means more force) */
-	vFloat scaleFactor = projCenterDistance / shadowSize;
-	scaleFactor = min(1.0f, scaleFactor);
-
-	/* generate magnitude */
-	vFloat deltaV = vPXVectorMagnitudeV(velDiff);
-	if (deltaV < VPHYS_EPSILON) return forceInfo;
-
-	/* rotation is arc length of velocity difference */
-	vFloat deltaR = PXArcLengthToAngle(deltaV,
-		sColRadius);
-
-	/* scale by opposite object's weight and scale factor */
-	deltaR *= (target->mass) / (source->mass + target->mass);
-	deltaR *= scaleFactor;
-	deltaR *= (1.0f - source->friction);
-
-	/* if angular velocity is already greater than deltaR	*/
-	/* then don't apply force								*/
-	if (deltaR < 0.0f && source->angularVelocity < deltaR) return forceInfo;
-	if (deltaR > 0.0f && source->angularVelocity > deltaR) return forceInfo;
-
-	/* apply force */
-	source->angularAcceleration += deltaR;
-
-	/* generate scaled arclength */
-	vFloat deltaVScaled = PXAngleToArcLength(deltaR, sColRadius);
-	
-	forceInfo.linearEquivalent = deltaVScaled;
-	forceInfo.angularForce = deltaR;
-	return forceInfo;
 }
 
 /* ========== WORLDBOUND GENERATION				==========	*/
-static void vPXGenerateWorldBounds(vPPhysical phys)
+static void PXGenerateWorldBounds(PPXBodyStore store, vUI32 body)
 {
-	/* create mesh using bounds */
-	vPXBoundToMesh(phys->worldBound.mesh, phys->bound);
+	vPPXWorldBoundMesh worldBound = store->worldBound + body;
+
+	/* rotation as a unit axis, so every vertex (and every shape	*/
+	/* normal during collision) is rotated with one multiply		*/
+	vFloat theta = store->rotation[body] * VPHYS_DEGTORAD;
+	vVect  axis  = (theta == 0.0f) ? vPXCreateVect(1.0f, 0.0f) :
+		vPXCreateVect(cosf(theta), sinf(theta));
+	worldBound->axis = axis;
+
+	/* create mesh using bounds of body's shape */
+	vPXShapeID shape = store->shape[body];
+	vPXBoundToMesh(worldBound->mesh, (shape == PX_SHAPE_BOUND) ?
+		store->bound[body] : store->shapes[shape].bound);
 
 	/* transform each vertex */
+	vVect  position = store->anticipatedPos[body];
+	vFloat scale    = store->scale[body];
 	for (int i = 0; i < 4; i++)
 	{
-		vPXVectorTransform(phys->worldBound.mesh + i, phys->anticipatedPos,
-			phys->transform.scale, phys->transform.rotation);
+		vFloat x = worldBound->mesh[i].x * scale;
+		vFloat y = worldBound->mesh[i].y * scale;
+		worldBound->mesh[i] = vPXCreateVect(
+			position.x + x * axis.x - y * axis.y,
+			position.y + x * axis.y + y * axis.x);
 	}
 
 	/* calculate bounding box */
-	float minX, maxX; minX = maxX = phys->worldBound.mesh[0].x;
-	float minY, maxY; minY = maxY = phys->worldBound.mesh[0].y;
+	float minX, maxX; minX = maxX = worldBound->mesh[0].x;
+	float minY, maxY; minY = maxY = worldBound->mesh[0].y;
 
 	for (int i = 0; i < 4; i++)
 	{
-		minX = min(minX, phys->worldBound.mesh[i].x);
-		maxX = max(maxX, phys->worldBound.mesh[i].x);
-		minY = min(minY, phys->worldBound.mesh[i].y);
-		maxY = max(maxY, phys->worldBound.mesh[i].y);
+		minX = min(minX, worldBound->mesh[i].x);
+		maxX = max(maxX, worldBound->mesh[i].x);
+		minY = min(minY, worldBound->mesh[i].y);
+		maxY = max(maxY, worldBound->mesh[i].y);
 	}
 
 	/* create bounding box */
-	phys->worldBound.boundingBox = vGCreateRect(minX, maxX, minY, maxY);
+	worldBound->boundingBox = vGCreateRect(minX, maxX, minY, maxY);
 
 	/* set bounding box dims */
-	phys->worldBound.boundingBoxDims = vCreatePosition(maxX - minX, maxY - minY);
+	worldBound->boundingBoxDims = vCreatePosition(maxX - minX, maxY - minY);
 
 	/* calculate "center" */
-	phys->worldBound.center = vPXVectorAverageV(phys->worldBound.mesh, 4);
+	worldBound->center = vPXVectorAverageV(worldBound->mesh, 4);
 }
 
-/* ========== ITERATE FUNCS			==========	*/
-static void vPXPhysicalListIterateSetupFunc(vHNDL dbHndl, vPPhysical* objectPtr, 
-	vPTR input)
+static vBOOL PXWorldBoundIsClean(PPXBodyStore store, vUI32 body)
 {
-	vPPhysical pObj = *objectPtr;
-
-	/* if object is inactive, skip */
-	if (pObj->properties.isActive == FALSE) return;
-
-	/* increment object's age */
-	pObj->age++;
+	/* bit-identical inputs rebuild a bit-identical bound */
+	if (store->boundDirty[body] == TRUE) return FALSE;
+	return memcmp(store->boundOrigin + body, store->anticipatedPos + body,
+			sizeof(vVect)) == 0 &&
+		memcmp(store->boundRotation + body, store->rotation + body,
+			sizeof(vFloat)) == 0 &&
+		memcmp(store->boundScale + body, store->scale + body,
+			sizeof(vFloat)) == 0;
+}
 
-	/* clear object acceleration */
-	pObj->acceleration = vPXCreateVect(0.0f, 0.0f);
-	pObj->angularAcceleration = 0.0f;
+/* ========== SIMULATION PASSES					==========	*/
+static void PXSetupBodies(vPPXWorld world)
+{
+	PPXBodyStore store = &world->bodies;
+	world->stats.bodies = store->count;
+	store->hullCount = 0;
 
-	/* update renderable transform (if applicable) */
-	if (pObj->renderableTransformOverride == TRUE
-		&& pObj->renderableCache != NULL )
+	for (vUI32 body = 0; body < store->count; body++)
 	{
-		vGLock();
-		pObj->renderableCache->transform = pObj->transform;
-		vGUnlock();
-	}
-
-	/* ENSURE ALL VALUES ARE VALID */
-	vPXEnforceEpsilonV(&pObj->transform.position);
-	vPXEnforceEpsilonV(&pObj->velocity);
-	vPXEnforceEpsilonF(&pObj->angularVelocity);
-	vPXEnforceEpsilonF(&pObj->transform.rotation);
-
-	/* generate anticipated position */
-	pObj->anticipatedPos = pObj->transform.position;
-	vPXVectorAddV(&pObj->anticipatedPos, pObj->velocity);
+		/* tick flags and hulls only ever last the tick that set them */
+		store->flags[body] &= ~PX_BODY_TICK_FLAGS;
+		store->hull[body]   = PX_BODY_NONE;
+
+		/* if body is inactive, skip */
+		if ((store->flags[body] & PX_BODY_ACTIVE) == 0) continue;
+		world->stats.activeBodies++;
+
+		/* increment body's age */
+		store->age[body]++;
+
+		/* start body acceleration from gravity */
+		store->acceleration[body] =
+			(store->fieldLayer[body] & world->fields.gravityLayer) ?
+			world->fields.gravity : vPXCreateVect(0.0f, 0.0f);
+		store->angularAcceleration[body] = 0.0f;
+
+		/* ENSURE ALL VALUES ARE VALID */
+		vPXEnforceEpsilonV(store->position + body);
+		vPXEnforceEpsilonV(store->velocity + body);
+		vPXEnforceEpsilonF(store->angularVelocity + body);
+		vPXEnforceEpsilonF(store->rotation + body);
+
+		/* generate anticipated position */
+		store->anticipatedPos[body] = vPXVectorAddCopy(store->position[body],
+			store->velocity[body]);
+
+		/* generate body's world bounds, unless nothing they are	*/
+		/* built from changed since the last time					*/
+		if (PXWorldBoundIsClean(store, body) == TRUE)
+		{
+			world->stats.boundsReused++;
+		}
+		else
+		{
+			PXGenerateWorldBounds(store, body);
+			store->boundOrigin[body]   = store->anticipatedPos[body];
+			store->boundRotation[body] = store->rotation[body];
+			store->boundScale[body]    = store->scale[body];
+			store->boundDirty[body]    = FALSE;
+			store->viewSync[body]     |= PX_VIEW_BOUND;
+		}
+		PXShapeHullCache(world, body);
 
-	/* generate object's world bounds */
-	vPXGenerateWorldBounds(pObj);
+		/* assign body to partitions */
+		PXPartObjectOrangizeIntoPartitions(world, body);
+	}
 
-	/* assign object to partitions */
-	PXPartObjectOrangizeIntoPartitions(pObj);
+	world->stats.boundSkipFraction = (world->stats.activeBodies == 0) ? 0.0f :
+		(vFloat)world->stats.boundsReused / (vFloat)world->stats.activeBodies;
 }
 
 static void vPXPartitionIterateCollisionFunc(vHNDL dbHndl, vPPXPartition part,
 	vPTR input)
 {
+	vPPXWorld world = input;
+
 	/* if partition has 1 element or less, skip */
 	if (part->useage <= 1) return;
 
 	/* if nothing in the partition is moving around, skip */
 	if (part->totalVelocity < PARITION_MINVELOCITY) return;
 
+	/* if no two bodies are on colliding layers, skip */
+	if (PXLayerCellCollides(world, part) == FALSE)
+	{
+		world->stats.layerCellSkips++;
+		return;
+	}
+
+	PXTRACE_SPAN_BEGIN(world, traceStart);
+	PPXBodyStore store = &world->bodies;
+	PPXLayerMatrix layers = &world->layers;
+	vUI32 groupCount = PXLayerGroupCell(world, part);
+
 	/* pushback vector accumulator */
 	PPXPushbackInfo colPushList = 
 		vAllocZeroed(sizeof(PXPushbackInfo) * part->useage);
@@ -325,9 +331,20 @@ static void vPXPartitionIterateCollisionFunc(vHNDL dbHndl, vPPXPartition part,
 	/* collision info list */
 	PPXCollisionInfo colList = vAllocZeroed(sizeof(PXCollisionInfo) * part->useage);
 
-	/* loop all objects */
-	for (int i = 0; i < part->useage; i++)
+	/* over budget, each cell stops after so many pair tests */
+	vUI32 pairLimit = PXBudgetDegraded(world, PX_DEGRADE_PAIR_CAP) ?
+		world->stats.pairTests + PX_BUDGET_CELL_PAIRS : 0xFFFFFFFF;
+	vUI32 start = (pairLimit == 0xFFFFFFFF) ? 0 :
+		world->budget.pairCapStart % part->useage;
+	vBOOL capped = FALSE;
+
+	/* loop all bodies, until the cell runs out of pair tests.	*/
+	/* capped cells start where the budget says, see			*/
+	/* PXBudgetPlan, so every body gets its turn				*/
+	for (int n = 0; n < part->useage && capped == FALSE; n++)
 	{
+		int i = (n + start) % part->useage;
+
 		/* clear collision list */
 		vZeroMemory(colList, sizeof(PXCollisionInfo) * part->useage);
 		vUI32 colListUseage = 0;
@@ -337,52 +354,69 @@ static void vPXPartitionIterateCollisionFunc(vHNDL dbHndl, vPPXPartition part,
 		pushInfo->accumulator    = vCreatePosition(0.0f, 0.0f);
 		pushInfo->collisionCount = 0;
 
-		vPPhysical source = part->list[i];
-
-		/* loop every other object (no self collision) */
-		for (int j = 0; j < part->useage; j++)
-		{
-			if (i == j) continue;
+		vUI32 source = part->list[i];
 
-			vPPhysical target = part->list[j];
-			PPXCollisionInfo colInfo = colList + colListUseage;
+		/* sensors only overlap, see PXSensorTick. bodies LOD is	*/
+		/* not stepping this tick stay put, others still hit them	*/
+		if (store->flags[source] & (PX_BODY_SENSOR | PX_BODY_IDLE)) continue;
 
-			/* if not on same collision layer, skip */
-			if ((source->properties.collideLayer &
-				 target->properties.collideLayer) == ZERO) continue;
+		/* loop every other body on a colliding layer (no self collision) */
+		for (vUI32 g = 0; g < groupCount && capped == FALSE; g++)
+		{
+			PPXLayerGroup group = layers->groups + g;
+			if (PXLayersCollide(world, store->collideLayer[source],
+				group->layer) == FALSE) continue;
+
+			for (vUI32 j = 0; j < group->count; j++)
+			{
+				vUI32 target = layers->groupBodies[group->first + j];
+				if (target == source) continue;
+				if (world->stats.pairTests >= pairLimit)
+				{
+					capped = TRUE;
+					break;
+				}
+
+				PPXCollisionInfo colInfo = colList + colListUseage;
 				
-			/* pre-check collision */
-			if (vPXDetectCollisionPreEstimate(source, target) == FALSE) continue;
-
-			/* do proper collision detection */
-			vVect pushBackVec; vFloat pushBackMag;
-			vBOOL colResult = vPXDetectCollisionSAT(source, target,
-				&pushBackVec, &pushBackMag);
-			if (colResult == FALSE) continue;
-
-			/* calculate angular force force from collision */
-			PXAngularForceInfo angularInfo = 
-				PXCalculateAngularForce(pushInfo, target, source);
-
-			/* force that was converted to angular force is taken	*/
-			/* away from the pushvector								*/
-			pushBackMag -= vPXFastFabs(angularInfo.linearEquivalent);
-			pushBackMag = max(0.0f, pushBackMag);
-
-			/* store collision data */
-			colInfo->collidedObject    = target;
-			colInfo->pushBackVector    = pushBackVec;
-			colInfo->pushBackMagnitude = pushBackMag;
-
-			/* scale pushback vector by mass ratio and add to accumulator */
-			vFloat massRatio = target->mass / (source->mass + target->mass);
-			vPXVectorAddV(&pushInfo->accumulator,
-				vPXVectorMultiplyCopy(pushBackVec,
-					pushBackMag * massRatio * POS_DEINTERSECT_COEFF));
-			pushInfo->collisionCount++;
-
-			/* update collision use */
-			colListUseage++;
+				/* pre-check collision */
+				if (PXDetectCollisionPreEstimate(store->worldBound + source,
+					store->worldBound + target) == FALSE) continue;
+
+				/* do proper collision detection */
+				vVect pushBackVec; vFloat pushBackMag;
+				world->stats.pairTests++;
+				vBOOL colResult = PXDetectCollision(world, source, target,
+					&pushBackVec, &pushBackMag);
+				if (colResult == FALSE) continue;
+				world->stats.pairHits++;
+
+				/* calculate angular force force from collision */
+				PXAngularForceInfo angularInfo = 
+					PXCalculateAngularForce(world, pushInfo, target, source);
+				store->angularAcceleration[source] += angularInfo.angularForce;
+
+				/* force that was converted to angular force is taken	*/
+				/* away from the pushvector								*/
+				pushBackMag -= vPXFastFabs(angularInfo.linearEquivalent);
+				pushBackMag = max(0.0f, pushBackMag);
+
+				/* store collision data */
+				colInfo->collidedBody      = target;
+				colInfo->pushBackVector    = pushBackVec;
+				colInfo->pushBackMagnitude = pushBackMag;
+
+				/* scale pushback vector by mass ratio and add to accumulator */
+				vFloat massRatio = store->mass[target] /
+					(store->mass[source] + store->mass[target]);
+				vPXVectorAddV(&pushInfo->accumulator,
+					vPXVectorMultiplyCopy(pushBackVec,
+						pushBackMag * massRatio * POS_DEINTERSECT_COEFF));
+				pushInfo->collisionCount++;
+
+				/* update collision use */
+				colListUseage++;
+			}
 		}
 
 		/* if no collisions detected, skip momentum transfer portion */
@@ -394,108 +428,504 @@ static void vPXPartitionIterateCollisionFunc(vHNDL dbHndl, vPPXPartition part,
 		{
 			PPXCollisionInfo momentumCol = colList + j;
 			vPXVectorAddV(&newVelocityAverage,
-				PXCalculateMomentumTransferVect(source, momentumCol->collidedObject));
+				PXCalculateMomentumTransferVect(world, source, momentumCol->collidedBody));
 		}
 		vPXVectorMultiply(&newVelocityAverage, 1.0f / (vFloat)colListUseage);
-		source->velocity = newVelocityAverage;
+		store->velocity[source] = newVelocityAverage;
 	}
 
-	/* loop all object's de-intersection vectors, take average and push */
+	/* loop all body's de-intersection vectors, take average and push */
 	for (int i = 0; i < part->useage; i++)
 	{
 		/* no push if no collisions */
 		PPXPushbackInfo pushInfo = colPushList + i;
 		if (pushInfo->collisionCount == 0) continue;
 
-		/* average accumulator and push object */
+		/* average accumulator and push body */
 		vPXVectorMultiply(&pushInfo->accumulator,
 			1.0f / (vFloat)pushInfo->collisionCount);
-		vPXVectorAddV(&part->list[i]->transform.position,
-			pushInfo->accumulator);
+		vPXVectorAddV(store->position + part->list[i], pushInfo->accumulator);
 	}
 
 	/* free lists */
 	vFree(colPushList);
 	vFree(colList);
+	if (capped == TRUE) world->stats.pairCapCells++;
+
+	PXTRACE_SPAN_END(world, traceStart, PX_TRACE_COLLISION_PARTITION,
+		part->x, part->y);
+}
+
+/* ========== DETERMINISTIC CONTACTS			==========	*/
+/* deterministic worlds never update bodies while collisions	*/
+/* are being found; every contact is measured against the		*/
+/* pre-collision state, then all contacts are sorted and		*/
+/* applied in one fixed order. the result does not depend on	*/
+/* partition order or on which thread found which contact.	*/
+static PPXContact PXContactClaim(vPPXWorld world)
+{
+	if (world->contactCount == world->contactCapacity)
+	{
+		vUI32 newCapacity = max(CONTACT_CAPACITY_MIN,
+			world->contactCapacity << 1);
+		PPXContact newContacts = vAlloc(sizeof(PXContact) * newCapacity);
+		if (world->contacts != NULL)
+		{
+			vMemCopy(newContacts, world->contacts,
+				sizeof(PXContact) * world->contactCount);
+		}
+		vFree(world->contacts);
+		world->contacts = newContacts;
+		world->contactCapacity = newCapacity;
+	}
+	return world->contacts + world->contactCount++;
+}
+
+static vBOOL PXContactOwnedByPartition(vPPXWorld world, vPPXPartition part,
+	vUI32 a, vUI32 b)
+{
+	/* a pair sharing several partitions is only handled by the	*/
+	/* one holding the min corner of their bounding box overlap	*/
+	vPGRect ra = &world->bodies.worldBound[a].boundingBox;
+	vPGRect rb = &world->bodies.worldBound[b].boundingBox;
+	vI32 cx = (vI32)floorf(max(ra->left, rb->left) / world->partitionSize);
+	vI32 cy = (vI32)floorf(max(ra->bottom, rb->bottom) / world->partitionSize);
+	return cx == part->x && cy == part->y;
+}
+
+static void PXContactGenerate(vPPXWorld world, vUI32 source, vUI32 target)
+{
+	vVect pushBackVec; vFloat pushBackMag;
+	world->stats.pairTests++;
+	if (PXDetectCollision(world, source, target, &pushBackVec,
+		&pushBackMag) == FALSE) return;
+	world->stats.pairHits++;
+
+	/* force converted to angular force is taken away from the push */
+	PXAngularForceInfo angularInfo =
+		PXCalculateAngularForce(world, NULL, target, source);
+	pushBackMag -= vPXFastFabs(angularInfo.linearEquivalent);
+	pushBackMag = max(0.0f, pushBackMag);
+
+	PPXContact contact = PXContactClaim(world);
+	contact->source            = source;
+	contact->target            = target;
+	contact->pushBack          = pushBackVec;
+	contact->pushBackMagnitude = pushBackMag;
+	contact->angularForce      = angularInfo.angularForce;
+	contact->transfer          = PXCalculateMomentumTransferVect(world,
+		source, target);
+}
+
+static void PXContactPair(vPPXWorld world, vPPXPartition part, vUI32 a,
+	vUI32 b)
+{
+	PPXBodyStore store = &world->bodies;
+	if (PXDetectCollisionPreEstimate(store->worldBound + a,
+		store->worldBound + b) == FALSE) return;
+	if (PXContactOwnedByPartition(world, part, a, b) == FALSE) return;
+
+	/* bodies LOD is not stepping this tick only push the other */
+	if ((store->flags[a] & PX_BODY_IDLE) == 0) PXContactGenerate(world, a, b);
+	if ((store->flags[b] & PX_BODY_IDLE) == 0) PXContactGenerate(world, b, a);
 }
 
-static void vPXPhysicalListIterateDoDynamicsFunc(vHNDL dbHndl, vPPhysical* objectPtr,
+static void vPXPartitionIterateContactFunc(vHNDL dbHndl, vPPXPartition part,
 	vPTR input)
 {
-	vPPhysical phys = *objectPtr;
+	vPPXWorld world = input;
 
-	/* call object's update func if exists */
-	if (phys->updateFunc != NULL)
-		phys->updateFunc(phys);
+	if (part->useage <= 1) return;
+	if (part->totalVelocity < PARITION_MINVELOCITY) return;
+	if (PXLayerCellCollides(world, part) == FALSE)
+	{
+		world->stats.layerCellSkips++;
+		return;
+	}
 
-	/* apply object drag */
-	PXApplyFriction(phys, phys->drag);
-	phys->angularVelocity *= (1.0f - phys->drag);
+	PXTRACE_SPAN_BEGIN(world, traceStart);
+	PPXLayerMatrix layers = &world->layers;
+	vUI32 groupCount = PXLayerGroupCell(world, part);
 
-	/* update object velocity */
-	vPXVectorAddV(&phys->velocity, phys->acceleration);
-	phys->angularVelocity += phys->angularAcceleration;
+	/* each colliding pair of groups once, a group with itself	*/
+	/* included. sensors are in no group						*/
+	for (vUI32 ga = 0; ga < groupCount; ga++)
+	{
+		PPXLayerGroup groupA = layers->groups + ga;
+		for (vUI32 gb = ga; gb < groupCount; gb++)
+		{
+			PPXLayerGroup groupB = layers->groups + gb;
+			if (PXLayersCollide(world, groupA->layer, groupB->layer) == FALSE)
+				continue;
+
+			/* each unordered pair once, responding in both directions */
+			for (vUI32 i = 0; i < groupA->count; i++)
+			{
+				vUI32 a = layers->groupBodies[groupA->first + i];
+				for (vUI32 j = (ga == gb) ? i + 1 : 0; j < groupB->count; j++)
+				{
+					vUI32 b = layers->groupBodies[groupB->first + j];
+					PXContactPair(world, part, a, b);
+				}
+			}
+		}
+	}
 
-	/* update object position and rotation */
-	vPXVectorAddV(&phys->transform.position, phys->velocity);
-	phys->transform.rotation += phys->angularVelocity;
+	PXTRACE_SPAN_END(world, traceStart, PX_TRACE_COLLISION_PARTITION,
+		part->x, part->y);
 }
 
-/* ========== RENDER THREAD FUNCTIONS			==========	*/
-void vPXT_initFunc(vPWorker worker, vPTR workerData, vPTR input)
+static int PXContactCompare(const void* c1, const void* c2)
 {
-	
+	PPXContact a = (PPXContact)c1;
+	PPXContact b = (PPXContact)c2;
+	if (a->source != b->source) return (a->source < b->source) ? -1 : 1;
+	if (a->target != b->target) return (a->target < b->target) ? -1 : 1;
+	return 0;
 }
 
-void vPXT_exitFunc(vPWorker worker, vPTR workerData)
+static void PXResolveContacts(vPPXWorld world)
 {
+	PPXBodyStore store = &world->bodies;
+	PPXContact contacts = world->contacts;
+	vUI32 count = world->contactCount;
+
+	/* (source, target) is unique, so the sorted order is total */
+	if (count > 1) qsort(contacts, count, sizeof(PXContact), PXContactCompare);
+	world->stats.contacts = count;
 
+	/* each source's contacts are adjacent, apply them as one group */
+	vUI32 last = 0;
+	for (vUI32 first = 0; first < count; first = last)
+	{
+		vUI32 source = contacts[first].source;
+		vVect pushBack = vCreatePosition(0.0f, 0.0f);
+		vVect velocity = vCreatePosition(0.0f, 0.0f);
+
+		for (last = first; last < count && contacts[last].source == source;
+			last++)
+		{
+			PPXContact contact = contacts + last;
+			vFloat massRatio = store->mass[contact->target] /
+				(store->mass[source] + store->mass[contact->target]);
+			vPXVectorAddV(&pushBack, vPXVectorMultiplyCopy(contact->pushBack,
+				contact->pushBackMagnitude * massRatio * POS_DEINTERSECT_COEFF));
+			vPXVectorAddV(&velocity, contact->transfer);
+			store->angularAcceleration[source] += contact->angularForce;
+		}
+
+		/* average momentum transfer and de-intersection */
+		vFloat scale = 1.0f / (vFloat)(last - first);
+		store->velocity[source] = vPXVectorMultiplyCopy(velocity, scale);
+		vPXVectorAddV(store->position + source,
+			vPXVectorMultiplyCopy(pushBack, scale));
+	}
+
+	world->contactCount = 0;
 }
 
-ULONGLONG __pxCycleTimeTaken = 0;
-ULONGLONG __pxDrawTimeTaken = 0;
-void vPXT_cycleFunc(vPWorker worker, vPTR workerData)
+static void PXCallUpdateFunc(vPPXWorld world, vUI32 body)
+{
+	/* call body's update func through its view */
+	PPXBodyStore store = &world->bodies;
+	vPPhysical phys = store->physical[body];
+	PXTRACE_SPAN_BEGIN(world, traceStart);
+	PXBodyStoreScatter(world, body);
+	store->updateFunc[body](phys);
+	PXBodyStoreGather(world, body);
+	PXTRACE_SPAN_END(world, traceStart, PX_TRACE_UPDATEFUNC, phys, 0);
+}
+
+static vBOOL PXUpdateIsThreadSafe(vPPXWorld world, vUI32 body)
 {
-	/* reset profiler accumulator */
-	if (worker->cycleCount % PROFILER_REFRESH_INTERVAL == 0)
+	PPXBodyStore store = &world->bodies;
+	if (store->updateFunc[body] == NULL) return FALSE;
+	if (store->physical[body] == NULL) return FALSE;
+	if (store->flags[body] & PX_BODY_IDLE) return FALSE;
+	return world->pool.allThreadSafe == TRUE ||
+		(store->flags[body] & PX_BODY_THREADSAFE_UPDATE) != 0;
+}
+
+static void PXUpdateTask(vPPXWorld world, vUI32 first, vUI32 end,
+	vPTR input)
+{
+	PPXBodyStore store = &world->bodies;
+	for (vUI32 body = first; body < end; body++)
 	{
-		__pxDrawTimeTaken /= PROFILER_REFRESH_INTERVAL;
-		__pxCycleTimeTaken /= PROFILER_REFRESH_INTERVAL;
-		vPXDebugLogFormatted("Physics Tick Rate: %d\nPhysics Debug Draw Rate: %d\n",
-			__pxCycleTimeTaken, __pxDrawTimeTaken);
-		__pxCycleTimeTaken = 0;
-		__pxDrawTimeTaken = 0;
+		if (PXUpdateIsThreadSafe(world, body) == FALSE) continue;
+		PXCallUpdateFunc(world, body);
+
+		/* gather rebuilt the flags, mark it for the serial pass */
+		store->flags[body] |= PX_BODY_UPDATED;
 	}
+}
+
+static void PXDoDynamics(vPPXWorld world)
+{
+	PPXBodyStore store = &world->bodies;
+	world->stats.parallelUpdates = 0;
+
+	/* thread-safe update funcs go wide first, see vphyspool.h.	*/
+	/* helpers are only woken when there is one					*/
+	vBOOL anyThreadSafe = FALSE;
+	for (vUI32 body = 0; body < store->count && world->pool.threadCount > 0 &&
+		anyThreadSafe == FALSE; body++)
+		anyThreadSafe = PXUpdateIsThreadSafe(world, body);
+	if (anyThreadSafe == TRUE)
+		PXPoolRun(world, store->count, PX_UPDATE_CHUNK, PXUpdateTask, NULL);
+
+	for (vUI32 body = 0; body < store->count; body++)
+	{
+		/* LOD steps this body on a later tick, and bodies	*/
+		/* destroyed by an earlier update func are holes		*/
+		if (store->flags[body] & PX_BODY_IDLE) continue;
+		if (store->physical[body] == NULL) continue;
 
-	ULONGLONG cycleStartTime = GetTickCount64();
+		/* the rest of the update funcs run here, one by one */
+		if (store->flags[body] & PX_BODY_UPDATED)
+		{
+			store->flags[body] &= ~PX_BODY_UPDATED;
+			world->stats.parallelUpdates++;
+		}
+		else if (store->updateFunc[body] != NULL)
+			PXCallUpdateFunc(world, body);
 
-	/* clear all partitions */
-	PXPartResetPartitions();
+		/* reduced rate bodies cover every tick since their last	*/
+		/* step, one tick at a time so free motion matches full rate	*/
+		vUI32 steps = PXLODSteps(world, body);
+		for (vUI32 step = 0; step < steps; step++)
+		{
+			/* apply body drag */
+			vFloat dragScale = 1.0f - store->drag[body];
+			vPXVectorMultiply(store->velocity + body, dragScale);
+			store->angularVelocity[body] *= dragScale;
+
+			/* update body velocity */
+			vPXVectorAddV(store->velocity + body, store->acceleration[body]);
+			store->angularVelocity[body] += store->angularAcceleration[body];
+
+			/* update body position and rotation */
+			vPXVectorAddV(store->position + body, store->velocity[body]);
+			store->rotation[body] += store->angularVelocity[body];
+		}
+	}
+}
+
+/* ========== STATE HASHING						==========	*/
+vUI64 PXComputeStateHash(vPPXWorld world)
+{
+	/* particles are left out, as they are out of snapshots and	*/
+	/* recordings, which must reproduce this hash				*/
+	vUI64 hash = PXBodyStoreHash(world, PX_HASH_OFFSET);
+	hash = PXTilemapHash(world, hash);
+	hash = PXFieldHash(world, hash);
+	hash = PXLayerHash(world, hash);
+	hash = PXLODHash(world, hash);
+	hash = (hash ^ world->stats.tickCount) * PX_HASH_PRIME;
+	for (vUI32 word = 0; word < 4; word++)
+		for (vUI32 lane = 0; lane < RAND_LANES; lane++)
+			hash = (hash ^ world->random.state[word][lane]) * PX_HASH_PRIME;
+	hash = (hash ^ world->random.lane) * PX_HASH_PRIME;
+	return hash;
+}
+
+
+/* ========== TICK LOGIC						==========	*/
+static vI64 PXPhaseBegin(void)
+{
+	return PXTraceTimestamp();
+}
+
+static void PXPhaseEnd(vPPXWorld world, vUI8 phase, vUI8 traceName,
+	vI64 phaseStart)
+{
+	vI64 elapsed = PXTraceTimestamp() - phaseStart;
+	world->stats.phaseTimeNs[phase] = 
+		(vUI64)((elapsed * 1000000000.0) / (double)world->timeFrequency);
+	PXTRACE_SPAN_END(world, phaseStart, traceName, 0, 0);
+}
+
+static void vPXPartitionCountUsedIterateFunc(vHNDL dbHndl, vPPXPartition part,
+	vPTR input)
+{
+	vPPXWorld world = input;
+	if (part->inUse == TRUE) world->stats.partitionsUsed++;
+}
+
+void PXTick(vPPXWorld world)
+{
+	vI64 tickStart = PXPhaseBegin();
 
-	/* setup all objects for collision calculations */
-	/* (refer to function for implementation)		*/
-	vDBufferIterate(_vphys.physObjectList, vPXPhysicalListIterateSetupFunc, NULL);
+	/* reset per-tick counters */
+	world->stats.bodies         = 0;
+	world->stats.activeBodies   = 0;
+	world->stats.partitionsUsed = 0;
+	world->stats.pairTests      = 0;
+	world->stats.pairHits       = 0;
+	world->stats.layerCellSkips = 0;
+	world->stats.boundsReused   = 0;
+	world->stats.pairCapCells   = 0;
+
+	/* bring regions in and out of memory before anything runs */
+	PXStreamTick(world);
+
+	/* clear all partitions */
+	vI64 phaseStart = PXPhaseBegin();
+	PXPartResetPartitions(world);
+	PXPhaseEnd(world, PX_PHASE_PARTITION_RESET, PX_TRACE_PARTITION_RESET,
+		phaseStart);
+
+	/* pull changes from touched views, then setup all	*/
+	/* bodies for collision calculations					*/
+	/* (refer to function for implementation)				*/
+	phaseStart = PXPhaseBegin();
+	PXBodyStoreCompact(world);
+	PXBodyStoreGatherTouched(world);
+	PXBodyStoreSpatialSort(world);
+	PXSetupBodies(world);
+	PXBudgetPlan(world);
+	PXLODAssign(world);
+	PXPhaseEnd(world, PX_PHASE_SETUP, PX_TRACE_SETUP, phaseStart);
+	PXTRACE_COUNTER(world, PX_TRACE_COUNTER_BODIES, world->stats.activeBodies,
+		world->stats.bodies);
 
 	/* do collision calculations and de-intersect objects */
-	vDBufferIterate(_vphys.partitions, vPXPartitionIterateCollisionFunc, NULL);
+	phaseStart = PXPhaseBegin();
+	world->stats.contacts = 0;
+	if (world->deterministic == TRUE)
+	{
+		vDBufferIterate(world->partitions, vPXPartitionIterateContactFunc,
+			world);
+		PXResolveContacts(world);
+	}
+	else
+	{
+		vDBufferIterate(world->partitions, vPXPartitionIterateCollisionFunc,
+			world);
+	}
+	world->budget.pairNs = (vUI64)(((PXTraceTimestamp() - phaseStart) *
+		1000000000.0) / (double)world->timeFrequency);
+	PXTilemapCollideBodies(world);
+	PXSensorTick(world);
+	PXPhaseEnd(world, PX_PHASE_COLLISION, PX_TRACE_COLLISION, phaseStart);
+	PXTRACE_COUNTER(world, PX_TRACE_COUNTER_PAIRS, world->stats.pairTests,
+		world->stats.pairHits);
 
 	/* apply all dynamics from forces accumulated during */
-	/* collision detection and user-defined update func   */
-	vDBufferIterate(_vphys.physObjectList, vPXPhysicalListIterateDoDynamicsFunc, NULL);
-
-	__pxCycleTimeTaken += (GetTickCount64() - cycleStartTime);
+	/* collision detection, force fields and user-defined */
+	/* update func                                        */
+	phaseStart = PXPhaseBegin();
+	PXFieldApplyBodies(world);
+	PXDoDynamics(world);
+	PXBodyStoreScatterTick(world);
+	PXPhaseEnd(world, PX_PHASE_DYNAMICS, PX_TRACE_DYNAMICS, phaseStart);
+
+	/* step particles against the bodies' partitions, which	*/
+	/* stay filled until the next tick resets them				*/
+	phaseStart = PXPhaseBegin();
+	PXParticleTick(world);
+	PXPhaseEnd(world, PX_PHASE_PARTICLES, PX_TRACE_PARTICLES, phaseStart);
+
+	/* fields run out once bodies and particles both felt them */
+	PXFieldExpire(world);
+
+	vDBufferIterate(world->partitions, vPXPartitionCountUsedIterateFunc,
+		world);
 
 	/* debug draw all things */
-	if (_vphys.debugMode == TRUE)
+	world->stats.phaseTimeNs[PX_PHASE_DEBUGDRAW] = 0;
+	if (world->debugMode == TRUE)
 	{
-		ULONGLONG drawStartTime = GetTickCount64();
+		phaseStart = PXPhaseBegin();
+		PXDebugDraw(world);
+		PXPhaseEnd(world, PX_PHASE_DEBUGDRAW, PX_TRACE_DEBUGDRAW, phaseStart);
+	}
+
+	world->stats.tickCount++;
+
+	/* fingerprint the result so lockstep peers can compare ticks */
+	if (world->deterministic == TRUE)
+		world->stats.stateHash = PXComputeStateHash(world);
+
+	/* hand this tick to the flight recorder */
+	if (world->record.enabled == TRUE)
+		PXRecordCapture(world);
 
-		/* axis lines */
-		vGDrawLineF(-0xFFFF, 0, 0xFFFF, 0, vGCreateColorB(0, 0, 255, 255), 5.0f);
-		vGDrawLineF(0, -0xFFFF, 0, 0xFFFF, vGCreateColorB(255, 0, 0, 255), 5.0f);
+	/* publish results for lock-free queries */
+	PXQueryPublish(world);
+
+	world->stats.tickTimeNs = (vUI64)(((PXTraceTimestamp() - tickStart) * 
+		1000000000.0) / (double)world->timeFrequency);
+	PXBudgetLearn(world);
+	PXTRACE_SPAN_END(world, tickStart, PX_TRACE_TICK, 0, 0);
+}
 
-		vDBufferIterate(_vphys.partitions, vPXDebugDrawIterateFunc, NULL);
 
-		__pxDrawTimeTaken += (GetTickCount64() - drawStartTime);
+/* ========== RENDER THREAD FUNCTIONS			==========	*/
+void vPXT_initFunc(vPWorker worker, vPTR workerData, vPTR input)
+{
+	
+}
+
+void vPXT_exitFunc(vPWorker worker, vPTR workerData)
+{
+
+}
+
+static void PXWorkerTick(vPPXWorld world)
+{
+	PXTick(world);
+
+	/* sum for the worker's periodic log */
+	world->profileTickNs += world->stats.tickTimeNs;
+	world->profileDrawNs += world->stats.phaseTimeNs[PX_PHASE_DEBUGDRAW];
+	world->profileTicks++;
+}
+
+void vPXT_cycleFunc(vPWorker worker, vPTR workerData)
+{
+	vPPXWorld world = workerData;
+
+	/* the whole tick runs under the physics lock */
+	vPXWorldLock(world);
+
+	/* log profiler values averaged over the ticks since last log */
+	if (worker->cycleCount % PROFILER_REFRESH_INTERVAL == 0 &&
+		world->profileTicks > 0)
+	{
+		vPXWorldDebugLogFormatted(world, "Physics Tick Time: %llu us\n"
+			"Physics Debug Draw Time: %llu us\n",
+			world->profileTickNs / world->profileTicks / 1000,
+			world->profileDrawNs / world->profileTicks / 1000);
+		world->profileTickNs = 0;
+		world->profileDrawNs = 0;
+		world->profileTicks  = 0;
+	}
+
+	if (world->deterministic == FALSE)
+	{
+		PXWorkerTick(world);
+		vPXWorldUnlock(world);
+		return;
+	}
+
+	/* deterministic worlds advance in whole fixed ticks; cycle	*/
+	/* jitter changes when a tick runs, never what it computes	*/
+	vI64 now = PXTraceTimestamp();
+	if (world->tickClockLast == 0) world->tickClockLast = now;
+	world->tickClock += now - world->tickClockLast;
+	world->tickClockLast = now;
+
+	vI64 tickLength = (vI64)((world->tickInterval * world->timeFrequency) /
+		1000000);
+	for (int i = 0; i < PX_TICK_CATCHUP_MAX && world->tickClock >= tickLength;
+		i++)
+	{
+		PXWorkerTick(world);
+		world->tickClock -= tickLength;
 	}
-}
\ No newline at end of file
+
+	/* too far behind to catch up, drop the backlog */
+	world->tickClock = min(world->tickClock, tickLength);
+	vPXWorldUnlock(world);
+}
@@ -10,6 +10,11 @@
 #include "vphys.h"
 
 
+/* ========== TICK LOGIC						==========	*/
+void  PXTick(vPPXWorld world);
+vUI64 PXComputeStateHash(vPPXWorld world);
+
+
 /* ========== RENDER THREAD FUNCTIONS			==========	*/
 void vPXT_initFunc(vPWorker worker, vPTR workerData, vPTR input);
 void vPXT_exitFunc(vPWorker worker, vPTR workerData);
@@ -0,0 +1,445 @@
+/* ========== <vphystilemap.c>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Tilemap collider for static terrain.						*/
+/* Pushes are chosen per tile among its exposed faces and	*/
+/* then merged per direction, so a body resting across		*/
+/* several floor tiles is lifted once, not once per tile.	*/
+
+
+/* ========== INCLUDES							==========	*/
+#include "vphystilemap.h"
+#include "vphyscore.h"
+#include "vcollision.h"
+#include "vphysshape.h"
+#include "vbodystore.h"
+#include "vphystrace.h"
+#include <math.h>
+
+
+/* ========== INTERNAL STRUCTS					==========	*/
+typedef struct PXTileRange
+{
+	vI32 x0, y0;	/* inclusive */
+	vI32 x1, y1;
+} PXTileRange, *PPXTileRange;
+
+typedef struct PXTilePush
+{
+	vFloat left, right, bottom, top;	/* deepest push each way	*/
+} PXTilePush, *PPXTilePush;
+
+
+/* ========== HELPERS							==========	*/
+static vBOOL PXTileSolid(PPXTilemap map, vI32 x, vI32 y)
+{
+	/* past the edge of the map is open space */
+	if (x < 0 || y < 0 || x >= (vI32)map->width || y >= (vI32)map->height)
+		return FALSE;
+	return map->tiles[(SIZE_T)y * map->width + x] != PX_TILE_EMPTY;
+}
+
+static vUI8 PXTileFaces(PPXTilemap map, vI32 x, vI32 y)
+{
+	vUI8 faces = 0;
+	if (PXTileSolid(map, x - 1, y) == FALSE) faces |= PX_TILE_FACE_LEFT;
+	if (PXTileSolid(map, x + 1, y) == FALSE) faces |= PX_TILE_FACE_RIGHT;
+	if (PXTileSolid(map, x, y - 1) == FALSE) faces |= PX_TILE_FACE_BOTTOM;
+	if (PXTileSolid(map, x, y + 1) == FALSE) faces |= PX_TILE_FACE_TOP;
+	return faces;
+}
+
+static vGRect PXTileRect(PPXTilemap map, vI32 x, vI32 y)
+{
+	vFloat left   = map->origin.x + (vFloat)x * map->tileSize;
+	vFloat bottom = map->origin.y + (vFloat)y * map->tileSize;
+	return vGCreateRect(left, left + map->tileSize, bottom,
+		bottom + map->tileSize);
+}
+
+static vI32 PXTileIndex(vFloat offset, vFloat tileSize, vUI32 count)
+{
+	/* clamped as a float first, the offset may be huge */
+	vFloat index = floorf(offset / tileSize);
+	index = max(0.0f, min((vFloat)count - 1.0f, index));
+	return (vI32)index;
+}
+
+static vBOOL PXTileRangeOf(PPXTilemap map, vGRect rect, PPXTileRange range)
+{
+	vFloat mapRight = map->origin.x + (vFloat)map->width  * map->tileSize;
+	vFloat mapTop   = map->origin.y + (vFloat)map->height * map->tileSize;
+	if (rect.right <= map->origin.x || rect.left >= mapRight ||
+		rect.top <= map->origin.y || rect.bottom >= mapTop) return FALSE;
+
+	range->x0 = PXTileIndex(rect.left   - map->origin.x, map->tileSize, map->width);
+	range->x1 = PXTileIndex(rect.right  - map->origin.x, map->tileSize, map->width);
+	range->y0 = PXTileIndex(rect.bottom - map->origin.y, map->tileSize, map->height);
+	range->y1 = PXTileIndex(rect.top    - map->origin.y, map->tileSize, map->height);
+	return TRUE;
+}
+
+static void PXTilePushOut(PPXTilemap map, vI32 x, vI32 y, vGRect tile,
+	vGRect bounds, PPXTilePush push)
+{
+	/* the shortest way out through a face bordering empty	*/
+	/* space. faces shared with a solid neighbour never push,	*/
+	/* nor do faces on the far side of the tile from the body	*/
+	vUI8 faces = PXTileFaces(map, x, y);
+	vFloat dx = (bounds.left + bounds.right) - (tile.left + tile.right);
+	vFloat dy = (bounds.bottom + bounds.top) - (tile.bottom + tile.top);
+	if (dx > 0.0f) faces &= ~PX_TILE_FACE_LEFT;
+	if (dx < 0.0f) faces &= ~PX_TILE_FACE_RIGHT;
+	if (dy > 0.0f) faces &= ~PX_TILE_FACE_BOTTOM;
+	if (dy < 0.0f) faces &= ~PX_TILE_FACE_TOP;
+	vFloat depth[4] = {
+		bounds.right - tile.left,	/* out the left face	*/
+		tile.right - bounds.left,	/* out the right face	*/
+		bounds.top - tile.bottom,	/* out the bottom face	*/
+		tile.top - bounds.bottom,	/* out the top face		*/
+	};
+
+	vI32 best = -1;
+	for (vI32 face = 0; face < 4; face++)
+	{
+		if ((faces & (1 << face)) == 0 || !(depth[face] > 0.0f)) continue;
+		if (best < 0 || depth[face] < depth[best]) best = face;
+	}
+
+	/* buried tiles leave it to the tiles around them */
+	switch (best)
+	{
+	case 0: push->left   = max(push->left,   depth[0]); break;
+	case 1: push->right  = max(push->right,  depth[1]); break;
+	case 2: push->bottom = max(push->bottom, depth[2]); break;
+	case 3: push->top    = max(push->top,    depth[3]); break;
+	default: break;
+	}
+}
+
+static vBOOL PXTileOverlapsCircle(vGRect tile, vFloat x, vFloat y,
+	vFloat radius)
+{
+	vFloat dx = x - max(tile.left, min(tile.right, x));
+	vFloat dy = y - max(tile.bottom, min(tile.top, y));
+	return (dx * dx + dy * dy) < (radius * radius);
+}
+
+static vBOOL PXTileOverlapsShape(PPXShapeInstance inst, vGRect tile)
+{
+	/* tiles collide as unrotated boxes */
+	vPXWorldBoundMesh tileBound;
+	vZeroMemory(&tileBound, sizeof(tileBound));
+	tileBound.mesh[0] = vPXCreateVect(tile.left, tile.bottom);
+	tileBound.mesh[1] = vPXCreateVect(tile.left, tile.top);
+	tileBound.mesh[2] = vPXCreateVect(tile.right, tile.top);
+	tileBound.mesh[3] = vPXCreateVect(tile.right, tile.bottom);
+	tileBound.center  = vPXCreateVect((tile.left + tile.right) * 0.5f,
+		(tile.bottom + tile.top) * 0.5f);
+	tileBound.boundingBox = tile;
+	tileBound.boundingBoxDims = vPXCreateVect(tile.right - tile.left,
+		tile.top - tile.bottom);
+	tileBound.axis = vPXCreateVect(1.0f, 0.0f);
+
+	PXShapeInstance tileInst;
+	tileInst.shape      = PXShapeLookup(NULL, PX_SHAPE_BOUND);
+	tileInst.worldBound = &tileBound;
+	tileInst.origin     = tileBound.center;
+	tileInst.scale      = 1.0f;
+	tileInst.hull       = NULL;
+	return PXOverlapShapes(inst, &tileInst);
+}
+
+static vFloat PXTileRespond(vFloat normalVel, vFloat pushDir,
+	vFloat restitution)
+{
+	/* only motion into the face is reflected */
+	if (normalVel * pushDir >= 0.0f) return normalVel;
+	return -normalVel * restitution;
+}
+
+
+/* ========== TILEMAP COLLISION					==========	*/
+void PXTilemapInit(vPPXWorld world)
+{
+	world->tilemap.restitution = PX_TILEMAP_RESTITUTION_DEFAULT;
+	world->tilemap.friction    = PX_TILEMAP_FRICTION_DEFAULT;
+}
+
+void PXTilemapFree(vPPXWorld world)
+{
+	vFree(world->tilemap.tiles);
+	world->tilemap.tiles  = NULL;
+	world->tilemap.width  = 0;
+	world->tilemap.height = 0;
+}
+
+void PXTilemapCollideBodies(vPPXWorld world)
+{
+	PPXTilemap map = &world->tilemap;
+	world->stats.tileContacts = 0;
+	if (map->width == 0) return;
+
+	PXTRACE_SPAN_BEGIN(world, traceStart);
+	PPXBodyStore store = &world->bodies;
+
+	/* in body order, so deterministic worlds stay so */
+	for (vUI32 body = 0; body < store->count; body++)
+	{
+		if ((store->flags[body] & (PX_BODY_ACTIVE | PX_BODY_SENSOR |
+			PX_BODY_IDLE)) != PX_BODY_ACTIVE) continue;
+		if ((store->collideLayer[body] & map->collideLayer) == ZERO) continue;
+
+		PXTileRange range;
+		if (PXTileRangeOf(map, store->worldBound[body].boundingBox,
+			&range) == FALSE) continue;
+
+		PXShapeInstance inst;
+		PXShapeInstanceFromBody(world, body, &inst);
+		vGRect bounds = PXShapeInstanceBounds(&inst);
+
+		/* an unrotated box overlaps whatever its bounds do */
+		vBOOL exact = inst.shape->type == PX_SHAPE_TYPE_BOX &&
+			inst.worldBound->axis.y == 0.0f;
+
+		PXTilePush push = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for (vI32 y = range.y0; y <= range.y1; y++)
+		{
+			for (vI32 x = range.x0; x <= range.x1; x++)
+			{
+				if (PXTileSolid(map, x, y) == FALSE) continue;
+
+				vGRect tile = PXTileRect(map, x, y);
+				if (bounds.right <= tile.left || bounds.left >= tile.right ||
+					bounds.top <= tile.bottom || bounds.bottom >= tile.top)
+					continue;
+				if (exact == FALSE && PXTileOverlapsShape(&inst, tile) == FALSE)
+					continue;
+
+				PXTilePushOut(map, x, y, tile, bounds, &push);
+			}
+		}
+
+		vVect pushVec = vPXCreateVect(push.right - push.left,
+			push.top - push.bottom);
+		if (pushVec.x == 0.0f && pushVec.y == 0.0f) continue;
+		world->stats.tileContacts++;
+
+		/* reflect the normal speed and drag the tangential	*/
+		vVect velOld = store->velocity[body];
+		vVect vel    = velOld;
+		vFloat keep  = 1.0f - map->friction;
+		if (pushVec.x != 0.0f)
+		{
+			vel.x  = PXTileRespond(vel.x, pushVec.x, map->restitution);
+			vel.y *= keep;
+		}
+		if (pushVec.y != 0.0f)
+		{
+			vel.y  = PXTileRespond(vel.y, pushVec.y, map->restitution);
+			vel.x *= keep;
+		}
+		store->velocity[body] = vel;
+
+		/* the push is from the anticipated position, so take	*/
+		/* back what the new velocity will add in dynamics		*/
+		store->position[body].x += pushVec.x + velOld.x - vel.x;
+		store->position[body].y += pushVec.y + velOld.y - vel.y;
+	}
+
+	PXTRACE_SPAN_END(world, traceStart, PX_TRACE_TILEMAP,
+		world->stats.tileContacts, 0);
+}
+
+void PXTilemapCollideParticles(vPPXWorld world)
+{
+	PPXTilemap map = &world->tilemap;
+	if (map->width == 0) return;
+
+	PPXParticleStore store = &world->particles;
+	for (vUI32 i = 0; i < store->count; i++)
+	{
+		if ((store->collideLayer[i] & map->collideLayer) == ZERO) continue;
+
+		vFloat x = store->positionX[i];
+		vFloat y = store->positionY[i];
+		vFloat r = store->radius[i];
+		vGRect bounds = vGCreateRect(x - r, x + r, y - r, y + r);
+
+		PXTileRange range;
+		if (PXTileRangeOf(map, bounds, &range) == FALSE) continue;
+
+		PXTilePush push = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for (vI32 ty = range.y0; ty <= range.y1; ty++)
+		{
+			for (vI32 tx = range.x0; tx <= range.x1; tx++)
+			{
+				if (PXTileSolid(map, tx, ty) == FALSE) continue;
+
+				vGRect tile = PXTileRect(map, tx, ty);
+				if (PXTileOverlapsCircle(tile, x, y, r) == FALSE) continue;
+				PXTilePushOut(map, tx, ty, tile, bounds, &push);
+			}
+		}
+
+		vFloat pushX = push.right - push.left;
+		vFloat pushY = push.top - push.bottom;
+		if (pushX == 0.0f && pushY == 0.0f) continue;
+		world->stats.particleContacts++;
+
+		/* particles are already integrated, only move them out */
+		store->positionX[i] += pushX;
+		store->positionY[i] += pushY;
+		if (pushX != 0.0f)
+			store->velocityX[i] = PXTileRespond(store->velocityX[i], pushX,
+				store->restitution);
+		if (pushY != 0.0f)
+			store->velocityY[i] = PXTileRespond(store->velocityY[i], pushY,
+				store->restitution);
+	}
+}
+
+vUI64 PXTilemapHash(vPPXWorld world, vUI64 hash)
+{
+	/* the revision stands in for the tiles, which never	*/
+	/* change without it									*/
+	PPXTilemap map = &world->tilemap;
+	hash = PXHashBytes(hash, &map->width, sizeof(map->width));
+	hash = PXHashBytes(hash, &map->height, sizeof(map->height));
+	hash = PXHashBytes(hash, &map->origin, sizeof(map->origin));
+	hash = PXHashBytes(hash, &map->tileSize, sizeof(map->tileSize));
+	hash = PXHashBytes(hash, &map->collideLayer, sizeof(map->collideLayer));
+	hash = PXHashBytes(hash, &map->restitution, sizeof(map->restitution));
+	hash = PXHashBytes(hash, &map->friction, sizeof(map->friction));
+	hash = PXHashBytes(hash, &map->revision, sizeof(map->revision));
+	return hash;
+}
+
+
+/* ========== TILEMAP							==========	*/
+VPHYSAPI vBOOL vPXWorldSetTilemap(vPPXWorld world, vVect origin,
+	vFloat tileSize, vUI32 width, vUI32 height, const vUI8* tiles,
+	vUI8 collideLayer)
+{
+	if (!(tileSize > 0.0f) || width == 0 || height == 0 ||
+		width > PX_TILEMAP_SIDE_MAX || height > PX_TILEMAP_SIDE_MAX)
+	{
+		vPXWorldDebugLogFormatted(world, "Tilemaps need a positive tile size "
+			"and 1 to %d tiles per side\n", PX_TILEMAP_SIDE_MAX);
+		return FALSE;
+	}
+
+	SIZE_T tileCount = (SIZE_T)width * height;
+	vUI8* newTiles = vAllocZeroed(tileCount);
+	if (tiles != NULL) vMemCopy(newTiles, tiles, tileCount);
+
+	vPXWorldLock(world);
+	PPXTilemap map = &world->tilemap;
+	vFree(map->tiles);
+	map->tiles        = newTiles;
+	map->width        = width;
+	map->height       = height;
+	map->origin       = origin;
+	map->tileSize     = tileSize;
+	map->collideLayer = collideLayer;
+	map->revision++;
+	vPXWorldUnlock(world);
+	return TRUE;
+}
+
+VPHYSAPI void vPXWorldClearTilemap(vPPXWorld world)
+{
+	vPXWorldLock(world);
+	PXTilemapFree(world);
+	world->tilemap.revision++;
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI void vPXWorldSetTilemapResponse(vPPXWorld world,
+	vFloat restitution, vFloat friction)
+{
+	vPXWorldLock(world);
+	world->tilemap.restitution = max(0.0f, min(1.0f, restitution));
+	world->tilemap.friction    = max(0.0f, min(1.0f, friction));
+	vPXWorldUnlock(world);
+}
+
+
+/* ========== TILES								==========	*/
+VPHYSAPI void vPXWorldSetTile(vPPXWorld world, vUI32 x, vUI32 y, vUI8 tile)
+{
+	vPXWorldLock(world);
+	PPXTilemap map = &world->tilemap;
+	if (x < map->width && y < map->height)
+	{
+		map->tiles[(SIZE_T)y * map->width + x] = tile;
+		map->revision++;
+	}
+	vPXWorldUnlock(world);
+}
+
+VPHYSAPI vUI8 vPXWorldGetTile(vPPXWorld world, vUI32 x, vUI32 y)
+{
+	vPXWorldLock(world);
+	PPXTilemap map = &world->tilemap;
+	vUI8 tile = PX_TILE_EMPTY;
+	if (x < map->width && y < map->height)
+		tile = map->tiles[(SIZE_T)y * map->width + x];
+	vPXWorldUnlock(world);
+	return tile;
+}
+
+VPHYSAPI vBOOL vPXWorldGetTileCoord(vPPXWorld world, vVect position,
+	vPUI32 xOut, vPUI32 yOut)
+{
+	vPXWorldLock(world);
+	PPXTilemap map = &world->tilemap;
+	vBOOL inside = FALSE;
+	if (map->width != 0)
+	{
+		vFloat tx = floorf((position.x - map->origin.x) / map->tileSize);
+		vFloat ty = floorf((position.y - map->origin.y) / map->tileSize);
+		inside = tx >= 0.0f && ty >= 0.0f &&
+			tx < (vFloat)map->width && ty < (vFloat)map->height;
+		if (inside)
+		{
+			*xOut = (vUI32)tx;
+			*yOut = (vUI32)ty;
+		}
+	}
+	vPXWorldUnlock(world);
+	return inside;
+}
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI vBOOL vPXSetTilemap(vVect origin, vFloat tileSize, vUI32 width,
+	vUI32 height, const vUI8* tiles, vUI8 collideLayer)
+{
+	return vPXWorldSetTilemap(&_vphys, origin, tileSize, width, height, tiles,
+		collideLayer);
+}
+
+VPHYSAPI void vPXClearTilemap(void)
+{
+	vPXWorldClearTilemap(&_vphys);
+}
+
+VPHYSAPI void vPXSetTilemapResponse(vFloat restitution, vFloat friction)
+{
+	vPXWorldSetTilemapResponse(&_vphys, restitution, friction);
+}
+
+VPHYSAPI void vPXSetTile(vUI32 x, vUI32 y, vUI8 tile)
+{
+	vPXWorldSetTile(&_vphys, x, y, tile);
+}
+
+VPHYSAPI vUI8 vPXGetTile(vUI32 x, vUI32 y)
+{
+	return vPXWorldGetTile(&_vphys, x, y);
+}
+
+VPHYSAPI vBOOL vPXGetTileCoord(vVect position, vPUI32 xOut, vPUI32 yOut)
+{
+	return vPXWorldGetTileCoord(&_vphys, position, xOut, yOut);
+}
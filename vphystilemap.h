@@ -0,0 +1,60 @@
+/* ========== <vphystilemap.h>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Tilemap collider for static terrain.						*/
+/* A world holds at most one grid of tile ids, one byte per	*/
+/* tile, which bodies and particles are pushed out of each	*/
+/* tick. Tiles are never bodies: they take no partition,	*/
+/* body slot or pair test, and only the tiles under a body	*/
+/* are looked at. Bodies are only pushed through faces		*/
+/* that border an empty tile, so a run of solid tiles acts	*/
+/* as one edge and nothing snags on the seams.				*/
+
+#ifndef _VPHYS_TILEMAP_INCLUDE_
+#define _VPHYS_TILEMAP_INCLUDE_
+
+/* ========== INCLUDES							==========	*/
+#include "vphysdefs.h"
+
+
+/* ========== TILEMAP							==========	*/
+/* replaces the world's tilemap. tiles holds width * height	*/
+/* ids, row by row from the bottom, and is copied; NULL		*/
+/* starts every tile empty. any id but PX_TILE_EMPTY is		*/
+/* solid. bodies and particles collide with the tilemap		*/
+/* when they share any collide layer with it				*/
+VPHYSAPI vBOOL vPXWorldSetTilemap(vPPXWorld world, vVect origin,
+	vFloat tileSize, vUI32 width, vUI32 height, const vUI8* tiles,
+	vUI8 collideLayer);
+VPHYSAPI void  vPXWorldClearTilemap(vPPXWorld world);
+/* restitution and friction range from 0 to 1				*/
+VPHYSAPI void  vPXWorldSetTilemapResponse(vPPXWorld world,
+	vFloat restitution, vFloat friction);
+
+
+/* ========== TILES								==========	*/
+/* out of range tiles are ignored on set and read as empty	*/
+VPHYSAPI void vPXWorldSetTile(vPPXWorld world, vUI32 x, vUI32 y, vUI8 tile);
+VPHYSAPI vUI8 vPXWorldGetTile(vPPXWorld world, vUI32 x, vUI32 y);
+/* tile holding a world position, FALSE outside the map		*/
+VPHYSAPI vBOOL vPXWorldGetTileCoord(vPPXWorld world, vVect position,
+	vPUI32 xOut, vPUI32 yOut);
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI vBOOL vPXSetTilemap(vVect origin, vFloat tileSize, vUI32 width,
+	vUI32 height, const vUI8* tiles, vUI8 collideLayer);
+VPHYSAPI void  vPXClearTilemap(void);
+VPHYSAPI void  vPXSetTilemapResponse(vFloat restitution, vFloat friction);
+VPHYSAPI void  vPXSetTile(vUI32 x, vUI32 y, vUI8 tile);
+VPHYSAPI vUI8  vPXGetTile(vUI32 x, vUI32 y);
+VPHYSAPI vBOOL vPXGetTileCoord(vVect position, vPUI32 xOut, vPUI32 yOut);
+
+
+/* ========== TILEMAP COLLISION					==========	*/
+void  PXTilemapInit(vPPXWorld world);
+void  PXTilemapFree(vPPXWorld world);
+void  PXTilemapCollideBodies(vPPXWorld world);
+void  PXTilemapCollideParticles(vPPXWorld world);
+vUI64 PXTilemapHash(vPPXWorld world, vUI64 hash);
+
+#endif
@@ -0,0 +1,267 @@
+/* ========== <vphystrace.c>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Chrome trace-event recorder for physics ticks			*/
+
+
+/* ========== INCLUDES							==========	*/
+#define _CRT_SECURE_NO_WARNINGS
+#include "vphystrace.h"
+#include "vphyscore.h"
+#include <stdio.h>
+
+
+/* ========== INTERNAL DATA						==========	*/
+typedef struct PXTraceNameInfo
+{
+	vPCHAR name;
+	vPCHAR argName1;	/* span argument or first counter series	*/
+	vPCHAR argName2;	/* span argument or second counter series	*/
+} PXTraceNameInfo, *PPXTraceNameInfo;
+
+static const PXTraceNameInfo __pxTraceNames[PX_TRACE_NAME_COUNT] =
+{
+	{ "tick",				NULL,		NULL		},
+	{ "partition reset",	NULL,		NULL		},
+	{ "setup",				NULL,		NULL		},
+	{ "collision",			NULL,		NULL		},
+	{ "partition collision","x",		"y"			},
+	{ "dynamics",			NULL,		NULL		},
+	{ "updateFunc",			"body",		NULL		},
+	{ "debug draw",			NULL,		NULL		},
+	{ "bodies",				"active",	"total"		},
+	{ "pairs",				"tested",	"colliding"	},
+	{ "particles",			NULL,		NULL		},
+	{ "tilemap",			"bodies",	NULL		},
+	{ "force fields",		"bodies",	NULL		},
+	{ "sensors",			"overlaps",	NULL		},
+	{ "streaming",			"loads",	"evictions"	},
+	{ "level of detail",	"idle",		"cells"		},
+	{ "tick budget",		"projected us",	"level"	},
+};
+
+
+/* ========== HELPERS							==========	*/
+static double PXTraceToMicroseconds(vPPXWorld world, vI64 counterValue)
+{
+	return ((double)counterValue * 1000000.0) / 
+		(double)world->trace.timeFrequency;
+}
+
+static vPPXTraceEvent PXTraceClaimEvent(vPPXWorld world)
+{
+	/* enter before checking, so the buffer cannot be freed	*/
+	/* under a recorder that saw tracing enabled				*/
+	InterlockedIncrement(&world->trace.writers);
+	if (world->trace.enabled == FALSE)
+	{
+		InterlockedDecrement(&world->trace.writers);
+		return NULL;
+	}
+
+	/* claim a slot, oldest events are overwritten when full */
+	vUI64 slot = (vUI64)InterlockedIncrement64(&world->trace.writeCursor) - 1;
+	return world->trace.events + (slot & (world->trace.capacity - 1));
+}
+
+static void PXTraceReleaseEvent(vPPXWorld world)
+{
+	InterlockedDecrement(&world->trace.writers);
+}
+
+static void PXTraceWriteEvent(vPPXWorld world, FILE* file,
+	vPPXTraceEvent event, vBOOL first)
+{
+	const PXTraceNameInfo* info = __pxTraceNames + event->name;
+	double ts = PXTraceToMicroseconds(world,
+		event->timeStart - world->trace.timeOrigin);
+
+	if (first == FALSE) fputs(",\n", file);
+
+	if (event->type == PX_TRACE_COUNTER)
+	{
+		fprintf(file, "{\"name\":\"%s\",\"cat\":\"vphysics\",\"ph\":\"C\","
+			"\"ts\":%.3f,\"pid\":%d,\"tid\":%u,"
+			"\"args\":{\"%s\":%lld,\"%s\":%lld}}",
+			info->name, ts, TRACE_PROCESS_ID, event->threadID,
+			info->argName1, event->value, info->argName2, event->arg1);
+		return;
+	}
+
+	fprintf(file, "{\"name\":\"%s\",\"cat\":\"vphysics\",\"ph\":\"X\","
+		"\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%u",
+		info->name, ts, PXTraceToMicroseconds(world, event->value),
+		TRACE_PROCESS_ID, event->threadID);
+
+	/* write span arguments (if any) */
+	if (event->name == PX_TRACE_UPDATEFUNC)
+	{
+		fprintf(file, ",\"args\":{\"%s\":\"0x%llx\"}", info->argName1,
+			(unsigned long long)event->arg1);
+	}
+	else if (info->argName1 != NULL)
+	{
+		fprintf(file, ",\"args\":{\"%s\":%lld,\"%s\":%lld}",
+			info->argName1, event->arg1, info->argName2, event->arg2);
+	}
+
+	fputc('}', file);
+}
+
+
+/* ========== TRACE CONTROL						==========	*/
+VPHYSAPI vBOOL vPXWorldTraceBegin(vPPXWorld world, vPCHAR filePath,
+	vUI32 eventCapacity)
+{
+	vPXWorldLock(world);
+
+	/* only one trace may be recorded per world at once */
+	if (world->trace.enabled == TRUE)
+	{
+		vPXWorldUnlock(world);
+		return FALSE;
+	}
+
+	FILE* file = fopen(filePath, "w");
+	if (file == NULL)
+	{
+		vPXWorldDebugLogFormatted(world, "Could not open trace file %s\n",
+			filePath);
+		vPXWorldUnlock(world);
+		return FALSE;
+	}
+
+	if (eventCapacity == 0) eventCapacity = TRACE_CAPACITY_DEFAULT;
+
+	/* ring slots are taken by mask, round up to a power of two */
+	vUI32 capacity = 1;
+	while (capacity < eventCapacity && capacity < TRACE_CAPACITY_MAX)
+		capacity <<= 1;
+	eventCapacity = capacity;
+
+	/* all events are recorded into this buffer, nothing is */
+	/* allocated or written to disk until the trace ends	*/
+	world->trace.outFile  = file;
+	world->trace.events   = vAllocZeroed(sizeof(vPXTraceEvent) * eventCapacity);
+	world->trace.capacity = eventCapacity;
+	world->trace.writeCursor = 0;
+
+	LARGE_INTEGER counter;
+	QueryPerformanceFrequency(&counter);
+	world->trace.timeFrequency = counter.QuadPart;
+	QueryPerformanceCounter(&counter);
+	world->trace.timeOrigin = counter.QuadPart;
+
+	InterlockedExchange(&world->trace.enabled, TRUE);
+
+	vPXWorldUnlock(world);
+	return TRUE;
+}
+
+VPHYSAPI vBOOL vPXWorldTraceEnd(vPPXWorld world)
+{
+	vPXWorldLock(world);
+
+	if (world->trace.enabled == FALSE)
+	{
+		vPXWorldUnlock(world);
+		return FALSE;
+	}
+	/* recorders may run outside the world lock, wait for any	*/
+	/* still writing before the buffer is read and freed		*/
+	InterlockedExchange(&world->trace.enabled, FALSE);
+	while (InterlockedCompareExchange(&world->trace.writers, 0, 0) != 0)
+		Sleep(0);
+
+	FILE* file = world->trace.outFile;
+
+	/* find range of events still in the ring buffer */
+	vUI64 recorded = (vUI64)world->trace.writeCursor;
+	vUI64 first = 0;
+	if (recorded > world->trace.capacity)
+		first = recorded - world->trace.capacity;
+
+	fputs("{\"traceEvents\":[\n", file);
+	fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+		"\"args\":{\"name\":\"vPhysics\"}}", TRACE_PROCESS_ID);
+
+	for (vUI64 i = first; i < recorded; i++)
+	{
+		PXTraceWriteEvent(world, file,
+			world->trace.events + (i & (world->trace.capacity - 1)), FALSE);
+	}
+
+	fprintf(file, "\n],\"displayTimeUnit\":\"ms\","
+		"\"otherData\":{\"droppedEvents\":%llu}}\n",
+		(unsigned long long)first);
+	fclose(file);
+
+	vFree(world->trace.events);
+	world->trace.events  = NULL;
+	world->trace.outFile = NULL;
+
+	vPXWorldUnlock(world);
+	return TRUE;
+}
+
+VPHYSAPI vBOOL vPXWorldTraceIsEnabled(vPPXWorld world)
+{
+	return world->trace.enabled;
+}
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI vBOOL vPXTraceBegin(vPCHAR filePath, vUI32 eventCapacity)
+{
+	return vPXWorldTraceBegin(&_vphys, filePath, eventCapacity);
+}
+
+VPHYSAPI vBOOL vPXTraceEnd(void)
+{
+	return vPXWorldTraceEnd(&_vphys);
+}
+
+VPHYSAPI vBOOL vPXTraceIsEnabled(void)
+{
+	return vPXWorldTraceIsEnabled(&_vphys);
+}
+
+
+/* ========== EVENT RECORDING					==========	*/
+vI64 PXTraceTimestamp(void)
+{
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart;
+}
+
+void PXTraceRecordSpan(vPPXWorld world, vUI8 name, vI64 timeStart,
+	vI64 arg1, vI64 arg2)
+{
+	vI64 timeEnd = PXTraceTimestamp();
+	vPPXTraceEvent event = PXTraceClaimEvent(world);
+	if (event == NULL) return;
+
+	event->type      = PX_TRACE_SPAN;
+	event->name      = name;
+	event->threadID  = GetCurrentThreadId();
+	event->timeStart = timeStart;
+	event->value     = timeEnd - timeStart;
+	event->arg1      = arg1;
+	event->arg2      = arg2;
+	PXTraceReleaseEvent(world);
+}
+
+void PXTraceRecordCounter(vPPXWorld world, vUI8 name, vI64 series1,
+	vI64 series2)
+{
+	vPPXTraceEvent event = PXTraceClaimEvent(world);
+	if (event == NULL) return;
+
+	event->type      = PX_TRACE_COUNTER;
+	event->name      = name;
+	event->threadID  = GetCurrentThreadId();
+	event->timeStart = PXTraceTimestamp();
+	event->value     = series1;
+	event->arg1      = series2;
+	PXTraceReleaseEvent(world);
+}
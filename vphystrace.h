@@ -0,0 +1,54 @@
+/* ========== <vphystrace.h>					==========	*/
+/* Bailey Jia-Tao Brown							2022		*/
+/* Chrome trace-event recorder for physics ticks			*/
+
+#ifndef _VPHYS_TRACE_INCLUDE_
+#define _VPHYS_TRACE_INCLUDE_
+
+/* ========== INCLUDES							==========	*/
+#include "vphysdefs.h"
+
+
+/* ========== TRACE CONTROL						==========	*/
+VPHYSAPI vBOOL vPXWorldTraceBegin(vPPXWorld world, vPCHAR filePath,
+	vUI32 eventCapacity);
+VPHYSAPI vBOOL vPXWorldTraceEnd(vPPXWorld world);
+VPHYSAPI vBOOL vPXWorldTraceIsEnabled(vPPXWorld world);
+
+
+/* ========== DEFAULT WORLD						==========	*/
+VPHYSAPI vBOOL vPXTraceBegin(vPCHAR filePath, vUI32 eventCapacity);
+VPHYSAPI vBOOL vPXTraceEnd(void);
+VPHYSAPI vBOOL vPXTraceIsEnabled(void);
+
+
+/* ========== EVENT RECORDING					==========	*/
+vI64 PXTraceTimestamp(void);
+void PXTraceRecordSpan(vPPXWorld world, vUI8 name, vI64 timeStart,
+	vI64 arg1, vI64 arg2);
+void PXTraceRecordCounter(vPPXWorld world, vUI8 name, vI64 series1,
+	vI64 series2);
+
+/* recording macros compile to nothing when VPHYS_NO_TRACE is defined	*/
+/* and otherwise cost a single flag check while tracing is disabled	*/
+#ifndef VPHYS_NO_TRACE
+#define PXTRACE_SPAN_BEGIN(world, var) \
+	vI64 var = ((world)->trace.enabled ? PXTraceTimestamp() : 0)
+#define PXTRACE_SPAN_END(world, var, name, arg1, arg2) \
+	do { \
+		if ((world)->trace.enabled && var != 0) \
+			PXTraceRecordSpan(world, name, var, (vI64)(arg1), (vI64)(arg2)); \
+	} while (0)
+#define PXTRACE_COUNTER(world, name, series1, series2) \
+	do { \
+		if ((world)->trace.enabled) \
+			PXTraceRecordCounter(world, name, (vI64)(series1), \
+				(vI64)(series2)); \
+	} while (0)
+#else
+#define PXTRACE_SPAN_BEGIN(world, var)
+#define PXTRACE_SPAN_END(world, var, name, arg1, arg2) do { } while (0)
+#define PXTRACE_COUNTER(world, name, series1, series2) do { } while (0)
+#endif
+
+#endif
@@ -8,16 +8,9 @@
 #include "vspacepart.h"
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 
-/* ========== INTERNAL STRUCTS					==========	*/
-typedef struct PXPartitionAssignIterateInput
-{
-	vI32 px, py;
-	vPPhysical object;
-	vBOOL partitionFound;
-} PXPartitionAssignIterateInput, * PXPPartitionAssignIterateInput;
-
 /* ========== HELPERS							==========	*/
 static vPTR PXRealloc(vPTR block, SIZE_T oldSize, SIZE_T newSize)
 {
@@ -27,157 +20,333 @@ static vPTR PXRealloc(vPTR block, SIZE_T oldSize, SIZE_T newSize)
 	return newBlock;
 }
 
-static void PXCalculatePartitionValue(vPI32 xOut, vPI32 yOut, vFloat fInx, vFloat fIny)
+static void PXCalculatePartitionValue(vPPXWorld world, vPI32 xOut, vPI32 yOut,
+	vFloat fInx, vFloat fIny)
 {
 	/* find corresponding partition */
-	*xOut = (vI32)floorf(fInx / _vphys.partitionSize);
-	*yOut = (vI32)floorf(fIny / _vphys.partitionSize);
+	*xOut = (vI32)floorf(fInx / world->partitionSize);
+	*yOut = (vI32)floorf(fIny / world->partitionSize);
 }
 
-static void PXEnsurePartitionSizeRequirement(vPPXPartition partition, 
-	vI32 sizeRequired)
+static void PXEnsurePartitionSizeRequirement(vPPXWorld world,
+	vPPXPartition partition, vI32 sizeRequired)
 {
 	/* ensure minimum allocation */
 	if (partition->list == NULL)
 	{
-		vPXDebugLogFormatted("Allocating partition [%d %d] list\n",
+		vPXWorldDebugLogFormatted(world, "Allocating partition [%d %d] list\n",
 			partition->x, partition->y);
-		partition->list = vAlloc(sizeof(vPPhysical) * PARTITION_CAPACITY_MIN);
+		partition->list = vAlloc(sizeof(vUI32) * PARTITION_CAPACITY_MIN);
 		partition->capacity = PARTITION_CAPACITY_MIN;
 	}
 	
 	/* increment partition size (if needed) */
 	if (partition->capacity <= sizeRequired)
 	{
-		vPXDebugLogFormatted("Expanding partition [%d %d] from size %d -> %d\n",
+		vPXWorldDebugLogFormatted(world,
+			"Expanding partition [%d %d] from size %d -> %d\n",
 			partition->x, partition->y, partition->capacity,
 			partition->capacity + PARTITION_CAPACITY_STEP);
 
 		vUI64 oldSize = partition->capacity;
 		partition->capacity += PARTITION_CAPACITY_STEP;
-		partition->list = PXRealloc(partition->list, sizeof(vPPhysical) * oldSize,
-			sizeof(vPPhysical) * partition->capacity);
+		partition->list = PXRealloc(partition->list, sizeof(vUI32) * oldSize,
+			sizeof(vUI32) * partition->capacity);
 	}
 }
 
-static void PXAssignObjToPartitionFinalization(vPPXPartition part, vPPhysical pObj)
+static void PXAssignObjToPartitionFinalization(vPPXWorld world,
+	vPPXPartition part, vUI32 body)
 {
+	PPXBodyStore store = &world->bodies;
+
 	/* ensure partition is big enough */
-	PXEnsurePartitionSizeRequirement(part, part->useage + 1);
+	PXEnsurePartitionSizeRequirement(world, part, part->useage + 1);
 
-	/* add object to partition's object list */
-	part->list[part->useage] = pObj;
+	/* add body to partition's body list */
+	part->list[part->useage] = body;
 	part->useage++;
 
+	/* sensors never pair, they take no part in the layer summary */
+	if ((store->flags[body] & PX_BODY_SENSOR) == 0)
+	{
+		vUI8 layer = store->collideLayer[body];
+		part->layerRepeatMask |= part->layerMask & layer;
+		part->layerMask       |= layer;
+	}
+
 	/* accumulate total "velocity" */
-	vFloat velMag = vPXFastFabs(pObj->velocity.x) +
-		vPXFastFabs(pObj->velocity.y) + vPXFastFabs(pObj->angularVelocity);
+	vFloat velMag = vPXFastFabs(store->velocity[body].x) +
+		vPXFastFabs(store->velocity[body].y) +
+		vPXFastFabs(store->angularVelocity[body]);
 
 	/* cases to ignore optimization */
-	if (velMag < PARITION_MINVELOCITY && pObj->age < PARTITION_OPTIMIZE_MINAGE
-		|| pObj->properties.noPartitionOptimize)
+	if (velMag < PARITION_MINVELOCITY && store->age[body] < PARTITION_OPTIMIZE_MINAGE
+		|| (store->flags[body] & PX_BODY_NO_PARTITION_OPTIMIZE))
 		velMag = 0xFFFF;
 
 	part->totalVelocity += velMag;
 }
 
-static void PXAssignObjToPartitionIterateFunc(vHNDL dbHndl, vPPXPartition partition, 
-	PXPPartitionAssignIterateInput input)
+static vPPXPartition PXClaimPartition(vPPXWorld world, vI32 pX, vI32 pY)
 {
-	/* do not continue to evaluate if solution is found */
-	if (input->partitionFound == TRUE) return;
+	/* reuse a partition left over from previous ticks if possible */
+	if (world->partitionPoolCursor < world->partitionPoolCount)
+		return world->partitionPool[world->partitionPoolCursor++];
 
-	/* if reached UNUSED partition, means no partitions are left */
-	/* mark partition as used and set it to match our purposes   */
-	if (partition->inUse == FALSE)
+	/* otherwise create a new partition and add it to the pool */
+	if (world->partitionPoolCount == world->partitionPoolCapacity)
 	{
-		/* match requirements */
-		partition->x = input->px;
-		partition->y = input->py;
-
-		/* mark as USED */
-		partition->inUse = TRUE;
+		vUI32 oldCapacity = world->partitionPoolCapacity;
+		world->partitionPoolCapacity = max(PARTITION_POOL_CAPACITY_MIN,
+			oldCapacity << 1);
+		world->partitionPool = PXRealloc(world->partitionPool,
+			sizeof(vPPXPartition) * oldCapacity,
+			sizeof(vPPXPartition) * world->partitionPoolCapacity);
+	}
 
-		/* finalize assigning obj to partition */
-		PXAssignObjToPartitionFinalization(partition, input->object);
+	vPPXPartition newPartition = vDBufferAdd(world->partitions, NULL);
+	vPXWorldDebugLogFormatted(world, "Created new parition [%d %d]\n", pX, pY);
 
-		/* mark as found */
-		input->partitionFound = TRUE;
+	world->partitionPool[world->partitionPoolCount++] = newPartition;
+	world->partitionPoolCursor++;
+	return newPartition;
+}
 
-		/* end */
+static void PXAssignObjectToPartition(vPPXWorld world, vI32 pX, vI32 pY,
+	vUI32 body)
+{
+	/* find partition already holding these coordinates */
+	vUI32 poolIndex = PXCellMapFind(&world->partitionMap, pX, pY);
+	if (poolIndex != CELLMAP_EMPTY)
+	{
+		PXAssignObjToPartitionFinalization(world,
+			world->partitionPool[poolIndex], body);
 		return;
 	}
 
-	/* check if partition has matching values */
-	if (partition->x == input->px && partition->y == input->py)
-	{
-		/* finalize assigning obj to partition */
-		PXAssignObjToPartitionFinalization(partition, input->object);
+	/* if none found, claim an unused partition for them */
+	poolIndex = world->partitionPoolCursor;
+	vPPXPartition partition = PXClaimPartition(world, pX, pY);
+	PXCellMapInsert(&world->partitionMap, pX, pY, poolIndex);
 
-		/* mark as found */
-		input->partitionFound = TRUE;
-	}
+	/* setup partition parameters */
+	partition->inUse = TRUE;
+	partition->x = pX; partition->y = pY;
+
+	/* finalize assigning to partition */
+	PXAssignObjToPartitionFinalization(world, partition, body);
 }
 
-static void PXAssignObjectToPartition(vI32 pX, vI32 pY, vPPhysical obj)
+static void PXPartitionResetIterateFunc(vHNDL dbHndl, vPPXPartition partition, vPTR input)
 {
-	/* setup iteration input */
-	PXPartitionAssignIterateInput input;
-	input.px = pX; input.py = pY;
-	input.object = obj;
-	input.partitionFound = FALSE;
+	partition->inUse  = FALSE;	/* mark as unused */
+	partition->useage = ZERO;	/* reset useage counter */
+	partition->totalVelocity = 0.0f;	/* reset total velocity */
+	partition->layerMask       = ZERO;	/* reset layer summary */
+	partition->layerRepeatMask = ZERO;
+}
 
-	/* try and assign object to an allocated partition */
-	vDBufferIterate(_vphys.partitions, PXAssignObjToPartitionIterateFunc,
-		&input);
+static void PXPartitionFreeIterateFunc(vHNDL dbHndl, vPPXPartition partition, vPTR input)
+{
+	vFree(partition->list);
+}
 
-	/* on partition found, return */
-	if (input.partitionFound == TRUE) return;
 
-	/* if no allocated partitions found, create a new partition to assign */
-	vPPXPartition newPartition = vDBufferAdd(_vphys.partitions, NULL);
 
-	/* setup partition parameters */
-	newPartition->inUse = TRUE;
-	newPartition->x = pX; newPartition->y = pY; 
+/* ========== CELL MAP							==========	*/
+static vUI32 PXCellMapHash(vUI64 key)
+{
+	/* 64 bit finalizer mix, folded to 32 bits */
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdull;
+	key ^= key >> 33;
+	return (vUI32)key;
+}
 
-	vPXDebugLogFormatted("Created new parition [%d %d]\n",
-		newPartition->x, newPartition->y);
+static vUI64 PXCellMapKey(vI32 x, vI32 y)
+{
+	return ((vUI64)(vUI32)x << 32) | (vUI64)(vUI32)y;
+}
 
-	/* finalize assigning to partition */
-	PXAssignObjToPartitionFinalization(newPartition, obj);
+static void PXCellMapAllocate(PPXCellMap map, vUI32 capacity)
+{
+	map->keys     = vAlloc(sizeof(vUI64) * capacity);
+	map->values   = vAlloc(sizeof(vUI32) * capacity);
+	map->capacity = capacity;
+	map->count    = 0;
+	memset(map->values, 0xFF, sizeof(vUI32) * capacity);
 }
 
-static void PXPartitionResetIterateFunc(vHNDL dbHndl, vPPXPartition partition, vPTR input)
+void PXCellMapInit(PPXCellMap map, vUI32 capacity)
 {
-	partition->inUse  = FALSE;	/* mark as unused */
-	partition->useage = ZERO;	/* reset useage counter */
-	partition->totalVelocity = 0.0f;	/* reset total velocity */
+	vUI32 pow2 = CELLMAP_CAPACITY_MIN;
+	while (pow2 < capacity) pow2 <<= 1;
+	PXCellMapAllocate(map, pow2);
+}
+
+void PXCellMapFree(PPXCellMap map)
+{
+	vFree(map->keys);
+	vFree(map->values);
+	vZeroMemory(map, sizeof(PXCellMap));
+}
+
+void PXCellMapClear(PPXCellMap map)
+{
+	if (map->count == 0) return;
+	memset(map->values, 0xFF, sizeof(vUI32) * map->capacity);
+	map->count = 0;
+}
+
+vUI32 PXCellMapFind(PPXCellMap map, vI32 x, vI32 y)
+{
+	if (map->capacity == 0) return CELLMAP_EMPTY;
+
+	vUI64 key  = PXCellMapKey(x, y);
+	vUI32 mask = map->capacity - 1;
+	vUI32 slot = PXCellMapHash(key) & mask;
+
+	/* linear probe until match or empty slot */
+	while (map->values[slot] != CELLMAP_EMPTY)
+	{
+		if (map->keys[slot] == key) return map->values[slot];
+		slot = (slot + 1) & mask;
+	}
+	return CELLMAP_EMPTY;
+}
+
+void PXCellMapInsert(PPXCellMap map, vI32 x, vI32 y, vUI32 value)
+{
+	/* keep load factor under 1/2 */
+	if ((map->count + 1) * 2 > map->capacity)
+	{
+		PXCellMap old = *map;
+		PXCellMapAllocate(map, max(CELLMAP_CAPACITY_MIN, old.capacity << 1));
+		for (vUI32 i = 0; i < old.capacity; i++)
+		{
+			if (old.values[i] == CELLMAP_EMPTY) continue;
+			vUI32 slot = PXCellMapHash(old.keys[i]) & (map->capacity - 1);
+			while (map->values[slot] != CELLMAP_EMPTY)
+				slot = (slot + 1) & (map->capacity - 1);
+			map->keys[slot]   = old.keys[i];
+			map->values[slot] = old.values[i];
+			map->count++;
+		}
+		vFree(old.keys);
+		vFree(old.values);
+	}
+
+	vUI64 key  = PXCellMapKey(x, y);
+	vUI32 mask = map->capacity - 1;
+	vUI32 slot = PXCellMapHash(key) & mask;
+	while (map->values[slot] != CELLMAP_EMPTY)
+	{
+		if (map->keys[slot] == key)
+		{
+			map->values[slot] = value;
+			return;
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	map->keys[slot]   = key;
+	map->values[slot] = value;
+	map->count++;
+}
+
+
+/* ========== CELL ORDER						==========	*/
+static vUI32 PXMortonSpread(vUI32 v)
+{
+	/* spread low 16 bits out to the even bits */
+	v &= 0x0000FFFF;
+	v = (v | (v << 8)) & 0x00FF00FF;
+	v = (v | (v << 4)) & 0x0F0F0F0F;
+	v = (v | (v << 2)) & 0x33333333;
+	v = (v | (v << 1)) & 0x55555555;
+	return v;
+}
+
+vUI32 PXCellMortonKey(vI32 x, vI32 y)
+{
+	/* biased so the world origin sits mid range */
+	x = max(0, min(0xFFFF, x + 0x8000));
+	y = max(0, min(0xFFFF, y + 0x8000));
+	return PXMortonSpread(x) | (PXMortonSpread(y) << 1);
+}
+
+void PXCellSortByKey(vPUI32 keys, vUI32 count, vPUI32 order, vPUI32 scratch)
+{
+	/* LSD radix sort of indices on the 32 bit keys, 8 bits a pass */
+	vPUI32 orderFrom = order;
+	vPUI32 orderTo   = scratch;
+	for (vUI32 i = 0; i < count; i++) orderFrom[i] = i;
+	for (vUI32 shift = 0; shift < 32; shift += 8)
+	{
+		vUI32 counts[0x100];
+		vZeroMemory(counts, sizeof(counts));
+		for (vUI32 i = 0; i < count; i++)
+			counts[(keys[orderFrom[i]] >> shift) & 0xFF]++;
+
+		vUI32 total = 0;
+		for (vUI32 bucket = 0; bucket < 0x100; bucket++)
+		{
+			vUI32 bucketCount = counts[bucket];
+			counts[bucket] = total;
+			total += bucketCount;
+		}
+
+		for (vUI32 i = 0; i < count; i++)
+			orderTo[counts[(keys[orderFrom[i]] >> shift) & 0xFF]++] = orderFrom[i];
+
+		vPUI32 swap = orderFrom; orderFrom = orderTo; orderTo = swap;
+	}
+
+	/* 4 passes leave the result back in order */
 }
 
 
 /* ========== SPACE PARTITIONING FUNCTIONS		==========	*/
-void PXPartResetPartitions(void)
+void PXPartResetPartitions(vPPXWorld world)
 {
-	vDBufferIterate(_vphys.partitions, PXPartitionResetIterateFunc, NULL);
+	vDBufferIterate(world->partitions, PXPartitionResetIterateFunc, NULL);
+	PXCellMapClear(&world->partitionMap);
+	world->partitionPoolCursor = 0;
 }
 
-void PXPartObjectOrangizeIntoPartitions(vPPhysical phys)
+void PXPartFreePartitions(vPPXWorld world)
 {
+	vDBufferIterate(world->partitions, PXPartitionFreeIterateFunc, NULL);
+	vDestroyDBuffer(world->partitions);
+	vFree(world->partitionPool);
+	PXCellMapFree(&world->partitionMap);
+
+	world->partitions            = NULL;
+	world->partitionPool         = NULL;
+	world->partitionPoolCount    = 0;
+	world->partitionPoolCapacity = 0;
+	world->partitionPoolCursor   = 0;
+}
+
+void PXPartObjectOrangizeIntoPartitions(vPPXWorld world, vUI32 body)
+{
+	vPGRect boundingBox = &world->bodies.worldBound[body].boundingBox;
+
 	/* get range of partitions to assign object to */
 	vI32 xMin = 0, yMin = 0;
-	PXCalculatePartitionValue(&xMin, &yMin,
-		phys->worldBound.boundingBox.left, phys->worldBound.boundingBox.bottom);
+	PXCalculatePartitionValue(world, &xMin, &yMin,
+		boundingBox->left, boundingBox->bottom);
 	vI32 xMax = 0, yMax = 0;
-	PXCalculatePartitionValue(&xMax, &yMax,
-		phys->worldBound.boundingBox.right, phys->worldBound.boundingBox.top);
+	PXCalculatePartitionValue(world, &xMax, &yMax,
+		boundingBox->right, boundingBox->top);
 
 	/* for each in range, assign the pObj to that partition */
 	for (vI32 pWalkX = xMin; pWalkX <= xMax; pWalkX++)
 	{
 		for (vI32 pWalkY = yMin; pWalkY <= yMax; pWalkY++)
 		{
-			PXAssignObjectToPartition(pWalkX, pWalkY, phys);
+			PXAssignObjectToPartition(world, pWalkX, pWalkY, body);
 		}
 	}
 }
\ No newline at end of file
@@ -11,8 +11,22 @@
 #include "vphys.h"
 
 
+/* ========== CELL MAP							==========	*/
+void  PXCellMapInit(PPXCellMap map, vUI32 capacity);
+void  PXCellMapFree(PPXCellMap map);
+void  PXCellMapClear(PPXCellMap map);
+vUI32 PXCellMapFind(PPXCellMap map, vI32 x, vI32 y);
+void  PXCellMapInsert(PPXCellMap map, vI32 x, vI32 y, vUI32 value);
+
+
+/* ========== CELL ORDER						==========	*/
+vUI32 PXCellMortonKey(vI32 x, vI32 y);
+void  PXCellSortByKey(vPUI32 keys, vUI32 count, vPUI32 order, vPUI32 scratch);
+
+
 /* ========== SPACE PARTITIONING FUNCTIONS		==========	*/
-void PXPartResetPartitions(void);
-void PXPartObjectOrangizeIntoPartitions(vPPhysical phys);
+void PXPartResetPartitions(vPPXWorld world);
+void PXPartFreePartitions(vPPXWorld world);
+void PXPartObjectOrangizeIntoPartitions(vPPXWorld world, vUI32 body);
 
 #endif
\ No newline at end of file